@@ -96,14 +96,17 @@ add_library(core
   fboss/agent/RestartTimeTracker.cpp
   fboss/agent/RouteUpdateLogger.cpp
   fboss/agent/RouteUpdateLoggingPrefixTracker.cpp
+  fboss/agent/RxPacketClassifier.cpp
   fboss/agent/StandaloneRibConversions.cpp
   fboss/agent/StaticL2ForNeighborObserver.cpp
   fboss/agent/StaticL2ForNeighborUpdater.cpp
   fboss/agent/StaticL2ForNeighborSwSwitchUpdater.cpp
   fboss/agent/SwSwitch.cpp
+  fboss/agent/SwitchStateHistory.cpp
   fboss/agent/ThreadHeartbeat.cpp
   fboss/agent/TunIntf.cpp
   fboss/agent/TunManager.cpp
+  fboss/agent/TxPacketTemplates.cpp
   fboss/agent/ndp/IPv6RouteAdvertiser.cpp
   fboss/agent/oss/RouteUpdateLogger.cpp
   fboss/agent/oss/SwSwitch.cpp
@@ -129,6 +132,7 @@ target_link_libraries(core
   state
   state_utils
   exponential_back_off
+  stage_tracer
   fboss_config_utils
   phy_cpp2
   transceiver_cpp2
@@ -43,6 +43,14 @@ add_library(hw_resource_stats_publisher
   fboss/agent/hw/HwResourceStatsPublisher.cpp
 )
 
+add_library(hw_stats_scheduler
+  fboss/agent/hw/HwStatsScheduler.cpp
+)
+
+add_library(hw_programming_scheduler
+  fboss/agent/hw/HwProgrammingScheduler.cpp
+)
+
 target_link_libraries(hw_switch_warmboot_helper
   utils
   Folly::folly
@@ -82,3 +90,12 @@ target_link_libraries(hw_resource_stats_publisher
   fb303::fb303
   hardware_stats_cpp2
 )
+
+target_link_libraries(hw_stats_scheduler
+  fb303::fb303
+  Folly::folly
+)
+
+target_link_libraries(hw_programming_scheduler
+  Folly::folly
+)
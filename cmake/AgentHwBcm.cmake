@@ -94,6 +94,7 @@ target_link_libraries(bcm
   hw_switch_warmboot_helper
   hw_switch_stats
   hw_resource_stats_publisher
+  hw_stats_scheduler
   bcm_types
   packettrace_cpp2
   buffer_stats
@@ -32,6 +32,7 @@ add_library(hw_stats_collection_speed
 target_link_libraries(hw_stats_collection_speed
   config_factory
   hw_packet_utils
+  hw_port_fb303_stats
   ecmp_helper
   hw_benchmark_main
   Folly::folly
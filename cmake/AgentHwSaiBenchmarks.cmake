@@ -3,6 +3,71 @@
 # In general, libraries and binaries in fboss/foo/bar are built by
 # cmake/FooBar.cmake
 
+add_library(sai_tx_throughput
+  fboss/agent/hw/sai/benchmarks/SaiTxThroughputBenchmark.cpp
+)
+
+target_link_libraries(sai_tx_throughput
+  config_factory
+  hw_packet_utils
+  hw_benchmark_main
+  sai_switch
+  Folly::folly
+  Folly::follybenchmark
+)
+
+add_library(sai_state_programming_speed
+  fboss/agent/hw/sai/benchmarks/SaiStateProgrammingBenchmark.cpp
+)
+
+target_link_libraries(sai_state_programming_speed
+  config_factory
+  hw_benchmark_main
+  route_scale_gen
+  sai_switch
+  Folly::folly
+  Folly::follybenchmark
+)
+
+add_library(sai_ecmp_next_hop_swap_speed
+  fboss/agent/hw/sai/benchmarks/SaiEcmpNextHopSwapBenchmark.cpp
+)
+
+target_link_libraries(sai_ecmp_next_hop_swap_speed
+  config_factory
+  ecmp_helper
+  hw_benchmark_main
+  sai_switch
+  Folly::folly
+  Folly::follybenchmark
+)
+
+add_library(sai_neighbor_bulk_programming_speed
+  fboss/agent/hw/sai/benchmarks/SaiNeighborBulkProgrammingBenchmark.cpp
+)
+
+target_link_libraries(sai_neighbor_bulk_programming_speed
+  config_factory
+  hw_benchmark_main
+  sai_switch
+  Folly::folly
+  Folly::follybenchmark
+)
+
+add_library(sai_ecmp_shrink_fast_path_speed
+  fboss/agent/hw/sai/benchmarks/SaiEcmpShrinkFastPathBenchmark.cpp
+)
+
+target_link_libraries(sai_ecmp_shrink_fast_path_speed
+  config_factory
+  ecmp_helper
+  hw_benchmark_main
+  function_call_time_reporter
+  sai_switch
+  Folly::folly
+  Folly::follybenchmark
+)
+
 # NOTE: All the benchmark executables need to link in ${SAI_IMPL_ARG}
 # using '--whole-archive' flag in order to ensure SAI_IMPL symbols are included
 
@@ -171,6 +236,74 @@ function(BUILD_SAI_BENCHMARKS SAI_IMPL_NAME SAI_IMPL_ARG)
     -DSAI_VER_RELEASE=${SAI_VER_RELEASE}"
   )
 
+  add_executable(sai_tx_throughput-${SAI_IMPL_NAME}-${SAI_VER_SUFFIX} /dev/null)
+
+  target_link_libraries(sai_tx_throughput-${SAI_IMPL_NAME}-${SAI_VER_SUFFIX}
+    -Wl,--whole-archive
+    sai_switch_ensemble
+    sai_tx_throughput
+    ${SAI_IMPL_ARG}
+    -Wl,--no-whole-archive
+  )
+
+  set_target_properties(sai_tx_throughput-${SAI_IMPL_NAME}-${SAI_VER_SUFFIX}
+    PROPERTIES COMPILE_FLAGS
+    "-DSAI_VER_MAJOR=${SAI_VER_MAJOR} \
+    -DSAI_VER_MINOR=${SAI_VER_MINOR}  \
+    -DSAI_VER_RELEASE=${SAI_VER_RELEASE}"
+  )
+
+  add_executable(sai_state_programming_speed-${SAI_IMPL_NAME}-${SAI_VER_SUFFIX} /dev/null)
+
+  target_link_libraries(sai_state_programming_speed-${SAI_IMPL_NAME}-${SAI_VER_SUFFIX}
+    -Wl,--whole-archive
+    sai_switch_ensemble
+    sai_state_programming_speed
+    ${SAI_IMPL_ARG}
+    -Wl,--no-whole-archive
+  )
+
+  set_target_properties(sai_state_programming_speed-${SAI_IMPL_NAME}-${SAI_VER_SUFFIX}
+    PROPERTIES COMPILE_FLAGS
+    "-DSAI_VER_MAJOR=${SAI_VER_MAJOR} \
+    -DSAI_VER_MINOR=${SAI_VER_MINOR}  \
+    -DSAI_VER_RELEASE=${SAI_VER_RELEASE}"
+  )
+
+  add_executable(sai_ecmp_next_hop_swap_speed-${SAI_IMPL_NAME}-${SAI_VER_SUFFIX} /dev/null)
+
+  target_link_libraries(sai_ecmp_next_hop_swap_speed-${SAI_IMPL_NAME}-${SAI_VER_SUFFIX}
+    -Wl,--whole-archive
+    sai_switch_ensemble
+    sai_ecmp_next_hop_swap_speed
+    ${SAI_IMPL_ARG}
+    -Wl,--no-whole-archive
+  )
+
+  set_target_properties(sai_ecmp_next_hop_swap_speed-${SAI_IMPL_NAME}-${SAI_VER_SUFFIX}
+    PROPERTIES COMPILE_FLAGS
+    "-DSAI_VER_MAJOR=${SAI_VER_MAJOR} \
+    -DSAI_VER_MINOR=${SAI_VER_MINOR}  \
+    -DSAI_VER_RELEASE=${SAI_VER_RELEASE}"
+  )
+
+  add_executable(sai_neighbor_bulk_programming_speed-${SAI_IMPL_NAME}-${SAI_VER_SUFFIX} /dev/null)
+
+  target_link_libraries(sai_neighbor_bulk_programming_speed-${SAI_IMPL_NAME}-${SAI_VER_SUFFIX}
+    -Wl,--whole-archive
+    sai_switch_ensemble
+    sai_neighbor_bulk_programming_speed
+    ${SAI_IMPL_ARG}
+    -Wl,--no-whole-archive
+  )
+
+  set_target_properties(sai_neighbor_bulk_programming_speed-${SAI_IMPL_NAME}-${SAI_VER_SUFFIX}
+    PROPERTIES COMPILE_FLAGS
+    "-DSAI_VER_MAJOR=${SAI_VER_MAJOR} \
+    -DSAI_VER_MINOR=${SAI_VER_MINOR}  \
+    -DSAI_VER_RELEASE=${SAI_VER_RELEASE}"
+  )
+
   add_executable(sai_tx_slow_path_rate-${SAI_IMPL_NAME}-${SAI_VER_SUFFIX} /dev/null)
 
   target_link_libraries(sai_tx_slow_path_rate-${SAI_IMPL_NAME}-${SAI_VER_SUFFIX}
@@ -224,6 +357,24 @@ function(BUILD_SAI_BENCHMARKS SAI_IMPL_NAME SAI_IMPL_ARG)
     -DSAI_VER_RELEASE=${SAI_VER_RELEASE}"
   )
 
+  add_executable(sai_ecmp_shrink_fast_path_speed-${SAI_IMPL_NAME}-${SAI_VER_SUFFIX} /dev/null)
+
+  target_link_libraries(sai_ecmp_shrink_fast_path_speed-${SAI_IMPL_NAME}-${SAI_VER_SUFFIX}
+    -Wl,--whole-archive
+    sai_switch_ensemble
+    sai_ecmp_shrink_fast_path_speed
+    sai_ecmp_utils
+    ${SAI_IMPL_ARG}
+    -Wl,--no-whole-archive
+  )
+
+  set_target_properties(sai_ecmp_shrink_fast_path_speed-${SAI_IMPL_NAME}-${SAI_VER_SUFFIX}
+    PROPERTIES COMPILE_FLAGS
+    "-DSAI_VER_MAJOR=${SAI_VER_MAJOR} \
+    -DSAI_VER_MINOR=${SAI_VER_MINOR}  \
+    -DSAI_VER_RELEASE=${SAI_VER_RELEASE}"
+  )
+
   add_executable(sai_ecmp_shrink_with_competing_route_updates_speed-${SAI_IMPL_NAME}-${SAI_VER_SUFFIX} /dev/null)
 
   target_link_libraries(sai_ecmp_shrink_with_competing_route_updates_speed-${SAI_IMPL_NAME}-${SAI_VER_SUFFIX}
@@ -366,6 +517,9 @@ if(SAI_IMPL)
   install(
     TARGETS
     sai_ecmp_shrink_speed-sai_impl-${SAI_VER_SUFFIX})
+  install(
+    TARGETS
+    sai_ecmp_shrink_fast_path_speed-sai_impl-${SAI_VER_SUFFIX})
   install(
     TARGETS
     sai_hgrid_uu_scale_route_add_speed-sai_impl-${SAI_VER_SUFFIX})
@@ -381,6 +535,18 @@ if(SAI_IMPL)
   install(
     TARGETS
     sai_tx_slow_path_rate-sai_impl-${SAI_VER_SUFFIX})
+  install(
+    TARGETS
+    sai_tx_throughput-sai_impl-${SAI_VER_SUFFIX})
+  install(
+    TARGETS
+    sai_state_programming_speed-sai_impl-${SAI_VER_SUFFIX})
+  install(
+    TARGETS
+    sai_ecmp_next_hop_swap_speed-sai_impl-${SAI_VER_SUFFIX})
+  install(
+    TARGETS
+    sai_neighbor_bulk_programming_speed-sai_impl-${SAI_VER_SUFFIX})
   install(
     TARGETS
     sai_rx_slow_path_rate-sai_impl-${SAI_VER_SUFFIX})
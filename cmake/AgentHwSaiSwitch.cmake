@@ -29,6 +29,7 @@ add_library(sai_switch
   fboss/agent/hw/sai/switch/SaiSwitch.cpp
   fboss/agent/hw/sai/switch/SaiSwitchManager.cpp
   fboss/agent/hw/sai/switch/SaiTxPacket.cpp
+  fboss/agent/hw/sai/switch/SaiTxQueue.cpp
   fboss/agent/hw/sai/switch/SaiVlanManager.cpp
   fboss/agent/hw/sai/switch/SaiVirtualRouterManager.cpp
   fboss/agent/hw/sai/switch/SaiWredManager.cpp
@@ -45,6 +46,8 @@ target_link_libraries(sai_switch
   hw_cpu_fb303_stats
   hw_port_fb303_stats
   hw_resource_stats_publisher
+  hw_stats_scheduler
+  hw_programming_scheduler
   hw_switch_warmboot_helper
   sai_api
   sai_store
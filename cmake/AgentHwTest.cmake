@@ -65,6 +65,7 @@ add_library(hw_switch_ensemble
 
 target_link_libraries(hw_switch_ensemble
   hw_link_state_toggler
+  hw_stats_scheduler
   core
 )
 
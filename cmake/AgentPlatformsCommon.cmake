@@ -22,6 +22,7 @@ target_link_libraries(platform_mapping
   error
   fboss_config_utils
   platform_config_cpp2
+  Folly::folly
   ${RE2}
 )
 
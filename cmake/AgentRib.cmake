@@ -12,6 +12,7 @@ add_library(standalone_rib
   fboss/agent/rib/RouteTypes.cpp
   fboss/agent/rib/RouteUpdater.cpp
   fboss/agent/rib/RoutingInformationBase.cpp
+  fboss/agent/rib/UnicastRouteDecoder.cpp
 )
 
 target_link_libraries(standalone_rib
@@ -23,6 +24,8 @@ target_link_libraries(standalone_rib
   ctrl_cpp2
   label_forwarding_action
   state_utils
+  interned
+  stage_tracer
   Folly::folly
 )
 
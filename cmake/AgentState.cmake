@@ -68,6 +68,7 @@ target_link_libraries(state
   label_forwarding_action
   state_utils
   radix_tree
+  interned
   phy_cpp2
   Folly::folly
 )
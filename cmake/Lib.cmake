@@ -27,6 +27,16 @@ add_library(ref_map
 
 set_target_properties(ref_map PROPERTIES LINKER_LANGUAGE CXX)
 
+add_library(interned
+  fboss/lib/Interned.h
+)
+
+set_target_properties(interned PROPERTIES LINKER_LANGUAGE CXX)
+
+target_link_libraries(interned
+  Folly::folly
+)
+
 add_library(tuple_utils
   fboss/lib/TupleUtils.h
 )
@@ -48,3 +58,12 @@ add_library(function_call_time_reporter
 target_link_libraries(function_call_time_reporter
   Folly::folly
 )
+
+add_library(stage_tracer
+  fboss/lib/StageTracer.cpp
+)
+
+target_link_libraries(stage_tracer
+  fb303::fb303
+  Folly::folly
+)
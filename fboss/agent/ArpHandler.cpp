@@ -21,6 +21,7 @@
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/SwitchStats.h"
 #include "fboss/agent/TxPacket.h"
+#include "fboss/agent/TxPacketTemplates.h"
 #include "fboss/agent/packet/PktUtil.h"
 #include "fboss/agent/state/AggregatePort.h"
 #include "fboss/agent/state/ArpEntry.h"
@@ -50,6 +51,10 @@ enum : uint8_t {
   ARP_PLEN_IPV4 = 4,
 };
 
+// Offset of the op code in the frames we send, past the tagged ethernet
+// header and the hardware and protocol types and lengths
+constexpr uint32_t kArpOpCodeOffset = 24;
+
 namespace facebook::fboss {
 
 ArpHandler::ArpHandler(SwSwitch* sw) : sw_(sw) {}
@@ -187,24 +192,34 @@ static void sendArp(
   // The minimum packet length is 64.  We use 68 here on the assumption that
   // the packet will go out untagged, which will remove 4 bytes.
   uint32_t pktLen = 68;
-  auto pkt = sw->allocatePacket(pktLen);
-  RWPrivateCursor cursor(pkt->buf());
+  // The frame is the same for every ARP sent from an interface address but
+  // for the destination, op code and target, which get patched in below
+  auto pkt = sw->getTxPacketTemplates()->allocatePacket(
+      {TxPacketTemplates::Kind::ARP, vlan, senderMac, senderIP},
+      pktLen,
+      [&](RWPrivateCursor* cursor) {
+        TxPacket::writeEthHeader(
+            cursor, targetMac, senderMac, vlan, ArpHandler::ETHERTYPE_ARP);
+        cursor->writeBE<uint16_t>(ARP_HTYPE_ETHERNET);
+        cursor->writeBE<uint16_t>(ARP_PTYPE_IPV4);
+        cursor->writeBE<uint8_t>(ARP_HLEN_ETHERNET);
+        cursor->writeBE<uint8_t>(ARP_PLEN_IPV4);
+        cursor->writeBE<uint16_t>(op);
+        cursor->push(senderMac.bytes(), MacAddress::SIZE);
+        cursor->write<uint32_t>(senderIP.toLong());
+        // Fill the rest, target and padding, with 0s
+        memset(cursor->writableData(), 0, cursor->length());
+      });
 
-  pkt->writeEthHeader(
-      &cursor, targetMac, senderMac, vlan, ArpHandler::ETHERTYPE_ARP);
-  cursor.writeBE<uint16_t>(ARP_HTYPE_ETHERNET);
-  cursor.writeBE<uint16_t>(ARP_PTYPE_IPV4);
-  cursor.writeBE<uint8_t>(ARP_HLEN_ETHERNET);
-  cursor.writeBE<uint8_t>(ARP_PLEN_IPV4);
+  RWPrivateCursor cursor(pkt->buf());
+  cursor.push(targetMac.bytes(), MacAddress::SIZE);
+  cursor.skip(kArpOpCodeOffset - MacAddress::SIZE);
   cursor.writeBE<uint16_t>(op);
-  cursor.push(senderMac.bytes(), MacAddress::SIZE);
-  cursor.write<uint32_t>(senderIP.toLong());
+  cursor.skip(MacAddress::SIZE + IPAddressV4::byteCount());
   cursor.push(
       ((op == ARP_OP_REQUEST) ? MacAddress::ZERO.bytes() : targetMac.bytes()),
       MacAddress::SIZE);
   cursor.write<uint32_t>(targetIP.toLong());
-  // Fill the padding with 0s
-  memset(cursor.writableData(), 0, cursor.length());
 
   sw->sendNetworkControlPacketAsync(std::move(pkt), portDesc);
 }
@@ -8,47 +8,47 @@
  *
  */
 
+#include <limits.h>
+#include <sys/uio.h>
 #include <cstdlib>
+#include <cstring>
 #include <exception>
 #include <fstream>
 #include <iostream>
+#include <vector>
 
 #include "fboss/agent/AsyncLogger.h"
 #include "fboss/agent/SysError.h"
 
 #include <folly/FileUtil.h>
 #include <gflags/gflags.h>
+#include <glog/logging.h>
 
 DEFINE_bool(
     disable_async_logger,
     false,
     "Flag to indicate whether to disable async logging and directly write into the file");
 
-enum BufferToWrite { BUFFER0, BUFFER1 };
-
 static std::string exitFilePath;
-static uint32_t offset = 0;
-static BufferToWrite currentBuffer = BUFFER0;
-static std::array<char, facebook::fboss::AsyncLogger::kBufferSize> buffer0;
-static std::array<char, facebook::fboss::AsyncLogger::kBufferSize> buffer1;
+static std::atomic<const facebook::fboss::AsyncLogger*> terminateLogger{
+    nullptr};
 
 namespace {
 
 void terminateHandler() {
-  if (offset > 0) {
+  auto logger = terminateLogger.load();
+  if (logger) {
     // Use standard library instead of folly because in unclean exit, folly
     // library could be inaccessible so there's a higher chance of writing into
     // file using standard library.
     std::ofstream logfile;
     logfile.open(exitFilePath, std::ofstream::app);
 
-    if (currentBuffer == BUFFER0) {
-      logfile.write(buffer0.data(), offset);
-    } else {
-      logfile.write(buffer1.data(), offset);
+    auto bytesWritten = logger->writeBufferedLogsOnTerminate(logfile);
+    if (bytesWritten > 0) {
+      std::cerr << "Async logger exit with " << bytesWritten
+                << " bytes written to file " << std::endl;
     }
-    std::cerr << "Async logger exit with " << offset
-              << " bytes written to file " << std::endl;
   }
 
   abort();
@@ -57,73 +57,239 @@ void terminateHandler() {
 } // namespace
 
 namespace facebook::fboss {
-AsyncLogger::AsyncLogger(std::string filePath, uint32_t logTimeout)
-    : bufferSize_(AsyncLogger::kBufferSize) {
+AsyncLogger::AsyncLogger(
+    std::string filePath,
+    uint32_t logTimeout,
+    BackpressureMode backpressureMode,
+    uint32_t segmentSize,
+    uint32_t numSegments)
+    : backpressureMode_(backpressureMode),
+      segmentSize_(segmentSize),
+      numSegments_(numSegments) {
+  // The ring needs at least one segment to write to while another one is
+  // being flushed.
+  CHECK_GE(numSegments_, 2);
+  CHECK_GT(segmentSize_, 0);
+
   openLogFile(filePath);
 
   if (!FLAGS_disable_async_logger) {
-    logBuffer_ = buffer0.data();
-    flushBuffer_ = buffer1.data();
+    ringMemory_ = std::make_unique<char[]>(
+        static_cast<size_t>(segmentSize_) * numSegments_);
+    segments_ = std::make_unique<Segment[]>(numSegments_);
+    for (uint32_t i = 0; i < numSegments_; ++i) {
+      segments_[i].data =
+          ringMemory_.get() + static_cast<size_t>(i) * segmentSize_;
+    }
 
     exitFilePath = filePath;
 
     logTimeout_ = std::chrono::milliseconds(logTimeout);
 
+    terminateLogger.store(this);
     std::set_terminate(terminateHandler);
   }
 }
 
 AsyncLogger::~AsyncLogger() {
+  // Unregister from terminate handler before the ring memory is released
+  const AsyncLogger* self = this;
+  terminateLogger.compare_exchange_strong(self, nullptr);
   fsync(logFile_.wlock()->fd());
 }
 
 void AsyncLogger::worker_thread() {
   while (enableLogging_) {
-    std::unique_lock<std::mutex> lock(latch_);
+    bool requested;
+    OversizedRecord* oversized;
+    {
+      std::unique_lock<std::mutex> lock(latch_);
+
+      // Wait for either 1. Timeout 2. Force flush, full flush or oversized
+      // record 3. Stop
+      requested = flushCv_.wait_for(lock, logTimeout_, [this] {
+        return forceFlush_ || fullFlush_ || oversizedRecord_ ||
+            !enableLogging_;
+      });
+      fullFlush_ = false;
+      oversized = oversizedRecord_;
+    }
+    bool forceRequested = forceFlush_;
+    bool force = forceRequested || oversized;
+
+    // On timeout or force flush, also write out the partially filled segment
+    // producers are currently writing to. On full flush, only segments that
+    // were sealed by producers are written out so that the ring keeps
+    // filling whole segments under heavy logging.
+    if (!requested || force) {
+      sealHeadIfNotEmpty();
+    }
+    flushSealedSegments();
+    if (oversized) {
+      writeOversizedRecord(oversized);
+    }
 
-    // Wait for either 1. Timeout 2. Force flush or full flush
-    cv_.wait_for(lock, logTimeout_, [this] {
-      return this->forceFlush_ || this->fullFlush_;
-    });
+    // Notify force flush that write completes
+    if (forceRequested) {
+      std::lock_guard<std::mutex> lock(latch_);
+      forceFlush_ = false;
+      promise_.set_value(0);
+      promise_ = std::promise<int>();
+    }
+  }
 
-    // Swap log buffer and flush buffer
-    char* writeBuffer = logBuffer_;
-    uint32_t currSize = offset;
-    offset = 0;
-    currentBuffer = ((currentBuffer == BUFFER0) ? BUFFER1 : BUFFER0);
-    logBuffer_ = flushBuffer_;
+  // Drain whatever is left in the ring before exiting
+  sealHeadIfNotEmpty();
+  flushSealedSegments();
+  OversizedRecord* oversized;
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    oversized = oversizedRecord_;
+  }
+  if (oversized) {
+    writeOversizedRecord(oversized);
+  }
+}
 
-    if (fullFlush_) {
-      fullFlush_ = false;
+void AsyncLogger::writeOversizedRecord(OversizedRecord* record) {
+  std::exception_ptr error;
+  try {
+    writeToFile(record->data, record->size);
+  } catch (const std::exception&) {
+    error = std::current_exception();
+  }
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    oversizedRecord_ = nullptr;
+  }
+  if (error) {
+    record->written.set_exception(error);
+  } else {
+    record->written.set_value();
+  }
+}
+
+void AsyncLogger::sealSegment(uint64_t seq, uint64_t validSize) {
+  segmentAt(seq).validSize.store(validSize, std::memory_order_release);
+  tryAdvanceHead(seq);
+  notifyFlushThread();
+}
+
+bool AsyncLogger::tryAdvanceHead(uint64_t seq) {
+  // The next segment in the ring is free only once it has been flushed
+  if (seq + 1 < tail_.load(std::memory_order_acquire) + numSegments_) {
+    auto expected = seq;
+    head_.compare_exchange_strong(
+        expected, seq + 1, std::memory_order_acq_rel);
+  }
+  return head_.load(std::memory_order_acquire) != seq;
+}
+
+bool AsyncLogger::waitForNextSegment(uint64_t seq) {
+  while (head_.load(std::memory_order_acquire) == seq) {
+    if (tryAdvanceHead(seq)) {
+      break;
     }
+    if (backpressureMode_ == BackpressureMode::DROP || !enableLogging_) {
+      return false;
+    }
+    // Every segment is waiting to be flushed, block until one is freed
+    std::unique_lock<std::mutex> lock(latch_);
+    spaceCv_.wait(lock, [this, seq] {
+      return head_.load(std::memory_order_acquire) != seq ||
+          seq + 1 < tail_.load(std::memory_order_acquire) + numSegments_ ||
+          !enableLogging_;
+    });
+  }
+  return true;
+}
 
-    lock.unlock();
-    cv_.notify_one();
+void AsyncLogger::sealHeadIfNotEmpty() {
+  auto seq = head_.load(std::memory_order_acquire);
+  auto& segment = segmentAt(seq);
+  auto reserved = segment.reserved.load(std::memory_order_acquire);
+  if (reserved == 0 || reserved > segmentSize_) {
+    // Either nothing to flush, or a producer already sealed this segment
+    return;
+  }
+  // Reserve past the end of the segment, exactly like a producer whose
+  // record does not fit. Whoever overflows first seals the segment.
+  auto offset =
+      segment.reserved.fetch_add(segmentSize_ + 1, std::memory_order_acq_rel);
+  if (offset <= segmentSize_) {
+    segment.validSize.store(offset, std::memory_order_release);
+    tryAdvanceHead(seq);
+  }
+}
 
-    // Write content in swap buffer to file
-    if (currSize > 0) {
-      auto bytesWritten = logFile_.withWLock([&](auto& lockedFile) {
-        return folly::writeFull(lockedFile.fd(), writeBuffer, currSize);
-      });
+void AsyncLogger::flushSealedSegments() {
+  std::vector<iovec> iov;
+  iov.reserve(numSegments_);
 
-      if (bytesWritten < 0) {
-        throw SysError(
-            errno, "error writing ", currSize, " bytes to log file.");
-      }
+  while (true) {
+    auto head = head_.load(std::memory_order_acquire);
+    if (isSealed(segmentAt(head))) {
+      // Sealed while the ring was full, move on now that space may be free
+      tryAdvanceHead(head);
+      head = head_.load(std::memory_order_acquire);
+    }
+    auto tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head) {
+      return;
+    }
 
-      flushCount_++;
+    iov.clear();
+    for (auto seq = tail; seq < head; ++seq) {
+      auto& segment = segmentAt(seq);
+      // The sealing producer publishes validSize right after its reservation,
+      // and producers with reservations below validSize may still be copying.
+      uint64_t validSize;
+      while ((validSize = segment.validSize.load(std::memory_order_acquire)) ==
+             kNotSealed) {
+        std::this_thread::yield();
+      }
+      while (segment.committed.load(std::memory_order_acquire) < validSize) {
+        std::this_thread::yield();
+      }
+      if (validSize > 0) {
+        iov.push_back({segment.data, validSize});
+      }
     }
 
-    memset(writeBuffer, 0, bufferSize_);
-    flushBuffer_ = writeBuffer;
+    // Write content of all sealed segments to file
+    logFile_.withWLock([&](auto& lockedFile) {
+      for (size_t i = 0; i < iov.size(); i += IOV_MAX) {
+        auto count = std::min<size_t>(IOV_MAX, iov.size() - i);
+        if (folly::writevFull(lockedFile.fd(), iov.data() + i, count) < 0) {
+          throw SysError(
+              errno, "error writing ", count, " segments to log file.");
+        }
+      }
+    });
+    flushCount_ += iov.size();
+
+    // Reset the flushed segments and hand them back to producers
+    for (auto seq = tail; seq < head; ++seq) {
+      auto& segment = segmentAt(seq);
+      segment.committed.store(0, std::memory_order_relaxed);
+      segment.validSize.store(kNotSealed, std::memory_order_relaxed);
+      segment.reserved.store(0, std::memory_order_release);
+    }
+    tail_.store(head, std::memory_order_release);
 
-    // Notify force flush that write completes
-    if (forceFlush_) {
-      forceFlush_ = false;
-      promise_.set_value(0);
-      promise_ = std::promise<int>();
+    {
+      std::lock_guard<std::mutex> lock(latch_);
     }
+    spaceCv_.notify_all();
+  }
+}
+
+void AsyncLogger::notifyFlushThread() {
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    fullFlush_ = true;
   }
+  flushCv_.notify_one();
 }
 
 void AsyncLogger::startFlushThread() {
@@ -135,7 +301,12 @@ void AsyncLogger::startFlushThread() {
 
 void AsyncLogger::stopFlushThread() {
   if (!FLAGS_disable_async_logger && enableLogging_) {
-    enableLogging_ = false;
+    {
+      std::lock_guard<std::mutex> lock(latch_);
+      enableLogging_ = false;
+    }
+    flushCv_.notify_one();
+    spaceCv_.notify_all();
     flushThread_->join();
     delete flushThread_;
   }
@@ -143,59 +314,103 @@ void AsyncLogger::stopFlushThread() {
 
 void AsyncLogger::forceFlush() {
   if (!FLAGS_disable_async_logger) {
-    future_ = promise_.get_future();
-
-    forceFlush_ = true;
-    cv_.notify_one();
+    {
+      std::lock_guard<std::mutex> lock(latch_);
+      future_ = promise_.get_future();
+      forceFlush_ = true;
+    }
+    flushCv_.notify_one();
 
     // Wait for flush to complete
     future_.get();
   }
 }
 
+void AsyncLogger::writeToFile(const char* logRecord, size_t logSize) {
+  auto bytesWritten = logFile_.withWLock([&](auto& lockedFile) {
+    return folly::writeFull(lockedFile.fd(), logRecord, logSize);
+  });
+
+  if (bytesWritten < 0) {
+    throw SysError(errno, "error writing ", logSize, " bytes to log file.");
+  }
+}
+
 void AsyncLogger::appendLog(const char* logRecord, size_t logSize) {
-  if (!enableLogging_) {
+  if (!enableLogging_ || logSize == 0) {
     return;
   }
 
-  if (FLAGS_disable_async_logger && logSize > 0) {
-    auto bytesWritten = logFile_.withWLock([&](auto& lockedFile) {
-      return folly::writeFull(lockedFile.fd(), logRecord, logSize);
-    });
-
-    if (bytesWritten < 0) {
-      throw SysError(errno, "error writing ", logSize, " bytes to log file.");
-    }
+  if (FLAGS_disable_async_logger) {
+    writeToFile(logRecord, logSize);
     return;
   }
 
-  // Acquire the lock and check if there's enough space in the buffer
-  latch_.lock();
+  if (logSize > segmentSize_) {
+    appendOversizedLog(logRecord, logSize);
+    return;
+  }
 
-  if (logSize + offset >= bufferSize_) {
-    // Release the lock and notify worker thread to flush logs
-    fullFlush_ = true;
-    latch_.unlock();
-    cv_.notify_one();
+  while (true) {
+    auto seq = head_.load(std::memory_order_acquire);
+    auto& segment = segmentAt(seq);
+    auto offset =
+        segment.reserved.fetch_add(logSize, std::memory_order_acq_rel);
+
+    if (offset + logSize <= segmentSize_) {
+      // Fast path: record fits in the current segment
+      memcpy(segment.data + offset, logRecord, logSize);
+      segment.committed.fetch_add(logSize, std::memory_order_release);
+      return;
+    }
 
-    // Wait for worker to finish
-    std::unique_lock<std::mutex> lock(latch_);
-    cv_.wait(lock, [logSize] {
-      return logSize + offset < AsyncLogger::kBufferSize;
-    });
+    if (offset <= segmentSize_) {
+      // We are the first to overflow this segment. Everything reserved before
+      // us belongs to the segment.
+      sealSegment(seq, offset);
+    }
 
-    // Write to buffer
-    memcpy(logBuffer_ + offset, logRecord, logSize);
-    offset += logSize;
+    if (!waitForNextSegment(seq)) {
+      droppedRecords_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+  }
+}
 
-    lock.unlock();
-  } else {
-    // Directly write to buffer
-    memcpy(logBuffer_ + offset, logRecord, logSize);
-    offset += logSize;
+void AsyncLogger::appendOversizedLog(const char* logRecord, size_t logSize) {
+  // The record can never fit in a segment. Hand it to the flush thread,
+  // which writes it out right after everything reserved before it, so it
+  // keeps its place among the records. One record at a time.
+  std::lock_guard<std::mutex> oversizedLock(oversizedMutex_);
+  OversizedRecord record{logRecord, logSize, {}};
+  auto written = record.written.get_future();
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    if (!enableLogging_) {
+      // The flush thread may be gone already
+      droppedRecords_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    oversizedRecord_ = &record;
+  }
+  flushCv_.notify_one();
+  written.get();
+}
 
-    latch_.unlock();
+uint64_t AsyncLogger::writeBufferedLogsOnTerminate(std::ostream& out) const {
+  if (!segments_) {
+    return 0;
+  }
+  uint64_t bytesWritten = 0;
+  auto tail = tail_.load();
+  auto head = head_.load();
+  for (auto seq = tail; seq <= head && seq < tail + numSegments_; ++seq) {
+    auto& segment = segmentAt(seq);
+    auto size = std::min<uint64_t>(segment.committed.load(), segmentSize_);
+    out.write(segment.data, size);
+    bytesWritten += size;
   }
+  return bytesWritten;
 }
 
 void AsyncLogger::openLogFile(std::string& file_path) {
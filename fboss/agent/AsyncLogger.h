@@ -10,66 +10,165 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <future>
+#include <limits>
+#include <memory>
 #include <mutex>
+#include <ostream>
+#include <thread>
 
 #include <folly/File.h>
 #include <folly/Synchronized.h>
 
 namespace facebook::fboss {
 
+/*
+ * AsyncLogger buffers log records in memory and writes them out to a file from
+ * a dedicated flush thread.
+ *
+ * The buffer is a ring of fixed size segments shared by all producers.
+ * Producers reserve space in the active segment with a single atomic
+ * fetch_add and copy their record in without taking any lock. The producer
+ * whose reservation first overflows the active segment seals it and moves the
+ * ring forward to the next free segment. The flush thread waits for in-flight
+ * copies into sealed segments to complete and writes all of them out with a
+ * single writev().
+ *
+ * When every segment is waiting to be flushed, producers either block until
+ * the flush thread frees a segment or drop their record (and count it),
+ * depending on the configured BackpressureMode.
+ */
 class AsyncLogger {
  public:
-  explicit AsyncLogger(std::string filePath, uint32_t logTimeout);
-
-  ~AsyncLogger();
+  enum class BackpressureMode {
+    // Block producers until the flush thread frees a segment
+    BLOCK,
+    // Drop records that do not fit and bump droppedRecords()
+    DROP,
+  };
 
   /*
-   * To handle unclean exit, we use terminate handler to write out the logs that
-   * are still in the buffer. However, terminate handler is invoked after the
-   * program exits, meaning variables could be already destructed when we enter
-   * terminate handler. Therefore, we use static variables for the async buffer
-   * and related data structures. They are not garbage collected until terminate
-   * handler is finished.
-   * However, the downside of this approach is that the buffer size needs to be
-   * hardcoded (instead of declaring a google flag and pass in as command line
-   * argument). The buffer size should be known at compile time.
-   * Therefore, we chose the buffer size of 409600, which is an appropriate
-   * number that's not introducing too much memory overhead (roughly 0.035% of
-   * current prod usage), but still perform well in frequent updates and
-   * benchmark tests.
+   * Default segment size and count. Two segments of 409600 bytes matches the
+   * memory footprint of the old double-buffered logger (roughly 0.035% of
+   * current prod usage). We default to four segments so that bursts of
+   * logging can keep filling the ring while the flush thread is writing out.
    */
   static auto constexpr kBufferSize = 409600;
+  static auto constexpr kDefaultNumSegments = 4;
+
+  AsyncLogger(
+      std::string filePath,
+      uint32_t logTimeout,
+      BackpressureMode backpressureMode = BackpressureMode::BLOCK,
+      uint32_t segmentSize = kBufferSize,
+      uint32_t numSegments = kDefaultNumSegments);
+
+  ~AsyncLogger();
 
   void startFlushThread();
   void stopFlushThread();
+  // Wait for everything logged so far to be written out. Not meant to be
+  // called from more than one thread at a time.
   void forceFlush();
 
   void appendLog(const char* logRecord, size_t logSize);
 
-  // Expose these variables for testing purpose
+  uint64_t droppedRecords() const {
+    return droppedRecords_.load(std::memory_order_relaxed);
+  }
+
+  uint32_t getSegmentSize() const {
+    return segmentSize_;
+  }
+
+  uint32_t getNumSegments() const {
+    return numSegments_;
+  }
+
+  /*
+   * To handle unclean exit, we use terminate handler to write out the logs
+   * that are still in the ring. The handler only reads the raw segment memory
+   * which is released after the handler is unregistered in the destructor.
+   */
+  uint64_t writeBufferedLogsOnTerminate(std::ostream& out) const;
+
+  // Expose these variables for testing purpose. flushCount_ is the number of
+  // non-empty segments written out to the log file.
   uint32_t flushCount_{0};
 
  private:
+  /*
+   * A segment is open for writes while reserved <= segmentSize_. Once a
+   * reservation pushes reserved past segmentSize_, the segment is sealed and
+   * validSize is the number of bytes that belong to records which fit.
+   * The segment is ready to be flushed once committed == validSize.
+   */
+  static auto constexpr kNotSealed = std::numeric_limits<uint64_t>::max();
+
+  struct alignas(64) Segment {
+    std::atomic<uint64_t> reserved{0};
+    std::atomic<uint64_t> committed{0};
+    std::atomic<uint64_t> validSize{kNotSealed};
+    char* data{nullptr};
+  };
+
+  // A record larger than a segment, written out by the flush thread
+  struct OversizedRecord {
+    const char* data;
+    size_t size;
+    std::promise<void> written;
+  };
+
   void worker_thread();
   void openLogFile(std::string& file_path);
 
-  bool forceFlush_{false};
-  bool fullFlush_{false};
-  bool enableLogging_{false};
-
-  uint32_t bufferSize_;
-
-  char* logBuffer_;
-  char* flushBuffer_;
+  Segment& segmentAt(uint64_t seq) const {
+    return segments_[seq % numSegments_];
+  }
+  bool isSealed(const Segment& segment) const {
+    return segment.reserved.load(std::memory_order_acquire) > segmentSize_;
+  }
+  void sealSegment(uint64_t seq, uint64_t validSize);
+  bool tryAdvanceHead(uint64_t seq);
+  bool waitForNextSegment(uint64_t seq);
+  void sealHeadIfNotEmpty();
+  void flushSealedSegments();
+  void writeToFile(const char* logRecord, size_t logSize);
+  void appendOversizedLog(const char* logRecord, size_t logSize);
+  void writeOversizedRecord(OversizedRecord* record);
+  void notifyFlushThread();
+
+  std::atomic<bool> forceFlush_{false};
+  std::atomic<bool> fullFlush_{false};
+  std::atomic<bool> enableLogging_{false};
+
+  BackpressureMode backpressureMode_;
+  uint32_t segmentSize_;
+  uint32_t numSegments_;
+
+  std::unique_ptr<char[]> ringMemory_;
+  std::unique_ptr<Segment[]> segments_;
+
+  // Sequence number of the segment producers are writing to
+  std::atomic<uint64_t> head_{0};
+  // Sequence number of the oldest segment not yet flushed
+  std::atomic<uint64_t> tail_{0};
+
+  std::atomic<uint64_t> droppedRecords_{0};
 
   std::promise<int> promise_;
   std::future<int> future_;
   std::mutex latch_;
+  // Serializes oversized records, one is handed to the flush thread at a time
+  std::mutex oversizedMutex_;
+  // Guarded by latch_
+  OversizedRecord* oversizedRecord_{nullptr};
   std::thread* flushThread_;
-  std::condition_variable cv_;
+  std::condition_variable flushCv_;
+  std::condition_variable spaceCv_;
   std::chrono::microseconds logTimeout_;
 
   folly::Synchronized<folly::File> logFile_;
@@ -20,6 +20,7 @@
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/SwitchStats.h"
 #include "fboss/agent/TxPacket.h"
+#include "fboss/agent/TxPacketTemplates.h"
 #include "fboss/agent/Utils.h"
 #include "fboss/agent/packet/ICMPHdr.h"
 #include "fboss/agent/packet/IPv6Hdr.h"
@@ -47,6 +48,14 @@ using folly::io::RWPrivateCursor;
 using std::shared_ptr;
 using std::unique_ptr;
 
+namespace {
+// Offsets of the variable fields of the neighbor solicitations we send, in
+// a tagged ethernet frame
+constexpr uint32_t kNdpSolicitationDstIPOffset = 42;
+constexpr uint32_t kNdpSolicitationChecksumOffset = 60;
+constexpr uint32_t kNdpSolicitationTargetOffset = 66;
+} // namespace
+
 namespace facebook::fboss {
 
 template <typename BodyFn>
@@ -667,16 +676,64 @@ void IPv6Handler::sendMulticastNeighborSolicitation(
   XLOG(DBG4) << "sending neighbor solicitation for " << targetIP << " on vlan "
              << vlanID;
 
-  sendNeighborSolicitation(
-      sw,
-      solicitedNodeAddr,
-      dstMac,
-      srcIP,
-      srcMac,
-      targetIP,
-      vlanID,
-      std::optional<PortDescriptor>(),
-      ndpOptions);
+  uint32_t bodyLength = ICMPHdr::ICMPV6_UNUSED_LEN + IPAddressV6::byteCount() +
+      ndpOptions.computeTotalLength();
+  uint32_t pktLen = ICMPHdr::computeTotalLengthV6(bodyLength);
+
+  // Solicitations sent from an interface only differ in their destination
+  // and target. The template leaves both zeroed, so the checksum it carries
+  // only needs them added in.
+  auto pkt = sw->getTxPacketTemplates()->allocatePacket(
+      {TxPacketTemplates::Kind::NDP_NEIGHBOR_SOLICITATION,
+       vlanID,
+       srcMac,
+       srcIP},
+      pktLen,
+      [&](RWPrivateCursor* cursor) {
+        IPv6Hdr ipv6(srcIP, IPAddressV6());
+        ipv6.trafficClass = 0xe0; // CS7 precedence (network control)
+        ipv6.payloadLength = ICMPHdr::SIZE + bodyLength;
+        ipv6.nextHeader = static_cast<uint8_t>(IP_PROTO::IP_PROTO_IPV6_ICMP);
+        ipv6.hopLimit = 255;
+        ICMPHdr icmp6(
+            static_cast<uint8_t>(
+                ICMPv6Type::ICMPV6_TYPE_NDP_NEIGHBOR_SOLICITATION),
+            static_cast<uint8_t>(ICMPv6Code::ICMPV6_CODE_NDP_MESSAGE_CODE),
+            0);
+        icmp6.serializeFullPacket(
+            cursor,
+            MacAddress::ZERO,
+            srcMac,
+            vlanID,
+            ipv6,
+            bodyLength,
+            [&](RWPrivateCursor* bodyCursor) {
+              bodyCursor->writeBE<uint32_t>(0); // reserved
+              bodyCursor->push(
+                  IPAddressV6().bytes(), IPAddressV6::byteCount());
+              ndpOptions.serialize(bodyCursor);
+            });
+      });
+
+  auto buf = pkt->buf();
+  RWPrivateCursor(buf).push(dstMac.bytes(), MacAddress::SIZE);
+  (RWPrivateCursor(buf) + kNdpSolicitationDstIPOffset)
+      .push(solicitedNodeAddr.bytes(), IPAddressV6::byteCount());
+  (RWPrivateCursor(buf) + kNdpSolicitationTargetOffset)
+      .push(targetIP.bytes(), IPAddressV6::byteCount());
+
+  uint32_t sum = static_cast<uint16_t>(
+      ~(Cursor(buf) + kNdpSolicitationChecksumOffset).readBE<uint16_t>());
+  sum = PktUtil::partialChecksum(
+      Cursor(buf) + kNdpSolicitationDstIPOffset, IPAddressV6::byteCount(), sum);
+  sum = PktUtil::partialChecksum(
+      Cursor(buf) + kNdpSolicitationTargetOffset,
+      IPAddressV6::byteCount(),
+      sum);
+  (RWPrivateCursor(buf) + kNdpSolicitationChecksumOffset)
+      .writeBE<uint16_t>(PktUtil::finalizeChecksum(sum));
+
+  sw->sendNetworkControlPacketAsync(std::move(pkt), std::nullopt);
 }
 
 /* unicast neighbor solicitation */
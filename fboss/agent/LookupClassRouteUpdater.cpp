@@ -37,22 +37,100 @@ namespace facebook::fboss {
 
 // Helper methods
 
-void LookupClassRouteUpdater::reAddAllRoutes(const StateDelta& stateDelta) {
-  auto& newState = stateDelta.newState();
+template <typename AddrT>
+void LookupClassRouteUpdater::reAddRouteHelper(
+    const StateDelta& stateDelta,
+    RouterID rid,
+    const RoutePrefix<AddrT>& routePrefix) {
+  auto routeTable =
+      stateDelta.newState()->getRouteTables()->getRouteTableIf(rid);
+  if (!routeTable) {
+    return;
+  }
 
-  for (const auto& routeTable : *newState->getRouteTables()) {
-    auto rid = routeTable->getID();
+  auto route =
+      routeTable->template getRib<AddrT>()->routes()->getRouteIf(routePrefix);
+  if (route && !route->getClassID().has_value()) {
+    processRouteAdded(stateDelta, rid, route);
+  }
+}
 
-    for (const auto& route : *(routeTable->getRibV6()->routes())) {
-      if (!route->getClassID().has_value()) {
-        processRouteAdded(stateDelta, rid, route);
+void LookupClassRouteUpdater::reAddRoutesForSubnet(
+    const StateDelta& stateDelta,
+    const folly::CIDRNetwork& subnet) {
+  if (!nextHop2PrefixesIndexed_) {
+    buildNextHop2PrefixesIndex(stateDelta.newState());
+  }
+
+  /*
+   * Only routes with a nextHop in the subnet may become eligible for caching
+   * in nextHopAndVlan2Prefixes_, find them through nextHop2Prefixes_ instead
+   * of walking every route.
+   */
+  auto& [ipAddress, mask] = subnet;
+  std::set<RidAndCidr> toBeReAddedPrefixes;
+  for (const auto& [nextHop, prefixes] : nextHop2Prefixes_) {
+    if (nextHop.inSubnet(ipAddress, mask)) {
+      toBeReAddedPrefixes.insert(prefixes.begin(), prefixes.end());
+    }
+  }
+
+  for (const auto& [rid, cidr] : toBeReAddedPrefixes) {
+    auto& [prefixAddress, prefixMask] = cidr;
+    if (prefixAddress.isV6()) {
+      RoutePrefix<folly::IPAddressV6> routePrefixV6{
+          prefixAddress.asV6(), prefixMask};
+      reAddRouteHelper(stateDelta, rid, routePrefixV6);
+    } else {
+      RoutePrefix<folly::IPAddressV4> routePrefixV4{
+          prefixAddress.asV4(), prefixMask};
+      reAddRouteHelper(stateDelta, rid, routePrefixV4);
+    }
+  }
+}
+
+template <typename RouteT>
+void LookupClassRouteUpdater::updateNextHop2PrefixesIndex(
+    RouterID rid,
+    const std::shared_ptr<RouteT>& route,
+    bool add) {
+  if (!nextHop2PrefixesIndexed_) {
+    return;
+  }
+
+  auto ridAndCidr = std::make_pair(
+      rid, folly::CIDRNetwork{route->prefix().network, route->prefix().mask});
+  for (const auto& nextHop : route->getForwardInfo().getNextHopSet()) {
+    if (add) {
+      nextHop2Prefixes_[nextHop.addr()].insert(ridAndCidr);
+      continue;
+    }
+    auto it = nextHop2Prefixes_.find(nextHop.addr());
+    if (it != nextHop2Prefixes_.end()) {
+      it->second.erase(ridAndCidr);
+      if (it->second.empty()) {
+        nextHop2Prefixes_.erase(it);
       }
     }
+  }
+}
+
+void LookupClassRouteUpdater::buildNextHop2PrefixesIndex(
+    const std::shared_ptr<SwitchState>& switchState) {
+  nextHop2PrefixesIndexed_ = true;
 
+  auto addRoute = [this](RouterID rid, const auto& route) {
+    if (route->isResolved() && !route->isToCPU()) {
+      updateNextHop2PrefixesIndex(rid, route, true /* add */);
+    }
+  };
+  for (const auto& routeTable : *switchState->getRouteTables()) {
+    auto rid = routeTable->getID();
+    for (const auto& route : *(routeTable->getRibV6()->routes())) {
+      addRoute(rid, route);
+    }
     for (const auto& route : *(routeTable->getRibV4()->routes())) {
-      if (!route->getClassID().has_value()) {
-        processRouteAdded(stateDelta, rid, route);
-      }
+      addRoute(rid, route);
     }
   }
 }
@@ -147,7 +225,7 @@ bool LookupClassRouteUpdater::belongsToSubnetInCache(
 void LookupClassRouteUpdater::updateSubnetsCache(
     const StateDelta& stateDelta,
     std::shared_ptr<Port> port,
-    bool reAddAllRoutesEnabled) {
+    bool reAddRoutesEnabled) {
   auto& newState = stateDelta.newState();
 
   for (const auto& [vlanID, vlanInfo] : port->getVlans()) {
@@ -162,17 +240,18 @@ void LookupClassRouteUpdater::updateSubnetsCache(
         newState->getInterfaces()->getInterfaceIf(vlan->getInterfaceID());
     if (interface) {
       for (auto address : interface->getAddresses()) {
-        subnetsCache.insert(address);
+        auto inserted = subnetsCache.insert(address).second;
 
-        if (reAddAllRoutesEnabled) {
+        if (inserted && reAddRoutesEnabled) {
           /*
            * When a new subnet is added to the cache, the nextHops of existing
            * routes may become eligible for caching in
            * nextHopAndVlan2Prefixes_. Furthermore, such a nextHop may have
            * classID associated with it, and in that case, the corresponding
-           * route could inherit that classID. Thus, re-add all the routes.
+           * route could inherit that classID. Thus, re-add the routes with a
+           * nextHop in the new subnet.
            */
-          reAddAllRoutes(stateDelta);
+          reAddRoutesForSubnet(stateDelta, address);
         }
       }
     }
@@ -184,7 +263,7 @@ void LookupClassRouteUpdater::updateSubnetsCache(
 void LookupClassRouteUpdater::processPortAdded(
     const StateDelta& stateDelta,
     const std::shared_ptr<Port>& addedPort,
-    bool reAddAllRoutesEnabled) {
+    bool reAddRoutesEnabled) {
   CHECK(addedPort);
 
   if (addedPort->getLookupClassesToDistributeTrafficOn().size() == 0) {
@@ -195,7 +274,7 @@ void LookupClassRouteUpdater::processPortAdded(
     return;
   }
 
-  updateSubnetsCache(stateDelta, addedPort, reAddAllRoutesEnabled);
+  updateSubnetsCache(stateDelta, addedPort, reAddRoutesEnabled);
 }
 
 void LookupClassRouteUpdater::processPortRemovedForVlan(
@@ -256,7 +335,7 @@ void LookupClassRouteUpdater::processPortChanged(
   if (oldPort->getLookupClassesToDistributeTrafficOn().size() == 0 &&
       newPort->getLookupClassesToDistributeTrafficOn().size() != 0) {
     // enable queue-per-host for this port
-    processPortAdded(stateDelta, newPort, true /* re-all all routes */);
+    processPortAdded(stateDelta, newPort, true /* re-add routes */);
   } else if (
       oldPort->getLookupClassesToDistributeTrafficOn().size() != 0 &&
       newPort->getLookupClassesToDistributeTrafficOn().size() == 0) {
@@ -268,7 +347,7 @@ void LookupClassRouteUpdater::processPortChanged(
     // queue-per-host remains enabled, but port's VLAN membership changed, readd
     if (oldPort->getVlans() != newPort->getVlans()) {
       processPortRemoved(stateDelta, oldPort);
-      processPortAdded(stateDelta, newPort, true /* re-all all routes */);
+      processPortAdded(stateDelta, newPort, true /* re-add routes */);
     }
   }
 }
@@ -280,9 +359,8 @@ void LookupClassRouteUpdater::processPortUpdates(const StateDelta& stateDelta) {
 
     if (!oldPort && newPort) {
       // processRouteUpdates is invoked after processPortAdd,
-      // thus, we don't need to re-add all the routes.
-      processPortAdded(
-          stateDelta, newPort, false /* don't re-add all routes */);
+      // thus, we don't need to re-add the routes.
+      processPortAdded(stateDelta, newPort, false /* don't re-add routes */);
     } else if (oldPort && !newPort) {
       processPortRemoved(stateDelta, oldPort);
     } else {
@@ -309,11 +387,9 @@ void LookupClassRouteUpdater::processInterfaceAdded(
   for (auto& [portID, portInfo] : vlan->getPorts()) {
     std::ignore = portInfo;
     auto port = switchState->getPorts()->getPortIf(portID);
-    // routes are re-added once outside the for loop
-    processPortAdded(stateDelta, port, false /* don't re-add all routes */);
+    // routes are re-added only for subnets newly added to the cache
+    processPortAdded(stateDelta, port, true /* re-add routes */);
   }
-
-  reAddAllRoutes(stateDelta);
 }
 
 void LookupClassRouteUpdater::processInterfaceRemoved(
@@ -645,6 +721,8 @@ void LookupClassRouteUpdater::processRouteAdded(
     return;
   }
 
+  updateNextHop2PrefixesIndex(rid, addedRoute, true /* add */);
+
   auto ridAndCidr = std::make_pair(
       rid,
       folly::CIDRNetwork{addedRoute->prefix().network,
@@ -677,6 +755,7 @@ void LookupClassRouteUpdater::processRouteRemoved(
   // classID here. Furthermore, the route is already removed, so we don't need
   // to schedule a state update either. Just remove the route from local data
   // structures.
+  updateNextHop2PrefixesIndex(rid, removedRoute, false /* remove */);
 
   auto ridAndCidr = std::make_pair(
       rid,
@@ -816,8 +895,22 @@ void LookupClassRouteUpdater::updateClassIDForRouteHelper(
 
 void LookupClassRouteUpdater::updateClassIDsForRoutes(
     const std::vector<RouteAndClassID>& routesAndClassIDs) {
+  pendingRoutesAndClassIDs_.insert(
+      pendingRoutesAndClassIDs_.end(),
+      routesAndClassIDs.begin(),
+      routesAndClassIDs.end());
+}
+
+void LookupClassRouteUpdater::schedulePendingClassIDUpdates() {
+  if (pendingRoutesAndClassIDs_.empty()) {
+    return;
+  }
+
+  // Updates are applied in order, so the last classID computed for a route
+  // wins
   auto updateClassIDsForRoutesFn =
-      [this, routesAndClassIDs](const std::shared_ptr<SwitchState>& state)
+      [this, routesAndClassIDs = std::move(pendingRoutesAndClassIDs_)](
+          const std::shared_ptr<SwitchState>& state)
       -> std::shared_ptr<SwitchState> {
     auto newState{state};
 
@@ -840,6 +933,7 @@ void LookupClassRouteUpdater::updateClassIDsForRoutes(
     return newState;
   };
 
+  pendingRoutesAndClassIDs_.clear();
   sw_->updateState(
       "Update classIDs for routes", std::move(updateClassIDsForRoutesFn));
 }
@@ -913,6 +1007,7 @@ void LookupClassRouteUpdater::stateUpdated(const StateDelta& stateDelta) {
    * Skip the processing on other setups.
    */
   if (vlan2SubnetsCache_.empty()) {
+    schedulePendingClassIDUpdates();
     return;
   }
 
@@ -921,6 +1016,13 @@ void LookupClassRouteUpdater::stateUpdated(const StateDelta& stateDelta) {
 
   processRouteUpdates<folly::IPAddressV6>(stateDelta);
   processRouteUpdates<folly::IPAddressV4>(stateDelta);
+
+  /*
+   * Route classID changes computed while processing this delta, e.g. for every
+   * route using a nextHop that just got resolved, go out as a single state
+   * update.
+   */
+  schedulePendingClassIDUpdates();
 }
 
 } // namespace facebook::fboss
@@ -27,7 +27,22 @@ class LookupClassRouteUpdater : public AutoRegisterStateObserver {
 
  private:
   // Helper methods
-  void reAddAllRoutes(const StateDelta& stateDelta);
+  template <typename AddrT>
+  void reAddRouteHelper(
+      const StateDelta& stateDelta,
+      RouterID rid,
+      const RoutePrefix<AddrT>& routePrefix);
+  void reAddRoutesForSubnet(
+      const StateDelta& stateDelta,
+      const folly::CIDRNetwork& subnet);
+
+  template <typename RouteT>
+  void updateNextHop2PrefixesIndex(
+      RouterID rid,
+      const std::shared_ptr<RouteT>& route,
+      bool add);
+  void buildNextHop2PrefixesIndex(
+      const std::shared_ptr<SwitchState>& switchState);
 
   bool vlanHasOtherPortsWithClassIDs(
       const std::shared_ptr<SwitchState>& switchState,
@@ -47,7 +62,7 @@ class LookupClassRouteUpdater : public AutoRegisterStateObserver {
   void updateSubnetsCache(
       const StateDelta& stateDelta,
       std::shared_ptr<Port> port,
-      bool reAddAllRoutesEnabled);
+      bool reAddRoutesEnabled);
 
   std::optional<cfg::AclLookupClass> getClassIDForNeighbor(
       const std::shared_ptr<SwitchState>& switchState,
@@ -58,7 +73,7 @@ class LookupClassRouteUpdater : public AutoRegisterStateObserver {
   void processPortAdded(
       const StateDelta& stateDelta,
       const std::shared_ptr<Port>& addedPort,
-      bool reAddAllRoutesEnabled);
+      bool reAddRoutesEnabled);
   void processPortRemovedForVlan(
       const StateDelta& stateDelta,
       const std::shared_ptr<Port>& removedPort,
@@ -154,6 +169,7 @@ class LookupClassRouteUpdater : public AutoRegisterStateObserver {
       std::optional<cfg::AclLookupClass> classID);
   void updateClassIDsForRoutes(
       const std::vector<RouteAndClassID>& routesAndClassIDs);
+  void schedulePendingClassIDUpdates();
 
   template <typename AddrT>
   void clearClassIDsForRoutes() const;
@@ -256,6 +272,26 @@ class LookupClassRouteUpdater : public AutoRegisterStateObserver {
    */
   std::set<RidAndCidr> allPrefixesWithClassID_;
 
+  /*
+   * NextHop IP to prefixes map, for every resolved route, irrespective of
+   * vlan2SubnetsCache_.
+   *
+   * When a subnet is added to vlan2SubnetsCache_, only the routes with a
+   * nextHop in that subnet need to be re-added. This index lets us find them
+   * without walking every route in the switchState. It is built on the first
+   * subnet addition that needs it, and maintained on route add/remove from
+   * then on, so setups that never add subnets after routes pay nothing.
+   */
+  folly::F14FastMap<folly::IPAddress, std::set<RidAndCidr>> nextHop2Prefixes_;
+  bool nextHop2PrefixesIndexed_{false};
+
+  /*
+   * Route classID updates computed while processing a StateDelta. These are
+   * applied together with a single updateState once the delta is processed,
+   * rather than scheduling one state update per neighbor or route change.
+   */
+  std::vector<RouteAndClassID> pendingRoutesAndClassIDs_;
+
   SwSwitch* sw_;
 
   bool inited_{false};
@@ -64,7 +64,7 @@ class NeighborCacheImpl {
         vlanID_(vlanID),
         vlanName_(vlanName),
         intfID_(intfID),
-        evb_(sw->getNeighborCacheEvb()) {}
+        evb_(sw->getNeighborCacheEvb(vlanID)) {}
 
   // Methods useful for subclasses
   void setPendingEntry(AddressType ip, bool force = false);
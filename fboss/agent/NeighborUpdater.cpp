@@ -43,20 +43,26 @@ namespace facebook::fboss {
 using facebook::fboss::DeltaFunctions::forEachChanged;
 
 NeighborUpdater::NeighborUpdater(SwSwitch* sw)
-    : AutoRegisterStateObserver(sw, "NeighborUpdater"),
-      impl_(std::make_shared<NeighborUpdaterImpl>()),
-      sw_(sw) {}
+    : AutoRegisterStateObserver(sw, "NeighborUpdater"), sw_(sw) {
+  for (size_t shard = 0; shard < sw_->getNumNeighborCacheShards(); ++shard) {
+    shards_.push_back(
+        {std::make_shared<NeighborUpdaterImpl>(),
+         sw_->getNeighborCacheEvbForShard(shard)});
+  }
+}
 
 NeighborUpdater::~NeighborUpdater() {
-  // we make sure to destroy the NeighborUpdaterImpl on the neighbor
+  // we make sure to destroy each NeighborUpdaterImpl on its neighbor
   // cache thread to avoid racing between background entry processing
   // and destruction.
-  sw_->getNeighborCacheEvb()->runImmediatelyOrRunInEventBaseThreadAndWait(
-      [this]() mutable { return impl_.reset(); });
+  for (auto& shard : shards_) {
+    shard.evb->runImmediatelyOrRunInEventBaseThreadAndWait(
+        [&shard]() mutable { return shard.impl.reset(); });
+  }
 }
 
 void NeighborUpdater::waitForPendingUpdates() {
-  folly::via(sw_->getNeighborCacheEvb(), [impl = this->impl_]() {}).get();
+  runOnAllShards([](NeighborUpdaterImpl* /*impl*/) {}).get();
 }
 
 auto NeighborUpdater::createCaches(const SwitchState* state, const Vlan* vlan)
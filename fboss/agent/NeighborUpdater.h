@@ -10,10 +10,14 @@
 #pragma once
 
 #include <boost/container/flat_map.hpp>
+#include <folly/futures/Future.h>
 #include <list>
 #include <mutex>
+#include <numeric>
 #include <string>
+#include <type_traits>
 #include <utility>
+#include <vector>
 #include "fboss/agent/ArpCache.h"
 #include "fboss/agent/NdpCache.h"
 #include "fboss/agent/NeighborUpdaterImpl.h"
@@ -33,6 +37,14 @@ class StateDelta;
  * work on the neighbor thread using the implementation methods present in
  * `NeighborUpdaterImpl`.
  *
+ * Neighbor caches are sharded by VLAN across one or more neighbor threads
+ * (see SwSwitch::getNeighborCacheShard), each shard with its own
+ * `NeighborUpdaterImpl`. Work for a VLAN is scheduled on the thread of the
+ * shard owning it, while work that is not specific to one VLAN is scheduled
+ * on every shard and the results combined. The SwitchState updates resulting
+ * from all shards are queued on the update thread and coalesced there as
+ * before.
+ *
  * Most methods in this class return a `folly::Future<>` which the caller can
  * use to wait for completion of the underlying execution.
  *
@@ -46,7 +58,12 @@ class NeighborUpdater : public AutoRegisterStateObserver {
  private:
   using NeighborCaches = NeighborUpdaterImpl::NeighborCaches;
 
-  std::shared_ptr<NeighborUpdaterImpl> impl_;
+  struct Shard {
+    std::shared_ptr<NeighborUpdaterImpl> impl;
+    folly::EventBase* evb;
+  };
+
+  std::vector<Shard> shards_;
   SwSwitch* sw_{nullptr};
 
  public:
@@ -58,28 +75,44 @@ class NeighborUpdater : public AutoRegisterStateObserver {
   void stateUpdated(const StateDelta& delta) override;
 
   // Zero-cost forwarders. See comment in NeighborUpdater.def.
+  //
+  // NEIGHBOR_UPDATER_METHOD methods take the VLAN as their first argument and
+  // run on the shard owning that VLAN, or on every shard for VlanID(0). The
+  // rest are not specific to a VLAN and run on every shard.
 #define ARG_TEMPLATE_PARAMETER(TYPE, NAME) typename T_##NAME
 #define ARG_RVALUE_REF_TYPE(TYPE, NAME) T_##NAME&& NAME
 #define ARG_FORWARDER(TYPE, NAME) std::forward<T_##NAME>(NAME)
 #define ARG_NAME_ONLY(TYPE, NAME) NAME
-#define NEIGHBOR_UPDATER_METHOD(VISIBILITY, NAME, RETURN_TYPE, ...)           \
-  VISIBILITY:                                                                 \
-  template <ARG_LIST(ARG_TEMPLATE_PARAMETER, ##__VA_ARGS__)>                  \
-  folly::Future<folly::lift_unit_t<RETURN_TYPE>> NAME(                        \
-      ARG_LIST(ARG_RVALUE_REF_TYPE, ##__VA_ARGS__)) {                         \
-    return folly::via(sw_->getNeighborCacheEvb(), [=, impl = this->impl_]() { \
-      return impl->NAME(ARG_LIST(ARG_NAME_ONLY, ##__VA_ARGS__));              \
-    });                                                                       \
+#define ARG_FIRST_NAME(TYPE, NAME, ...) NAME
+#define NEIGHBOR_UPDATER_METHOD(VISIBILITY, NAME, RETURN_TYPE, ...)      \
+  VISIBILITY:                                                            \
+  template <ARG_LIST(ARG_TEMPLATE_PARAMETER, ##__VA_ARGS__)>             \
+  folly::Future<folly::lift_unit_t<RETURN_TYPE>> NAME(                   \
+      ARG_LIST(ARG_RVALUE_REF_TYPE, ##__VA_ARGS__)) {                    \
+    return runForVlan(                                                   \
+        ARG_FIRST_NAME(__VA_ARGS__, _), [=](NeighborUpdaterImpl* impl) { \
+          return impl->NAME(ARG_LIST(ARG_NAME_ONLY, ##__VA_ARGS__));     \
+        });                                                              \
   }
-#define NEIGHBOR_UPDATER_METHOD_NO_ARGS(VISIBILITY, NAME, RETURN_TYPE)     \
-  VISIBILITY:                                                              \
-  folly::Future<folly::lift_unit_t<RETURN_TYPE>> NAME() {                  \
-    return folly::via(sw_->getNeighborCacheEvb(), [impl = this->impl_]() { \
-      return impl->NAME();                                                 \
-    });                                                                    \
+#define NEIGHBOR_UPDATER_ALL_SHARDS_METHOD(VISIBILITY, NAME, RETURN_TYPE, ...) \
+  VISIBILITY:                                                                  \
+  template <ARG_LIST(ARG_TEMPLATE_PARAMETER, ##__VA_ARGS__)>                   \
+  folly::Future<folly::lift_unit_t<RETURN_TYPE>> NAME(                         \
+      ARG_LIST(ARG_RVALUE_REF_TYPE, ##__VA_ARGS__)) {                          \
+    return runOnAllShards([=](NeighborUpdaterImpl* impl) {                     \
+      return impl->NAME(ARG_LIST(ARG_NAME_ONLY, ##__VA_ARGS__));               \
+    });                                                                        \
+  }
+#define NEIGHBOR_UPDATER_METHOD_NO_ARGS(VISIBILITY, NAME, RETURN_TYPE) \
+  VISIBILITY:                                                          \
+  folly::Future<folly::lift_unit_t<RETURN_TYPE>> NAME() {              \
+    return runOnAllShards(                                             \
+        [](NeighborUpdaterImpl* impl) { return impl->NAME(); });       \
   }
 #include "fboss/agent/NeighborUpdater.def"
 #undef NEIGHBOR_UPDATER_METHOD
+#undef NEIGHBOR_UPDATER_ALL_SHARDS_METHOD
+#undef ARG_FIRST_NAME
 
  public:
   template <typename AddrT>
@@ -106,6 +139,54 @@ class NeighborUpdater : public AutoRegisterStateObserver {
       const std::shared_ptr<AggregatePort>& newAggPort);
   void sendNeighborUpdates(const VlanDelta& delta);
 
+  template <typename Fn>
+  auto runOnShard(size_t shard, Fn fn) {
+    return folly::via(
+        shards_[shard].evb,
+        [fn = std::move(fn), impl = shards_[shard].impl]() {
+          return fn(impl.get());
+        });
+  }
+
+  template <typename Fn>
+  auto runOnAllShards(Fn fn) {
+    using ResultT =
+        folly::lift_unit_t<std::invoke_result_t<Fn, NeighborUpdaterImpl*>>;
+    std::vector<folly::Future<ResultT>> futures;
+    for (size_t shard = 0; shard < shards_.size(); ++shard) {
+      futures.push_back(runOnShard(shard, fn));
+    }
+    return folly::collect(std::move(futures))
+        .toUnsafeFuture()
+        .thenValue([](std::vector<ResultT> results) {
+          return combineShardResults(std::move(results));
+        });
+  }
+
+  template <typename Fn>
+  auto runForVlan(VlanID vlan, Fn fn) {
+    if (vlan == VlanID(0) && shards_.size() > 1) {
+      return runOnAllShards(std::move(fn));
+    }
+    return runOnShard(sw_->getNeighborCacheShard(vlan), std::move(fn));
+  }
+
+  static folly::Unit combineShardResults(std::vector<folly::Unit> /*results*/) {
+    return folly::unit;
+  }
+  static uint32_t combineShardResults(std::vector<uint32_t> results) {
+    return std::accumulate(results.begin(), results.end(), uint32_t{0});
+  }
+  template <typename EntryThrift>
+  static std::list<EntryThrift> combineShardResults(
+      std::vector<std::list<EntryThrift>> results) {
+    std::list<EntryThrift> combined;
+    for (auto& result : results) {
+      combined.splice(combined.end(), result);
+    }
+    return combined;
+  }
+
   // Forbidden copy constructor and assignment operator
   NeighborUpdater(NeighborUpdater const&) = delete;
   NeighborUpdater& operator=(NeighborUpdater const&) = delete;
@@ -6,70 +6,226 @@
 #include "fboss/agent/NeighborUpdater.h"
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/Vlan.h"
 #include "folly/Random.h"
 
+#include <fb303/ServiceData.h>
+#include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
+
+#include <algorithm>
 #include <chrono>
+#include <map>
+
+DEFINE_int32(
+    resolved_nexthop_probe_rate,
+    100,
+    "Maximum number of resolved next hop probes sent per second");
+DEFINE_int32(
+    resolved_nexthop_probe_burst,
+    20,
+    "Maximum number of resolved next hop probes sent back to back");
 
 namespace {
 const std::chrono::milliseconds kInitialBackoff{1000};
 const std::chrono::milliseconds kMaximumBackoff{10000};
 auto constexpr kJitterPct = 10;
+
+auto constexpr kProbesSent = "resolved_nexthop_probe.sent";
+auto constexpr kProbesSkipped = "resolved_nexthop_probe.skipped";
+auto constexpr kProbesDeferred = "resolved_nexthop_probe.deferred";
+
+double probeRate() {
+  return std::max(FLAGS_resolved_nexthop_probe_rate, 1);
+}
+
+double probeBurst() {
+  return std::max(FLAGS_resolved_nexthop_probe_burst, 1);
+}
 } // namespace
 
 namespace facebook::fboss {
 
 ResolvedNextHopProbe::ResolvedNextHopProbe(
-    SwSwitch* sw,
     folly::EventBase* evb,
-    ResolvedNextHop nexthop)
-    : folly::AsyncTimeout(evb),
-      sw_(sw),
-      evb_(evb),
+    ResolvedNextHop nexthop,
+    ResolvedNextHopProbePacer* pacer)
+    : evb_(evb),
       nexthop_(nexthop),
+      pacer_(pacer),
       backoff_(kInitialBackoff, kMaximumBackoff) {}
 
-void ResolvedNextHopProbe::timeoutExpired() noexcept {
-  auto ip = nexthop_.addr();
-  auto state = sw_->getState();
-  auto intf = state->getInterfaces()->getInterfaceIf(nexthop_.intfID().value());
-  if (!intf) {
-    // probe and state update runs in distinct threads. probe runs in background
-    // thread while state update in update thread.
-    // imagine that probe is invoked right after state is updated but before
-    // probe is either stopped or removed by probe scheduler.  in this state
-    // update has either deleted interface or vlan. in such a case, a probe may
-    // attempt to access interface or vlan which no longer exists. in such a
-    // case simply stop scheduling this probe.
-    XLOG(ERR) << "a spurios probe to " << nexthop_.addr() << " on interface "
-              << nexthop_.intfID().value() << " exists!";
-    stop();
-    return;
-  }
-  auto vlanId = intf->getVlanID();
-  auto vlan = state->getVlans()->getVlanIf(vlanId);
-  if (!vlan) {
-    XLOG(ERR) << "a spurios probe to " << nexthop_.addr() << " on vlan "
-              << vlanId << " exists!";
-    stop();
+void ResolvedNextHopProbe::_start() {
+  if (running_) {
     return;
   }
+  running_ = true;
+  pacer_->add(this, backoff_.getTimeRemainingUntilRetry());
+}
 
-  if (ip.isV4()) {
-    // send arp request
-    ArpHandler::sendArpRequest(sw_, vlan, ip.asV4());
-    sw_->getNeighborUpdater()->sentArpRequest(vlanId, ip.asV4());
-  } else {
-    // send ndp request
-    IPv6Handler::sendMulticastNeighborSolicitation(sw_, ip.asV6(), vlan);
-    sw_->getNeighborUpdater()->sentNeighborSolicitation(vlanId, ip.asV6());
+void ResolvedNextHopProbe::_stop() {
+  if (running_) {
+    pacer_->remove(this);
+    running_ = false;
   }
+  backoff_.reportSuccess();
+}
+
+std::chrono::milliseconds ResolvedNextHopProbe::probeSent() {
   // exponential back-off
   backoff_.reportError();
   // add jitter to reduce contention
   auto backoff = backoff_.getTimeRemainingUntilRetry();
-  auto timeout = backoff.count() +
-      (folly::Random::rand32() % (backoff.count() * kJitterPct / 100));
-  scheduleTimeout(timeout);
+  return std::chrono::milliseconds(
+      backoff.count() +
+      (folly::Random::rand32() % (backoff.count() * kJitterPct / 100)));
+}
+
+ResolvedNextHopProbePacer::ResolvedNextHopProbePacer(
+    SwSwitch* sw,
+    folly::EventBase* evb,
+    NowFn now)
+    : folly::AsyncTimeout(evb), sw_(sw), now_(std::move(now)) {}
+
+void ResolvedNextHopProbePacer::add(
+    ResolvedNextHopProbe* probe,
+    std::chrono::milliseconds delay) {
+  probe->dueTime_ = now_() + delay;
+  dueProbes_.emplace(probe->dueTime_, probe);
+  scheduleNext();
+}
+
+void ResolvedNextHopProbePacer::remove(ResolvedNextHopProbe* probe) {
+  dueProbes_.erase(std::make_pair(probe->dueTime_, probe));
+  scheduleNext();
+}
+
+void ResolvedNextHopProbePacer::scheduleNext() {
+  if (dueProbes_.empty()) {
+    cancelTimeout();
+    return;
+  }
+  auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(
+      dueProbes_.begin()->first - now_());
+  scheduleTimeout(std::max(delay, std::chrono::milliseconds(0)));
+}
+
+void ResolvedNextHopProbePacer::timeoutExpired() noexcept {
+  auto now = now_();
+  std::vector<ResolvedNextHopProbe*> dueProbes;
+  while (!dueProbes_.empty() && dueProbes_.begin()->first <= now) {
+    dueProbes.push_back(dueProbes_.begin()->second);
+    dueProbes_.erase(dueProbes_.begin());
+  }
+  sendProbes(std::move(dueProbes), now);
+  scheduleNext();
+}
+
+template <typename AddrT>
+bool ResolvedNextHopProbePacer::hasNeighborEntry(const AddrT& addr, Vlan* vlan)
+    const {
+  auto table = vlan->template getNeighborEntryTable<AddrT>();
+  return table->getEntryIf(addr) != nullptr;
+}
+
+void ResolvedNextHopProbePacer::sendProbes(
+    std::vector<ResolvedNextHopProbe*> probes,
+    Clock::time_point now) {
+  if (probes.empty()) {
+    return;
+  }
+
+  // Look interfaces and vlans up once for all the probes going out on them
+  auto state = sw_->getState();
+  std::map<InterfaceID, std::shared_ptr<Vlan>> intf2Vlan;
+  auto getVlan = [&](InterfaceID intfID) {
+    auto itr = intf2Vlan.find(intfID);
+    if (itr == intf2Vlan.end()) {
+      auto intf = state->getInterfaces()->getInterfaceIf(intfID);
+      auto vlan = intf ? state->getVlans()->getVlanIf(intf->getVlanID())
+                       : nullptr;
+      itr = intf2Vlan.emplace(intfID, std::move(vlan)).first;
+    }
+    return itr->second;
+  };
+
+  // Probes are handled in the order they were due in, and only the probes
+  // actually sent take a token
+  int64_t sent = 0;
+  int64_t skipped = 0;
+  std::vector<ResolvedNextHopProbe*> deferred;
+  for (auto probe : probes) {
+    auto intfID = probe->nexthop_.intfID().value();
+    auto vlan = getVlan(intfID);
+    if (!vlan) {
+      // probe and state update runs in distinct threads. probe runs in
+      // background thread while state update in update thread.
+      // imagine that probe is invoked right after state is updated but before
+      // probe is either stopped or removed by probe scheduler.  in this state
+      // update has either deleted interface or vlan. in such a case, a probe
+      // may attempt to access interface or vlan which no longer exists. in
+      // such a case simply stop scheduling this probe.
+      XLOG(ERR) << "a spurios probe to " << probe->nexthop_.addr()
+                << " on interface " << intfID << " exists!";
+      probe->running_ = false;
+      continue;
+    }
+
+    auto ip = probe->nexthop_.addr();
+    // Neighbor entry showed up since the probe was started, the probe
+    // scheduler will stop this probe once it processes that state update
+    auto hasEntry = ip.isV4() ? hasNeighborEntry(ip.asV4(), vlan.get())
+                              : hasNeighborEntry(ip.asV6(), vlan.get());
+    if (hasEntry) {
+      ++skipped;
+      probe->dueTime_ = now + kInitialBackoff;
+      dueProbes_.emplace(probe->dueTime_, probe);
+      continue;
+    }
+
+    if (!tokenBucket_.consume(
+            1,
+            probeRate(),
+            probeBurst(),
+            std::chrono::duration<double>(now.time_since_epoch()).count())) {
+      deferred.push_back(probe);
+      continue;
+    }
+
+    auto vlanId = vlan->getID();
+    if (ip.isV4()) {
+      // send arp request
+      ArpHandler::sendArpRequest(sw_, vlan, ip.asV4());
+      sw_->getNeighborUpdater()->sentArpRequest(vlanId, ip.asV4());
+    } else {
+      // send ndp request
+      IPv6Handler::sendMulticastNeighborSolicitation(sw_, ip.asV6(), vlan);
+      sw_->getNeighborUpdater()->sentNeighborSolicitation(vlanId, ip.asV6());
+    }
+    ++sent;
+    probe->dueTime_ = now_() + probe->probeSent();
+    dueProbes_.emplace(probe->dueTime_, probe);
+  }
+
+  // Out of tokens, push the rest of the probes back, one per token as the
+  // bucket refills, rather than having them all compete for the next token.
+  auto tokenInterval = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(1 / probeRate()));
+  for (size_t i = 0; i < deferred.size(); ++i) {
+    auto probe = deferred[i];
+    probe->dueTime_ = now + tokenInterval * (i + 1);
+    dueProbes_.emplace(probe->dueTime_, probe);
+  }
+
+  if (sent) {
+    fb303::fbData->addStatValue(kProbesSent, sent, fb303::SUM);
+  }
+  if (skipped) {
+    fb303::fbData->addStatValue(kProbesSkipped, skipped, fb303::SUM);
+  }
+  if (!deferred.empty()) {
+    fb303::fbData->addStatValue(kProbesDeferred, deferred.size(), fb303::SUM);
+  }
 }
 
 } // namespace facebook::fboss
@@ -5,21 +5,30 @@
 #include "fboss/agent/state/RouteNextHop.h"
 #include "fboss/lib/ExponentialBackoff.h"
 
+#include <folly/TokenBucket.h>
 #include <folly/io/async/AsyncTimeout.h>
 #include <folly/io/async/EventBase.h>
 
+#include <chrono>
+#include <functional>
+#include <set>
+#include <utility>
+#include <vector>
+
 namespace facebook::fboss {
 
 class SwSwitch;
+class Vlan;
+class ResolvedNextHopProbePacer;
 
-class ResolvedNextHopProbe : public folly::AsyncTimeout {
+class ResolvedNextHopProbe {
  public:
   ResolvedNextHopProbe(
-      SwSwitch* sw,
       folly::EventBase* evb,
-      ResolvedNextHop nexthop);
+      ResolvedNextHop nexthop,
+      ResolvedNextHopProbePacer* pacer);
 
-  ~ResolvedNextHopProbe() override {
+  ~ResolvedNextHopProbe() {
     stop();
   }
 
@@ -31,21 +40,68 @@ class ResolvedNextHopProbe : public folly::AsyncTimeout {
     evb_->runImmediatelyOrRunInEventBaseThreadAndWait([=]() { _stop(); });
   }
 
- private:
-  void _start() {
-    scheduleTimeout(backoff_.getTimeRemainingUntilRetry());
+  const ResolvedNextHop& getNextHop() const {
+    return nexthop_;
   }
 
-  void _stop() {
-    cancelTimeout();
-    backoff_.reportSuccess();
-  }
-  void timeoutExpired() noexcept override;
+ private:
+  friend class ResolvedNextHopProbePacer;
+
+  void _start();
+  void _stop();
+
+  // Delay until the next probe, once this one has been sent
+  std::chrono::milliseconds probeSent();
 
-  SwSwitch* sw_;
   folly::EventBase* evb_;
   ResolvedNextHop nexthop_;
+  ResolvedNextHopProbePacer* pacer_;
   ExponentialBackoff<std::chrono::milliseconds> backoff_;
+  // Only accessed from evb_
+  bool running_{false};
+  std::chrono::steady_clock::time_point dueTime_;
+};
+
+/*
+ * Sends the probes of all resolved next hops from a single timer, rather than
+ * one timer per probe, so that probes to thousands of next hops don't go out
+ * in bursts competing with real ARP/NDP traffic:
+ *  - a token bucket caps the rate of probes. Probes due while the bucket is
+ *    empty are deferred and spread evenly over the time needed to send them.
+ *  - interfaces and vlans are looked up once for the probes due together.
+ *  - probes to next hops which have since got a neighbor entry are skipped,
+ *    without taking a token.
+ *
+ * All methods must be called from the EventBase the probes run on.
+ */
+class ResolvedNextHopProbePacer : public folly::AsyncTimeout {
+ public:
+  using Clock = std::chrono::steady_clock;
+  // Source of the current time for due probes and the token bucket, tests
+  // pass their own to step time rather than wait for it
+  using NowFn = std::function<Clock::time_point()>;
+
+  ResolvedNextHopProbePacer(
+      SwSwitch* sw,
+      folly::EventBase* evb,
+      NowFn now = &Clock::now);
+
+  void add(ResolvedNextHopProbe* probe, std::chrono::milliseconds delay);
+  void remove(ResolvedNextHopProbe* probe);
+
+ private:
+  void timeoutExpired() noexcept override;
+  void scheduleNext();
+  void sendProbes(
+      std::vector<ResolvedNextHopProbe*> probes,
+      Clock::time_point now);
+  template <typename AddrT>
+  bool hasNeighborEntry(const AddrT& addr, Vlan* vlan) const;
+
+  SwSwitch* sw_;
+  NowFn now_;
+  folly::DynamicTokenBucket tokenBucket_;
+  std::set<std::pair<Clock::time_point, ResolvedNextHopProbe*>> dueProbes_;
 };
 
 } // namespace facebook::fboss
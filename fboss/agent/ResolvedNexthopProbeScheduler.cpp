@@ -10,7 +10,10 @@
 namespace facebook::fboss {
 
 ResolvedNexthopProbeScheduler::ResolvedNexthopProbeScheduler(SwSwitch* sw)
-    : sw_(sw) {}
+    : sw_(sw),
+      pacer_(std::make_unique<ResolvedNextHopProbePacer>(
+          sw,
+          sw->getBackgroundEvb())) {}
 
 ResolvedNexthopProbeScheduler::~ResolvedNexthopProbeScheduler() {
   for (auto entry : resolvedNextHop2Probes_) {
@@ -29,7 +32,7 @@ void ResolvedNexthopProbeScheduler::processChangedResolvedNexthops(
       resolvedNextHop2Probes_.emplace(
           nexthop,
           std::make_shared<ResolvedNextHopProbe>(
-              sw_, sw_->getBackgroundEvb(), nexthop));
+              sw_->getBackgroundEvb(), nexthop, pacer_.get()));
       continue;
     }
     itr->second++;
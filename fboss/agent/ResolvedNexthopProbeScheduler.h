@@ -11,6 +11,7 @@ namespace facebook::fboss {
 
 class SwSwitch;
 class ResolvedNextHopProbe;
+class ResolvedNextHopProbePacer;
 
 class ResolvedNexthopProbeScheduler {
   /*
@@ -47,6 +48,8 @@ class ResolvedNexthopProbeScheduler {
   }
 
   SwSwitch* sw_{nullptr};
+  // paces probes of all resolved next hops, must outlive the probes
+  std::unique_ptr<ResolvedNextHopProbePacer> pacer_;
   boost::container::
       flat_map<ResolvedNextHop, std::shared_ptr<ResolvedNextHopProbe>>
           resolvedNextHop2Probes_;
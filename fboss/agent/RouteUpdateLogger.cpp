@@ -16,38 +16,36 @@ namespace facebook::fboss {
 namespace {
 template <typename AddrT>
 void handleChangedRoute(
-    const RouteUpdateLoggingPrefixTracker& tracker,
+    const RouteUpdateLoggingPrefixTracker::Snapshot& trackedPrefixes,
     const std::unique_ptr<RouteLogger<AddrT>>& logger,
     const std::shared_ptr<Route<AddrT>>& oldRoute,
     const std::shared_ptr<Route<AddrT>>& newRoute) {
-  std::vector<std::string> matchedIdentifiers;
-  auto prefix = oldRoute->prefix();
-  if (tracker.tracking(prefix, matchedIdentifiers)) {
-    logger->logChangedRoute(oldRoute, newRoute, matchedIdentifiers);
+  auto matched = trackedPrefixes.match(oldRoute->prefix());
+  if (matched.any()) {
+    logger->logChangedRoute(
+        oldRoute, newRoute, trackedPrefixes.getIdentifiers(matched));
   }
 }
 
 template <typename AddrT>
 void handleRemovedRoute(
-    const RouteUpdateLoggingPrefixTracker& tracker,
+    const RouteUpdateLoggingPrefixTracker::Snapshot& trackedPrefixes,
     const std::unique_ptr<RouteLogger<AddrT>>& logger,
     const std::shared_ptr<Route<AddrT>>& oldRoute) {
-  std::vector<std::string> matchedIdentifiers;
-  auto prefix = oldRoute->prefix();
-  if (tracker.tracking(prefix, matchedIdentifiers)) {
-    logger->logRemovedRoute(oldRoute, matchedIdentifiers);
+  auto matched = trackedPrefixes.match(oldRoute->prefix());
+  if (matched.any()) {
+    logger->logRemovedRoute(oldRoute, trackedPrefixes.getIdentifiers(matched));
   }
 }
 
 template <typename AddrT>
 void handleAddedRoute(
-    const RouteUpdateLoggingPrefixTracker& tracker,
+    const RouteUpdateLoggingPrefixTracker::Snapshot& trackedPrefixes,
     const std::unique_ptr<RouteLogger<AddrT>>& logger,
     const std::shared_ptr<Route<AddrT>>& newRoute) {
-  std::vector<std::string> matchedIdentifiers;
-  auto prefix = newRoute->prefix();
-  if (tracker.tracking(prefix, matchedIdentifiers)) {
-    logger->logAddedRoute(newRoute, matchedIdentifiers);
+  auto matched = trackedPrefixes.match(newRoute->prefix());
+  if (matched.any()) {
+    logger->logAddedRoute(newRoute, trackedPrefixes.getIdentifiers(matched));
   }
 }
 } // anonymous namespace
@@ -67,26 +65,41 @@ RouteUpdateLogger::RouteUpdateLogger(
     : AutoRegisterStateObserver(sw, "RouteUpdateLogger"),
       routeLoggerV4_(std::move(routeLoggerV4)),
       routeLoggerV6_(std::move(routeLoggerV6)),
-      mplsRouteLogger_(std::move(mplsRouteLogger)) {}
+      mplsRouteLogger_(std::move(mplsRouteLogger)) {
+  routeLoggerV4_->setLogEventBase(sw->getBackgroundEvb());
+  routeLoggerV6_->setLogEventBase(sw->getBackgroundEvb());
+  mplsRouteLogger_->setLogEventBase(sw->getBackgroundEvb());
+}
 
 void RouteUpdateLogger::stateUpdated(const StateDelta& delta) {
-  for (const auto& rtDelta : delta.getRouteTablesDelta()) {
-    DeltaFunctions::forEachChanged(
-        rtDelta.getRoutesV4Delta(),
-        &handleChangedRoute<folly::IPAddressV4>,
-        &handleAddedRoute<folly::IPAddressV4>,
-        &handleRemovedRoute<folly::IPAddressV4>,
-        prefixTracker_,
-        routeLoggerV4_);
-    DeltaFunctions::forEachChanged(
-        rtDelta.getRoutesV6Delta(),
-        &handleChangedRoute<folly::IPAddressV6>,
-        &handleAddedRoute<folly::IPAddressV6>,
-        &handleRemovedRoute<folly::IPAddressV6>,
-        prefixTracker_,
-        routeLoggerV6_);
+  const auto& summary = delta.getSummary();
+  auto trackedPrefixes = prefixTracker_.getSnapshot();
+  // Skip walking the route deltas when no prefix is tracked
+  if (summary.changed(StateDeltaSummary::ROUTE_TABLES) &&
+      !trackedPrefixes->empty()) {
+    for (const auto& rtDelta : delta.getRouteTablesDelta()) {
+      DeltaFunctions::forEachChanged(
+          rtDelta.getRoutesV4Delta(),
+          &handleChangedRoute<folly::IPAddressV4>,
+          &handleAddedRoute<folly::IPAddressV4>,
+          &handleRemovedRoute<folly::IPAddressV4>,
+          *trackedPrefixes,
+          routeLoggerV4_);
+      DeltaFunctions::forEachChanged(
+          rtDelta.getRoutesV6Delta(),
+          &handleChangedRoute<folly::IPAddressV6>,
+          &handleAddedRoute<folly::IPAddressV6>,
+          &handleRemovedRoute<folly::IPAddressV6>,
+          *trackedPrefixes,
+          routeLoggerV6_);
+    }
+  }
+  if (summary.changed(StateDeltaSummary::LABEL_FIB)) {
+    logLabelUpdates(delta);
   }
+}
 
+void RouteUpdateLogger::logLabelUpdates(const StateDelta& delta) {
   auto* mplsRouteLogger = mplsRouteLogger_.get();
   CHECK(mplsRouteLogger);
   const auto labelTracker = labelTracker_.rlock();
@@ -155,15 +168,12 @@ template <typename AddrT>
 void RouteLogger<AddrT>::logAddedRoute(
     const std::shared_ptr<Route<AddrT>>& newRoute,
     const std::vector<std::string>& identifiers) {
-  for (const auto& identifier : identifiers) {
-    auto newRouteStr = newRoute->str();
-    updateLogHandler_->log(
-        UpdateLogHandler::UPDATE_TYPE::ADD,
-        identifier,
-        "route",
-        nullptr,
-        &newRouteStr);
-  }
+  dispatcher_.log(
+      UpdateLogHandler::UPDATE_TYPE::ADD,
+      identifiers,
+      "route",
+      std::shared_ptr<Route<AddrT>>(),
+      newRoute);
 }
 
 template <typename AddrT>
@@ -171,31 +181,24 @@ void RouteLogger<AddrT>::logChangedRoute(
     const std::shared_ptr<Route<AddrT>>& oldRoute,
     const std::shared_ptr<Route<AddrT>>& newRoute,
     const std::vector<std::string>& identifiers) {
-  for (const auto& identifier : identifiers) {
-    auto oldRouteStr = oldRoute->str();
-    auto newRouteStr = newRoute->str();
-    updateLogHandler_->log(
-        UpdateLogHandler::UPDATE_TYPE::CHANGE,
-        identifier,
-        "route",
-        &oldRouteStr,
-        &newRouteStr);
-  }
+  dispatcher_.log(
+      UpdateLogHandler::UPDATE_TYPE::CHANGE,
+      identifiers,
+      "route",
+      oldRoute,
+      newRoute);
 }
 
 template <typename AddrT>
 void RouteLogger<AddrT>::logRemovedRoute(
     const std::shared_ptr<Route<AddrT>>& oldRoute,
     const std::vector<std::string>& identifiers) {
-  for (const auto& identifier : identifiers) {
-    auto oldRouteStr = oldRoute->str();
-    updateLogHandler_->log(
-        UpdateLogHandler::UPDATE_TYPE::DELETE,
-        identifier,
-        "route",
-        &oldRouteStr,
-        nullptr);
-  }
+  dispatcher_.log(
+      UpdateLogHandler::UPDATE_TYPE::DELETE,
+      identifiers,
+      "route",
+      oldRoute,
+      std::shared_ptr<Route<AddrT>>());
 }
 
 void GlogUpdateLogHandler::log(
@@ -233,45 +236,35 @@ std::string GlogUpdateLogHandler::entityUpdateMessage(
 void MplsRouteLogger::logAddedRoute(
     const std::shared_ptr<LabelForwardingEntry>& newRoute,
     const std::vector<std::string>& identifiers) {
-  for (const auto& identifier : identifiers) {
-    auto newRouteStr = newRoute->str();
-    updateLogHandler_->log(
-        UpdateLogHandler::UPDATE_TYPE::ADD,
-        identifier,
-        "label fib entry entry",
-        nullptr,
-        &newRouteStr);
-  }
+  dispatcher_.log(
+      UpdateLogHandler::UPDATE_TYPE::ADD,
+      identifiers,
+      "label fib entry entry",
+      std::shared_ptr<LabelForwardingEntry>(),
+      newRoute);
 }
 
 void MplsRouteLogger::logChangedRoute(
     const std::shared_ptr<LabelForwardingEntry>& oldRoute,
     const std::shared_ptr<LabelForwardingEntry>& newRoute,
     const std::vector<std::string>& identifiers) {
-  for (const auto& identifier : identifiers) {
-    auto oldRouteStr = oldRoute->str();
-    auto newRouteStr = newRoute->str();
-    updateLogHandler_->log(
-        UpdateLogHandler::UPDATE_TYPE::CHANGE,
-        identifier,
-        "label fib entry entry",
-        &oldRouteStr,
-        &newRouteStr);
-  }
+  dispatcher_.log(
+      UpdateLogHandler::UPDATE_TYPE::CHANGE,
+      identifiers,
+      "label fib entry entry",
+      oldRoute,
+      newRoute);
 }
 
 void MplsRouteLogger::logRemovedRoute(
     const std::shared_ptr<LabelForwardingEntry>& oldRoute,
     const std::vector<std::string>& identifiers) {
-  for (const auto& identifier : identifiers) {
-    auto oldRouteStr = oldRoute->str();
-    updateLogHandler_->log(
-        UpdateLogHandler::UPDATE_TYPE::DELETE,
-        identifier,
-        "label fib entry entry",
-        &oldRouteStr,
-        nullptr);
-  }
+  dispatcher_.log(
+      UpdateLogHandler::UPDATE_TYPE::DELETE,
+      identifiers,
+      "label fib entry entry",
+      oldRoute,
+      std::shared_ptr<LabelForwardingEntry>());
 }
 
 void RouteUpdateLogger::startLoggingForLabel(
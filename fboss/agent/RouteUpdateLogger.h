@@ -10,6 +10,7 @@
 #pragma once
 
 #include <folly/IPAddress.h>
+#include <folly/io/async/EventBase.h>
 #include <folly/logging/xlog.h>
 #include "fboss/agent/RouteUpdateLoggingPrefixTracker.h"
 #include "fboss/agent/StateObserver.h"
@@ -18,6 +19,7 @@
 #include "fboss/agent/state/StateDelta.h"
 
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace facebook::fboss {
@@ -79,10 +81,72 @@ struct GlogUpdateLogHandler : UpdateLogHandler {
       const std::string* newEntity);
 };
 
+/*
+ * Hands entity updates to an UpdateLogHandler. When an event base is set,
+ * the entities are formatted and logged there, so that logging doesn't hold
+ * up the thread reporting the updates. Otherwise this happens inline.
+ */
+class UpdateLogDispatcher {
+ public:
+  UpdateLogDispatcher() : updateLogHandler_(UpdateLogHandler::get()) {}
+
+  void setEventBase(folly::EventBase* evb) {
+    evb_ = evb;
+  }
+
+  template <typename EntityT>
+  void log(
+      UpdateLogHandler::UPDATE_TYPE operation,
+      const std::vector<std::string>& identifiers,
+      const std::string& entityType,
+      std::shared_ptr<EntityT> oldEntity,
+      std::shared_ptr<EntityT> newEntity) {
+    auto logFn = [handler = updateLogHandler_,
+                  operation,
+                  identifiers,
+                  entityType,
+                  oldEntity = std::move(oldEntity),
+                  newEntity = std::move(newEntity)]() {
+      // Format the entities once, however many identifiers track them
+      std::optional<std::string> oldEntityStr;
+      std::optional<std::string> newEntityStr;
+      if (oldEntity) {
+        oldEntityStr = oldEntity->str();
+      }
+      if (newEntity) {
+        newEntityStr = newEntity->str();
+      }
+      for (const auto& identifier : identifiers) {
+        handler->log(
+            operation,
+            identifier,
+            entityType,
+            oldEntityStr ? &*oldEntityStr : nullptr,
+            newEntityStr ? &*newEntityStr : nullptr);
+      }
+    };
+    if (evb_) {
+      evb_->runInEventBaseThread(std::move(logFn));
+    } else {
+      logFn();
+    }
+  }
+
+ private:
+  // Shared with queued updates, which may outlive the dispatcher
+  std::shared_ptr<UpdateLogHandler> updateLogHandler_;
+  folly::EventBase* evb_{nullptr};
+};
+
 template <typename AddrT>
 class RouteLogger : public RouteLoggerBase<Route<AddrT>> {
  public:
-  RouteLogger() : updateLogHandler_(UpdateLogHandler::get()) {}
+  RouteLogger() {}
+
+  // Format and log updates on evb, rather than inline
+  void setLogEventBase(folly::EventBase* evb) {
+    dispatcher_.setEventBase(evb);
+  }
 
   void logAddedRoute(
       const std::shared_ptr<Route<AddrT>>& newRoute,
@@ -96,12 +160,17 @@ class RouteLogger : public RouteLoggerBase<Route<AddrT>> {
       const std::vector<std::string>& identifiers) override;
 
  private:
-  std::unique_ptr<UpdateLogHandler> updateLogHandler_;
+  UpdateLogDispatcher dispatcher_;
 };
 
 class MplsRouteLogger : public RouteLoggerBase<LabelForwardingEntry> {
  public:
-  MplsRouteLogger() : updateLogHandler_(UpdateLogHandler::get()) {}
+  MplsRouteLogger() {}
+
+  // Format and log updates on evb, rather than inline
+  void setLogEventBase(folly::EventBase* evb) {
+    dispatcher_.setEventBase(evb);
+  }
 
   void logAddedRoute(
       const std::shared_ptr<LabelForwardingEntry>& newRoute,
@@ -115,7 +184,7 @@ class MplsRouteLogger : public RouteLoggerBase<LabelForwardingEntry> {
       const std::vector<std::string>& identifiers) override;
 
  private:
-  std::unique_ptr<UpdateLogHandler> updateLogHandler_;
+  UpdateLogDispatcher dispatcher_;
 };
 
 class LabelsTracker {
@@ -151,6 +220,10 @@ class LabelsTracker {
  * (or more specific location with that prefix) is added, removed, or
  * changes, log that information. The logger is pluggable, but by default
  * we use GLOG.
+ *
+ * Changed routes are matched against a snapshot of the tracked prefixes,
+ * taken once per state update. Log messages are formatted and written on
+ * the background thread.
  */
 class RouteUpdateLogger : public AutoRegisterStateObserver {
   // TODO(pshaikh): rename RouteUpdateLogger to FibUpdateObserver
@@ -195,6 +268,8 @@ class RouteUpdateLogger : public AutoRegisterStateObserver {
   }
 
  private:
+  void logLabelUpdates(const StateDelta& delta);
+
   RouteUpdateLoggingPrefixTracker prefixTracker_;
   folly::Synchronized<LabelsTracker> labelTracker_;
   std::unique_ptr<RouteLogger<folly::IPAddressV4>> routeLoggerV4_;
@@ -10,6 +10,9 @@
 
 #include "RouteUpdateLoggingPrefixTracker.h"
 #include <folly/logging/xlog.h>
+#include "fboss/agent/FbossError.h"
+
+#include <algorithm>
 
 namespace facebook::fboss {
 
@@ -24,16 +27,52 @@ std::string RouteUpdateLoggingInstance::str() const {
       "{} {} {}", prefix.str(), identifier, exact ? "exact" : "longest-match");
 }
 
+RouteUpdateLoggingPrefixTracker::IdentifierSet
+RouteUpdateLoggingPrefixTracker::Snapshot::match(
+    const RoutePrefix<folly::IPAddress>& prefix) const {
+  if (prefix.network.isV4()) {
+    return match(
+        RoutePrefix<folly::IPAddressV4>{prefix.network.asV4(), prefix.mask});
+  }
+  return match(
+      RoutePrefix<folly::IPAddressV6>{prefix.network.asV6(), prefix.mask});
+}
+
+std::vector<std::string>
+RouteUpdateLoggingPrefixTracker::Snapshot::getIdentifiers(
+    IdentifierSet ids) const {
+  std::vector<std::string> identifiers;
+  for (size_t i = 0; i < identifiers_.size(); ++i) {
+    if (ids.test(i)) {
+      identifiers.push_back(identifiers_[i]);
+    }
+  }
+  return identifiers;
+}
+
+RouteUpdateLoggingPrefixTracker::RouteUpdateLoggingPrefixTracker()
+    : snapshot_(std::make_shared<Snapshot>()) {}
+
 void RouteUpdateLoggingPrefixTracker::track(
     const RouteUpdateLoggingInstance& req) {
   XLOG(INFO) << "Tracking " << req.str();
   SYNCHRONIZED(trackedPrefixes_) {
+    if (trackedPrefixes_.find(req.identifier) == trackedPrefixes_.end() &&
+        trackedPrefixes_.size() >= kMaxIdentifiers) {
+      throw FbossError(
+          "Cannot track ",
+          req.str(),
+          ", route updates are already tracked for ",
+          kMaxIdentifiers,
+          " identifiers");
+    }
     auto found = trackedPrefixes_[req.identifier].insert(
         req.prefix.network, req.prefix.mask, req);
     // Use the most recently set configuration
     if (!found.second) {
       found.first.value() = req;
     }
+    publishSnapshot(trackedPrefixes_);
   }
 }
 
@@ -48,6 +87,10 @@ void RouteUpdateLoggingPrefixTracker::stopTracking(
       return;
     }
     itr->second.erase(prefix.network, prefix.mask);
+    if (itr->second.size() == 0) {
+      trackedPrefixes_.erase(itr);
+    }
+    publishSnapshot(trackedPrefixes_);
   }
 }
 
@@ -57,29 +100,35 @@ void RouteUpdateLoggingPrefixTracker::stopTracking(
   XLOG(INFO) << "Stop tracking all prefixes for " << identifier;
   SYNCHRONIZED(trackedPrefixes_) {
     trackedPrefixes_.erase(identifier);
+    publishSnapshot(trackedPrefixes_);
   }
 }
 
-bool RouteUpdateLoggingPrefixTracker::trackingImpl(
-    const RoutePrefix<folly::IPAddress>& prefix,
-    std::vector<std::string>& identifiers) const {
-  identifiers.clear();
-  SYNCHRONIZED_CONST(trackedPrefixes_) {
-    for (const auto& prefixes : trackedPrefixes_) {
-      const auto match =
-          prefixes.second.longestMatch(prefix.network, prefix.mask);
-      if (match != prefixes.second.end()) {
-        if (!match.value().exact) {
-          identifiers.push_back(prefixes.first);
-          continue;
-        }
-        if (match.value().prefix == prefix) {
-          identifiers.push_back(prefixes.first);
-        }
-      }
+void RouteUpdateLoggingPrefixTracker::publishSnapshot(
+    const TrackedPrefixes& trackedPrefixes) {
+  // Tracking changes are rare, just rebuild the merged trees
+  auto snapshot = std::make_shared<Snapshot>();
+  for (const auto& prefixes : trackedPrefixes) {
+    snapshot->identifiers_.push_back(prefixes.first);
+  }
+  std::sort(snapshot->identifiers_.begin(), snapshot->identifiers_.end());
+
+  auto getEntry = [](auto& tree, const auto& network, uint8_t mask) {
+    return &tree.insert(network, mask, Snapshot::Entry()).first->value();
+  };
+  for (size_t i = 0; i < snapshot->identifiers_.size(); ++i) {
+    for (const auto& itr : trackedPrefixes.at(snapshot->identifiers_[i])) {
+      const auto& prefix = itr->value().prefix;
+      auto* entry = prefix.network.isV4()
+          ? getEntry(snapshot->v4Tree_, prefix.network.asV4(), prefix.mask)
+          : getEntry(snapshot->v6Tree_, prefix.network.asV6(), prefix.mask);
+      entry->tracking.set(i);
+      entry->exact.set(i, itr->value().exact);
     }
   }
-  return (identifiers.size() > 0);
+
+  folly::SpinLockGuard guard(snapshotLock_);
+  snapshot_ = std::move(snapshot);
 }
 
 std::vector<RouteUpdateLoggingInstance>
@@ -9,11 +9,14 @@
  */
 #pragma once
 
+#include <folly/SpinLock.h>
 #include <folly/Synchronized.h>
 #include "fboss/agent/state/RouteTypes.h"
 #include "fboss/lib/RadixTree.h"
 
+#include <bitset>
 #include <memory>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -46,11 +49,87 @@ struct RouteUpdateLoggingInstance {
  */
 class RouteUpdateLoggingPrefixTracker {
  public:
+  // The most identifiers that can track prefixes at the same time
+  static constexpr size_t kMaxIdentifiers = 64;
+  using IdentifierSet = std::bitset<kMaxIdentifiers>;
+
+  /*
+   * The prefixes tracked by all identifiers, merged into one radix tree per
+   * address family. Each node holds the set of identifiers tracking its
+   * prefix, and which of them only want exact matches.
+   *
+   * Snapshots are immutable: tracking changes publish a new one, so that
+   * state updates can match all of their routes against a snapshot without
+   * taking any lock.
+   */
+  class Snapshot {
+   public:
+    bool empty() const {
+      return identifiers_.empty();
+    }
+
+    /*
+     * Returns the identifiers tracking the prefix. As with tracking the
+     * prefixes of each identifier separately, the most specific prefix an
+     * identifier tracks that covers this one decides whether it matches.
+     */
+    template <typename AddrT>
+    IdentifierSet match(const RoutePrefix<AddrT>& prefix) const {
+      const auto& tree = getTree<AddrT>();
+      IdentifierSet matched;
+      auto itr = tree.longestMatch(prefix.network, prefix.mask);
+      if (itr == tree.end()) {
+        return matched;
+      }
+      IdentifierSet decided;
+      for (const auto* node = &(*itr); node; node = node->parent()) {
+        if (node->isNonValueNode()) {
+          continue;
+        }
+        const auto& entry = node->value();
+        auto ids = entry.tracking & ~decided;
+        if (node->masklen() != prefix.mask) {
+          ids &= ~entry.exact;
+        }
+        matched |= ids;
+        decided |= entry.tracking;
+      }
+      return matched;
+    }
+    IdentifierSet match(const RoutePrefix<folly::IPAddress>& prefix) const;
+
+    std::vector<std::string> getIdentifiers(IdentifierSet ids) const;
+
+   private:
+    friend class RouteUpdateLoggingPrefixTracker;
+
+    struct Entry {
+      IdentifierSet tracking;
+      IdentifierSet exact;
+    };
+
+    template <typename AddrT>
+    const network::RadixTree<AddrT, Entry>& getTree() const {
+      if constexpr (std::is_same_v<AddrT, folly::IPAddressV4>) {
+        return v4Tree_;
+      } else {
+        return v6Tree_;
+      }
+    }
+
+    // Identifier names, indexed by their bit in identifier sets
+    std::vector<std::string> identifiers_;
+    network::RadixTree<folly::IPAddressV4, Entry> v4Tree_;
+    network::RadixTree<folly::IPAddressV6, Entry> v6Tree_;
+  };
+
+  RouteUpdateLoggingPrefixTracker();
   ~RouteUpdateLoggingPrefixTracker() {}
   /*
    * Start tracking a prefix. Will overwrite existing exact-ness settings.
    * i.e. for a single identifier, if we track expecting exact matches, then
    * track allowing for longest match, tracking() will use longest match.
+   * Throws FbossError if kMaxIdentifiers identifiers already track prefixes.
    */
   void track(const RouteUpdateLoggingInstance& req);
   // Stop a particular tracking instance
@@ -61,6 +140,12 @@ class RouteUpdateLoggingPrefixTracker {
   void stopTracking(const std::string& identifier);
   std::vector<RouteUpdateLoggingInstance> getTrackedPrefixes() const;
 
+  // The prefixes tracked right now
+  std::shared_ptr<const Snapshot> getSnapshot() const {
+    folly::SpinLockGuard guard(snapshotLock_);
+    return snapshot_;
+  }
+
   /* Returns whether or not the prefix is tracked for logging.
    * Will also populate identifiers with all of the identifiers that
    * tracking for this prefix was turned on with.
@@ -69,19 +154,23 @@ class RouteUpdateLoggingPrefixTracker {
   bool tracking(
       const RoutePrefix<AddrT>& prefix,
       std::vector<std::string>& identifiers) const {
-    folly::IPAddress addr{prefix.network};
-    RoutePrefix<folly::IPAddress> p{addr, prefix.mask};
-    return trackingImpl(p, identifiers);
+    auto snapshot = getSnapshot();
+    identifiers = snapshot->getIdentifiers(snapshot->match(prefix));
+    return (identifiers.size() > 0);
   }
 
  private:
-  bool trackingImpl(
-      const RoutePrefix<folly::IPAddress>& prefix,
-      std::vector<std::string>& identifiers) const;
-  folly::Synchronized<std::unordered_map<
+  using TrackedPrefixes = std::unordered_map<
       std::string,
-      network::RadixTree<folly::IPAddress, RouteUpdateLoggingInstance>>>
-      trackedPrefixes_;
+      network::RadixTree<folly::IPAddress, RouteUpdateLoggingInstance>>;
+
+  // Called with trackedPrefixes_ locked, so that snapshots are published in
+  // the order of the changes they reflect
+  void publishSnapshot(const TrackedPrefixes& trackedPrefixes);
+
+  folly::Synchronized<TrackedPrefixes> trackedPrefixes_;
+  mutable folly::SpinLock snapshotLock_;
+  std::shared_ptr<const Snapshot> snapshot_;
 };
 
 } // namespace facebook::fboss
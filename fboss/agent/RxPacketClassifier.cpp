@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/RxPacketClassifier.h"
+
+#include "fboss/agent/packet/Ethertype.h"
+#include "fboss/agent/packet/PktUtil.h"
+
+#include <folly/Bits.h>
+
+using folly::MacAddress;
+using folly::io::Cursor;
+
+namespace {
+// The minimum required frame length for ethernet is 64 bytes
+auto constexpr kMinFrameLength = 64;
+auto constexpr kUntaggedHdrLength = 2 * MacAddress::SIZE + 2;
+auto constexpr kTaggedHdrLength = kUntaggedHdrLength + 4;
+
+uint16_t readBE16(const uint8_t* data) {
+  return folly::Endian::big(folly::loadUnaligned<uint16_t>(data));
+}
+} // namespace
+
+namespace facebook::fboss {
+
+std::optional<ClassifiedRxPacket> RxPacketClassifier::classify(
+    std::unique_ptr<RxPacket> pkt) {
+  if (pkt->getLength() < kMinFrameLength) {
+    return std::nullopt;
+  }
+
+  ClassifiedRxPacket classified;
+  const auto* buf = pkt->buf();
+  if (buf->length() >= kTaggedHdrLength) {
+    // Common case, the whole header is in the first buffer. Read it in place
+    // rather than through a cursor.
+    auto data = buf->data();
+    classified.dst = MacAddress::fromBinary(
+        folly::ByteRange(data, MacAddress::SIZE));
+    classified.src = MacAddress::fromBinary(
+        folly::ByteRange(data + MacAddress::SIZE, MacAddress::SIZE));
+    classified.ethertype = readBE16(data + 2 * MacAddress::SIZE);
+    classified.l3Offset = kUntaggedHdrLength;
+    if (classified.ethertype ==
+        static_cast<uint16_t>(ETHERTYPE::ETHERTYPE_VLAN)) {
+      // Skip over the VLAN tag, we ignore it for now
+      classified.ethertype = readBE16(data + kTaggedHdrLength - 2);
+      classified.l3Offset = kTaggedHdrLength;
+    }
+  } else {
+    Cursor c(buf);
+    classified.dst = PktUtil::readMac(&c);
+    classified.src = PktUtil::readMac(&c);
+    classified.ethertype = c.readBE<uint16_t>();
+    if (classified.ethertype ==
+        static_cast<uint16_t>(ETHERTYPE::ETHERTYPE_VLAN)) {
+      c += 2;
+      classified.ethertype = c.readBE<uint16_t>();
+    }
+    classified.l3Offset = c - Cursor(buf);
+  }
+  classified.pkt = std::move(pkt);
+  return classified;
+}
+
+} // namespace facebook::fboss
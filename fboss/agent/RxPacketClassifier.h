@@ -0,0 +1,54 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/agent/RxPacket.h"
+
+#include <folly/MacAddress.h>
+#include <folly/io/Cursor.h>
+
+#include <memory>
+#include <optional>
+
+namespace facebook::fboss {
+
+/*
+ * A trapped packet along with the fields of its ethernet header.
+ */
+struct ClassifiedRxPacket {
+  std::unique_ptr<RxPacket> pkt;
+  folly::MacAddress dst;
+  folly::MacAddress src;
+  uint16_t ethertype{0};
+  // Offset of the L3 header, past the ethernet header and VLAN tag if any
+  uint32_t l3Offset{0};
+
+  // Cursor pointing to the L3 header
+  folly::io::Cursor l3Cursor() const {
+    return folly::io::Cursor(pkt->buf()) + l3Offset;
+  }
+};
+
+/*
+ * Parses the ethernet header of trapped packets, so that the handler a packet
+ * goes to can be picked and given a cursor at its L3 header without parsing
+ * the header again.
+ */
+class RxPacketClassifier {
+ public:
+  /*
+   * Parse the ethernet header of a single packet. Returns nothing for
+   * packets shorter than the minimum ethernet frame.
+   */
+  static std::optional<ClassifiedRxPacket> classify(
+      std::unique_ptr<RxPacket> pkt);
+};
+
+} // namespace facebook::fboss
@@ -35,11 +35,14 @@
 #include "fboss/agent/RestartTimeTracker.h"
 #include "fboss/agent/RouteUpdateLogger.h"
 #include "fboss/agent/RxPacket.h"
+#include "fboss/agent/RxPacketClassifier.h"
 #include "fboss/agent/StaticL2ForNeighborObserver.h"
+#include "fboss/agent/SwitchStateHistory.h"
 #include "fboss/agent/SwitchStats.h"
 #include "fboss/agent/ThriftHandler.h"
 #include "fboss/agent/TunManager.h"
 #include "fboss/agent/TxPacket.h"
+#include "fboss/agent/TxPacketTemplates.h"
 #include "fboss/agent/Utils.h"
 #include "fboss/agent/capture/PcapPkt.h"
 #include "fboss/agent/capture/PktCaptureManager.h"
@@ -53,6 +56,7 @@
 #include "fboss/agent/state/StateDelta.h"
 #include "fboss/agent/state/StateUpdateHelpers.h"
 #include "fboss/agent/state/SwitchState.h"
+#include "fboss/lib/StageTracer.h"
 
 #include <fb303/ServiceData.h>
 #include <folly/Demangle.h>
@@ -108,6 +112,17 @@ DEFINE_bool(
     false,
     "Flag to turn on logging of all updates to the FIB");
 
+DEFINE_int32(
+    neighbor_cache_threads,
+    1,
+    "Number of threads Arp and Ndp caches are sharded across, by VLAN");
+
+DEFINE_int32(
+    route_update_traces,
+    100,
+    "Number of most recent route update traces to keep, "
+    "0 to disable route update tracing");
+
 namespace {
 
 /**
@@ -156,6 +171,7 @@ namespace facebook::fboss {
 SwSwitch::SwSwitch(std::unique_ptr<Platform> platform)
     : hw_(platform->getHwSwitch()),
       platform_(std::move(platform)),
+      txPacketTemplates_(new TxPacketTemplates(this)),
       arp_(new ArpHandler(this)),
       ipv4_(new IPv4Handler(this)),
       ipv6_(new IPv6Handler(this)),
@@ -163,6 +179,9 @@ SwSwitch::SwSwitch(std::unique_ptr<Platform> platform)
       pcapMgr_(new PktCaptureManager(this)),
       mirrorManager_(new MirrorManager(this)),
       routeUpdateLogger_(new RouteUpdateLogger(this)),
+      routeUpdateTracer_(
+          new StageTracer("route_update", FLAGS_route_update_traces)),
+      stateHistory_(new SwitchStateHistory()),
       resolvedNexthopMonitor_(new ResolvedNexthopMonitor(this)),
       resolvedNexthopProbeScheduler_(new ResolvedNexthopProbeScheduler(this)),
       rib_(new rib::RoutingInformationBase()),
@@ -231,7 +250,7 @@ void SwSwitch::stop() {
   updThreadHeartbeat_.reset();
   packetTxThreadHeartbeat_.reset();
   lacpThreadHeartbeat_.reset();
-  neighborCacheThreadHeartbeat_.reset();
+  neighborCacheThreadHeartbeats_.clear();
   rib_.reset();
 
   lookupClassUpdater_.reset();
@@ -347,6 +366,7 @@ void SwSwitch::updateStats() {
   updateRouteStats();
   updatePortInfo();
   updateLldpStats();
+  stateHistory_->updateStats();
   try {
     getHw()->updateStats(stats());
   } catch (const std::exception& ex) {
@@ -525,14 +545,19 @@ void SwSwitch::init(std::unique_ptr<TunManager> tunMgr, SwitchFlags flags) {
       FLAGS_thread_heartbeat_ms,
       updateLacpThreadHeartbeatStats);
 
-  neighborCacheThreadHeartbeat_ = std::make_unique<ThreadHeartbeat>(
-      &neighborCacheEventBase_,
-      *folly::getThreadName(neighborCacheThread_->get_id()),
-      FLAGS_thread_heartbeat_ms,
-      [this](int delay, int backlog) {
-        stats()->neighborCacheHeartbeatDelay(delay);
-        stats()->neighborCacheEventBacklog(backlog);
-      });
+  for (size_t shard = 0; shard < neighborCacheEventBases_.size(); ++shard) {
+    auto queueDepthCounter =
+        folly::to<std::string>("neighbor_cache.shard", shard, ".queue_depth");
+    neighborCacheThreadHeartbeats_.push_back(std::make_unique<ThreadHeartbeat>(
+        neighborCacheEventBases_[shard].get(),
+        *folly::getThreadName(neighborCacheThreads_[shard]->get_id()),
+        FLAGS_thread_heartbeat_ms,
+        [this, queueDepthCounter](int delay, int backlog) {
+          stats()->neighborCacheHeartbeatDelay(delay);
+          stats()->neighborCacheEventBacklog(backlog);
+          fb303::fbData->setCounter(queueDepthCounter, backlog);
+        }));
+  }
 
   setSwitchRunState(SwitchRunState::INITIALIZED);
   if (FLAGS_log_all_fib_updates) {
@@ -650,6 +675,8 @@ void SwSwitch::notifyStateObservers(const StateDelta& delta) {
 }
 
 void SwSwitch::updateState(unique_ptr<StateUpdate> update) {
+  update->trace_ = StageTracer::current();
+  StageTracer::markCurrent("update_queued");
   {
     folly::SpinLockGuard guard(pendingUpdatesLock_);
     pendingUpdates_.push_back(*update.release());
@@ -754,11 +781,17 @@ void SwSwitch::handlePendingUpdates() {
   // queue whenever applied and desired states diverge. After that, other
   // supplied state updates are applied (that were spliced above).
   auto newDesiredState = oldAppliedState;
+  std::vector<std::shared_ptr<StageTrace>> traces;
   auto iter = updates.begin();
   while (iter != updates.end()) {
     StateUpdate* update = &(*iter);
     ++iter;
 
+    auto trace = update->trace_;
+    if (trace) {
+      trace->mark("update_dequeued");
+      traces.push_back(trace);
+    }
     shared_ptr<SwitchState> intermediateState;
     XLOG(INFO) << "preparing state update " << update->getName();
     try {
@@ -781,12 +814,16 @@ void SwSwitch::handlePendingUpdates() {
       intermediateState->publish();
       newDesiredState = intermediateState;
     }
+    if (trace) {
+      trace->mark("state_computed");
+    }
   }
 
   // Now apply the update and notify subscribers
   if (newDesiredState != oldAppliedState) {
     // There was some change during these state updates
-    auto newAppliedState = applyUpdate(oldAppliedState, newDesiredState);
+    auto newAppliedState =
+        applyUpdate(oldAppliedState, newDesiredState, traces);
     // Stick the initial applied->desired in the beginning
     bool newOutOfSync = (newAppliedState != newDesiredState);
     fb303::fbData->setCounter("hw_out_of_sync", newOutOfSync);
@@ -826,21 +863,37 @@ void SwSwitch::setStateInternal(
   CHECK(bool(newDesiredState));
   CHECK(newAppliedState->isPublished());
   CHECK(newDesiredState->isPublished());
-  folly::SpinLockGuard guard(stateLock_);
-  appliedStateDontUseDirectly_.swap(newAppliedState);
-  desiredStateDontUseDirectly_.swap(newDesiredState);
+  {
+    folly::SpinLockGuard guard(stateLock_);
+    appliedStateDontUseDirectly_.swap(newAppliedState);
+    desiredStateDontUseDirectly_.swap(newDesiredState);
+  }
+  // After the swap, so holders asked to drop old states can get the new ones
+  auto states = getStates();
+  stateHistory_->published(states.first);
+  stateHistory_->published(states.second);
 }
 
 void SwSwitch::setDesiredState(std::shared_ptr<SwitchState> newDesiredState) {
   CHECK(bool(newDesiredState));
   CHECK(newDesiredState->isPublished());
-  folly::SpinLockGuard guard(stateLock_);
-  desiredStateDontUseDirectly_.swap(newDesiredState);
+  {
+    folly::SpinLockGuard guard(stateLock_);
+    desiredStateDontUseDirectly_.swap(newDesiredState);
+  }
+  stateHistory_->published(getDesiredState());
 }
 
 std::shared_ptr<SwitchState> SwSwitch::applyUpdate(
     const shared_ptr<SwitchState>& oldState,
-    const shared_ptr<SwitchState>& newState) {
+    const shared_ptr<SwitchState>& newState,
+    const std::vector<std::shared_ptr<StageTrace>>& traces) {
+  auto markTraces = [&traces](folly::StringPiece stage) {
+    for (const auto& trace : traces) {
+      trace->mark(stage);
+    }
+  };
+
   // Check that we are starting from what has been already applied
   DCHECK_EQ(oldState, getAppliedState());
 
@@ -850,6 +903,7 @@ std::shared_ptr<SwitchState> SwSwitch::applyUpdate(
   DCHECK_GT(newState->getGeneration(), oldState->getGeneration());
 
   StateDelta delta(oldState, newState);
+  XLOG(DBG2) << "State delta summary: " << delta.getSummary();
 
   // If we are already exiting, abort the update
   if (isExiting()) {
@@ -885,6 +939,8 @@ std::shared_ptr<SwitchState> SwSwitch::applyUpdate(
                 << folly::exceptionStr(ex);
   }
 
+  markTraces("hw_programmed");
+
   setStateInternal(newAppliedState, newState);
 
   // Notifies all observers of the current state update. We notify them that
@@ -892,6 +948,7 @@ std::shared_ptr<SwitchState> SwSwitch::applyUpdate(
   // have been applied yet. If an observer wants to know the applied state,
   // they can query the SwSwitch about it.
   notifyStateObservers(delta);
+  markTraces("observers_notified");
 
   auto end = std::chrono::steady_clock::now();
   auto duration =
@@ -1004,29 +1061,28 @@ void SwSwitch::handlePacket(std::unique_ptr<RxPacket> pkt) {
 
   // The minimum required frame length for ethernet is 64 bytes.
   // Abort processing early if the packet is too short.
-  auto len = pkt->getLength();
-  if (len < 64) {
+  auto classified = RxPacketClassifier::classify(std::move(pkt));
+  if (!classified) {
     portStats(port)->pktBogus();
     return;
   }
+  dispatchPacket(std::move(*classified));
+}
 
-  // Parse the source and destination MAC, as well as the ethertype.
-  Cursor c(pkt->buf());
-  auto dstMac = PktUtil::readMac(&c);
-  auto srcMac = PktUtil::readMac(&c);
-  auto ethertype = c.readBE<uint16_t>();
-  if (ethertype == 0x8100) {
-    // 802.1Q
-    c += 2; // Advance over the VLAN tag.  We ignore it for now
-    ethertype = c.readBE<uint16_t>();
-  }
+void SwSwitch::dispatchPacket(ClassifiedRxPacket&& classified) {
+  Cursor c = classified.l3Cursor();
+  auto pkt = std::move(classified.pkt);
+  PortID port = pkt->getSrcPort();
+  auto dstMac = classified.dst;
+  auto srcMac = classified.src;
+  auto ethertype = classified.ethertype;
 
   XLOG(DBG5) << "trapped packet: src_port=" << pkt->getSrcPort()
              << " srcAggPort="
              << (pkt->isFromAggregatePort()
                      ? folly::to<string>(pkt->getSrcAggregatePort())
                      : "None")
-             << " vlan=" << pkt->getSrcVlan() << " length=" << len
+             << " vlan=" << pkt->getSrcVlan() << " length=" << pkt->getLength()
              << " src=" << srcMac << " dst=" << dstMac << " ethertype=0x"
              << std::hex << ethertype << " :: " << pkt->describeDetails();
 
@@ -1116,9 +1172,24 @@ void SwSwitch::startThreads() {
   }));
   lacpThread_.reset(new std::thread(
       [=] { this->threadLoop("fbossLacpThread", &lacpEventBase_); }));
-  neighborCacheThread_.reset(new std::thread([=] {
-    this->threadLoop("fbossNeighborCacheThread", &neighborCacheEventBase_);
-  }));
+  for (size_t shard = 0; shard < neighborCacheEventBases_.size(); ++shard) {
+    // Keep the original thread name for the first (or only) shard
+    auto name = shard == 0
+        ? std::string("fbossNeighborCacheThread")
+        : folly::to<std::string>("fbossNeighborCacheThread", shard);
+    auto evb = neighborCacheEventBases_[shard].get();
+    neighborCacheThreads_.push_back(std::make_unique<std::thread>(
+        [=] { this->threadLoop(name, evb); }));
+  }
+}
+
+std::vector<std::unique_ptr<folly::EventBase>>
+SwSwitch::createNeighborCacheEventBases() {
+  std::vector<std::unique_ptr<folly::EventBase>> eventBases;
+  for (auto i = 0; i < std::max(FLAGS_neighbor_cache_threads, 1); ++i) {
+    eventBases.push_back(std::make_unique<folly::EventBase>());
+  }
+  return eventBases;
 }
 
 void SwSwitch::stopThreads() {
@@ -1148,9 +1219,9 @@ void SwSwitch::stopThreads() {
     lacpEventBase_.runInEventBaseThread(
         [this] { lacpEventBase_.terminateLoopSoon(); });
   }
-  if (neighborCacheThread_) {
-    neighborCacheEventBase_.runInEventBaseThread(
-        [this] { neighborCacheEventBase_.terminateLoopSoon(); });
+  for (size_t shard = 0; shard < neighborCacheThreads_.size(); ++shard) {
+    auto evb = neighborCacheEventBases_[shard].get();
+    evb->runInEventBaseThread([evb] { evb->terminateLoopSoon(); });
   }
   if (backgroundThread_) {
     backgroundThread_->join();
@@ -1167,8 +1238,8 @@ void SwSwitch::stopThreads() {
   if (lacpThread_) {
     lacpThread_->join();
   }
-  if (neighborCacheThread_) {
-    neighborCacheThread_->join();
+  for (auto& neighborCacheThread : neighborCacheThreads_) {
+    neighborCacheThread->join();
   }
 
   platform_->stop();
@@ -1502,6 +1573,9 @@ void SwSwitch::applyConfig(const std::string& reason, bool reload) {
 
 bool SwSwitch::isValidStateUpdate(const StateDelta& delta) const {
   bool isValid = true;
+  if (!delta.getSummary().changed(StateDeltaSummary::ACLS)) {
+    return hw_->isValidStateUpdate(delta);
+  }
 
   forEachChanged(
       delta.getAclsDelta(),
@@ -34,6 +34,7 @@
 namespace facebook::fboss {
 
 class ArpHandler;
+struct ClassifiedRxPacket;
 class IPv4Handler;
 class IPv6Handler;
 class LinkAggregationManager;
@@ -50,8 +51,12 @@ class SwitchStats;
 class StateDelta;
 class NeighborUpdater;
 class RouteUpdateLogger;
+class StageTrace;
+class StageTracer;
 class StateObserver;
+class SwitchStateHistory;
 class TunManager;
+class TxPacketTemplates;
 class MirrorManager;
 class LookupClassUpdater;
 class LookupClassRouteUpdater;
@@ -403,10 +408,21 @@ class SwSwitch : public HwSwitch::Callback {
   }
 
   /*
-   * Get the EventBase for Arp/Ndp Cache
+   * Arp/Ndp caches are sharded by VLAN across the neighbor cache threads.
+   * Get the number of shards, the shard a VLAN's caches belong to, and the
+   * EventBase for a shard or VLAN.
    */
-  folly::EventBase* getNeighborCacheEvb() {
-    return &neighborCacheEventBase_;
+  size_t getNumNeighborCacheShards() const {
+    return neighborCacheEventBases_.size();
+  }
+  size_t getNeighborCacheShard(VlanID vlan) const {
+    return static_cast<size_t>(vlan) % neighborCacheEventBases_.size();
+  }
+  folly::EventBase* getNeighborCacheEvbForShard(size_t shard) {
+    return neighborCacheEventBases_.at(shard).get();
+  }
+  folly::EventBase* getNeighborCacheEvb(VlanID vlan) {
+    return getNeighborCacheEvbForShard(getNeighborCacheShard(vlan));
   }
 
   /**
@@ -532,6 +548,13 @@ class SwSwitch : public HwSwitch::Callback {
     return nUpdater_.get();
   }
 
+  /*
+   * Get the pre-rendered frames control plane packets are built from.
+   */
+  TxPacketTemplates* getTxPacketTemplates() {
+    return txPacketTemplates_.get();
+  }
+
   /*
    * Get the PktCaptureManager object.
    */
@@ -553,6 +576,22 @@ class SwSwitch : public HwSwitch::Callback {
     return routeUpdateLogger_.get();
   }
 
+  /*
+   * Get the tracer recording per stage latency of route updates
+   */
+  StageTracer* getRouteUpdateTracer() {
+    return routeUpdateTracer_.get();
+  }
+
+  /*
+   * Get the tracker of the live SwitchState generations. Consumers keeping
+   * states around past a state update should take their references through
+   * it.
+   */
+  SwitchStateHistory* getStateHistory() {
+    return stateHistory_.get();
+  }
+
   LinkAggregationManager* getLagManager() {
     return lagManager_.get();
   }
@@ -721,12 +760,14 @@ class SwSwitch : public HwSwitch::Callback {
   void setSwitchRunState(SwitchRunState desiredState);
   SwitchStats* createSwitchStats();
   void handlePacket(std::unique_ptr<RxPacket> pkt);
+  void dispatchPacket(ClassifiedRxPacket&& classified);
 
   static void handlePendingUpdatesHelper(SwSwitch* sw);
   void handlePendingUpdates();
   std::shared_ptr<SwitchState> applyUpdate(
       const std::shared_ptr<SwitchState>& oldState,
-      const std::shared_ptr<SwitchState>& newState);
+      const std::shared_ptr<SwitchState>& newState,
+      const std::vector<std::shared_ptr<StageTrace>>& traces = {});
 
   void startThreads();
   void stopThreads();
@@ -849,11 +890,15 @@ class SwSwitch : public HwSwitch::Callback {
   std::unique_ptr<ThreadHeartbeat> lacpThreadHeartbeat_;
 
   /*
-   * A thread dedicated to Arp and Ndp cache entry processing.
+   * Threads dedicated to Arp and Ndp cache entry processing, one per neighbor
+   * cache shard.
    */
-  std::unique_ptr<std::thread> neighborCacheThread_;
-  folly::EventBase neighborCacheEventBase_;
-  std::unique_ptr<ThreadHeartbeat> neighborCacheThreadHeartbeat_;
+  static std::vector<std::unique_ptr<folly::EventBase>>
+  createNeighborCacheEventBases();
+  std::vector<std::unique_ptr<std::thread>> neighborCacheThreads_;
+  std::vector<std::unique_ptr<folly::EventBase>> neighborCacheEventBases_{
+      createNeighborCacheEventBases()};
+  std::vector<std::unique_ptr<ThreadHeartbeat>> neighborCacheThreadHeartbeats_;
 
   /*
    * A callback for listening to neighbors coming and going.
@@ -871,6 +916,8 @@ class SwSwitch : public HwSwitch::Callback {
    */
   std::map<StateObserver*, std::string> stateObservers_;
 
+  // Declared first, the handlers and neighbor threads build frames from it
+  std::unique_ptr<TxPacketTemplates> txPacketTemplates_;
   std::unique_ptr<ArpHandler> arp_;
   std::unique_ptr<IPv4Handler> ipv4_;
   std::unique_ptr<IPv6Handler> ipv6_;
@@ -878,6 +925,8 @@ class SwSwitch : public HwSwitch::Callback {
   std::unique_ptr<PktCaptureManager> pcapMgr_;
   std::unique_ptr<MirrorManager> mirrorManager_;
   std::unique_ptr<RouteUpdateLogger> routeUpdateLogger_;
+  std::unique_ptr<StageTracer> routeUpdateTracer_;
+  std::unique_ptr<SwitchStateHistory> stateHistory_;
   std::unique_ptr<LinkAggregationManager> lagManager_;
   std::unique_ptr<ResolvedNexthopMonitor> resolvedNexthopMonitor_;
   std::unique_ptr<ResolvedNexthopProbeScheduler> resolvedNexthopProbeScheduler_;
@@ -0,0 +1,249 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/SwitchStateHistory.h"
+
+#include "fboss/agent/state/SwitchState.h"
+
+#include <fb303/ServiceData.h>
+#include <folly/Conv.h>
+#include <folly/String.h>
+#include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+DEFINE_int32(
+    max_live_switch_state_generations,
+    0,
+    "Advisory. If non zero, ask the holders of switch states older than the "
+    "newest this many to drop their references. Only references taken "
+    "through SwitchStateHistory::hold() with a release callback can be "
+    "dropped, the holders of others are only logged.");
+
+namespace facebook::fboss {
+
+namespace {
+auto constexpr kLiveGenerations = "switch_state.live_generations";
+auto constexpr kOldestAgeMs = "switch_state.oldest_generation_age_ms";
+auto constexpr kReleaseRequests = "switch_state.release_requests";
+} // namespace
+
+void SwitchStateHistory::published(const std::shared_ptr<SwitchState>& state) {
+  CHECK(state->isPublished());
+  std::vector<std::function<void()>> releases;
+  std::vector<std::string> holders;
+  {
+    auto entries = entries_.wlock();
+    getEntry(&*entries, state);
+    size_t maxGenerations =
+        std::max(FLAGS_max_live_switch_state_generations, 0);
+    if (maxGenerations == 0 || entries->size() <= maxGenerations) {
+      return;
+    }
+    auto end = entries->end() - maxGenerations;
+    for (auto entry = entries->begin(); entry != end; ++entry) {
+      for (const auto& weakHold : entry->holds) {
+        auto hold = weakHold.lock();
+        if (!hold) {
+          continue;
+        }
+        holders.push_back(folly::to<std::string>(
+            hold->holder, "@", entry->generation));
+        if (hold->release) {
+          releases.push_back(hold->release);
+        }
+      }
+    }
+  }
+  XLOG(WARNING) << "More than " << FLAGS_max_live_switch_state_generations
+                << " switch state generations alive, old ones held by: "
+                << (holders.empty() ? "unknown" : folly::join(", ", holders));
+  fb303::fbData->addStatValue(kReleaseRequests, releases.size(), fb303::SUM);
+  // Outside of the lock, as releasing may drop the last reference
+  for (const auto& release : releases) {
+    release();
+  }
+}
+
+std::shared_ptr<SwitchState> SwitchStateHistory::hold(
+    const std::shared_ptr<SwitchState>& state,
+    const std::string& holder,
+    std::function<void()> release) {
+  CHECK(state);
+  auto hold = std::make_shared<Hold>(Hold{state, holder, std::move(release)});
+  getEntry(&*entries_.wlock(), state).holds.push_back(hold);
+  // Share ownership with the hold, so the hold lives as long as the reference
+  return std::shared_ptr<SwitchState>(hold, hold->state.get());
+}
+
+SwitchStateHistory::Summary SwitchStateHistory::getSummary() const {
+  std::vector<std::shared_ptr<SwitchState>> states;
+  std::vector<uint64_t> ids;
+  auto summary = getGenerations(&states, &ids);
+
+  auto bytes = bytesCache_.wlock();
+  if (bytes->ids != ids) {
+    *bytes = computeBytes(states);
+    bytes->ids = std::move(ids);
+  }
+  for (size_t i = 0; i < summary.generations.size(); ++i) {
+    summary.generations[i].uniqueBytes = bytes->uniqueBytes[i];
+  }
+  summary.totalBytes = bytes->totalBytes;
+  return summary;
+}
+
+SwitchStateHistory::Summary SwitchStateHistory::getGenerations(
+    std::vector<std::shared_ptr<SwitchState>>* states,
+    std::vector<uint64_t>* ids) const {
+  Summary summary;
+  auto entries = entries_.rlock();
+  for (const auto& entry : *entries) {
+    auto state = entry.state.lock();
+    if (!state) {
+      continue;
+    }
+    GenerationInfo info;
+    info.generation = entry.generation;
+    info.publishedAt = entry.publishedAt;
+    for (const auto& weakHold : entry.holds) {
+      if (auto hold = weakHold.lock()) {
+        info.holders.push_back(hold->holder);
+      }
+    }
+    summary.generations.push_back(std::move(info));
+    if (states) {
+      states->push_back(std::move(state));
+      ids->push_back(entry.id);
+    }
+  }
+  return summary;
+}
+
+size_t SwitchStateHistory::numLiveGenerations() const {
+  auto entries = entries_.rlock();
+  return std::count_if(
+      entries->begin(), entries->end(), [](const Entry& entry) {
+        return !entry.state.expired();
+      });
+}
+
+void SwitchStateHistory::updateStats() const {
+  // Byte accounting walks the states, so it is left to getSummary() callers
+  auto generations = getGenerations().generations;
+  int64_t oldestAgeMs = 0;
+  if (!generations.empty()) {
+    oldestAgeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                      std::chrono::steady_clock::now() -
+                      generations.front().publishedAt)
+                      .count();
+  }
+  fb303::fbData->setCounter(kLiveGenerations, generations.size());
+  fb303::fbData->setCounter(kOldestAgeMs, oldestAgeMs);
+}
+
+void SwitchStateHistory::prune(std::deque<Entry>* entries) {
+  for (auto& entry : *entries) {
+    auto& holds = entry.holds;
+    holds.erase(
+        std::remove_if(
+            holds.begin(),
+            holds.end(),
+            [](const std::weak_ptr<Hold>& hold) { return hold.expired(); }),
+        holds.end());
+  }
+  entries->erase(
+      std::remove_if(
+          entries->begin(),
+          entries->end(),
+          [](const Entry& entry) { return entry.state.expired(); }),
+      entries->end());
+}
+
+SwitchStateHistory::Entry& SwitchStateHistory::getEntry(
+    std::deque<Entry>* entries,
+    const std::shared_ptr<SwitchState>& state) {
+  prune(entries);
+  auto entry = std::find_if(
+      entries->begin(), entries->end(), [&state](const Entry& entry) {
+        return entry.statePtr == state.get();
+      });
+  if (entry != entries->end()) {
+    return *entry;
+  }
+  Entry newEntry;
+  newEntry.id = nextId_++;
+  newEntry.state = state;
+  newEntry.statePtr = state.get();
+  newEntry.generation = state->getGeneration();
+  newEntry.publishedAt = std::chrono::steady_clock::now();
+  entries->push_back(std::move(newEntry));
+  return entries->back();
+}
+
+SwitchStateHistory::BytesCache SwitchStateHistory::computeBytes(
+    const std::vector<std::shared_ptr<SwitchState>>& states) {
+  auto constexpr kShared = std::numeric_limits<size_t>::max();
+  BytesCache bytes;
+  bytes.uniqueBytes.resize(states.size());
+  // Index of the state a node was reached from, or kShared if from several
+  std::unordered_map<const NodeBase*, size_t> owners;
+  std::vector<const NodeBase*> toVisit;
+  std::vector<const NodeBase*> toShare;
+  auto visitLater = [&toVisit](const NodeBase* child) {
+    if (child) {
+      toVisit.push_back(child);
+    }
+  };
+  auto shareLater = [&toShare](const NodeBase* child) {
+    if (child) {
+      toShare.push_back(child);
+    }
+  };
+
+  // Newest first. A node an older state shares was already walked along with
+  // all of its children, so the walk of the older state stops there and only
+  // marks the subtree shared.
+  for (auto i = states.size(); i-- > 0;) {
+    toVisit.push_back(states[i].get());
+    while (!toVisit.empty()) {
+      auto node = toVisit.back();
+      toVisit.pop_back();
+      auto ins = owners.emplace(node, i);
+      if (ins.second) {
+        auto nodeBytes = node->getNodeBytes();
+        bytes.uniqueBytes[i] += nodeBytes;
+        bytes.totalBytes += nodeBytes;
+        node->forEachChildNode(visitLater);
+        continue;
+      }
+      if (ins.first->second == i || ins.first->second == kShared) {
+        continue;
+      }
+      toShare.push_back(node);
+      while (!toShare.empty()) {
+        auto shared = toShare.back();
+        toShare.pop_back();
+        auto& owner = owners.at(shared);
+        if (owner == kShared) {
+          continue;
+        }
+        bytes.uniqueBytes[owner] -= shared->getNodeBytes();
+        owner = kShared;
+        shared->forEachChildNode(shareLater);
+      }
+    }
+  }
+  return bytes;
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,141 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/Synchronized.h>
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace facebook::fboss {
+
+class SwitchState;
+
+/*
+ * Keep track of the SwitchState generations which are still alive, to find
+ * consumers that hold on to old states.
+ *
+ * Every published state stays alive as long as someone holds a reference to
+ * it, and the nodes it does not share with newer states stay allocated with
+ * it. With large FIBs a consumer lagging behind by a few updates can pin
+ * several copies of the route tables.
+ *
+ * Consumers that keep states around past a state update take their
+ * reference through hold(), which records who holds which generation. If
+ * max_live_switch_state_generations is set, publishing a state asks the
+ * holders of the generations beyond it to drop their references. This is
+ * advisory: only holders that passed a release callback to hold() can be
+ * asked, and references not taken through hold() are not tracked.
+ *
+ * All the methods in this class are thread safe.
+ */
+class SwitchStateHistory {
+ public:
+  struct GenerationInfo {
+    uint32_t generation{0};
+    std::chrono::steady_clock::time_point publishedAt;
+    // Bytes of the nodes no other live state shares
+    uint64_t uniqueBytes{0};
+    // Holders that took their reference through hold()
+    std::vector<std::string> holders;
+  };
+
+  struct Summary {
+    // Live generations, oldest first
+    std::vector<GenerationInfo> generations;
+    // Bytes of all nodes of the live states, shared nodes counted once
+    uint64_t totalBytes{0};
+  };
+
+  /*
+   * Track a newly published state. States published again, e.g. when the
+   * applied and desired states are the same, are only tracked once.
+   */
+  void published(const std::shared_ptr<SwitchState>& state);
+
+  /*
+   * Return a reference to state attributed to holder. The state stays
+   * attributed to holder until all copies of the returned pointer are gone.
+   * If release is set, it is called when the holder should drop its
+   * reference as the state is too old. release may be called from any
+   * thread publishing states.
+   */
+  std::shared_ptr<SwitchState> hold(
+      const std::shared_ptr<SwitchState>& state,
+      const std::string& holder,
+      std::function<void()> release = nullptr);
+
+  /*
+   * Walk the live states and account the bytes of their nodes. This is a
+   * walk of every node of the newest state, the result is reused until the
+   * set of live states changes. Meant for on demand queries, not for
+   * periodic stats.
+   */
+  Summary getSummary() const;
+
+  size_t numLiveGenerations() const;
+
+  // Publish the fb303 counters that do not need byte accounting
+  void updateStats() const;
+
+ private:
+  struct Hold {
+    std::shared_ptr<SwitchState> state;
+    std::string holder;
+    std::function<void()> release;
+  };
+
+  struct Entry {
+    // Tells apart states allocated at the address of an expired one
+    uint64_t id{0};
+    std::weak_ptr<SwitchState> state;
+    const SwitchState* statePtr{nullptr};
+    uint32_t generation{0};
+    std::chrono::steady_clock::time_point publishedAt;
+    std::vector<std::weak_ptr<Hold>> holds;
+  };
+
+  struct BytesCache {
+    // Ids of the live states the bytes were computed for, oldest first
+    std::vector<uint64_t> ids;
+    std::vector<uint64_t> uniqueBytes;
+    uint64_t totalBytes{0};
+  };
+
+  // Live generations without byte accounting. If states is set, it gets the
+  // live states and ids their entry ids, both oldest first.
+  Summary getGenerations(
+      std::vector<std::shared_ptr<SwitchState>>* states = nullptr,
+      std::vector<uint64_t>* ids = nullptr) const;
+
+  // Drop expired states and holds. Called with entries_ locked.
+  static void prune(std::deque<Entry>* entries);
+
+  // Find the entry tracking state, adding one if there is none
+  Entry& getEntry(
+      std::deque<Entry>* entries,
+      const std::shared_ptr<SwitchState>& state);
+
+  static BytesCache computeBytes(
+      const std::vector<std::shared_ptr<SwitchState>>& states);
+
+  // Tracked states, oldest first
+  folly::Synchronized<std::deque<Entry>> entries_;
+  // Only accessed with entries_ locked
+  uint64_t nextId_{0};
+  mutable folly::Synchronized<BytesCache> bytesCache_;
+};
+
+} // namespace facebook::fboss
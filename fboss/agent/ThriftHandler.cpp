@@ -19,6 +19,7 @@
 #include "fboss/agent/NeighborUpdater.h"
 #include "fboss/agent/RouteUpdateLogger.h"
 #include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/SwitchStateHistory.h"
 #include "fboss/agent/SwitchStats.h"
 #include "fboss/agent/TxPacket.h"
 #include "fboss/agent/Utils.h"
@@ -49,6 +50,7 @@
 #include "fboss/agent/state/Vlan.h"
 #include "fboss/agent/state/VlanMap.h"
 #include "fboss/lib/LogThriftCall.h"
+#include "fboss/lib/StageTracer.h"
 
 #include <fb303/ServiceData.h>
 #include <folly/IPAddressV4.h>
@@ -611,6 +613,7 @@ void ThriftHandler::deleteUnicastRoutesInVrf(
   auto log = LOG_THRIFT_CALL(DBG1);
   ensureConfigured(__func__);
   ensureFibSynced(__func__);
+  ScopedStageTrace trace(sw_->getRouteUpdateTracer(), "delete unicast route");
 
   if (sw_->isStandaloneRibEnabled()) {
     auto routerID = RouterID(vrf);
@@ -704,6 +707,7 @@ void ThriftHandler::updateUnicastRoutesImpl(
     const std::unique_ptr<std::vector<UnicastRoute>>& routes,
     const std::string& updType,
     bool sync) {
+  ScopedStageTrace trace(sw_->getRouteUpdateTracer(), updType);
   if (sw_->isStandaloneRibEnabled()) {
     auto routerID = RouterID(vrf);
     auto clientID = ClientID(client);
@@ -1490,6 +1494,54 @@ void ThriftHandler::getMplsRouteUpdateLoggingTrackedLabels(
   }
 }
 
+void ThriftHandler::getRouteUpdateTraces(
+    std::vector<RouteUpdateTrace>& traces,
+    int32_t count) {
+  auto log = LOG_THRIFT_CALL(DBG1, count);
+  ensureConfigured(__func__);
+  if (count <= 0) {
+    return;
+  }
+  for (const auto& trace :
+       sw_->getRouteUpdateTracer()->getRecentTraces(count)) {
+    RouteUpdateTrace traceThrift;
+    *traceThrift.id_ref() = trace->getID();
+    *traceThrift.name_ref() = trace->getName();
+    *traceThrift.startTimeUs_ref() =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            trace->getStartTime().time_since_epoch())
+            .count();
+    auto stages = trace->getStages();
+    for (const auto& stage : stages) {
+      RouteUpdateTraceStage stageThrift;
+      *stageThrift.name_ref() = stage.name;
+      *stageThrift.elapsedUs_ref() =
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              stage.time - stages.front().time)
+              .count();
+      traceThrift.stages_ref()->push_back(std::move(stageThrift));
+    }
+    traces.push_back(std::move(traceThrift));
+  }
+}
+
+void ThriftHandler::getSwitchStateGenerations(
+    std::vector<SwitchStateGenerationInfo>& generations) {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  auto now = std::chrono::steady_clock::now();
+  for (const auto& generation :
+       sw_->getStateHistory()->getSummary().generations) {
+    SwitchStateGenerationInfo info;
+    *info.generation_ref() = generation.generation;
+    *info.ageMs_ref() = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            now - generation.publishedAt)
+                            .count();
+    *info.uniqueBytes_ref() = generation.uniqueBytes;
+    *info.holders_ref() = generation.holders;
+    generations.push_back(std::move(info));
+  }
+}
+
 void ThriftHandler::sendPkt(
     int32_t port,
     int32_t vlan,
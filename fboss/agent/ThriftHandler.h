@@ -233,6 +233,13 @@ class ThriftHandler : virtual public FbossCtrlSvIf,
   void getMplsRouteUpdateLoggingTrackedLabels(
       std::vector<MplsRouteUpdateLoggingInfo>& infos) override;
 
+  void getRouteUpdateTraces(
+      std::vector<RouteUpdateTrace>& traces,
+      int32_t count) override;
+
+  void getSwitchStateGenerations(
+      std::vector<SwitchStateGenerationInfo>& generations) override;
+
   /*
    * Event handler for when a connection is destroyed.  When there is an ongoing
    * duplex connection, there may be other threads that depend on the connection
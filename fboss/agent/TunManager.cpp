@@ -24,6 +24,7 @@ extern "C" {
 #include <folly/logging/xlog.h>
 #include "fboss/agent/NlError.h"
 #include "fboss/agent/RxPacket.h"
+#include "fboss/agent/SwitchStateHistory.h"
 #include "fboss/agent/SysError.h"
 #include "fboss/agent/TunIntf.h"
 #include "fboss/agent/state/Interface.h"
@@ -80,9 +81,42 @@ void TunManager::stateUpdated(const StateDelta& delta) {
   // not have to worry about waiting to listen to updates until the
   // SwSwitch is in the configured state. t4155406 should also help
   // with that.
+  //
+  // Still, only the interfaces and the ports and vlans that make up their
+  // status are looked at, so nothing else can change the outcome of a sync.
+  // The first update after registering is always synced, since the host may
+  // be out of date with the state as it was then.
+  const auto& summary = delta.getSummary();
+  if (syncScheduled_ &&
+      !summary.anyChanged(
+          StateDeltaSummary::INTERFACES,
+          StateDeltaSummary::PORTS,
+          StateDeltaSummary::VLANS)) {
+    return;
+  }
+  syncScheduled_ = true;
+
+  // Only the newest state needs syncing, so the queued syncs share one slot:
+  // the first to run syncs the newest state and the others have nothing
+  // left to do. If the host is slow and the state gets too old, sync the
+  // current state instead of holding on to it.
+  *pendingSyncState_.wlock() = sw_->getStateHistory()->hold(
+      delta.newState(), "TunManager", [this]() {
+        auto state = sw_->getState();
+        auto pending = pendingSyncState_.wlock();
+        if (*pending) {
+          *pending = std::move(state);
+        }
+      });
+  evb_->runInEventBaseThread([this]() { syncPendingState(); });
+}
 
-  auto state = delta.newState();
-  evb_->runInEventBaseThread([this, state]() { this->sync(state); });
+void TunManager::syncPendingState() {
+  std::shared_ptr<SwitchState> state;
+  pendingSyncState_.wlock()->swap(state);
+  if (state) {
+    sync(state);
+  }
 }
 
 bool TunManager::sendPacketToHost(
@@ -9,6 +9,7 @@
  */
 #pragma once
 
+#include <folly/Synchronized.h>
 #include <folly/io/async/EventBase.h>
 #include "fboss/agent/StateObserver.h"
 #include "fboss/agent/state/Interface.h"
@@ -90,6 +91,9 @@ class TunManager : public StateObserver {
   void stop() const;
   void start() const;
 
+  // Sync the newest state a sync was scheduled for, if any
+  void syncPendingState();
+
   /**
    * Add a TUN interface. It can happen two ways
    * 1. During probe process when we discover existing Tun interface on linux
@@ -233,6 +237,13 @@ class TunManager : public StateObserver {
   // from sw_
   bool observingState_{false};
 
+  // Whether a sync was scheduled since we started listening to state
+  // updates. Only accessed from the update thread.
+  bool syncScheduled_{false};
+
+  // The newest state a sync was scheduled for, if not synced yet
+  folly::Synchronized<std::shared_ptr<SwitchState>> pendingSyncState_;
+
   // Initial probe done
   bool probeDone_{false};
 
@@ -0,0 +1,71 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/TxPacketTemplates.h"
+
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/TxPacket.h"
+
+#include <folly/hash/Hash.h>
+
+#include <cstring>
+
+namespace {
+// Templates are keyed on interface addresses, so there are few of them. Cap
+// them anyway in case interfaces keep changing.
+auto constexpr kMaxTemplates = 4096;
+} // namespace
+
+namespace facebook::fboss {
+
+TxPacketTemplates::TxPacketTemplates(SwSwitch* sw) : sw_(sw) {}
+
+size_t TxPacketTemplates::KeyHash::operator()(const Key& key) const {
+  return folly::hash::hash_combine(
+      static_cast<uint8_t>(key.kind),
+      static_cast<uint16_t>(key.vlan),
+      key.srcMac.u64NBO(),
+      key.srcIP.hash());
+}
+
+void TxPacketTemplates::copyTemplate(const folly::IOBuf& frame, TxPacket* pkt)
+    const {
+  CHECK_EQ(frame.length(), pkt->buf()->length());
+  std::memcpy(pkt->buf()->writableData(), frame.data(), frame.length());
+}
+
+std::unique_ptr<TxPacket> TxPacketTemplates::allocatePacket(
+    const Key& key,
+    uint32_t length,
+    folly::FunctionRef<void(folly::io::RWPrivateCursor*)> render) {
+  auto pkt = sw_->allocatePacket(length);
+  {
+    auto templates = templates_.rlock();
+    auto it = templates->find(key);
+    if (it != templates->end()) {
+      copyTemplate(*it->second, pkt.get());
+      return pkt;
+    }
+  }
+
+  auto frame = folly::IOBuf::create(length);
+  frame->append(length);
+  folly::io::RWPrivateCursor cursor(frame.get());
+  render(&cursor);
+  copyTemplate(*frame, pkt.get());
+
+  auto templates = templates_.wlock();
+  if (templates->size() >= kMaxTemplates) {
+    templates->clear();
+  }
+  templates->emplace(key, std::move(frame));
+  return pkt;
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,96 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/agent/types.h"
+
+#include <folly/Function.h>
+#include <folly/IPAddress.h>
+#include <folly/MacAddress.h>
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBuf.h>
+
+#include <memory>
+
+namespace facebook::fboss {
+
+class SwSwitch;
+class TxPacket;
+
+/*
+ * Pre-rendered control plane frames, so that frames which only differ in a
+ * few fields (ARP requests and neighbor solicitations sent from the same
+ * interface) are built with a memcpy of the template rather than being
+ * serialized field by field.
+ *
+ * Templates are rendered the first time a frame is sent for a given key,
+ * and keyed on everything which is constant in them, so they never go stale.
+ * Callers patch the variable fields into the returned packet.
+ *
+ * Thread safe, frames are sent from the RX, update and neighbor threads.
+ *
+ * Other senders still serialize their frames, as little of them is constant:
+ * ICMPv4 errors quote the offending packet, LLDP frames go out once per port
+ * per interval, and PktFactory builds test frames from the HwSwitch.
+ */
+class TxPacketTemplates {
+ public:
+  enum class Kind : uint8_t {
+    ARP,
+    NDP_NEIGHBOR_SOLICITATION,
+  };
+
+  struct Key {
+    Kind kind;
+    VlanID vlan;
+    folly::MacAddress srcMac;
+    folly::IPAddress srcIP;
+
+    bool operator==(const Key& other) const {
+      return kind == other.kind && vlan == other.vlan &&
+          srcMac == other.srcMac && srcIP == other.srcIP;
+    }
+  };
+
+  explicit TxPacketTemplates(SwSwitch* sw);
+
+  /*
+   * Allocate a packet of the given length, filled in from the template for
+   * key. render() writes the template frame if there is none yet.
+   */
+  std::unique_ptr<TxPacket> allocatePacket(
+      const Key& key,
+      uint32_t length,
+      folly::FunctionRef<void(folly::io::RWPrivateCursor*)> render);
+
+  size_t numTemplates() const {
+    return templates_.rlock()->size();
+  }
+
+ private:
+  // Forbidden copy constructor and assignment operator
+  TxPacketTemplates(TxPacketTemplates const&) = delete;
+  TxPacketTemplates& operator=(TxPacketTemplates const&) = delete;
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+  using TemplateMap =
+      folly::F14FastMap<Key, std::unique_ptr<folly::IOBuf>, KeyHash>;
+
+  void copyTemplate(const folly::IOBuf& frame, TxPacket* pkt) const;
+
+  SwSwitch* sw_{nullptr};
+  folly::Synchronized<TemplateMap> templates_;
+};
+
+} // namespace facebook::fboss
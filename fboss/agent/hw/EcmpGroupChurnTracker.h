@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include "fboss/agent/hw/HwSwitchStats.h"
+
+#include <glog/logging.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * EcmpGroupChurnTracker follows the ECMP groups of a HwSwitch while the
+ * routes of a state delta are programmed, to keep the groups routes move to
+ * alive and to count the groups which were transient.
+ *
+ * Routes reference ECMP groups by their next hop set, and a group is freed
+ * once no route references it. Programming routes one by one can then free a
+ * group and create it again, e.g. when the last route on a set is removed
+ * before others move to it, and the new group takes an ECMP table entry
+ * while the groups the routes leave still hold theirs. To avoid this the
+ * HwSwitch pins the existing groups the routes of a delta move to for the
+ * whole pass. A group created during a pass is transient if it had to be
+ * created again later in the pass, or if no route references it anymore
+ * when the pass ends.
+ *
+ * Passes may overlap, e.g. when the routes of VRFs are programmed
+ * concurrently, and the groups are only released and counted at the end of
+ * the last one. Not thread safe, meant to be called with the HwSwitch lock
+ * held.
+ */
+template <typename KeyT, typename GroupT>
+class EcmpGroupChurnTracker {
+ public:
+  void beginPass() {
+    ++numPasses_;
+  }
+
+  void endPass(HwSwitchStats* stats) {
+    CHECK_GT(numPasses_, 0);
+    if (--numPasses_ > 0) {
+      return;
+    }
+    pins_.clear();
+    for (const auto& keyAndGroup : seen_) {
+      const auto& seen = keyAndGroup.second;
+      if (seen.created && seen.group.expired()) {
+        stats->ecmpGroupTransient();
+      }
+    }
+    seen_.clear();
+  }
+
+  /*
+   * Keep an existing group alive until the end of the pass, as routes of the
+   * pass move to it.
+   */
+  void pin(const KeyT& key, std::shared_ptr<GroupT> group) {
+    CHECK_GT(numPasses_, 0);
+    seen_.emplace(key, Seen{group, false});
+    pins_.push_back(std::move(group));
+  }
+
+  void created(
+      const KeyT& key,
+      const std::shared_ptr<GroupT>& group,
+      HwSwitchStats* stats) {
+    stats->ecmpGroupCreated();
+    if (numPasses_ == 0) {
+      return;
+    }
+    auto ins = seen_.emplace(key, Seen{group, true});
+    if (!ins.second) {
+      // The group for this key was freed earlier in the pass
+      stats->ecmpGroupTransient();
+      ins.first->second = Seen{group, true};
+    }
+  }
+
+ private:
+  struct Seen {
+    std::weak_ptr<GroupT> group;
+    // Whether the group was created during the pass
+    bool created;
+  };
+
+  int numPasses_{0};
+  std::map<KeyT, Seen> seen_;
+  std::vector<std::shared_ptr<GroupT>> pins_;
+};
+
+} // namespace facebook::fboss
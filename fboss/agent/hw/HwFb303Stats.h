@@ -36,14 +36,17 @@ class HwFb303Stats {
       int64_t val);
   void removeStat(const std::string& statName);
 
- private:
   /*
-   * Update queue stat
+   * Counter handle for callers updating stats in a hot loop. The handle
+   * stays valid until the stat is reinitialized or removed.
    */
   stats::MonotonicCounter* getCounterIf(const std::string& statName);
+
+ private:
   const stats::MonotonicCounter* getCounterIf(
       const std::string& statName) const;
 
-  folly::F14FastMap<std::string, stats::MonotonicCounter> counters_;
+  // Node map, since we hand out pointers to counters
+  folly::F14NodeMap<std::string, stats::MonotonicCounter> counters_;
 };
 } // namespace facebook::fboss
@@ -16,7 +16,55 @@
 
 namespace facebook::fboss {
 
-std::array<folly::StringPiece, 22> HwPortFb303Stats::kPortStatKeys() {
+namespace {
+/*
+ * Port stat values, in kPortStatKeys() order
+ */
+std::array<int64_t, HwPortFb303Stats::kNumPortStats> portStatValues(
+    const HwPortStats& stats) {
+  return {
+      *stats.inBytes__ref(),
+      *stats.inUnicastPkts__ref(),
+      *stats.inMulticastPkts__ref(),
+      *stats.inBroadcastPkts__ref(),
+      *stats.inDiscards__ref(),
+      *stats.inErrors__ref(),
+      *stats.inPause__ref(),
+      *stats.inIpv4HdrErrors__ref(),
+      *stats.inIpv6HdrErrors__ref(),
+      *stats.inDstNullDiscards__ref(),
+      *stats.inDiscardsRaw__ref(),
+      *stats.outBytes__ref(),
+      *stats.outUnicastPkts__ref(),
+      *stats.outMulticastPkts__ref(),
+      *stats.outBroadcastPkts__ref(),
+      *stats.outDiscards__ref(),
+      *stats.outErrors__ref(),
+      *stats.outPause__ref(),
+      *stats.outCongestionDiscardPkts__ref(),
+      *stats.outEcnCounter__ref(),
+      *stats.fecCorrectableErrors_ref(),
+      *stats.fecUncorrectableErrors_ref(),
+  };
+}
+
+/*
+ * Per queue stat values, in kQueueStatKeys() order
+ */
+std::array<
+    const std::map<int16_t, int64_t>*,
+    HwPortFb303Stats::kNumQueueStats>
+queueStatValues(const HwPortStats& stats) {
+  return {
+      &*stats.queueOutDiscardBytes__ref(),
+      &*stats.queueOutBytes__ref(),
+      &*stats.queueOutPackets__ref(),
+  };
+}
+} // namespace
+
+std::array<folly::StringPiece, HwPortFb303Stats::kNumPortStats>
+HwPortFb303Stats::kPortStatKeys() {
   return {
       kInBytes(),
       kInUnicastPkts(),
@@ -43,7 +91,8 @@ std::array<folly::StringPiece, 22> HwPortFb303Stats::kPortStatKeys() {
   };
 }
 
-std::array<folly::StringPiece, 3> HwPortFb303Stats::kQueueStatKeys() {
+std::array<folly::StringPiece, HwPortFb303Stats::kNumQueueStats>
+HwPortFb303Stats::kQueueStatKeys() {
   return {kOutCongestionDiscards(), kOutBytes(), kOutPkts()};
 }
 
@@ -87,6 +136,30 @@ void HwPortFb303Stats::reinitStats(std::optional<std::string> oldPortName) {
       portCounters_.reinitStat(newStatName, oldStatName);
     }
   }
+  resolveCounters();
+}
+
+void HwPortFb303Stats::resolveCounters() {
+  auto portStatKeys = kPortStatKeys();
+  for (auto i = 0; i < kNumPortStats; ++i) {
+    portCounterHandles_[i] =
+        portCounters_.getCounterIf(statName(portStatKeys[i], portName_));
+    CHECK(portCounterHandles_[i]);
+  }
+  auto queueStatKeys = kQueueStatKeys();
+  queueCounterHandles_.clear();
+  for (const auto& queueIdAndName : queueId2Name_) {
+    QueueCounters queueCounters{queueIdAndName.first, {}};
+    for (auto i = 0; i < kNumQueueStats; ++i) {
+      queueCounters.counters[i] = portCounters_.getCounterIf(statName(
+          queueStatKeys[i],
+          portName_,
+          queueIdAndName.first,
+          queueIdAndName.second));
+      CHECK(queueCounters.counters[i]);
+    }
+    queueCounterHandles_.push_back(queueCounters);
+  }
 }
 
 /*
@@ -125,6 +198,7 @@ void HwPortFb303Stats::queueChanged(int queueId, const std::string& queueName) {
   for (auto statKey : kQueueStatKeys()) {
     reinitStat(statKey, queueId, oldQueueName);
   }
+  resolveCounters();
 }
 
 void HwPortFb303Stats::queueRemoved(int queueId) {
@@ -134,100 +208,30 @@ void HwPortFb303Stats::queueRemoved(int queueId) {
         statName(statKey, portName_, queueId, queueId2Name_[queueId]));
   }
   queueId2Name_.erase(queueId);
+  resolveCounters();
 }
 
 void HwPortFb303Stats::updateStats(
     const HwPortStats& curPortStats,
     const std::chrono::seconds& retrievedAt) {
   timeRetrieved_ = retrievedAt;
-  updateStat(timeRetrieved_, kInBytes(), *curPortStats.inBytes__ref());
-  updateStat(
-      timeRetrieved_, kInUnicastPkts(), *curPortStats.inUnicastPkts__ref());
-  updateStat(
-      timeRetrieved_, kInMulticastPkts(), *curPortStats.inMulticastPkts__ref());
-  updateStat(
-      timeRetrieved_, kInBroadcastPkts(), *curPortStats.inBroadcastPkts__ref());
-  updateStat(
-      timeRetrieved_, kInDiscardsRaw(), *curPortStats.inDiscardsRaw__ref());
-  updateStat(timeRetrieved_, kInDiscards(), *curPortStats.inDiscards__ref());
-  updateStat(timeRetrieved_, kInErrors(), *curPortStats.inErrors__ref());
-  updateStat(timeRetrieved_, kInPause(), *curPortStats.inPause__ref());
-  updateStat(
-      timeRetrieved_, kInIpv4HdrErrors(), *curPortStats.inIpv4HdrErrors__ref());
-  updateStat(
-      timeRetrieved_, kInIpv6HdrErrors(), *curPortStats.inIpv6HdrErrors__ref());
-  updateStat(
-      timeRetrieved_,
-      kInDstNullDiscards(),
-      *curPortStats.inDstNullDiscards__ref());
-  // Egress Stats
-  updateStat(timeRetrieved_, kOutBytes(), *curPortStats.outBytes__ref());
-  updateStat(
-      timeRetrieved_, kOutUnicastPkts(), *curPortStats.outUnicastPkts__ref());
-  updateStat(
-      timeRetrieved_,
-      kOutMulticastPkts(),
-      *curPortStats.outMulticastPkts__ref());
-  updateStat(
-      timeRetrieved_,
-      kOutBroadcastPkts(),
-      *curPortStats.outBroadcastPkts__ref());
-  updateStat(timeRetrieved_, kOutDiscards(), *curPortStats.outDiscards__ref());
-  updateStat(timeRetrieved_, kOutErrors(), *curPortStats.outErrors__ref());
-  updateStat(timeRetrieved_, kOutPause(), *curPortStats.outPause__ref());
-  updateStat(
-      timeRetrieved_,
-      kOutCongestionDiscards(),
-      *curPortStats.outCongestionDiscardPkts__ref());
-  updateStat(
-      timeRetrieved_, kOutEcnCounter(), *curPortStats.outEcnCounter__ref());
-  updateStat(
-      timeRetrieved_,
-      kFecCorrectable(),
-      *curPortStats.fecCorrectableErrors_ref());
-  updateStat(
-      timeRetrieved_,
-      kFecUncorrectable(),
-      *curPortStats.fecUncorrectableErrors_ref());
+  auto portValues = portStatValues(curPortStats);
+  for (auto i = 0; i < kNumPortStats; ++i) {
+    portCounterHandles_[i]->updateValue(timeRetrieved_, portValues[i]);
+  }
 
   // Update queue stats
-  auto updateQueueStat = [this](
-                             folly::StringPiece statKey,
-                             int queueId,
-                             const std::map<int16_t, int64_t>& queueStats) {
-    auto qitr = queueStats.find(queueId);
-    CHECK(qitr != queueStats.end())
-        << "Missing stat: " << statKey
-        << " for queue: :" << queueId2Name_[queueId];
-    updateStat(timeRetrieved_, statKey, queueId, qitr->second);
-  };
-  for (const auto& queueIdAndName : queueId2Name_) {
-    updateQueueStat(
-        kOutCongestionDiscards(),
-        queueIdAndName.first,
-        *curPortStats.queueOutDiscardBytes__ref());
-    updateQueueStat(
-        kOutBytes(), queueIdAndName.first, *curPortStats.queueOutBytes__ref());
-    updateQueueStat(
-        kOutPkts(), queueIdAndName.first, *curPortStats.queueOutPackets__ref());
+  auto queueValues = queueStatValues(curPortStats);
+  for (const auto& queueCounters : queueCounterHandles_) {
+    for (auto i = 0; i < kNumQueueStats; ++i) {
+      auto qitr = queueValues[i]->find(queueCounters.queueId);
+      CHECK(qitr != queueValues[i]->end())
+          << "Missing stat: " << kQueueStatKeys()[i]
+          << " for queue: :" << queueId2Name_[queueCounters.queueId];
+      queueCounters.counters[i]->updateValue(timeRetrieved_, qitr->second);
+    }
   }
   updateQueueWatermarkStats(*curPortStats.queueWatermarkBytes__ref());
   portStats_ = curPortStats;
 }
-
-void HwPortFb303Stats::updateStat(
-    const std::chrono::seconds& now,
-    folly::StringPiece statKey,
-    int queueId,
-    int64_t val) {
-  portCounters_.updateStat(
-      now, statName(statKey, portName_, queueId, queueId2Name_[queueId]), val);
-}
-
-void HwPortFb303Stats::updateStat(
-    const std::chrono::seconds& now,
-    folly::StringPiece statKey,
-    int64_t val) {
-  portCounters_.updateStat(now, statName(statKey, portName_), val);
-}
 } // namespace facebook::fboss
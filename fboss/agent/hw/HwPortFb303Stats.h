@@ -15,8 +15,10 @@
 
 #include "folly/container/F14Map.h"
 
+#include <array>
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace facebook::fboss {
 
@@ -70,8 +72,10 @@ class HwPortFb303Stats {
       int queueId,
       folly::StringPiece queueName);
 
-  static std::array<folly::StringPiece, 22> kPortStatKeys();
-  static std::array<folly::StringPiece, 3> kQueueStatKeys();
+  static auto constexpr kNumPortStats = 22;
+  static auto constexpr kNumQueueStats = 3;
+  static std::array<folly::StringPiece, kNumPortStats> kPortStatKeys();
+  static std::array<folly::StringPiece, kNumQueueStats> kQueueStatKeys();
   int64_t getCounterLastIncrement(folly::StringPiece statKey) const;
 
  private:
@@ -98,20 +102,10 @@ class HwPortFb303Stats {
       const std::string& statName,
       std::optional<std::string> oldStatName);
   /*
-   * update port stat
+   * Look up counters for all port and queue stats. Must be called
+   * whenever a stat is (re)initialized or removed.
    */
-  void updateStat(
-      const std::chrono::seconds& now,
-      folly::StringPiece statKey,
-      int64_t val);
-  /*
-   * update port queue stat
-   */
-  void updateStat(
-      const std::chrono::seconds& now,
-      folly::StringPiece statKey,
-      int queueId,
-      int64_t val);
+  void resolveCounters();
 
   void updateQueueWatermarkStats(
       const std::map<int16_t, int64_t>& queueWatermarkBytes) const;
@@ -120,6 +114,18 @@ class HwPortFb303Stats {
   HwFb303Stats portCounters_;
   QueueId2Name queueId2Name_;
   HwPortStats portStats_;
+
+  /*
+   * Counters pre-resolved by resolveCounters(), so that updateStats does not
+   * build and hash stat names on every collection. Port counters are indexed
+   * like kPortStatKeys(), queue counters like kQueueStatKeys().
+   */
+  struct QueueCounters {
+    int queueId;
+    std::array<stats::MonotonicCounter*, kNumQueueStats> counters;
+  };
+  std::array<stats::MonotonicCounter*, kNumPortStats> portCounterHandles_{};
+  std::vector<QueueCounters> queueCounterHandles_;
 };
 
 } // namespace facebook::fboss
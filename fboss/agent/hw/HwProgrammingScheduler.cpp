@@ -0,0 +1,112 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/HwProgrammingScheduler.h"
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <folly/futures/Future.h>
+#include <folly/futures/SharedPromise.h>
+#include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
+
+#include <chrono>
+
+DEFINE_int32(
+    hw_programming_threads,
+    0,
+    "Number of threads used to program independent parts of a state delta "
+    "to hardware concurrently. 0 programs them serially on the update thread");
+
+namespace facebook::fboss {
+
+namespace {
+
+void runStep(const std::string& name, const std::function<void()>& fn) {
+  auto begin = std::chrono::steady_clock::now();
+  fn();
+  XLOG(DBG4) << "Programming " << name << " took "
+             << std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - begin)
+                    .count()
+             << "us";
+}
+
+} // namespace
+
+HwProgrammingScheduler::StepID HwProgrammingScheduler::add(
+    std::string name,
+    std::function<void()> fn,
+    std::vector<StepID> deps) {
+  StepID id = steps_.size();
+  for (auto dep : deps) {
+    CHECK_LT(dep, id) << name << " depends on a step added after it";
+  }
+  steps_.push_back({std::move(name), std::move(fn), std::move(deps)});
+  return id;
+}
+
+void HwProgrammingScheduler::run() {
+  if (!executor_ || steps_.size() <= 1) {
+    runSerial();
+  } else {
+    runConcurrent();
+  }
+}
+
+void HwProgrammingScheduler::runSerial() {
+  for (const auto& step : steps_) {
+    runStep(step.name, step.fn);
+  }
+}
+
+void HwProgrammingScheduler::runConcurrent() {
+  // Fulfilled once the step is done, or with the exception of the step or
+  // of the first of its dependencies to fail
+  std::vector<folly::SharedPromise<folly::Unit>> done(steps_.size());
+  std::vector<folly::SemiFuture<folly::Unit>> results;
+  results.reserve(steps_.size());
+  for (StepID id = 0; id < steps_.size(); ++id) {
+    const auto& step = steps_[id];
+    std::vector<folly::SemiFuture<folly::Unit>> deps;
+    deps.reserve(step.deps.size());
+    for (auto dep : step.deps) {
+      deps.push_back(done[dep].getSemiFuture());
+    }
+    results.push_back(done[id].getSemiFuture());
+    folly::collect(std::move(deps))
+        .via(executor_)
+        .thenValue([&step](auto&&) { runStep(step.name, step.fn); })
+        .thenTry([&promise = done[id]](folly::Try<folly::Unit>&& result) {
+          promise.setTry(std::move(result));
+        });
+  }
+
+  // Steps skipped for a failed dependency carry its exception, and depend
+  // only on steps added before them, so the first failure in add order is
+  // always the exception of a step that ran
+  for (auto& result : folly::collectAll(std::move(results)).get()) {
+    if (result.hasException()) {
+      result.exception().throw_exception();
+    }
+  }
+}
+
+std::unique_ptr<folly::Executor> HwProgrammingScheduler::createExecutor(
+    folly::StringPiece name) {
+  if (FLAGS_hw_programming_threads <= 0) {
+    return nullptr;
+  }
+  return std::make_unique<folly::CPUThreadPoolExecutor>(
+      FLAGS_hw_programming_threads,
+      std::make_shared<folly::NamedThreadFactory>(name));
+}
+
+} // namespace facebook::fboss
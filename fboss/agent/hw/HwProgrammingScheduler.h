@@ -0,0 +1,93 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include <folly/Range.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace folly {
+class Executor;
+} // namespace folly
+
+namespace facebook::fboss {
+
+/*
+ * HwProgrammingScheduler runs the steps a HwSwitch takes to program a state
+ * delta, e.g. the ACL changes or the neighbor changes of a VLAN, as a
+ * dependency graph.
+ *
+ * A step runs once all the steps it depends on are done. Since a step can
+ * only depend on steps added before it, the order steps are added in is a
+ * valid serial order. Without an executor they all run in that order on the
+ * caller thread, exactly as a plain sequence of calls would. With one, steps
+ * whose dependencies are done run concurrently on the executor.
+ *
+ * Concurrent steps must be safe to run together: they may only share
+ * objects which are synchronized, e.g. by taking the HwSwitch lock around
+ * each programmed object. Reading the state delta is always safe, states
+ * are immutable once published.
+ *
+ * Not thread safe, meant to be built and run by the thread programming the
+ * delta.
+ */
+class HwProgrammingScheduler {
+ public:
+  using StepID = size_t;
+
+  explicit HwProgrammingScheduler(folly::Executor* executor = nullptr)
+      : executor_(executor) {}
+
+  /*
+   * Add a step which runs after all of the deps are done. The step does
+   * not run if one of its dependencies failed.
+   */
+  StepID add(
+      std::string name,
+      std::function<void()> fn,
+      std::vector<StepID> deps = {});
+
+  /*
+   * Run all steps, returning once they are done. If steps failed, rethrows
+   * the exception of the first failed step in the order steps were added.
+   */
+  void run();
+
+  size_t numSteps() const {
+    return steps_.size();
+  }
+
+  /*
+   * Executor to program independent steps on, as configured by the
+   * hw_programming_threads flag. Returns nullptr, for serial programming,
+   * if it is 0.
+   */
+  static std::unique_ptr<folly::Executor> createExecutor(
+      folly::StringPiece name);
+
+ private:
+  struct Step {
+    std::string name;
+    std::function<void()> fn;
+    std::vector<StepID> deps;
+  };
+
+  void runSerial();
+  void runConcurrent();
+
+  folly::Executor* executor_;
+  std::vector<Step> steps_;
+};
+
+} // namespace facebook::fboss
@@ -0,0 +1,159 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/HwStatsScheduler.h"
+
+#include <fb303/ServiceData.h>
+#include <folly/Conv.h>
+#include <folly/hash/Hash.h>
+#include <gflags/gflags.h>
+
+#include <algorithm>
+
+DEFINE_int32(
+    hw_stats_port_counters_interval_s,
+    0,
+    "Interval in seconds for collecting port and queue byte/packet counters, "
+    "0 to collect on every stats collection");
+DEFINE_int32(
+    hw_stats_port_errors_interval_s,
+    10,
+    "Interval in seconds for collecting port error, discard and FEC "
+    "counters, spread across ports");
+DEFINE_int32(
+    hw_stats_prbs_interval_s,
+    10,
+    "Interval in seconds for collecting PRBS stats");
+DEFINE_int32(
+    hw_stats_trunks_interval_s,
+    0,
+    "Interval in seconds for collecting trunk stats");
+DEFINE_int32(
+    hw_stats_acls_interval_s,
+    0,
+    "Interval in seconds for collecting ACL counters");
+DEFINE_int32(
+    hw_stats_buffers_interval_s,
+    0,
+    "Interval in seconds for collecting buffer stats and watermarks");
+DEFINE_int32(
+    hw_stats_cpu_interval_s,
+    0,
+    "Interval in seconds for collecting CPU port queue stats");
+DEFINE_int32(
+    hw_stats_resources_interval_s,
+    0,
+    "Interval in seconds for publishing HW resource stats");
+
+namespace facebook::fboss {
+
+void HwStatsScheduler::startRound(std::chrono::steady_clock::time_point now) {
+  now_ = std::chrono::duration_cast<std::chrono::seconds>(
+      now.time_since_epoch());
+}
+
+bool HwStatsScheduler::isDue(HwStatsCategory category) {
+  auto& last = lastCollected_[index(category)];
+  if (last && now_ - *last < getInterval(category)) {
+    return false;
+  }
+  last = now_;
+  return true;
+}
+
+bool HwStatsScheduler::isDue(HwStatsCategory category, int64_t key) {
+  auto interval = getInterval(category).count();
+  auto& lastCollected = lastKeyCollected_[index(category)];
+  auto it = lastCollected.find(key);
+  if (interval > 1 && it != lastCollected.end()) {
+    // Collect once every time now + phase crosses a multiple of the
+    // interval. The phase is fixed per key, so keys are spread across the
+    // interval rather than all becoming due on the same round.
+    uint64_t phase =
+        folly::hash::twang_mix64(static_cast<uint64_t>(key)) % interval;
+    auto bucket = [interval, phase](std::chrono::seconds t) {
+      return (static_cast<uint64_t>(t.count()) + phase) / interval;
+    };
+    if (bucket(now_) == bucket(it->second)) {
+      return false;
+    }
+  }
+  lastCollected[key] = now_;
+  return true;
+}
+
+void HwStatsScheduler::collectionDone(
+    HwStatsCategory category,
+    std::chrono::microseconds elapsed) {
+  fb303::fbData->addStatValue(
+      folly::to<std::string>(
+          "hw.stats.", categoryName(category), ".collection_us"),
+      elapsed.count(),
+      fb303::AVG);
+}
+
+std::chrono::seconds HwStatsScheduler::getInterval(HwStatsCategory category) {
+  int32_t interval = 0;
+  switch (category) {
+    case HwStatsCategory::PORT_COUNTERS:
+      interval = FLAGS_hw_stats_port_counters_interval_s;
+      break;
+    case HwStatsCategory::PORT_ERRORS:
+      interval = FLAGS_hw_stats_port_errors_interval_s;
+      break;
+    case HwStatsCategory::PRBS:
+      interval = FLAGS_hw_stats_prbs_interval_s;
+      break;
+    case HwStatsCategory::TRUNKS:
+      interval = FLAGS_hw_stats_trunks_interval_s;
+      break;
+    case HwStatsCategory::ACLS:
+      interval = FLAGS_hw_stats_acls_interval_s;
+      break;
+    case HwStatsCategory::BUFFERS:
+      interval = FLAGS_hw_stats_buffers_interval_s;
+      break;
+    case HwStatsCategory::CPU:
+      interval = FLAGS_hw_stats_cpu_interval_s;
+      break;
+    case HwStatsCategory::RESOURCES:
+      interval = FLAGS_hw_stats_resources_interval_s;
+      break;
+    case HwStatsCategory::NUM_CATEGORIES:
+      break;
+  }
+  return std::chrono::seconds(std::max(interval, 0));
+}
+
+std::string HwStatsScheduler::categoryName(HwStatsCategory category) {
+  switch (category) {
+    case HwStatsCategory::PORT_COUNTERS:
+      return "port_counters";
+    case HwStatsCategory::PORT_ERRORS:
+      return "port_errors";
+    case HwStatsCategory::PRBS:
+      return "prbs";
+    case HwStatsCategory::TRUNKS:
+      return "trunks";
+    case HwStatsCategory::ACLS:
+      return "acls";
+    case HwStatsCategory::BUFFERS:
+      return "buffers";
+    case HwStatsCategory::CPU:
+      return "cpu";
+    case HwStatsCategory::RESOURCES:
+      return "resources";
+    case HwStatsCategory::NUM_CATEGORIES:
+      break;
+  }
+  return "unknown";
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,111 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include <folly/container/F14Map.h>
+
+#include <array>
+#include <chrono>
+#include <optional>
+#include <string>
+
+namespace facebook::fboss {
+
+enum class HwStatsCategory {
+  // Port and queue byte and packet counters
+  PORT_COUNTERS,
+  // Port error, discard and FEC counters
+  PORT_ERRORS,
+  PRBS,
+  TRUNKS,
+  ACLS,
+  BUFFERS,
+  CPU,
+  RESOURCES,
+  NUM_CATEGORIES,
+};
+
+/*
+ * HwStatsScheduler decides which categories of HW stats get collected on a
+ * given stats collection round, and publishes how long each category took to
+ * collect as hw.stats.<category>.collection_us.
+ *
+ * Each category has its own interval (hw_stats_*_interval_s flags, read on
+ * every round so they can be changed at runtime). An interval of 0 or 1
+ * second means the category is collected on every round. Categories
+ * collected per port (or any other key) are spread over their interval: each
+ * key gets a fixed phase within the interval, so that only about 1/interval
+ * of the keys are collected on any given round instead of all of them on the
+ * same one.
+ *
+ * Not thread safe, meant to be owned by the HwSwitch and used from the stats
+ * collection thread.
+ */
+class HwStatsScheduler {
+ public:
+  static auto constexpr kNumCategories =
+      static_cast<size_t>(HwStatsCategory::NUM_CATEGORIES);
+
+  /*
+   * Start a collection round, all isDue() calls until the next round are
+   * evaluated against now.
+   */
+  void startRound(
+      std::chrono::steady_clock::time_point now =
+          std::chrono::steady_clock::now());
+
+  /*
+   * Whether category should be collected on this round. Returning true
+   * records the category as collected.
+   */
+  bool isDue(HwStatsCategory category);
+  bool isDue(HwStatsCategory category, int64_t key);
+
+  /*
+   * Run fn and publish its run time as the collection time for category.
+   * The collect variant only does so if the category is due.
+   */
+  template <typename Fn>
+  void timed(HwStatsCategory category, Fn&& fn) {
+    auto begin = std::chrono::steady_clock::now();
+    fn();
+    collectionDone(
+        category,
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - begin));
+  }
+  template <typename Fn>
+  void collect(HwStatsCategory category, Fn&& fn) {
+    if (isDue(category)) {
+      timed(category, std::forward<Fn>(fn));
+    }
+  }
+
+  void collectionDone(
+      HwStatsCategory category,
+      std::chrono::microseconds elapsed);
+
+  static std::chrono::seconds getInterval(HwStatsCategory category);
+  static std::string categoryName(HwStatsCategory category);
+
+ private:
+  static size_t index(HwStatsCategory category) {
+    return static_cast<size_t>(category);
+  }
+
+  std::chrono::seconds now_{0};
+  std::array<std::optional<std::chrono::seconds>, kNumCategories>
+      lastCollected_;
+  std::array<folly::F14FastMap<int64_t, std::chrono::seconds>, kNumCategories>
+      lastKeyCollected_;
+};
+
+} // namespace facebook::fboss
@@ -50,12 +50,23 @@ HwSwitchStats::HwSwitchStats(
           SwitchStats::kCounterPrefix + vendor + ".tx.pkt.allocation.errors",
           SUM,
           RATE),
+      txQueueFull_(
+          map,
+          SwitchStats::kCounterPrefix + vendor + ".tx.pkt.queue_full",
+          SUM,
+          RATE),
       txQueued_(
           map,
           SwitchStats::kCounterPrefix + vendor + ".tx.pkt.queued_us",
           100,
           0,
           1000),
+      txQueueDepth_(
+          map,
+          SwitchStats::kCounterPrefix + vendor + ".tx.queue.depth",
+          64,
+          0,
+          4096),
       parityErrors_(
           map,
           SwitchStats::kCounterPrefix + vendor + ".parity.errors",
@@ -75,5 +86,15 @@ HwSwitchStats::HwSwitchStats(
           map,
           SwitchStats::kCounterPrefix + vendor + ".asic.error",
           SUM,
+          RATE),
+      ecmpGroupsCreated_(
+          map,
+          SwitchStats::kCounterPrefix + vendor + ".ecmp.groups.created",
+          SUM,
+          RATE),
+      ecmpGroupsTransient_(
+          map,
+          SwitchStats::kCounterPrefix + vendor + ".ecmp.groups.transient",
+          SUM,
           RATE) {}
 } // namespace facebook::fboss
@@ -42,6 +42,13 @@ class HwSwitchStats {
     txErrors_.addValue(1);
     txPktAllocErrors_.addValue(1);
   }
+  void txQueueFull() {
+    txErrors_.addValue(1);
+    txQueueFull_.addValue(1);
+  }
+  void txQueueDepth(uint64_t depth) {
+    txQueueDepth_.addValue(depth);
+  }
 
   void corrParityError() {
     parityErrors_.addValue(1);
@@ -57,6 +64,13 @@ class HwSwitchStats {
     asicErrors_.addValue(1);
   }
 
+  void ecmpGroupCreated() {
+    ecmpGroupsCreated_.addValue(1);
+  }
+  void ecmpGroupTransient() {
+    ecmpGroupsTransient_.addValue(1);
+  }
+
   int64_t getTxPktAllocCount() {
     return txPktAlloc_.count();
   }
@@ -75,6 +89,9 @@ class HwSwitchStats {
   int64_t getTxPktAllocErrorsCount() {
     return txPktAllocErrors_.count();
   }
+  int64_t getTxQueueFullCount() {
+    return txQueueFull_.count();
+  }
   int64_t getCorrParityErrorCount() {
     return corrParityErrors_.count();
   }
@@ -84,6 +101,12 @@ class HwSwitchStats {
   int64_t getAsicErrorCount() {
     return asicErrors_.count();
   }
+  int64_t getEcmpGroupCreatedCount() {
+    return ecmpGroupsCreated_.count();
+  }
+  int64_t getEcmpGroupTransientCount() {
+    return ecmpGroupsTransient_.count();
+  }
 
  private:
   // Forbidden copy constructor and assignment operator
@@ -103,9 +126,13 @@ class HwSwitchStats {
   // Errors in sending packets
   TLTimeseries txErrors_;
   TLTimeseries txPktAllocErrors_;
+  // Packets dropped because the software Tx queue was full
+  TLTimeseries txQueueFull_;
 
   // Time spent for each Tx packet queued in HW
   TLHistogram txQueued_;
+  // Depth of the software Tx queue, sampled on every Tx batch
+  TLHistogram txQueueDepth_;
 
   // parity errors
   TLTimeseries parityErrors_;
@@ -114,6 +141,12 @@ class HwSwitchStats {
 
   // Other ASIC errors
   TLTimeseries asicErrors_;
+
+  // ECMP groups created while programming routes, and those of them which
+  // only lived for part of a route update, i.e. were freed and created again
+  // or created and freed within the same update
+  TLTimeseries ecmpGroupsCreated_;
+  TLTimeseries ecmpGroupsTransient_;
 };
 
 } // namespace facebook::fboss
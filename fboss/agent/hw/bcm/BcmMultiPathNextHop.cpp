@@ -75,6 +75,32 @@ long BcmMultiPathNextHopTable::getEcmpEgressCount() const {
       });
 }
 
+std::shared_ptr<BcmMultiPathNextHop>
+BcmMultiPathNextHopTable::referenceOrEmplaceNextHop(
+    const BcmMultiPathNextHopKey& key) {
+  bool exists = getNextHopIf(key) != nullptr;
+  auto nexthop = BcmMultiPathNextHopTableBase::referenceOrEmplaceNextHop(key);
+  if (!exists && nexthop->getEgress()) {
+    churnTracker_.created(key, nexthop, getBcmSwitch()->getSwitchStats());
+  }
+  return nexthop;
+}
+
+void BcmMultiPathNextHopTable::beginRouteProgramming() {
+  churnTracker_.beginPass();
+}
+
+void BcmMultiPathNextHopTable::endRouteProgramming() {
+  churnTracker_.endPass(getBcmSwitch()->getSwitchStats());
+}
+
+void BcmMultiPathNextHopTable::pinNextHop(const BcmMultiPathNextHopKey& key) {
+  auto nexthop = getNextHops().ref(key);
+  if (nexthop && nexthop->getEgress()) {
+    churnTracker_.pin(key, std::move(nexthop));
+  }
+}
+
 void BcmMultiPathNextHopTable::egressResolutionChangedHwLocked(
     const BcmEcmpEgress::EgressIdSet& affectedEgressIds,
     BcmEcmpEgress::Action action) {
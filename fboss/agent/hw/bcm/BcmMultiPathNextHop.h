@@ -7,6 +7,7 @@ extern "C" {
 #include <bcm/types.h>
 }
 
+#include "fboss/agent/hw/EcmpGroupChurnTracker.h"
 #include "fboss/agent/hw/bcm/BcmEgress.h"
 #include "fboss/agent/hw/bcm/BcmHostKey.h"
 #include "fboss/agent/hw/bcm/BcmNextHop.h"
@@ -71,6 +72,28 @@ class BcmMultiPathNextHopTable : public BcmMultiPathNextHopTableBase {
   }
 
   long getEcmpEgressCount() const;
+
+  /*
+   * Hides BcmNextHopTable::referenceOrEmplaceNextHop, to count the ECMP
+   * egresses created
+   */
+  std::shared_ptr<BcmMultiPathNextHop> referenceOrEmplaceNextHop(
+      const BcmMultiPathNextHopKey& key);
+
+  /*
+   * Bracket programming the routes of a delta, to keep the ECMP egresses
+   * routes move to alive and count transient ones, see
+   * EcmpGroupChurnTracker.
+   */
+  void beginRouteProgramming();
+  void endRouteProgramming();
+
+  // Keep the ECMP egress of key, if any, alive until route programming ends
+  void pinNextHop(const BcmMultiPathNextHopKey& key);
+
+ private:
+  EcmpGroupChurnTracker<BcmMultiPathNextHopKey, BcmMultiPathNextHop>
+      churnTracker_;
 };
 
 } // namespace facebook::fboss
@@ -185,6 +185,9 @@ class BcmStatUpdater {
 
   /* Functions to be called during stats collection (UpdateStatsThread) */
   void updateStats();
+  void updateAclStats();
+  void updateHwTableStats();
+  void updatePrbsStats();
 
   void clearPortStats(const std::unique_ptr<std::vector<int32_t>>& ports);
 
@@ -205,9 +208,6 @@ class BcmStatUpdater {
 
   std::string counterTypeToString(cfg::CounterType type);
 
-  void updateAclStats();
-  void updateHwTableStats();
-  void updatePrbsStats();
   void refreshHwTableStats(const StateDelta& delta);
   void refreshAclStats();
   void refreshPrbsStats(const StateDelta& delta);
@@ -19,6 +19,7 @@
 #include <folly/Conv.h>
 #include <folly/FileUtil.h>
 #include <folly/Memory.h>
+#include <folly/ScopeGuard.h>
 #include <folly/hash/Hash.h>
 #include <folly/logging/xlog.h>
 
@@ -1070,6 +1071,13 @@ std::shared_ptr<SwitchState> BcmSwitch::stateChangedImpl(
 
   CHECK(!bothStandAloneRibOrRouteTableRibUsed(delta));
 
+  // Keep the ECMP egresses routes move to alive while routes are removed and
+  // changed, so that none is freed and created again
+  pinRouteEcmpEgresses(delta);
+  SCOPE_EXIT {
+    writableMultiPathNextHopTable()->endRouteProgramming();
+  };
+
   // remove all routes to be deleted
   processRemovedRoutes(delta);
   processRemovedFibRoutes(delta);
@@ -1778,6 +1786,9 @@ void BcmSwitch::processQosChanges(const StateDelta& delta) {
 }
 
 void BcmSwitch::processAclChanges(const StateDelta& delta) {
+  if (!delta.getSummary().changed(StateDeltaSummary::ACLS)) {
+    return;
+  }
   forEachChanged(
       delta.getAclsDelta(),
       &BcmSwitch::processChangedAcl,
@@ -2069,6 +2080,49 @@ void BcmSwitch::processRemovedRoute(
   routeTable_->deleteRoute(getBcmVrfId(id), route.get());
 }
 
+template <typename RoutesDelta>
+void BcmSwitch::pinRouteEcmpEgresses(
+    RouterID id,
+    const RoutesDelta& routesDelta) {
+  using RouteT = typename RoutesDelta::Node;
+  auto vrf = getBcmVrfId(id);
+  auto pin = [this, vrf](const shared_ptr<RouteT>& route) {
+    const auto& fwd = route->getForwardInfo();
+    if (fwd.getAction() == RouteForwardAction::NEXTHOPS) {
+      writableMultiPathNextHopTable()->pinNextHop(
+          BcmMultiPathNextHopKey(vrf, fwd.getNextHopSet()));
+    }
+  };
+  forEachChanged(
+      routesDelta,
+      [&](const shared_ptr<RouteT>& /*oldRoute*/,
+          const shared_ptr<RouteT>& newRoute) { pin(newRoute); },
+      [&](const shared_ptr<RouteT>& addedRoute) { pin(addedRoute); },
+      [](const shared_ptr<RouteT>& /*deletedRoute*/) {
+        // do nothing
+      });
+}
+
+void BcmSwitch::pinRouteEcmpEgresses(const StateDelta& delta) {
+  writableMultiPathNextHopTable()->beginRouteProgramming();
+  for (const auto& rtDelta : delta.getRouteTablesDelta()) {
+    if (!rtDelta.getNew()) {
+      continue;
+    }
+    RouterID id = rtDelta.getNew()->getID();
+    pinRouteEcmpEgresses(id, rtDelta.getRoutesV4Delta());
+    pinRouteEcmpEgresses(id, rtDelta.getRoutesV6Delta());
+  }
+  for (const auto& fibDelta : delta.getFibsDelta()) {
+    if (!fibDelta.getNew()) {
+      continue;
+    }
+    RouterID vrf = fibDelta.getNew()->getID();
+    pinRouteEcmpEgresses(vrf, fibDelta.getV4FibDelta());
+    pinRouteEcmpEgresses(vrf, fibDelta.getV6FibDelta());
+  }
+}
+
 void BcmSwitch::processRemovedRoutes(const StateDelta& delta) {
   for (auto const& rtDelta : delta.getRouteTablesDelta()) {
     if (!rtDelta.getOld()) {
@@ -2321,10 +2375,13 @@ bool BcmSwitch::sendPacketOutOfPortSync(
 }
 
 void BcmSwitch::updateStatsImpl(SwitchStats* /* switchStats */) {
+  statsScheduler_.startRound();
   // Update global statistics.
   updateGlobalStats();
   // Update cpu or host bound packet stats
-  controlPlane_->updateQueueCounters();
+  statsScheduler_.collect(HwStatsCategory::CPU, [this]() {
+    controlPlane_->updateQueueCounters();
+  });
 }
 
 folly::F14FastMap<std::string, HwPortStats> BcmSwitch::getPortStats() const {
@@ -2343,16 +2400,26 @@ void BcmSwitch::unregisterSwitchEventCallback(bcm_switch_event_t eventID) {
 }
 
 void BcmSwitch::updateGlobalStats() {
-  portTable_->updatePortStats();
-  trunkTable_->updateStats();
-  bcmStatUpdater_->updateStats();
+  statsScheduler_.timed(HwStatsCategory::PORT_COUNTERS, [this]() {
+    portTable_->updatePortStats();
+  });
+  statsScheduler_.collect(
+      HwStatsCategory::TRUNKS, [this]() { trunkTable_->updateStats(); });
+  statsScheduler_.collect(
+      HwStatsCategory::ACLS, [this]() { bcmStatUpdater_->updateAclStats(); });
+  statsScheduler_.collect(HwStatsCategory::RESOURCES, [this]() {
+    bcmStatUpdater_->updateHwTableStats();
+  });
+  statsScheduler_.collect(
+      HwStatsCategory::PRBS, [this]() { bcmStatUpdater_->updatePrbsStats(); });
 
   auto now =
       std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
   if ((now - bstStatsUpdateTime_ >= FLAGS_update_bststats_interval_s) ||
       bstStatsMgr_->isFineGrainedBufferStatLoggingEnabled()) {
     bstStatsUpdateTime_ = now;
-    bstStatsMgr_->updateStats();
+    statsScheduler_.timed(
+        HwStatsCategory::BUFFERS, [this]() { bstStatsMgr_->updateStats(); });
   }
 }
 
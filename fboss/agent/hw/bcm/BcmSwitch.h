@@ -16,6 +16,7 @@
 #include "fboss/agent/HwSwitch.h"
 #include "fboss/agent/L2Entry.h"
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
+#include "fboss/agent/hw/HwStatsScheduler.h"
 #include "fboss/agent/hw/bcm/BcmPlatform.h"
 #include "fboss/agent/types.h"
 
@@ -610,6 +611,13 @@ class BcmSwitch : public BcmSwitchIf {
   void processRemovedRoute(
       const RouterID id,
       const std::shared_ptr<RouteT>& route);
+  /*
+   * Pin the existing ECMP egresses added and changed routes point to, until
+   * route programming ends, see BcmMultiPathNextHopTable
+   */
+  void pinRouteEcmpEgresses(const StateDelta& delta);
+  template <typename RoutesDelta>
+  void pinRouteEcmpEgresses(RouterID id, const RoutesDelta& routesDelta);
   void processRemovedRoutes(const StateDelta& delta);
   void processAddedChangedRoutes(
       const StateDelta& delta,
@@ -925,6 +933,8 @@ class BcmSwitch : public BcmSwitchIf {
   std::unique_ptr<BcmUnit> unitObject_;
   BootType bootType_{BootType::UNINITIALIZED};
   int64_t bstStatsUpdateTime_{0};
+  // Only used from the stats collection thread
+  HwStatsScheduler statsScheduler_;
   std::unique_ptr<BcmQcmManager> qcmManager_;
 
   /*
@@ -10,6 +10,7 @@
 
 #include "fboss/agent/Platform.h"
 #include "fboss/agent/SwitchStats.h"
+#include "fboss/agent/hw/HwPortFb303Stats.h"
 #include "fboss/agent/hw/test/ConfigFactory.h"
 #include "fboss/agent/hw/test/HwSwitchEnsemble.h"
 #include "fboss/agent/hw/test/HwSwitchEnsembleFactory.h"
@@ -46,4 +47,40 @@ BENCHMARK(HwStatsCollection) {
   suspender.rehire();
 }
 
+/*
+ * Publish stats for 128 ports with 8 queues each, 1K times, without
+ * touching the HW. Port stats are synthetic, so this isolates the cost of
+ * exporting counters to fb303 from the cost of reading them from the ASIC.
+ */
+BENCHMARK(HwPortFb303StatsCollection) {
+  folly::BenchmarkSuspender suspender;
+  constexpr auto kNumPorts = 128;
+  constexpr auto kNumQueues = 8;
+  HwPortFb303Stats::QueueId2Name queueId2Name;
+  for (auto queueId = 0; queueId < kNumQueues; ++queueId) {
+    queueId2Name.emplace(queueId, folly::to<std::string>("queue", queueId));
+  }
+  std::vector<std::unique_ptr<HwPortFb303Stats>> portStats;
+  for (auto port = 0; port < kNumPorts; ++port) {
+    portStats.push_back(std::make_unique<HwPortFb303Stats>(
+        folly::to<std::string>("eth1/", port + 1, "/1"), queueId2Name));
+  }
+  HwPortStats stats;
+  for (auto queueId = 0; queueId < kNumQueues; ++queueId) {
+    stats.queueOutDiscardBytes__ref()[queueId] = 0;
+    stats.queueOutBytes__ref()[queueId] = 0;
+    stats.queueOutPackets__ref()[queueId] = 0;
+  }
+  suspender.dismiss();
+  for (auto i = 0; i < 1'000; ++i) {
+    auto now = std::chrono::seconds(i);
+    *stats.inBytes__ref() += 1000;
+    *stats.outBytes__ref() += 1000;
+    for (auto& portStat : portStats) {
+      portStat->updateStats(stats, now);
+    }
+  }
+  suspender.rehire();
+}
+
 } // namespace facebook::fboss
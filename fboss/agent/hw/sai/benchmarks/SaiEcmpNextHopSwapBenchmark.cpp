@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/HwSwitch.h"
+#include "fboss/agent/hw/HwSwitchStats.h"
+#include "fboss/agent/hw/test/ConfigFactory.h"
+#include "fboss/agent/hw/test/HwSwitchEnsemble.h"
+#include "fboss/agent/hw/test/HwSwitchEnsembleFactory.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/test/EcmpSetupHelper.h"
+
+#include <folly/Benchmark.h>
+#include <folly/Format.h>
+#include <folly/logging/xlog.h>
+
+namespace facebook::fboss {
+
+/*
+ * Move 50k routes spread over a few ECMP groups to other next hops at
+ * once, as a fabric wide next hop change does: the routes of each group
+ * move to the next hops of the next group. Routes are programmed grouped
+ * by next hops and the groups they move to stay alive throughout, so the
+ * swap should not create any group.
+ */
+namespace {
+
+auto constexpr kNumRoutes = 50000;
+auto constexpr kNumEcmpGroups = 4;
+auto constexpr kEcmpWidth = 4;
+
+std::vector<RoutePrefixV6> groupPrefixes(int group) {
+  std::vector<RoutePrefixV6> prefixes;
+  for (auto i = group; i < kNumRoutes; i += kNumEcmpGroups) {
+    prefixes.push_back(RoutePrefixV6{
+        folly::IPAddressV6(
+            folly::sformat("2401:db00:{:x}:{:x}::", i >> 16, i & 0xffff)),
+        64});
+  }
+  return prefixes;
+}
+
+/*
+ * Point the routes of group i to kEcmpWidth next hops starting at
+ * port (i + shift) % kNumEcmpGroups
+ */
+std::shared_ptr<SwitchState> setupRoutes(
+    const utility::EcmpSetupTargetedPorts6& ecmpHelper,
+    const std::vector<PortDescriptor>& ports,
+    std::shared_ptr<SwitchState> state,
+    int shift) {
+  for (auto group = 0; group < kNumEcmpGroups; ++group) {
+    auto first = ports.begin() + (group + shift) % kNumEcmpGroups;
+    boost::container::flat_set<PortDescriptor> nhops(
+        first, first + kEcmpWidth);
+    state = ecmpHelper.setupECMPForwarding(state, nhops, groupPrefixes(group));
+  }
+  return state;
+}
+
+} // namespace
+
+BENCHMARK(SaiEcmpNextHopSwap) {
+  folly::BenchmarkSuspender suspender;
+  auto ensemble = createHwEnsemble(HwSwitchEnsemble::getAllFeatures());
+  auto config = utility::onePortPerVlanConfig(
+      ensemble->getHwSwitch(), ensemble->masterLogicalPortIds());
+  ensemble->applyInitialConfig(config);
+
+  utility::EcmpSetupTargetedPorts6 ecmpHelper(ensemble->getProgrammedState());
+  std::vector<PortDescriptor> ports;
+  auto masterLogicalPorts = ensemble->masterLogicalPortIds();
+  for (auto i = 0; i < kNumEcmpGroups + kEcmpWidth - 1; ++i) {
+    ports.emplace_back(masterLogicalPorts[i]);
+  }
+  auto state = ecmpHelper.resolveNextHops(
+      ensemble->getProgrammedState(),
+      boost::container::flat_set<PortDescriptor>(ports.begin(), ports.end()));
+  ensemble->applyNewState(setupRoutes(ecmpHelper, ports, state, 0));
+  auto swappedState =
+      setupRoutes(ecmpHelper, ports, ensemble->getProgrammedState(), 1);
+
+  auto* stats = ensemble->getHwSwitch()->getSwitchStats();
+  auto created = stats->getEcmpGroupCreatedCount();
+  auto transient = stats->getEcmpGroupTransientCount();
+  suspender.dismiss();
+  ensemble->applyNewState(swappedState);
+  suspender.rehire();
+  XLOG(INFO) << "ECMP groups created: "
+             << stats->getEcmpGroupCreatedCount() - created
+             << ", transient: "
+             << stats->getEcmpGroupTransientCount() - transient;
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,71 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/sai/switch/SaiManagerTable.h"
+#include "fboss/agent/hw/sai/switch/SaiPortManager.h"
+#include "fboss/agent/hw/sai/switch/SaiSwitch.h"
+#include "fboss/agent/hw/test/ConfigFactory.h"
+#include "fboss/agent/hw/test/HwSwitchEnsemble.h"
+#include "fboss/agent/hw/test/HwSwitchEnsembleFactory.h"
+#include "fboss/agent/hw/test/HwTestEcmpUtils.h"
+#include "fboss/agent/test/EcmpSetupHelper.h"
+#include "fboss/lib/FunctionCallTimeReporter.h"
+
+#include <folly/Benchmark.h>
+#include <folly/IPAddress.h>
+
+namespace facebook::fboss {
+
+using utility::getEcmpSizeInHw;
+
+/*
+ * HwEcmpGroupShrink against fake SAI. Fake SAI has no links to take down,
+ * so deliver the port down notification the adapter would send and time
+ * until the ECMP group over the port shrinks.
+ */
+BENCHMARK(SaiEcmpGroupShrinkFastPath) {
+  folly::BenchmarkSuspender suspender;
+  constexpr int kEcmpWidth = 4;
+  auto ensemble = createHwEnsemble(HwSwitchEnsemble::getAllFeatures());
+  auto* saiSwitch = static_cast<SaiSwitch*>(ensemble->getHwSwitch());
+  auto config = utility::onePortPerVlanConfig(
+      saiSwitch, ensemble->masterLogicalPortIds());
+  ensemble->applyInitialConfig(config);
+  auto ecmpHelper =
+      utility::EcmpSetupAnyNPorts6(ensemble->getProgrammedState());
+  auto ecmpRouteState = ecmpHelper.setupECMPForwarding(
+      ecmpHelper.resolveNextHops(ensemble->getProgrammedState(), kEcmpWidth),
+      kEcmpWidth);
+  ensemble->applyNewState(ecmpRouteState);
+  auto prefix = folly::CIDRNetwork(folly::IPAddress("::"), 0);
+  CHECK_EQ(
+      kEcmpWidth,
+      getEcmpSizeInHw(saiSwitch, prefix, ecmpHelper.getRouterId(), kEcmpWidth));
+
+  sai_port_oper_status_notification_t operStatus{};
+  operStatus.port_id = saiSwitch->managerTable()
+                           ->portManager()
+                           .getPortHandle(
+                               ecmpHelper.ecmpPortDescriptorAt(0).phyPortID())
+                           ->port->adapterKey();
+  operStatus.port_state = SAI_PORT_OPER_STATUS_DOWN;
+  {
+    ScopedCallTimer timeIt;
+    suspender.dismiss();
+    saiSwitch->linkStateChangedCallbackTopHalf(1, &operStatus);
+    while (getEcmpSizeInHw(
+               saiSwitch, prefix, ecmpHelper.getRouterId(), kEcmpWidth) !=
+           kEcmpWidth - 1) {
+    }
+    suspender.rehire();
+  }
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/test/ConfigFactory.h"
+#include "fboss/agent/hw/test/HwSwitchEnsemble.h"
+#include "fboss/agent/hw/test/HwSwitchEnsembleFactory.h"
+#include "fboss/agent/state/Interface.h"
+#include "fboss/agent/state/InterfaceMap.h"
+#include "fboss/agent/state/MacEntry.h"
+#include "fboss/agent/state/MacTable.h"
+#include "fboss/agent/state/NdpTable.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/Vlan.h"
+#include "fboss/agent/state/VlanMap.h"
+
+#include <folly/Benchmark.h>
+#include <folly/IPAddressV6.h>
+#include <folly/MacAddress.h>
+
+namespace facebook::fboss {
+
+/*
+ * Resolve 50k neighbors at once, spread over the interfaces of a one port
+ * per VLAN config, along with the static MAC entries for them, as when a
+ * large NDP table is learnt or restored at once.
+ */
+namespace {
+
+auto constexpr kNumNeighbors = 50000;
+
+std::shared_ptr<SwitchState> addNeighbors(std::shared_ptr<SwitchState> state) {
+  struct NeighborIntf {
+    InterfaceID intfID;
+    VlanID vlanID;
+    PortDescriptor port;
+    folly::IPAddressV6 subnet;
+  };
+  std::vector<NeighborIntf> intfs;
+  for (const auto& intf : *state->getInterfaces()) {
+    auto vlan = state->getVlans()->getVlanIf(intf->getVlanID());
+    if (!vlan || vlan->getPorts().empty()) {
+      continue;
+    }
+    for (const auto& addr : intf->getAddresses()) {
+      if (addr.first.isV6() && !addr.first.isLinkLocal()) {
+        intfs.push_back(NeighborIntf{
+            intf->getID(),
+            vlan->getID(),
+            PortDescriptor(vlan->getPorts().begin()->first),
+            addr.first.asV6().mask(addr.second)});
+        break;
+      }
+    }
+  }
+  CHECK(!intfs.empty());
+
+  auto perIntf = (kNumNeighbors + intfs.size() - 1) / intfs.size();
+  uint64_t neighbor = 0;
+  for (const auto& intf : intfs) {
+    auto ndpTable =
+        state->getVlans()->getVlan(intf.vlanID)->getNdpTable()->modify(
+            intf.vlanID, &state);
+    auto macTable =
+        state->getVlans()->getVlan(intf.vlanID)->getMacTable()->modify(
+            intf.vlanID, &state);
+    for (size_t i = 0; i < perIntf && neighbor < kNumNeighbors; ++i) {
+      ++neighbor;
+      auto bytes = intf.subnet.toByteArray();
+      for (auto byte = 0; byte < 4; ++byte) {
+        bytes[15 - byte] = (neighbor >> (8 * byte)) & 0xff;
+      }
+      auto mac = folly::MacAddress::fromHBO(0x020000000000 + neighbor);
+      ndpTable->addEntry(
+          folly::IPAddressV6(bytes), mac, intf.port, intf.intfID);
+      macTable->addEntry(std::make_shared<MacEntry>(
+          mac, intf.port, std::nullopt, MacEntryType::STATIC_ENTRY));
+    }
+  }
+  return state;
+}
+
+} // namespace
+
+BENCHMARK(SaiNeighborBulkProgramming) {
+  folly::BenchmarkSuspender suspender;
+  auto ensemble = createHwEnsemble(HwSwitchEnsemble::getAllFeatures());
+  auto config = utility::onePortPerVlanConfig(
+      ensemble->getHwSwitch(), ensemble->masterLogicalPortIds());
+  ensemble->applyInitialConfig(config);
+  auto state = addNeighbors(ensemble->getProgrammedState()->clone());
+
+  suspender.dismiss();
+  ensemble->applyNewState(state);
+  suspender.rehire();
+}
+
+} // namespace facebook::fboss
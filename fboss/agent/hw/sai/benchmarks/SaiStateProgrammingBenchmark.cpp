@@ -0,0 +1,83 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/test/ConfigFactory.h"
+#include "fboss/agent/hw/test/HwSwitchEnsemble.h"
+#include "fboss/agent/hw/test/HwSwitchEnsembleFactory.h"
+#include "fboss/agent/state/AclEntry.h"
+#include "fboss/agent/state/AclMap.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/test/RouteScaleGenerators.h"
+
+#include <folly/Benchmark.h>
+#include <folly/Conv.h>
+#include <gflags/gflags.h>
+
+DECLARE_int32(hw_programming_threads);
+
+namespace facebook::fboss {
+
+/*
+ * Program one large delta mixing the FSW route scale, the neighbors it
+ * resolves and a thousand ACLs, serially and with the independent parts of
+ * the delta programmed concurrently (see HwProgrammingScheduler). Against
+ * fake SAI this measures the software side of programming: walking the
+ * delta and the SAI managers.
+ */
+namespace {
+
+auto constexpr kNumAcls = 1000;
+auto constexpr kAclStartPriority = 100000;
+
+std::shared_ptr<SwitchState> addAcls(std::shared_ptr<SwitchState> state) {
+  auto acls = state->getAcls()->modify(&state);
+  for (auto i = 0; i < kNumAcls; ++i) {
+    auto acl = std::make_shared<AclEntry>(
+        kAclStartPriority + i, folly::to<std::string>("acl", i));
+    acl->setDscp(i % 64);
+    acl->setL4SrcPort(1024 + i);
+    acl->setActionType(cfg::AclActionType::DENY);
+    acls->addEntry(acl);
+  }
+  return state;
+}
+
+void programMixedDelta(int numThreads) {
+  folly::BenchmarkSuspender suspender;
+  gflags::FlagSaver flagSaver;
+  // Read when the switch is created
+  FLAGS_hw_programming_threads = numThreads;
+  auto ensemble = createHwEnsemble(HwSwitchEnsemble::getAllFeatures());
+  auto config = utility::onePortPerVlanConfig(
+      ensemble->getHwSwitch(), ensemble->masterLogicalPortIds());
+  ensemble->applyInitialConfig(config);
+
+  // Each generated state builds on the one before, so the last one holds
+  // all routes and their resolved next hops
+  utility::FSWRouteScaleGenerator routeGenerator(
+      ensemble->getProgrammedState());
+  auto state = addAcls(routeGenerator.getSwitchStates().back()->clone());
+
+  suspender.dismiss();
+  ensemble->applyNewState(state);
+  suspender.rehire();
+}
+
+} // namespace
+
+BENCHMARK(SaiProgramMixedDeltaSerial) {
+  programMixedDelta(0);
+}
+
+BENCHMARK_RELATIVE(SaiProgramMixedDeltaFourThreads) {
+  programMixedDelta(4);
+}
+
+} // namespace facebook::fboss
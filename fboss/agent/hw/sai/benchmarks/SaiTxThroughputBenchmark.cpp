@@ -0,0 +1,128 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/Platform.h"
+#include "fboss/agent/hw/sai/switch/SaiTxQueue.h"
+#include "fboss/agent/hw/test/ConfigFactory.h"
+#include "fboss/agent/hw/test/HwSwitchEnsemble.h"
+#include "fboss/agent/hw/test/HwSwitchEnsembleFactory.h"
+#include "fboss/agent/hw/test/HwTestPacketUtils.h"
+
+#include <folly/Benchmark.h>
+#include <folly/IPAddressV6.h>
+#include <gflags/gflags.h>
+
+#include <thread>
+
+DECLARE_int32(sai_tx_queue_size);
+DECLARE_int32(sai_tx_batch_size);
+
+namespace facebook::fboss {
+
+/*
+ * Compare sending 100K packets inline on the caller thread with handing them
+ * to the async TX queue, with one and with several producer threads. Against
+ * fake SAI this measures the software overhead of the TX path: packet
+ * allocation from the buffer pool, queueing and per packet SAI send.
+ *
+ * The async variants wait for the TX thread to drain the queue, so they
+ * measure end to end throughput and not just the enqueue cost.
+ */
+namespace {
+
+auto constexpr kNumPackets = 100'000;
+
+std::vector<std::unique_ptr<TxPacket>> makePackets(
+    HwSwitch* hwSwitch,
+    const cfg::SwitchConfig& config,
+    folly::MacAddress cpuMac,
+    int numPackets) {
+  const auto kSrcIp = folly::IPAddressV6("2620:0:1cfe:face:b00c::3");
+  const auto kDstIp = folly::IPAddressV6("2620:0:1cfe:face:b00c::4");
+  const auto kSrcMac = folly::MacAddress{"fa:ce:b0:00:00:0c"};
+  std::vector<std::unique_ptr<TxPacket>> pkts;
+  pkts.reserve(numPackets);
+  for (auto i = 0; i < numPackets; ++i) {
+    pkts.push_back(utility::makeIpTxPacket(
+        hwSwitch,
+        VlanID(*config.vlanPorts_ref()[0].vlanID_ref()),
+        kSrcMac,
+        cpuMac,
+        kSrcIp,
+        kDstIp));
+  }
+  return pkts;
+}
+
+void runTxBenchmark(bool async, int numProducers) {
+  folly::BenchmarkSuspender suspender;
+  auto ensemble = createHwEnsemble({});
+  auto hwSwitch = ensemble->getHwSwitch();
+  auto config = utility::onePortPerVlanConfig(
+      hwSwitch, ensemble->masterLogicalPortIds());
+  ensemble->applyInitialConfig(config);
+  auto cpuMac = ensemble->getPlatform()->getLocalMac();
+
+  SaiTxQueue txQueue(
+      "fbossSaiTxBench",
+      // Large enough to never drop, we are measuring throughput
+      std::max(FLAGS_sai_tx_queue_size, kNumPackets),
+      FLAGS_sai_tx_batch_size,
+      [hwSwitch](SaiTxQueue::TxRequest& request) {
+        return hwSwitch->sendPacketSwitchedSync(std::move(request.pkt));
+      });
+  txQueue.start();
+
+  std::vector<std::vector<std::unique_ptr<TxPacket>>> pkts;
+  for (auto i = 0; i < numProducers; ++i) {
+    pkts.push_back(
+        makePackets(hwSwitch, config, cpuMac, kNumPackets / numProducers));
+  }
+
+  suspender.dismiss();
+  std::vector<std::thread> producers;
+  for (auto& producerPkts : pkts) {
+    producers.emplace_back([&producerPkts, &txQueue, hwSwitch, async]() {
+      for (auto& pkt : producerPkts) {
+        if (async) {
+          txQueue.enqueue(std::move(pkt));
+        } else {
+          hwSwitch->sendPacketSwitchedSync(std::move(pkt));
+        }
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  txQueue.waitUntilDrained();
+  suspender.rehire();
+  txQueue.stop();
+}
+
+} // namespace
+
+BENCHMARK(SaiTxSync) {
+  runTxBenchmark(false, 1);
+}
+
+BENCHMARK(SaiTxAsync) {
+  runTxBenchmark(true, 1);
+}
+
+BENCHMARK(SaiTxSyncFourProducers) {
+  runTxBenchmark(false, 4);
+}
+
+BENCHMARK(SaiTxAsyncFourProducers) {
+  runTxBenchmark(true, 4);
+}
+
+} // namespace facebook::fboss
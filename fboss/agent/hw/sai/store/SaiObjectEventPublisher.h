@@ -2,8 +2,6 @@
 
 #pragma once
 
-#include <boost/signals2.hpp>
-
 #include "fboss/agent/hw/sai/api/BridgeApi.h"
 #include "fboss/agent/hw/sai/api/FdbApi.h"
 #include "fboss/agent/hw/sai/api/NeighborApi.h"
@@ -15,6 +13,15 @@
 #include "fboss/agent/hw/sai/store/Traits.h"
 
 #include "fboss/lib/RefMap.h"
+#include "fboss/lib/TupleUtils.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace facebook::fboss {
 
@@ -90,7 +97,11 @@ namespace detail {
  * subscribers
  * 5) tracks live publishers, this is done to handle situation if
  * subscribers come after publishers without having subscribers to actively poll
- * publisher */
+ * publisher
+ * 6) coalesces create notifications issued in a batch, see beginBatch()
+ *
+ * Like the rest of SAI programming, it is not thread safe and meant to be
+ * used with the SaiSwitch lock held. */
 template <typename PublishedObjectTrait>
 class SaiObjectEventPublisher {
  public:
@@ -101,18 +112,43 @@ class SaiObjectEventPublisher {
 
  private:
   class Subscription {
-    // a subscription, using boost signals since they are fast in issuing
-    // notifications to large number of subscribers, thread safe, re-entrant.
-    template <typename T>
-    using CreateSignal =
-        boost::signals2::signal<void(std::shared_ptr<const T>)>;
-    CreateSignal<SaiObject<PublishedObjectTrait>> createSignal_;
-    using CreateSignalSlot =
-        typename CreateSignal<SaiObject<PublishedObjectTrait>>::slot_type;
-
-    using RemoveSignal = boost::signals2::signal<void()>;
-    RemoveSignal removeSignal_;
-    using RemoveSignalSlot = typename RemoveSignal::slot_type;
+    // Subscribers of a publisher key, in subscription order. A neighbor or
+    // next hop can have tens of thousands of subscribers, so this is a
+    // plain vector rather than signals with a slot per subscriber.
+    // Subscribers are not owned, and expired ones are dropped lazily.
+    std::vector<std::weak_ptr<Subscriber>> subscribers_;
+
+    void add(std::weak_ptr<Subscriber> subscriber) {
+      if (subscribers_.size() == subscribers_.capacity()) {
+        prune();
+      }
+      subscribers_.push_back(std::move(subscriber));
+    }
+
+    // Take references to the live subscribers, so that subscribers removed
+    // or added while notifying do not disturb the notification
+    std::vector<std::shared_ptr<Subscriber>> lockSubscribers() {
+      std::vector<std::shared_ptr<Subscriber>> subscribers;
+      subscribers.reserve(subscribers_.size());
+      for (const auto& subscriber : subscribers_) {
+        if (auto locked = subscriber.lock()) {
+          subscribers.push_back(std::move(locked));
+        }
+      }
+      if (subscribers.size() != subscribers_.size()) {
+        prune();
+      }
+      return subscribers;
+    }
+
+    void prune() {
+      subscribers_.erase(
+          std::remove_if(
+              subscribers_.begin(),
+              subscribers_.end(),
+              [](const auto& subscriber) { return subscriber.expired(); }),
+          subscribers_.end());
+    }
 
     friend class SaiObjectEventPublisher<PublishedObjectTrait>;
   };
@@ -125,53 +161,115 @@ class SaiObjectEventPublisher {
 
     auto subscription = result.first;
 
-    // add a subscriber here for create or remove notifications.
     // subscriptions are self managed, because they're put in ref map.
-    // further if subscriber gets removed, its not notified because
-    // "track_foreign" will delete its slot in general following principles hold
+    // In general following principles hold
     // 1. a subscription exists only if at least one subscriber exists
     // 2. a subscription is deleted if no subscriber exists
-    // 3. a slot for subscriber in subscription is freed if subscriber is
-    // removed.
-    // 4. a subscriber is not notified only if it exists
-    typename Subscription::CreateSignalSlot createSignalSlot = std::bind(
-        &Subscriber::afterCreate, subscriber.get(), std::placeholders::_1);
-    subscription->createSignal_.connect(
-        createSignalSlot.track_foreign(subscriberWeakPtr));
-
-    typename Subscription::RemoveSignalSlot removeSignalSlot =
-        std::bind(&Subscriber::beforeRemove, subscriber.get());
-    subscription->removeSignal_.connect(
-        removeSignalSlot.track_foreign(subscriberWeakPtr));
+    // 3. a subscriber is dropped from its subscription once removed
+    // 4. a subscriber is notified only if it exists
+    subscription->add(subscriberWeakPtr);
     subscriber->saveSubscription(subscription);
-    // check if publisher is already live
+    // check if publisher is already live. Only the new subscriber needs to
+    // learn about it, the others were notified when it was created. If its
+    // creation is still pending in a batch, all are notified at the end.
     auto publisher = livePublishers_.find(subscriber->getPublisherKey());
-    if (publisher != livePublishers_.end()) {
-      notifyCreate(publisher->first, publisher->second.lock());
+    if (publisher != livePublishers_.end() &&
+        pendingCreateIndices_.find(publisher->first) ==
+            pendingCreateIndices_.end()) {
+      if (auto object = publisher->second.lock()) {
+        subscriber->afterCreate(object);
+      }
     }
   }
 
   void notifyCreate(Key key, const std::shared_ptr<PublisherObject> object) {
-    livePublishers_.emplace(key, object);
-    auto subscription = subscriptions_.get(key);
-    if (!subscription) {
+    livePublishers_.insert_or_assign(key, object);
+    if (batchDepth_ > 0) {
+      auto ins = pendingCreateIndices_.emplace(key, pendingCreates_.size());
+      if (ins.second) {
+        pendingCreates_.emplace_back(key, object);
+      } else {
+        pendingCreates_[ins.first->second].second = object;
+      }
       return;
     }
-    subscription->createSignal_(object);
+    dispatchCreate(key, object);
   }
 
   void notifyDelete(Key key) {
     livePublishers_.erase(key);
+    auto pending = pendingCreateIndices_.find(key);
+    if (pending != pendingCreateIndices_.end()) {
+      // The subscribers were not told about the object yet
+      pendingCreates_[pending->second].second.reset();
+      pendingCreateIndices_.erase(pending);
+      return;
+    }
     auto subscription = subscriptions_.get(key);
     if (!subscription) {
       return;
     }
-    subscription->removeSignal_();
+    for (const auto& subscriber : subscription->lockSubscribers()) {
+      subscriber->beforeRemove();
+    }
+  }
+
+  /*
+   * Hold back create notifications until the matching endBatch(). The
+   * subscribers of each object created in the batch are then notified once,
+   * of its latest version, and not at all for objects removed again in the
+   * batch. Batches may nest. Remove notifications are not held back, as
+   * subscribers need to let go of an object before it goes away.
+   */
+  void beginBatch() {
+    ++batchDepth_;
+  }
+
+  void endBatch() {
+    CHECK_GT(batchDepth_, 0);
+    if (--batchDepth_ > 0) {
+      return;
+    }
+    auto pendingCreates = std::move(pendingCreates_);
+    pendingCreates_.clear();
+    pendingCreateIndices_.clear();
+    for (const auto& keyAndObject : pendingCreates) {
+      if (auto object = keyAndObject.second.lock()) {
+        dispatchCreate(keyAndObject.first, object);
+      }
+    }
+  }
+
+  /*
+   * Give up on all open batches after a failure, without notifying the
+   * subscribers of the objects they created. Those objects stay live, so
+   * subscribers coming later still learn about them.
+   */
+  void abortBatch() {
+    batchDepth_ = 0;
+    pendingCreates_.clear();
+    pendingCreateIndices_.clear();
   }
 
  private:
+  void dispatchCreate(
+      const Key& key,
+      const std::shared_ptr<PublisherObject>& object) {
+    auto subscription = subscriptions_.get(key);
+    if (!subscription) {
+      return;
+    }
+    for (const auto& subscriber : subscription->lockSubscribers()) {
+      subscriber->afterCreate(object);
+    }
+  }
+
   std::unordered_map<Key, std::weak_ptr<PublisherObject>> livePublishers_;
   UnorderedRefMap<Key, Subscription> subscriptions_;
+  int batchDepth_{0};
+  // Objects created in the current batch, in creation order
+  std::vector<std::pair<Key, std::weak_ptr<PublisherObject>>> pendingCreates_;
+  std::unordered_map<Key, size_t> pendingCreateIndices_;
 };
 
 } // namespace detail
@@ -200,6 +298,27 @@ class SaiObjectEventPublisher {
     std::get<PublishedObjectTrait>(publishers_).notifyDelete(key);
   }
 
+  /*
+   * Coalesce the create notifications of all publishers until the matching
+   * endBatch(), e.g. while programming the neighbors of a state delta.
+   * Publishers are ended in turn, so the objects a batch creates reach their
+   * subscribers one kind at a time, e.g. all neighbors before any of the
+   * next hops they bring up are created.
+   */
+  void beginBatch() {
+    tupleForEach([](auto& publisher) { publisher.beginBatch(); }, publishers_);
+  }
+
+  void endBatch() {
+    tupleForEach([](auto& publisher) { publisher.endBatch(); }, publishers_);
+  }
+
+  // Drop the batched create notifications of all publishers, see
+  // detail::SaiObjectEventPublisher::abortBatch()
+  void abortBatch() {
+    tupleForEach([](auto& publisher) { publisher.abortBatch(); }, publishers_);
+  }
+
   template <typename PublishedObjectTrait>
   detail::SaiObjectEventPublisher<PublishedObjectTrait>& get() {
     return std::get<detail::SaiObjectEventPublisher<PublishedObjectTrait>>(
@@ -207,14 +326,16 @@ class SaiObjectEventPublisher {
   }
 
  private:
+  // Publishers of objects come before the publishers of objects depending
+  // on them, which endBatch() relies on
   std::tuple<
+      detail::SaiObjectEventPublisher<SaiPortTraits>,
+      detail::SaiObjectEventPublisher<SaiRouterInterfaceTraits>,
       detail::SaiObjectEventPublisher<SaiBridgePortTraits>,
       detail::SaiObjectEventPublisher<SaiFdbTraits>,
       detail::SaiObjectEventPublisher<SaiNeighborTraits>,
       detail::SaiObjectEventPublisher<SaiIpNextHopTraits>,
-      detail::SaiObjectEventPublisher<SaiMplsNextHopTraits>,
-      detail::SaiObjectEventPublisher<SaiRouterInterfaceTraits>,
-      detail::SaiObjectEventPublisher<SaiPortTraits>>
+      detail::SaiObjectEventPublisher<SaiMplsNextHopTraits>>
       publishers_;
 };
 
@@ -0,0 +1,142 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/sai/api/NeighborApi.h"
+#include "fboss/agent/hw/sai/store/SaiObjectEventPublisher.h"
+#include "fboss/agent/hw/sai/store/SaiObjectEventSubscriber-defs.h"
+#include "fboss/agent/hw/sai/store/SaiStore.h"
+#include "fboss/agent/hw/sai/store/tests/SaiStoreTest.h"
+
+using namespace facebook::fboss;
+
+namespace {
+
+class TestNeighborSubscriber
+    : public detail::SaiObjectEventSubscriber<SaiNeighborTraits> {
+ public:
+  using Base = detail::SaiObjectEventSubscriber<SaiNeighborTraits>;
+  using Base::Base;
+
+  void afterCreate(PublisherObjectSharedPtr object) override {
+    ++creates;
+    setPublisherObject(object);
+  }
+  void beforeRemove() override {
+    ++removes;
+    setPublisherObject();
+  }
+
+  int creates{0};
+  int removes{0};
+};
+
+class SaiObjectEventPublisherTest : public SaiStoreTest {
+ public:
+  std::shared_ptr<TestNeighborSubscriber> subscribe() {
+    auto subscriber = std::make_shared<TestNeighborSubscriber>(neighbor);
+    publisher().subscribe(subscriber);
+    return subscriber;
+  }
+
+  std::shared_ptr<SaiObject<SaiNeighborTraits>> createNeighbor(
+      SaiStore& store) {
+    SaiNeighborTraits::CreateAttributes attrs{
+        folly::MacAddress{"42:42:42:42:42:42"}, std::nullopt};
+    return store.get<SaiNeighborTraits>().setObject(neighbor, attrs);
+  }
+
+  static SaiObjectEventPublisher& publisher() {
+    return *SaiObjectEventPublisher::getInstance();
+  }
+
+  SaiNeighborTraits::NeighborEntry neighbor{
+      0,
+      0,
+      folly::IPAddress{"10.10.42.1"}};
+};
+
+} // namespace
+
+TEST_F(SaiObjectEventPublisherTest, subscribeToLivePublisher) {
+  SaiStore s(0);
+  s.reload();
+  auto object = createNeighbor(s);
+  auto first = subscribe();
+  EXPECT_EQ(first->creates, 1);
+  EXPECT_TRUE(first->isReady());
+
+  // Only the new subscriber learns about the live publisher
+  auto second = subscribe();
+  EXPECT_EQ(first->creates, 1);
+  EXPECT_EQ(second->creates, 1);
+
+  object.reset();
+  EXPECT_EQ(first->removes, 1);
+  EXPECT_EQ(second->removes, 1);
+  EXPECT_FALSE(first->isReady());
+}
+
+TEST_F(SaiObjectEventPublisherTest, batchDefersCreate) {
+  SaiStore s(0);
+  s.reload();
+  auto first = subscribe();
+  publisher().beginBatch();
+  auto object = createNeighbor(s);
+  auto second = subscribe();
+  EXPECT_EQ(first->creates, 0);
+  EXPECT_EQ(second->creates, 0);
+
+  publisher().endBatch();
+  EXPECT_EQ(first->creates, 1);
+  EXPECT_EQ(second->creates, 1);
+  EXPECT_TRUE(second->isReady());
+}
+
+TEST_F(SaiObjectEventPublisherTest, batchDropsRemovedCreate) {
+  SaiStore s(0);
+  s.reload();
+  auto subscriber = subscribe();
+  publisher().beginBatch();
+  auto object = createNeighbor(s);
+  object.reset();
+  publisher().endBatch();
+  EXPECT_EQ(subscriber->creates, 0);
+  EXPECT_EQ(subscriber->removes, 0);
+  EXPECT_FALSE(subscriber->isReady());
+}
+
+TEST_F(SaiObjectEventPublisherTest, expiredSubscriber) {
+  SaiStore s(0);
+  s.reload();
+  auto first = subscribe();
+  auto second = subscribe();
+  second.reset();
+  auto object = createNeighbor(s);
+  EXPECT_EQ(first->creates, 1);
+}
+
+TEST_F(SaiObjectEventPublisherTest, abortBatchDropsCreates) {
+  SaiStore s(0);
+  s.reload();
+  auto first = subscribe();
+  publisher().beginBatch();
+  publisher().beginBatch();
+  auto object = createNeighbor(s);
+  publisher().abortBatch();
+  EXPECT_EQ(first->creates, 0);
+
+  // The object is still live and batching is over
+  auto second = subscribe();
+  EXPECT_EQ(second->creates, 1);
+  object.reset();
+  auto third = subscribe();
+  object = createNeighbor(s);
+  EXPECT_EQ(third->creates, 1);
+}
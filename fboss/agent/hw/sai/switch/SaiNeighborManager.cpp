@@ -111,6 +111,17 @@ void SaiNeighborManager::addNeighbor(
   SaiObjectEventPublisher::getInstance()->get<SaiFdbTraits>().subscribe(
       subscriber);
   managedNeighbors_.emplace(subscriberKey, std::move(subscriber));
+  managerTable_->nextHopGroupManager().addNeighborPort(
+      portID, swEntry->getIntfID(), swEntry->getIP());
+}
+
+template <typename NeighborEntryT>
+void SaiNeighborManager::addNeighbors(
+    const std::vector<std::shared_ptr<NeighborEntryT>>& swEntries) {
+  managedNeighbors_.reserve(managedNeighbors_.size() + swEntries.size());
+  for (const auto& swEntry : swEntries) {
+    addNeighbor(swEntry);
+  }
 }
 
 template <typename NeighborEntryT>
@@ -132,6 +143,8 @@ void SaiNeighborManager::removeNeighbor(
         "Attempted to remove non-existent neighbor: ", swEntry->getIP());
   }
   managedNeighbors_.erase(subscriberKey);
+  managerTable_->nextHopGroupManager().removeNeighborPort(
+      swEntry->getPort().phyPortID(), swEntry->getIntfID(), swEntry->getIP());
 }
 
 void SaiNeighborManager::clear() {
@@ -206,6 +219,11 @@ template void SaiNeighborManager::addNeighbor<NdpEntry>(
 template void SaiNeighborManager::addNeighbor<ArpEntry>(
     const std::shared_ptr<ArpEntry>& swEntry);
 
+template void SaiNeighborManager::addNeighbors<NdpEntry>(
+    const std::vector<std::shared_ptr<NdpEntry>>& swEntries);
+template void SaiNeighborManager::addNeighbors<ArpEntry>(
+    const std::vector<std::shared_ptr<ArpEntry>>& swEntries);
+
 template void SaiNeighborManager::removeNeighbor<NdpEntry>(
     const std::shared_ptr<NdpEntry>& swEntry);
 template void SaiNeighborManager::removeNeighbor<ArpEntry>(
@@ -21,6 +21,7 @@
 
 #include <memory>
 #include <mutex>
+#include <vector>
 
 namespace facebook::fboss {
 
@@ -101,6 +102,15 @@ class SaiNeighborManager {
   template <typename NeighborEntryT>
   void addNeighbor(const std::shared_ptr<NeighborEntryT>& swEntry);
 
+  /*
+   * Add many neighbors, e.g. all the neighbors a state delta resolves. Meant
+   * to be called in a publisher batch, so the neighbors are created once all
+   * of them subscribed.
+   */
+  template <typename NeighborEntryT>
+  void addNeighbors(
+      const std::vector<std::shared_ptr<NeighborEntryT>>& swEntries);
+
   template <typename NeighborEntryT>
   void removeNeighbor(const std::shared_ptr<NeighborEntryT>& swEntry);
 
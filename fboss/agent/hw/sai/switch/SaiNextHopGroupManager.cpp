@@ -11,12 +11,18 @@
 #include "fboss/agent/hw/sai/switch/SaiNextHopGroupManager.h"
 
 #include "fboss/agent/FbossError.h"
+#include "fboss/agent/HwSwitch.h"
 #include "fboss/agent/hw/sai/store/SaiStore.h"
 #include "fboss/agent/hw/sai/switch/SaiManagerTable.h"
 #include "fboss/agent/hw/sai/switch/SaiNeighborManager.h"
 #include "fboss/agent/hw/sai/switch/SaiNextHopManager.h"
 #include "fboss/agent/hw/sai/switch/SaiRouterInterfaceManager.h"
 #include "fboss/agent/hw/sai/switch/SaiSwitchManager.h"
+#include "fboss/agent/platforms/sai/SaiPlatform.h"
+#include "fboss/agent/state/Port.h"
+#include "fboss/agent/state/PortMap.h"
+#include "fboss/agent/state/StateDelta.h"
+#include "fboss/agent/state/SwitchState.h"
 
 #include <folly/logging/xlog.h>
 
@@ -72,11 +78,119 @@ SaiNextHopGroupManager::incRefOrAddNextHopGroup(
     auto key = std::make_pair(nextHopGroupId, resolvedNextHop);
     auto result = managedNextHopGroupMembers_.refOrEmplace(
         key, managerTable_, nextHopGroupId, resolvedNextHop);
+    if (result.second) {
+      auto& members = nextHopMembers_[NextHopKey(
+          resolvedNextHop.intf(), resolvedNextHop.addr())];
+      if (members.size() == members.capacity()) {
+        // Drop the members gone since the last time the index grew
+        members.erase(
+            std::remove_if(
+                members.begin(),
+                members.end(),
+                [](const auto& member) { return member.expired(); }),
+            members.end());
+      }
+      members.push_back(result.first);
+    }
     nextHopGroupHandle->members_.push_back(result.first);
   }
+  churnTracker_.created(
+      swNextHops,
+      nextHopGroupHandle,
+      platform_->getHwSwitch()->getSwitchStats());
   return nextHopGroupHandle;
 }
 
+void SaiNextHopGroupManager::beginRouteProgramming() {
+  churnTracker_.beginPass();
+}
+
+void SaiNextHopGroupManager::endRouteProgramming() {
+  churnTracker_.endPass(platform_->getHwSwitch()->getSwitchStats());
+}
+
+bool SaiNextHopGroupManager::pinNextHopGroup(
+    const RouteNextHopEntry::NextHopSet& swNextHops) {
+  auto nextHopGroupHandle = handles_.ref(swNextHops);
+  if (!nextHopGroupHandle) {
+    return false;
+  }
+  churnTracker_.pin(swNextHops, std::move(nextHopGroupHandle));
+  return true;
+}
+
+void SaiNextHopGroupManager::addNeighborPort(
+    PortID port,
+    InterfaceID interfaceId,
+    const folly::IPAddress& ip) {
+  portNextHops_[port].emplace(interfaceId, ip);
+}
+
+void SaiNextHopGroupManager::removeNeighborPort(
+    PortID port,
+    InterfaceID interfaceId,
+    const folly::IPAddress& ip) {
+  auto itr = portNextHops_.find(port);
+  if (itr == portNextHops_.end()) {
+    return;
+  }
+  itr->second.erase(NextHopKey(interfaceId, ip));
+  if (itr->second.empty()) {
+    portNextHops_.erase(itr);
+  }
+}
+
+size_t SaiNextHopGroupManager::handleLinkDown(PortID port) {
+  auto portItr = portNextHops_.find(port);
+  if (portItr == portNextHops_.end()) {
+    return 0;
+  }
+  size_t removed = 0;
+  for (const auto& nextHop : portItr->second) {
+    auto membersItr = nextHopMembers_.find(nextHop);
+    if (membersItr == nextHopMembers_.end()) {
+      continue;
+    }
+    for (const auto& weakMember : membersItr->second) {
+      auto member = weakMember.lock();
+      if (member && member->linkDown()) {
+        ++removed;
+      }
+    }
+  }
+  if (removed) {
+    linkDownPorts_.insert(port);
+    XLOG(DBG2) << "Removed " << removed
+               << " next hop group members over down port " << port;
+  }
+  return removed;
+}
+
+void SaiNextHopGroupManager::reconcileLinkState(const StateDelta& delta) {
+  for (auto itr = linkDownPorts_.begin(); itr != linkDownPorts_.end();) {
+    auto port = delta.newState()->getPorts()->getPortIf(*itr);
+    if (port && !port->isUp()) {
+      ++itr;
+      continue;
+    }
+    auto portItr = portNextHops_.find(*itr);
+    if (portItr != portNextHops_.end()) {
+      for (const auto& nextHop : portItr->second) {
+        auto membersItr = nextHopMembers_.find(nextHop);
+        if (membersItr == nextHopMembers_.end()) {
+          continue;
+        }
+        for (const auto& weakMember : membersItr->second) {
+          if (auto member = weakMember.lock()) {
+            member->linkUp();
+          }
+        }
+      }
+    }
+    itr = linkDownPorts_.erase(itr);
+  }
+}
+
 ManagedNextHopGroupMember::ManagedNextHopGroupMember(
     SaiManagerTable* managerTable,
     SaiNextHopGroupTraits::AdapterKey nexthopGroupId,
@@ -12,6 +12,7 @@
 
 #include "fboss/agent/hw/sai/api/NextHopGroupApi.h"
 
+#include "fboss/agent/hw/EcmpGroupChurnTracker.h"
 #include "fboss/agent/hw/sai/api/NextHopApi.h"
 #include "fboss/agent/hw/sai/store/SaiObject.h"
 #include "fboss/agent/state/RouteNextHop.h"
@@ -19,7 +20,10 @@
 #include "fboss/agent/types.h"
 #include "fboss/lib/RefMap.h"
 
+#include <map>
 #include <memory>
+#include <set>
+#include <vector>
 #include "folly/container/F14Map.h"
 #include "folly/container/F14Set.h"
 
@@ -32,6 +36,7 @@ namespace facebook::fboss {
 
 class SaiManagerTable;
 class SaiPlatform;
+class StateDelta;
 
 using SaiNextHopGroup = SaiObject<SaiNextHopGroupTraits>;
 using SaiNextHopGroupMember = SaiObject<SaiNextHopGroupMemberTraits>;
@@ -64,6 +69,7 @@ class ManagedSaiNextHopGroupMember
 
   void createObject(PublisherObjects added) {
     CHECK(this->allPublishedObjectsAlive()) << "next hops are not ready";
+    removedOnLinkDown_ = false;
 
     auto nexthopId = std::get<NextHopWeakPtr>(added).lock()->adapterKey();
 
@@ -78,11 +84,40 @@ class ManagedSaiNextHopGroupMember
   void removeObject(size_t /*index*/, PublisherObjects /*removed*/) {
     /* remove nexthop group member if next hop is removed */
     this->resetObject();
+    removedOnLinkDown_ = false;
+  }
+
+  /*
+   * Remove the member ahead of its next hop, as the port the next hop
+   * resolves over went down. Returns whether the member was programmed.
+   */
+  bool linkDown() {
+    if (!this->isAlive()) {
+      return false;
+    }
+    this->resetObject();
+    removedOnLinkDown_ = true;
+    return true;
+  }
+
+  /*
+   * Program a member removed by linkDown again, if its next hop was not
+   * removed in the meantime
+   */
+  void linkUp() {
+    if (!removedOnLinkDown_) {
+      return;
+    }
+    removedOnLinkDown_ = false;
+    if (this->allPublishedObjectsAlive()) {
+      createObject(std::make_tuple(this->getPublisherObject()));
+    }
   }
 
  private:
   SaiNextHopGroupTraits::AdapterKey nexthopGroupId_;
   NextHopWeight weight_;
+  bool removedOnLinkDown_{false};
 };
 
 class ManagedNextHopGroupMember {
@@ -103,6 +138,22 @@ class ManagedNextHopGroupMember {
         managedNextHopGroupMember_);
   }
 
+  bool linkDown() {
+    return std::visit(
+        [](auto arg) { return arg && arg->linkDown(); },
+        managedNextHopGroupMember_);
+  }
+
+  void linkUp() {
+    std::visit(
+        [](auto arg) {
+          if (arg) {
+            arg->linkUp();
+          }
+        },
+        managedNextHopGroupMember_);
+  }
+
  private:
   std::variant<
       std::shared_ptr<ManagedNextHop<SaiIpNextHopTraits>>,
@@ -135,7 +186,49 @@ class SaiNextHopGroupManager {
   std::shared_ptr<SaiNextHopGroupHandle> incRefOrAddNextHopGroup(
       const RouteNextHopEntry::NextHopSet& swNextHops);
 
+  /*
+   * Bracket programming the routes of a delta, to keep the next hop groups
+   * routes move to alive and count transient ones, see
+   * EcmpGroupChurnTracker.
+   */
+  void beginRouteProgramming();
+  void endRouteProgramming();
+
+  /*
+   * Keep the next hop group of swNextHops alive until route programming
+   * ends. Returns whether the group exists.
+   */
+  bool pinNextHopGroup(const RouteNextHopEntry::NextHopSet& swNextHops);
+
+  /*
+   * Next hops over a neighbor resolve over its port, see SaiNeighborManager
+   */
+  void addNeighborPort(
+      PortID port,
+      InterfaceID interfaceId,
+      const folly::IPAddress& ip);
+  void removeNeighborPort(
+      PortID port,
+      InterfaceID interfaceId,
+      const folly::IPAddress& ip);
+
+  /*
+   * Fast path for a port going down: remove the members over the port from
+   * their groups right away, rather than once the neighbors behind them are
+   * removed. Returns the number of members removed.
+   */
+  size_t handleLinkDown(PortID port);
+
+  /*
+   * Put back the members removed by handleLinkDown over ports which are up
+   * in the new state, e.g. after a flap the state update never saw. Members
+   * whose next hops were removed meanwhile stay out of their groups.
+   */
+  void reconcileLinkState(const StateDelta& delta);
+
  private:
+  using NextHopKey = std::pair<InterfaceID, folly::IPAddress>;
+
   SaiManagerTable* managerTable_;
   const SaiPlatform* platform_;
   // TODO(borisb): improve SaiObject/SaiStore to the point where they
@@ -146,6 +239,15 @@ class SaiNextHopGroupManager {
       std::pair<typename SaiNextHopGroupTraits::AdapterKey, ResolvedNextHop>,
       ManagedNextHopGroupMember>
       managedNextHopGroupMembers_;
+  EcmpGroupChurnTracker<RouteNextHopEntry::NextHopSet, SaiNextHopGroupHandle>
+      churnTracker_;
+  // Reverse index from ports to the members over them, through the next
+  // hops of the neighbors on each port
+  std::map<PortID, std::set<NextHopKey>> portNextHops_;
+  std::map<NextHopKey, std::vector<std::weak_ptr<ManagedNextHopGroupMember>>>
+      nextHopMembers_;
+  // Ports with members removed by handleLinkDown
+  std::set<PortID> linkDownPorts_;
 };
 
 } // namespace facebook::fboss
@@ -519,7 +519,21 @@ const std::vector<sai_stat_id_t>& SaiPortManager::supportedStats() const {
   return counterIds;
 }
 
-void SaiPortManager::updateStats(PortID portId) {
+const std::vector<sai_stat_id_t>& SaiPortManager::trafficStats() const {
+  static const std::vector<sai_stat_id_t> counterIds = {
+      SAI_PORT_STAT_IF_IN_OCTETS,
+      SAI_PORT_STAT_IF_IN_UCAST_PKTS,
+      SAI_PORT_STAT_IF_IN_MULTICAST_PKTS,
+      SAI_PORT_STAT_IF_IN_BROADCAST_PKTS,
+      SAI_PORT_STAT_IF_OUT_OCTETS,
+      SAI_PORT_STAT_IF_OUT_UCAST_PKTS,
+      SAI_PORT_STAT_IF_OUT_MULTICAST_PKTS,
+      SAI_PORT_STAT_IF_OUT_BROADCAST_PKTS,
+  };
+  return counterIds;
+}
+
+void SaiPortManager::updateStats(PortID portId, bool updateErrorStats) {
   auto handlesItr = handles_.find(portId);
   if (handlesItr == handles_.end()) {
     return;
@@ -541,7 +555,9 @@ void SaiPortManager::updateStats(PortID portId) {
       ? 0
       : *curPortStats.inDiscards__ref();
   curPortStats.timestamp__ref() = now.count();
-  handle->port->updateStats(supportedStats(), SAI_STATS_MODE_READ);
+  handle->port->updateStats(
+      updateErrorStats ? supportedStats() : trafficStats(),
+      SAI_STATS_MODE_READ);
   const auto& counters = handle->port->getStats();
   fillHwPortStats(counters, managerTable_->debugCounterManager(), curPortStats);
   std::vector<utility::CounterPrevAndCur> toSubtractFromInDiscardsRaw = {
@@ -101,7 +101,12 @@ class SaiPortManager {
   std::shared_ptr<Port> swPortFromAttributes(
       SaiPortTraits::CreateAttributes attributees) const;
 
-  void updateStats(PortID portID);
+  /*
+   * Byte and packet counters are always read. Error, discard and FEC
+   * counters are only read if updateErrorStats is set, otherwise their last
+   * read values are reported again.
+   */
+  void updateStats(PortID portID, bool updateErrorStats = true);
 
   void clearStats(PortID portID);
 
@@ -118,6 +123,7 @@ class SaiPortManager {
 
   void setQosMapsOnAllPorts(QosMapSaiId dscpToTc, QosMapSaiId tcToQueue);
   const std::vector<sai_stat_id_t>& supportedStats() const;
+  const std::vector<sai_stat_id_t>& trafficStats() const;
   SaiPortHandle* getPortHandleImpl(PortID swId) const;
   SaiQueueHandle* getQueueHandleImpl(
       PortID swId,
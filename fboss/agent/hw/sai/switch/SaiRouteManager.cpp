@@ -128,6 +128,18 @@ bool SaiRouteManager::validRoute(const std::shared_ptr<Route<AddrT>>& swRoute) {
   return true;
 }
 
+template <typename AddrT>
+std::optional<RouteNextHopEntry::NextHopSet> SaiRouteManager::getEcmpNextHops(
+    const std::shared_ptr<Route<AddrT>>& swRoute) {
+  // Same conditions addOrUpdateRoute references a next hop group on
+  const auto& fwd = swRoute->getForwardInfo();
+  if (fwd.getAction() != NEXTHOPS || swRoute->isConnected() ||
+      fwd.getNextHopSet().size() <= 1) {
+    return std::nullopt;
+  }
+  return fwd.normalizedNextHops();
+}
+
 template <typename AddrT>
 void SaiRouteManager::addOrUpdateRoute(
     SaiRouteHandle* routeHandle,
@@ -427,6 +439,13 @@ SaiRouteManager::routeEntryFromSwRoute<folly::IPAddressV4>(
     RouterID routerId,
     const std::shared_ptr<Route<folly::IPAddressV4>>& swEntry) const;
 
+template std::optional<RouteNextHopEntry::NextHopSet>
+SaiRouteManager::getEcmpNextHops<folly::IPAddressV6>(
+    const std::shared_ptr<Route<folly::IPAddressV6>>& swRoute);
+template std::optional<RouteNextHopEntry::NextHopSet>
+SaiRouteManager::getEcmpNextHops<folly::IPAddressV4>(
+    const std::shared_ptr<Route<folly::IPAddressV4>>& swRoute);
+
 template void SaiRouteManager::changeRoute<folly::IPAddressV6>(
     const std::shared_ptr<Route<folly::IPAddressV6>>& oldSwEntry,
     const std::shared_ptr<Route<folly::IPAddressV6>>& newSwEntry,
@@ -13,6 +13,7 @@
 #include "fboss/agent/hw/sai/api/NextHopGroupApi.h"
 #include "fboss/agent/hw/sai/api/RouteApi.h"
 #include "fboss/agent/hw/sai/store/SaiObject.h"
+#include "fboss/agent/state/RouteNextHopEntry.h"
 #include "fboss/agent/state/StateDelta.h"
 #include "fboss/agent/types.h"
 
@@ -22,6 +23,7 @@
 
 #include <memory>
 #include <mutex>
+#include <optional>
 
 namespace facebook::fboss {
 
@@ -100,6 +102,14 @@ class SaiRouteManager {
       const std::shared_ptr<Route<AddrT>>& swRoute,
       RouterID routerId);
 
+  /*
+   * Next hops of the ECMP group a route points to, or none if it does not
+   * point to a next hop group
+   */
+  template <typename AddrT>
+  static std::optional<RouteNextHopEntry::NextHopSet> getEcmpNextHops(
+      const std::shared_ptr<Route<AddrT>>& swRoute);
+
   SaiRouteHandle* getRouteHandle(const SaiRouteTraits::RouteEntry& entry);
   const SaiRouteHandle* getRouteHandle(
       const SaiRouteTraits::RouteEntry& entry) const;
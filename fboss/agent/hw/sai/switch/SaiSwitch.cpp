@@ -13,6 +13,7 @@
 #include "fboss/agent/Constants.h"
 #include "fboss/agent/Utils.h"
 #include "fboss/agent/hw/HwPortFb303Stats.h"
+#include "fboss/agent/hw/HwProgrammingScheduler.h"
 #include "fboss/agent/hw/HwResourceStatsPublisher.h"
 #include "fboss/agent/hw/gen-cpp2/hardware_stats_types.h"
 #include "fboss/agent/hw/sai/api/AdapterKeySerializers.h"
@@ -22,6 +23,7 @@
 #include "fboss/agent/hw/sai/api/SaiApiTable.h"
 #include "fboss/agent/hw/sai/api/SaiObjectApi.h"
 #include "fboss/agent/hw/sai/api/Types.h"
+#include "fboss/agent/hw/sai/store/SaiObjectEventPublisher.h"
 #include "fboss/agent/hw/sai/store/SaiStore.h"
 #include "fboss/agent/hw/sai/switch/ConcurrentIndices.h"
 #include "fboss/agent/hw/sai/switch/SaiAclTableGroupManager.h"
@@ -33,12 +35,14 @@
 #include "fboss/agent/hw/sai/switch/SaiInSegEntryManager.h"
 #include "fboss/agent/hw/sai/switch/SaiManagerTable.h"
 #include "fboss/agent/hw/sai/switch/SaiNeighborManager.h"
+#include "fboss/agent/hw/sai/switch/SaiNextHopGroupManager.h"
 #include "fboss/agent/hw/sai/switch/SaiPortManager.h"
 #include "fboss/agent/hw/sai/switch/SaiRouteManager.h"
 #include "fboss/agent/hw/sai/switch/SaiRouterInterfaceManager.h"
 #include "fboss/agent/hw/sai/switch/SaiRxPacket.h"
 #include "fboss/agent/hw/sai/switch/SaiSwitchManager.h"
 #include "fboss/agent/hw/sai/switch/SaiTxPacket.h"
+#include "fboss/agent/hw/sai/switch/SaiTxQueue.h"
 #include "fboss/agent/hw/sai/switch/SaiUnsupportedFeatureManager.h"
 #include "fboss/agent/hw/sai/switch/SaiVlanManager.h"
 #include "fboss/agent/packet/EthHdr.h"
@@ -51,8 +55,12 @@
 #include "fboss/agent/hw/HwSwitchWarmBootHelper.h"
 #include "fboss/agent/hw/switch_asics/HwAsic.h"
 
+#include <folly/Conv.h>
+#include <folly/ScopeGuard.h>
 #include <folly/logging/xlog.h>
 
+#include <algorithm>
+#include <map>
 #include <optional>
 
 extern "C" {
@@ -74,6 +82,19 @@ DEFINE_string(
     "CRITICAL",
     "Turn on SAI SDK logging. Options are DEBUG|INFO|NOTICE|WARN|ERROR|CRITICAL");
 
+DEFINE_bool(
+    sai_async_tx,
+    false,
+    "Send packets passed to the async TX APIs from a dedicated TX thread");
+DEFINE_int32(
+    sai_tx_queue_size,
+    4096,
+    "Number of packets the async TX queue holds before dropping");
+DEFINE_int32(
+    sai_tx_batch_size,
+    64,
+    "Max number of packets the TX thread sends per wakeup");
+
 namespace {
 /*
  * For the devices/SDK we use, the only events we should get (and process)
@@ -135,15 +156,39 @@ PortSaiId SaiSwitch::getCPUPortSaiId(SwitchSaiId switchId) {
 }
 
 SaiSwitch::SaiSwitch(SaiPlatform* platform, uint32_t featuresDesired)
-    : HwSwitch(featuresDesired), platform_(platform) {
+    : HwSwitch(featuresDesired),
+      platform_(platform),
+      programmingExecutor_(
+          HwProgrammingScheduler::createExecutor("SaiProgramming")) {
   utilCreateDir(platform_->getVolatileStateDir());
   utilCreateDir(platform_->getPersistentStateDir());
 }
 
-SaiSwitch::~SaiSwitch() {}
+SaiSwitch::~SaiSwitch() {
+  // The TX thread sends through managers and indices owned by this object
+  if (txQueue_) {
+    txQueue_->stop();
+  }
+}
 
 HwInitResult SaiSwitch::init(Callback* callback) noexcept {
   HwInitResult ret;
+  if (FLAGS_sai_async_tx) {
+    txQueue_ = std::make_unique<SaiTxQueue>(
+        "fbossSaiTx",
+        FLAGS_sai_tx_queue_size,
+        FLAGS_sai_tx_batch_size,
+        [this](SaiTxQueue::TxRequest& request) {
+          return request.portID
+              ? sendPacketOutOfPortSync(
+                    std::move(request.pkt),
+                    *request.portID,
+                    request.queueId)
+              : sendPacketSwitchedSync(std::move(request.pkt));
+        },
+        getSwitchStats());
+    txQueue_->start();
+  }
   {
     std::lock_guard<std::mutex> lock(saiSwitchMutex_);
     ret = initLocked(lock, callback);
@@ -214,6 +259,12 @@ void SaiSwitch::unregisterCallbacks() noexcept {
 
   fdbEventBottomHalfEventBase_.terminateLoopSoon();
   fdbEventBottomHalfThread_->join();
+
+  // Flush packets still queued for TX, async sends after this point are
+  // dropped
+  if (txQueue_) {
+    txQueue_->stop();
+  }
 }
 
 template <typename ManagerT>
@@ -273,119 +324,164 @@ void SaiSwitch::processLinkStateChangeDelta(const StateDelta& delta) {
 }
 
 std::shared_ptr<SwitchState> SaiSwitch::stateChanged(const StateDelta& delta) {
-  processRemovedDelta(
-      delta.getPortsDelta(),
-      managerTable_->portManager(),
-      &SaiPortManager::removePort);
-  processChangedDelta(
-      delta.getPortsDelta(),
-      managerTable_->portManager(),
-      &SaiPortManager::changePort);
-  processAddedDelta(
-      delta.getPortsDelta(),
-      managerTable_->portManager(),
-      &SaiPortManager::addPort);
-  processDelta(
-      delta.getVlansDelta(),
-      managerTable_->vlanManager(),
-      &SaiVlanManager::changeVlan,
-      &SaiVlanManager::addVlan,
-      &SaiVlanManager::removeVlan);
+  /*
+   * Each step below only depends on the steps it lists, and every object is
+   * programmed under saiSwitchMutex_. So with hw_programming_threads set,
+   * independent steps run concurrently: while one step programs, others walk
+   * their part of the delta, e.g. sort the ACLs by priority or merge large
+   * route tables, instead of waiting for their turn on the update thread.
+   */
+  HwProgrammingScheduler scheduler(programmingExecutor_.get());
+
+  auto ports = scheduler.add("ports", [this, &delta]() {
+    processRemovedDelta(
+        delta.getPortsDelta(),
+        managerTable_->portManager(),
+        &SaiPortManager::removePort);
+    processChangedDelta(
+        delta.getPortsDelta(),
+        managerTable_->portManager(),
+        &SaiPortManager::changePort);
+    processAddedDelta(
+        delta.getPortsDelta(),
+        managerTable_->portManager(),
+        &SaiPortManager::addPort);
+  });
+  auto vlans = scheduler.add(
+      "vlans",
+      [this, &delta]() {
+        processDelta(
+            delta.getVlansDelta(),
+            managerTable_->vlanManager(),
+            &SaiVlanManager::changeVlan,
+            &SaiVlanManager::addVlan,
+            &SaiVlanManager::removeVlan);
+      },
+      {ports});
 
   // LAGs
-  processDelta(
-      delta.getAggregatePortsDelta(),
-      managerTable_->lagManager(),
-      &SaiUnsupportedFeatureManager::processChanged,
-      &SaiUnsupportedFeatureManager::processAdded,
-      &SaiUnsupportedFeatureManager::processRemoved);
-
-  if (platform_->getAsic()->isSupported(HwAsic::Feature::QOS_MAP_GLOBAL)) {
-    processDefaultDataPlanePolicyDelta(delta, managerTable_->switchManager());
-  } else {
-    processDefaultDataPlanePolicyDelta(delta, managerTable_->portManager());
-  }
-
-  processDelta(
-      delta.getIntfsDelta(),
-      managerTable_->routerInterfaceManager(),
-      &SaiRouterInterfaceManager::changeRouterInterface,
-      &SaiRouterInterfaceManager::addRouterInterface,
-      &SaiRouterInterfaceManager::removeRouterInterface);
+  auto lags = scheduler.add(
+      "lags",
+      [this, &delta]() {
+        processDelta(
+            delta.getAggregatePortsDelta(),
+            managerTable_->lagManager(),
+            &SaiUnsupportedFeatureManager::processChanged,
+            &SaiUnsupportedFeatureManager::processAdded,
+            &SaiUnsupportedFeatureManager::processRemoved);
+      },
+      {ports});
+
+  auto qos = scheduler.add(
+      "default qos policy",
+      [this, &delta]() {
+        if (platform_->getAsic()->isSupported(
+                HwAsic::Feature::QOS_MAP_GLOBAL)) {
+          processDefaultDataPlanePolicyDelta(
+              delta, managerTable_->switchManager());
+        } else {
+          processDefaultDataPlanePolicyDelta(
+              delta, managerTable_->portManager());
+        }
+      },
+      {ports});
+
+  auto intfs = scheduler.add(
+      "interfaces",
+      [this, &delta]() {
+        processDelta(
+            delta.getIntfsDelta(),
+            managerTable_->routerInterfaceManager(),
+            &SaiRouterInterfaceManager::changeRouterInterface,
+            &SaiRouterInterfaceManager::addRouterInterface,
+            &SaiRouterInterfaceManager::removeRouterInterface);
+      },
+      {vlans, lags, qos});
 
+  // Neighbors and MACs of different VLANs are independent of each other
+  std::vector<HwProgrammingScheduler::StepID> neighbors{intfs};
   for (const auto& vlanDelta : delta.getVlansDelta()) {
-    processDelta(
-        vlanDelta.getArpDelta(),
-        managerTable_->neighborManager(),
-        &SaiNeighborManager::changeNeighbor<ArpEntry>,
-        &SaiNeighborManager::addNeighbor<ArpEntry>,
-        &SaiNeighborManager::removeNeighbor<ArpEntry>);
-
-    processDelta(
-        vlanDelta.getNdpDelta(),
-        managerTable_->neighborManager(),
-        &SaiNeighborManager::changeNeighbor<NdpEntry>,
-        &SaiNeighborManager::addNeighbor<NdpEntry>,
-        &SaiNeighborManager::removeNeighbor<NdpEntry>);
-
-    processDelta(
-        vlanDelta.getMacDelta(),
-        managerTable_->fdbManager(),
-        &SaiFdbManager::changeMac,
-        &SaiFdbManager::addMac,
-        &SaiFdbManager::removeMac);
+    auto vlan = vlanDelta.getOld() ? vlanDelta.getOld() : vlanDelta.getNew();
+    neighbors.push_back(scheduler.add(
+        folly::to<std::string>(
+            "vlan ", static_cast<int>(vlan->getID()), " neighbors"),
+        [this, vlanDelta]() { processNeighborsDelta(vlanDelta); },
+        {intfs}));
   }
 
   for (const auto& routeDelta : delta.getRouteTablesDelta()) {
     auto routerID = routeDelta.getOld() ? routeDelta.getOld()->getID()
                                         : routeDelta.getNew()->getID();
-    processDelta(
-        routeDelta.getRoutesV4Delta(),
-        managerTable_->routeManager(),
-        &SaiRouteManager::changeRoute<folly::IPAddressV4>,
-        &SaiRouteManager::addRoute<folly::IPAddressV4>,
-        &SaiRouteManager::removeRoute<folly::IPAddressV4>,
-        routerID);
+    scheduler.add(
+        folly::to<std::string>("vrf ", static_cast<int>(routerID), " routes"),
+        [this, routeDelta, routerID]() {
+          processRoutesDelta(routeDelta.getRoutesV4Delta(), routerID);
+          processRoutesDelta(routeDelta.getRoutesV6Delta(), routerID);
+        },
+        neighbors);
+  }
 
+  scheduler.add(
+      "control plane",
+      [this, &delta]() {
+        auto controlPlaneDelta = delta.getControlPlaneDelta();
+        if (controlPlaneDelta.getOld() != controlPlaneDelta.getNew()) {
+          auto lock = std::lock_guard<std::mutex>(saiSwitchMutex_);
+          managerTable_->hostifManager().processHostifDelta(
+              controlPlaneDelta);
+        }
+      },
+      {ports, qos});
+
+  scheduler.add(
+      "label fib",
+      [this, &delta]() {
+        processDelta(
+            delta.getLabelForwardingInformationBaseDelta(),
+            managerTable_->inSegEntryManager(),
+            &SaiInSegEntryManager::processChangedInSegEntry,
+            &SaiInSegEntryManager::processAddedInSegEntry,
+            &SaiInSegEntryManager::processRemovedInSegEntry);
+      },
+      neighbors);
+  scheduler.add("load balancers", [this, &delta]() {
     processDelta(
-        routeDelta.getRoutesV6Delta(),
-        managerTable_->routeManager(),
-        &SaiRouteManager::changeRoute<folly::IPAddressV6>,
-        &SaiRouteManager::addRoute<folly::IPAddressV6>,
-        &SaiRouteManager::removeRoute<folly::IPAddressV6>,
-        routerID);
+        delta.getLoadBalancersDelta(),
+        managerTable_->switchManager(),
+        &SaiSwitchManager::changeLoadBalancer,
+        &SaiSwitchManager::addOrUpdateLoadBalancer,
+        &SaiSwitchManager::removeLoadBalancer);
+  });
+
+  if (delta.getSummary().changed(StateDeltaSummary::ACLS)) {
+    scheduler.add(
+        "acls",
+        [this, &delta]() {
+          processDelta(
+              delta.getAclsDelta(),
+              managerTable_->aclTableManager(),
+              &SaiAclTableManager::changedAclEntry,
+              &SaiAclTableManager::addAclEntry,
+              &SaiAclTableManager::removeAclEntry,
+              kAclTable1);
+        },
+        {ports, lags});
   }
 
+  // Learning mode and the like apply to the MACs programmed above
+  scheduler.add(
+      "switch settings",
+      [this, &delta]() { processSwitchSettingsChanged(delta); },
+      neighbors);
+
+  scheduler.run();
+
   {
-    auto controlPlaneDelta = delta.getControlPlaneDelta();
-    if (controlPlaneDelta.getOld() != controlPlaneDelta.getNew()) {
-      auto lock = std::lock_guard<std::mutex>(saiSwitchMutex_);
-      managerTable_->hostifManager().processHostifDelta(controlPlaneDelta);
-    }
+    // Members removed on link down stay out until the port is up again
+    auto lock = std::lock_guard<std::mutex>(saiSwitchMutex_);
+    managerTable_->nextHopGroupManager().reconcileLinkState(delta);
   }
 
-  processDelta(
-      delta.getLabelForwardingInformationBaseDelta(),
-      managerTable_->inSegEntryManager(),
-      &SaiInSegEntryManager::processChangedInSegEntry,
-      &SaiInSegEntryManager::processAddedInSegEntry,
-      &SaiInSegEntryManager::processRemovedInSegEntry);
-  processDelta(
-      delta.getLoadBalancersDelta(),
-      managerTable_->switchManager(),
-      &SaiSwitchManager::changeLoadBalancer,
-      &SaiSwitchManager::addOrUpdateLoadBalancer,
-      &SaiSwitchManager::removeLoadBalancer);
-
-  processDelta(
-      delta.getAclsDelta(),
-      managerTable_->aclTableManager(),
-      &SaiAclTableManager::changedAclEntry,
-      &SaiAclTableManager::addAclEntry,
-      &SaiAclTableManager::removeAclEntry,
-      kAclTable1);
-
-  processSwitchSettingsChanged(delta);
   if (platform_->getAsic()->isSupported(
           HwAsic::Feature::RESOURCE_USAGE_STATS)) {
     auto lock = std::lock_guard<std::mutex>(saiSwitchMutex_);
@@ -520,38 +616,50 @@ std::unique_ptr<TxPacket> SaiSwitch::allocatePacket(uint32_t size) const {
 
 bool SaiSwitch::sendPacketSwitchedAsync(
     std::unique_ptr<TxPacket> pkt) noexcept {
-  return sendPacketSwitchedSync(std::move(pkt));
+  if (!txQueue_) {
+    return sendPacketSwitchedSync(std::move(pkt));
+  }
+  return txQueue_->enqueue(std::move(pkt));
 }
 
 bool SaiSwitch::sendPacketOutOfPortAsync(
     std::unique_ptr<TxPacket> pkt,
     PortID portID,
     std::optional<uint8_t> queueId) noexcept {
-  return sendPacketOutOfPortSync(std::move(pkt), portID, queueId);
+  if (!txQueue_) {
+    return sendPacketOutOfPortSync(std::move(pkt), portID, queueId);
+  }
+  return txQueue_->enqueue(std::move(pkt), portID, queueId);
 }
 
 void SaiSwitch::updateStatsImpl(SwitchStats* /* switchStats */) {
+  statsScheduler_.startRound();
   auto& portManager = managerTable_->portManager();
-  auto iter = concurrentIndices_->portIds.begin();
-  while (iter != concurrentIndices_->portIds.end()) {
-    {
-      std::lock_guard<std::mutex> locked(saiSwitchMutex_);
-      portManager.updateStats(iter->second);
+  statsScheduler_.timed(HwStatsCategory::PORT_COUNTERS, [&]() {
+    auto iter = concurrentIndices_->portIds.begin();
+    while (iter != concurrentIndices_->portIds.end()) {
+      auto portId = iter->second;
+      if (statsScheduler_.isDue(HwStatsCategory::PORT_COUNTERS, portId)) {
+        auto updateErrorStats =
+            statsScheduler_.isDue(HwStatsCategory::PORT_ERRORS, portId);
+        std::lock_guard<std::mutex> locked(saiSwitchMutex_);
+        portManager.updateStats(portId, updateErrorStats);
+      }
+      ++iter;
     }
-    ++iter;
-  }
-  {
+  });
+  statsScheduler_.collect(HwStatsCategory::CPU, [this]() {
     std::lock_guard<std::mutex> locked(saiSwitchMutex_);
     managerTable_->hostifManager().updateStats();
-  }
-  {
+  });
+  statsScheduler_.collect(HwStatsCategory::BUFFERS, [this]() {
     std::lock_guard<std::mutex> locked(saiSwitchMutex_);
     managerTable_->bufferManager().updateStats();
-  }
-  {
+  });
+  statsScheduler_.collect(HwStatsCategory::RESOURCES, [this]() {
     std::lock_guard<std::mutex> locked(saiSwitchMutex_);
     HwResourceStatsPublisher().publish(hwResourceStats_);
-  }
+  });
 }
 
 uint64_t SaiSwitch::getDeviceWatermarkBytes() const {
@@ -705,6 +813,8 @@ void SaiSwitch::linkStateChangedCallbackBottomHalf(
        * already resolved neighbors over that link.
        */
       std::lock_guard<std::mutex> lock{saiSwitchMutex_};
+      // Shrink the ECMP groups over the port before its FDB entries go
+      managerTable_->nextHopGroupManager().handleLinkDown(swPortId);
       managerTable_->fdbManager().handleLinkDown(swPortId);
     }
     swPortId2Status[swPortId] = up;
@@ -1332,6 +1442,135 @@ void SaiSwitch::processRemovedDelta(
       });
 }
 
+template <typename Delta>
+void SaiSwitch::processNeighborDelta(Delta delta) {
+  using NeighborEntryT = typename Delta::Node;
+  auto& neighborManager = managerTable_->neighborManager();
+  std::vector<std::shared_ptr<NeighborEntryT>> addedNeighbors;
+  DeltaFunctions::forEachChanged(
+      delta,
+      [&](const std::shared_ptr<NeighborEntryT>& oldNeighbor,
+          const std::shared_ptr<NeighborEntryT>& newNeighbor) {
+        neighborManager.changeNeighbor(oldNeighbor, newNeighbor);
+      },
+      [&](const std::shared_ptr<NeighborEntryT>& addedNeighbor) {
+        addedNeighbors.push_back(addedNeighbor);
+      },
+      [&](const std::shared_ptr<NeighborEntryT>& removedNeighbor) {
+        neighborManager.removeNeighbor(removedNeighbor);
+      });
+  // Removed neighbors go first, as added ones may take their place
+  neighborManager.addNeighbors(addedNeighbors);
+}
+
+void SaiSwitch::processNeighborsDelta(const VlanDelta& vlanDelta) {
+  auto lock = std::lock_guard<std::mutex>(saiSwitchMutex_);
+  auto publisher = SaiObjectEventPublisher::getInstance();
+  publisher->beginBatch();
+  try {
+    processNeighborDelta(vlanDelta.getArpDelta());
+    processNeighborDelta(vlanDelta.getNdpDelta());
+    auto& fdbManager = managerTable_->fdbManager();
+    DeltaFunctions::forEachChanged(
+        vlanDelta.getMacDelta(),
+        [&](const std::shared_ptr<MacEntry>& oldMac,
+            const std::shared_ptr<MacEntry>& newMac) {
+          fdbManager.changeMac(oldMac, newMac);
+        },
+        [&](const std::shared_ptr<MacEntry>& addedMac) {
+          fdbManager.addMac(addedMac);
+        },
+        [&](const std::shared_ptr<MacEntry>& removedMac) {
+          fdbManager.removeMac(removedMac);
+        });
+    // Programs the objects depending on the batched ones, e.g. next hops
+    publisher->endBatch();
+  } catch (const std::exception&) {
+    // Do not program anything more once programming failed, the failure is
+    // handled by the caller
+    publisher->abortBatch();
+    throw;
+  }
+}
+
+template <typename Delta>
+void SaiSwitch::processRoutesDelta(Delta delta, RouterID routerID) {
+  using RouteT = typename Delta::Node;
+  using AddrT = typename RouteT::Addr;
+  // Old and new route, no old route for added routes
+  using RouteChange =
+      std::pair<std::shared_ptr<RouteT>, std::shared_ptr<RouteT>>;
+  struct EcmpRouteChanges {
+    RouteNextHopEntry::NextHopSet nextHops;
+    bool groupExists{false};
+    std::vector<RouteChange> changes;
+  };
+
+  std::vector<RouteChange> nonEcmpChanges;
+  std::vector<EcmpRouteChanges> ecmpChanges;
+  std::map<RouteNextHopEntry::NextHopSet, size_t> ecmpChangesIndex;
+  auto addChange = [&](const std::shared_ptr<RouteT>& oldRoute,
+                       const std::shared_ptr<RouteT>& newRoute) {
+    auto nextHops = SaiRouteManager::getEcmpNextHops(newRoute);
+    if (!nextHops) {
+      nonEcmpChanges.emplace_back(oldRoute, newRoute);
+      return;
+    }
+    auto ins = ecmpChangesIndex.emplace(*nextHops, ecmpChanges.size());
+    if (ins.second) {
+      ecmpChanges.push_back({*nextHops, false, {}});
+    }
+    ecmpChanges[ins.first->second].changes.emplace_back(oldRoute, newRoute);
+  };
+  DeltaFunctions::forEachChanged(
+      delta,
+      [&](const std::shared_ptr<RouteT>& oldRoute,
+          const std::shared_ptr<RouteT>& newRoute) {
+        addChange(oldRoute, newRoute);
+      },
+      [&](const std::shared_ptr<RouteT>& newRoute) {
+        addChange(nullptr, newRoute);
+      },
+      [](const std::shared_ptr<RouteT>& /*removed*/) {});
+
+  auto& routeManager = managerTable_->routeManager();
+  auto& nextHopGroupManager = managerTable_->nextHopGroupManager();
+  {
+    auto lock = std::lock_guard<std::mutex>(saiSwitchMutex_);
+    nextHopGroupManager.beginRouteProgramming();
+    for (auto& ecmp : ecmpChanges) {
+      ecmp.groupExists = nextHopGroupManager.pinNextHopGroup(ecmp.nextHops);
+    }
+  }
+  SCOPE_EXIT {
+    auto lock = std::lock_guard<std::mutex>(saiSwitchMutex_);
+    nextHopGroupManager.endRouteProgramming();
+  };
+  std::stable_partition(
+      ecmpChanges.begin(), ecmpChanges.end(), [](const auto& ecmp) {
+        return ecmp.groupExists;
+      });
+
+  processRemovedDelta(
+      delta, routeManager, &SaiRouteManager::removeRoute<AddrT>, routerID);
+  auto programChange = [&](const RouteChange& change) {
+    auto lock = std::lock_guard<std::mutex>(saiSwitchMutex_);
+    if (change.first) {
+      routeManager.changeRoute(change.first, change.second, routerID);
+    } else {
+      routeManager.addRoute(change.second, routerID);
+    }
+  };
+  for (const auto& change : nonEcmpChanges) {
+    programChange(change);
+  }
+  for (const auto& ecmp : ecmpChanges) {
+    for (const auto& change : ecmp.changes) {
+      programChange(change);
+    }
+  }
+}
+
 void SaiSwitch::dumpDebugState(const std::string& path) const {
   saiCheckError(sai_dbg_generate_dump(path.c_str()));
 }
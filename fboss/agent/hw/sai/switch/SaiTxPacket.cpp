@@ -11,13 +11,58 @@
 #include "fboss/agent/hw/sai/switch/SaiTxPacket.h"
 #include "fboss/agent/hw/sai/switch/SaiPortManager.h"
 
+#include <folly/MPMCQueue.h>
 #include <folly/io/IOBuf.h>
 
+#include <cstdlib>
+
+namespace {
+
+using facebook::fboss::SaiTxPacket;
+
+folly::MPMCQueue<void*>& bufferPool() {
+  // Leaked on purpose: packets may be freed after static destruction starts
+  static auto* pool =
+      new folly::MPMCQueue<void*>(SaiTxPacket::kMaxPooledBuffers);
+  return *pool;
+}
+
+void* allocateBuffer() {
+  void* buf;
+  if (bufferPool().read(buf)) {
+    return buf;
+  }
+  buf = std::malloc(SaiTxPacket::kPooledBufferSize);
+  if (!buf) {
+    throw std::bad_alloc();
+  }
+  return buf;
+}
+
+void freeBuffer(void* buf, void* /* userData */) {
+  if (!bufferPool().write(buf)) {
+    std::free(buf);
+  }
+}
+
+} // namespace
+
 namespace facebook::fboss {
 
 SaiTxPacket::SaiTxPacket(uint32_t size) {
-  buf_ = folly::IOBuf::createSeparate(size);
-  buf_->append(size);
+  if (size > kPooledBufferSize) {
+    buf_ = folly::IOBuf::createSeparate(size);
+    buf_->append(size);
+    return;
+  }
+  buf_ = folly::IOBuf::takeOwnership(
+      allocateBuffer(), kPooledBufferSize, freeBuffer, nullptr);
+  buf_->trimEnd(kPooledBufferSize - size);
+}
+
+size_t SaiTxPacket::pooledBuffers() {
+  auto size = bufferPool().sizeGuess();
+  return size > 0 ? static_cast<size_t>(size) : 0;
 }
 
 } // namespace facebook::fboss
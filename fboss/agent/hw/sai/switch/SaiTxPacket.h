@@ -17,7 +17,18 @@ namespace facebook::fboss {
 
 class SaiTxPacket : public TxPacket {
  public:
+  /*
+   * Packets up to kPooledBufferSize bytes, i.e. all control plane packets we
+   * send, use buffers recycled from a process wide pool instead of a fresh
+   * allocation per packet. Larger packets fall back to a regular IOBuf.
+   */
+  static auto constexpr kPooledBufferSize = 2048;
+  static auto constexpr kMaxPooledBuffers = 8192;
+
   explicit SaiTxPacket(uint32_t size);
+
+  // Number of free buffers currently held by the pool
+  static size_t pooledBuffers();
 };
 
 } // namespace facebook::fboss
@@ -0,0 +1,139 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/sai/switch/SaiTxQueue.h"
+
+#include "fboss/agent/Utils.h"
+#include "fboss/agent/hw/HwSwitchStats.h"
+
+#include <folly/logging/xlog.h>
+
+#include <algorithm>
+
+namespace facebook::fboss {
+
+SaiTxQueue::SaiTxQueue(
+    std::string threadName,
+    uint32_t capacity,
+    uint32_t maxBatchSize,
+    SendFn sendFn,
+    HwSwitchStats* stats)
+    : threadName_(std::move(threadName)),
+      maxBatchSize_(std::max<uint32_t>(maxBatchSize, 1)),
+      sendFn_(std::move(sendFn)),
+      stats_(stats),
+      // One extra slot for the stop marker
+      queue_(std::max<uint32_t>(capacity, 1) + 1) {}
+
+SaiTxQueue::~SaiTxQueue() {
+  stop();
+}
+
+void SaiTxQueue::start() {
+  if (thread_) {
+    return;
+  }
+  thread_ = std::make_unique<std::thread>([this]() {
+    initThread(threadName_);
+    txThread();
+  });
+  running_.store(true, std::memory_order_release);
+}
+
+void SaiTxQueue::stop() {
+  if (!thread_) {
+    return;
+  }
+  running_.store(false, std::memory_order_seq_cst);
+  while (activeProducers_.load(std::memory_order_seq_cst) != 0) {
+    std::this_thread::yield();
+  }
+  // A request without a packet tells the TX thread to exit once everything
+  // queued ahead of it is sent
+  queue_.blockingWrite(TxRequest{});
+  thread_->join();
+  thread_.reset();
+}
+
+bool SaiTxQueue::enqueue(
+    std::unique_ptr<TxPacket> pkt,
+    std::optional<PortID> portID,
+    std::optional<uint8_t> queueId) noexcept {
+  activeProducers_.fetch_add(1, std::memory_order_seq_cst);
+  bool queued = false;
+  if (running_.load(std::memory_order_seq_cst)) {
+    queued = queue_.write(TxRequest{
+        std::move(pkt), portID, queueId, std::chrono::steady_clock::now()});
+  }
+  activeProducers_.fetch_sub(1, std::memory_order_seq_cst);
+
+  if (queued) {
+    enqueued_.fetch_add(1, std::memory_order_release);
+  } else {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    if (stats_) {
+      stats_->txQueueFull();
+    }
+  }
+  return queued;
+}
+
+void SaiTxQueue::waitUntilDrained() const {
+  auto target = enqueued_.load(std::memory_order_acquire);
+  while (sent_.load(std::memory_order_acquire) < target) {
+    std::this_thread::yield();
+  }
+}
+
+void SaiTxQueue::txThread() {
+  std::vector<TxRequest> batch;
+  batch.reserve(maxBatchSize_);
+  bool stopping = false;
+  while (!stopping) {
+    TxRequest request;
+    queue_.blockingRead(request);
+    // Drain whatever else is already queued, up to the batch size, so that a
+    // burst of packets costs a single wakeup of this thread
+    do {
+      if (!request.pkt) {
+        stopping = true;
+        break;
+      }
+      batch.push_back(std::move(request));
+    } while (batch.size() < maxBatchSize_ && queue_.read(request));
+    if (!batch.empty()) {
+      sendBatch(batch);
+    }
+  }
+  XLOG(DBG2) << threadName_ << " exiting, dropped " << droppedPackets()
+             << " packets on full queue";
+}
+
+void SaiTxQueue::sendBatch(std::vector<TxRequest>& batch) {
+  if (stats_) {
+    stats_->txQueueDepth(batch.size() + depth());
+  }
+  for (auto& request : batch) {
+    auto queued = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - request.enqueueTime);
+    bool sent = sendFn_(request);
+    if (stats_) {
+      if (sent) {
+        stats_->txSentDone(queued.count());
+      } else {
+        stats_->txError();
+      }
+    }
+  }
+  sent_.fetch_add(batch.size(), std::memory_order_release);
+  batch.clear();
+}
+
+} // namespace facebook::fboss
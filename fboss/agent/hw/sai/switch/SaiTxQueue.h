@@ -0,0 +1,113 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/agent/TxPacket.h"
+#include "fboss/agent/types.h"
+
+#include <folly/MPMCQueue.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace facebook::fboss {
+
+class HwSwitchStats;
+
+/*
+ * SaiTxQueue decouples callers of the async TX APIs from the SAI
+ * send_hostif_packet call. Any number of producers enqueue packets into a
+ * bounded queue without blocking, and a single TX thread drains the queue in
+ * batches, sending each packet with the supplied send function.
+ *
+ * Packets which do not fit in the queue are dropped and counted as tx errors,
+ * matching what a full hardware TX ring does on native SDKs.
+ */
+class SaiTxQueue {
+ public:
+  struct TxRequest {
+    std::unique_ptr<TxPacket> pkt;
+    // Egress port for packets sent out of port, unset for packets sent
+    // through the pipeline
+    std::optional<PortID> portID;
+    std::optional<uint8_t> queueId;
+    std::chrono::steady_clock::time_point enqueueTime;
+  };
+  using SendFn = std::function<bool(TxRequest& request)>;
+
+  SaiTxQueue(
+      std::string threadName,
+      uint32_t capacity,
+      uint32_t maxBatchSize,
+      SendFn sendFn,
+      HwSwitchStats* stats = nullptr);
+  ~SaiTxQueue();
+
+  void start();
+  /*
+   * Stop accepting packets, send whatever is still queued and join the TX
+   * thread.
+   */
+  void stop();
+
+  bool isRunning() const {
+    return running_.load(std::memory_order_acquire);
+  }
+
+  /*
+   * Queue a packet for TX. Returns false if the queue is not running or is
+   * full, in which case the packet is freed.
+   */
+  bool enqueue(
+      std::unique_ptr<TxPacket> pkt,
+      std::optional<PortID> portID = std::nullopt,
+      std::optional<uint8_t> queueId = std::nullopt) noexcept;
+
+  /*
+   * Block until every packet enqueued before this call has been handed to
+   * the send function.
+   */
+  void waitUntilDrained() const;
+
+  size_t depth() const {
+    auto size = queue_.sizeGuess();
+    return size > 0 ? static_cast<size_t>(size) : 0;
+  }
+  uint64_t droppedPackets() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  void txThread();
+  void sendBatch(std::vector<TxRequest>& batch);
+
+  std::string threadName_;
+  uint32_t maxBatchSize_;
+  SendFn sendFn_;
+  HwSwitchStats* stats_;
+
+  folly::MPMCQueue<TxRequest> queue_;
+  std::atomic<bool> running_{false};
+  // Producers between the running_ check and the queue write, stop() waits
+  // for these to finish so that no packet is left behind in the queue
+  std::atomic<uint32_t> activeProducers_{0};
+  std::atomic<uint64_t> enqueued_{0};
+  std::atomic<uint64_t> sent_{0};
+  std::atomic<uint64_t> dropped_{0};
+  std::unique_ptr<std::thread> thread_;
+};
+
+} // namespace facebook::fboss
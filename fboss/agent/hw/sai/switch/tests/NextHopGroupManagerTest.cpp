@@ -14,7 +14,11 @@
 #include "fboss/agent/hw/sai/switch/SaiNeighborManager.h"
 #include "fboss/agent/hw/sai/switch/SaiNextHopGroupManager.h"
 #include "fboss/agent/hw/sai/switch/tests/ManagerTestBase.h"
+#include "fboss/agent/state/Port.h"
+#include "fboss/agent/state/PortMap.h"
 #include "fboss/agent/state/RouteNextHopEntry.h"
+#include "fboss/agent/state/StateDelta.h"
+#include "fboss/agent/state/SwitchState.h"
 #include "fboss/agent/types.h"
 
 using namespace facebook::fboss;
@@ -126,6 +130,27 @@ TEST_F(NextHopGroupManagerTest, deleteNextHopGroup) {
   EXPECT_TRUE(counter.expired());
 }
 
+TEST_F(NextHopGroupManagerTest, pinNextHopGroup) {
+  ResolvedNextHop nh1{h0.ip, InterfaceID(intf0.id), ECMP_WEIGHT};
+  ResolvedNextHop nh2{h1.ip, InterfaceID(intf1.id), ECMP_WEIGHT};
+  RouteNextHopEntry::NextHopSet swNextHops{nh1, nh2};
+  auto& nextHopGroupManager = saiManagerTable->nextHopGroupManager();
+  nextHopGroupManager.beginRouteProgramming();
+  EXPECT_FALSE(nextHopGroupManager.pinNextHopGroup(swNextHops));
+  auto saiNextHopGroupHandle =
+      nextHopGroupManager.incRefOrAddNextHopGroup(swNextHops);
+  EXPECT_TRUE(nextHopGroupManager.pinNextHopGroup(swNextHops));
+  auto saiNextHopGroup = saiNextHopGroupHandle->nextHopGroup;
+  saiNextHopGroupHandle.reset();
+  // The pin keeps the group while no route references it
+  EXPECT_EQ(saiNextHopGroup.use_count(), 2);
+  EXPECT_EQ(
+      nextHopGroupManager.incRefOrAddNextHopGroup(swNextHops)->nextHopGroup,
+      saiNextHopGroup);
+  nextHopGroupManager.endRouteProgramming();
+  EXPECT_EQ(saiNextHopGroup.use_count(), 1);
+}
+
 TEST_F(NextHopGroupManagerTest, resolveNeighborBefore) {
   auto arpEntry0 = resolveArp(intf0.id, h0);
   auto arpEntry1 = resolveArp(intf1.id, h1);
@@ -139,6 +164,39 @@ TEST_F(NextHopGroupManagerTest, resolveNeighborBefore) {
   checkNextHopGroup(saiNextHopGroup->adapterKey(), {h0.ip, h1.ip});
 }
 
+TEST_F(NextHopGroupManagerTest, linkDownShrinksNextHopGroup) {
+  auto arpEntry0 = resolveArp(intf0.id, h0);
+  auto arpEntry1 = resolveArp(intf1.id, h1);
+  ResolvedNextHop nh1{h0.ip, InterfaceID(intf0.id), ECMP_WEIGHT};
+  ResolvedNextHop nh2{h1.ip, InterfaceID(intf1.id), ECMP_WEIGHT};
+  RouteNextHopEntry::NextHopSet swNextHops{nh1, nh2};
+  auto& nextHopGroupManager = saiManagerTable->nextHopGroupManager();
+  auto saiNextHopGroupHandle =
+      nextHopGroupManager.incRefOrAddNextHopGroup(swNextHops);
+  auto nextHopGroupId = saiNextHopGroupHandle->nextHopGroup->adapterKey();
+
+  EXPECT_EQ(nextHopGroupManager.handleLinkDown(PortID(h0.port.id)), 1);
+  checkNextHopGroup(nextHopGroupId, {h1.ip});
+  // Already shrunk
+  EXPECT_EQ(nextHopGroupManager.handleLinkDown(PortID(h0.port.id)), 0);
+
+  auto makeState = [&](bool up) {
+    auto state = std::make_shared<SwitchState>();
+    auto port = std::make_shared<Port>(PortID(h0.port.id), "port0");
+    port->setOperState(up);
+    state->getPorts()->addPort(port);
+    return state;
+  };
+  // The port is still down in the state, nothing to put back
+  auto downState = makeState(false);
+  nextHopGroupManager.reconcileLinkState(StateDelta(downState, downState));
+  checkNextHopGroup(nextHopGroupId, {h1.ip});
+
+  nextHopGroupManager.reconcileLinkState(
+      StateDelta(downState, makeState(true)));
+  checkNextHopGroup(nextHopGroupId, {h0.ip, h1.ip});
+}
+
 TEST_F(NextHopGroupManagerTest, resolveNeighborAfter) {
   ResolvedNextHop nh1{h0.ip, InterfaceID(intf0.id), ECMP_WEIGHT};
   ResolvedNextHop nh2{h1.ip, InterfaceID(intf1.id), ECMP_WEIGHT};
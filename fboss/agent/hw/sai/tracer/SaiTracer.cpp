@@ -78,6 +78,22 @@ DEFINE_int32(
     "Log timeout value in milliseconds. Logger will periodically"
     "flush logs even if the buffer is not full");
 
+DEFINE_int32(
+    sai_log_num_segments,
+    facebook::fboss::AsyncLogger::kDefaultNumSegments,
+    "Number of segments in the SAI Replayer log ring buffer");
+
+DEFINE_int32(
+    sai_log_segment_size,
+    facebook::fboss::AsyncLogger::kBufferSize,
+    "Size in bytes of each segment in the SAI Replayer log ring buffer");
+
+DEFINE_bool(
+    sai_log_drop_on_full,
+    false,
+    "Drop SAI Replayer log records instead of blocking SAI calls when the "
+    "log ring buffer is full");
+
 using facebook::fboss::SaiTracer;
 using folly::to;
 using std::string;
@@ -274,8 +290,13 @@ namespace facebook::fboss {
 
 SaiTracer::SaiTracer() {
   if (FLAGS_enable_replayer) {
-    asyncLogger_ =
-        std::make_unique<AsyncLogger>(FLAGS_sai_log, FLAGS_log_timeout);
+    asyncLogger_ = std::make_unique<AsyncLogger>(
+        FLAGS_sai_log,
+        FLAGS_log_timeout,
+        FLAGS_sai_log_drop_on_full ? AsyncLogger::BackpressureMode::DROP
+                                   : AsyncLogger::BackpressureMode::BLOCK,
+        FLAGS_sai_log_segment_size,
+        FLAGS_sai_log_num_segments);
 
     asyncLogger_->startFlushThread();
     asyncLogger_->appendLog(cpp_header_, strlen(cpp_header_));
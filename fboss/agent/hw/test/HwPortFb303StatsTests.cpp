@@ -164,6 +164,20 @@ TEST(HwPortFb303Stats, UpdateStats) {
   verifyUpdatedStats(portStats);
 }
 
+TEST(HwPortFb303Stats, UpdateStatsAfterReinit) {
+  // Counters are resolved once per (re)init, make sure updates after
+  // renames land on the current counters
+  HwPortFb303Stats portStats(kPortName, kQueue2Name);
+  portStats.portNameChanged("fab1/1/1");
+  portStats.portNameChanged(kPortName);
+  portStats.queueChanged(1, "platinum");
+  portStats.queueChanged(1, "gold");
+  portStats.queueChanged(3, "bronze");
+  portStats.queueRemoved(3);
+  updateStats(portStats);
+  verifyUpdatedStats(portStats);
+}
+
 TEST(HwPortFb303StatsTest, RenameQueue) {
   HwPortFb303Stats stats(kPortName, kQueue2Name);
   stats.queueChanged(1, "platinum");
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/HwProgrammingScheduler.h"
+
+#include <folly/Synchronized.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+using namespace facebook::fboss;
+
+namespace {
+
+class Recorder {
+ public:
+  std::function<void()> step(int id) {
+    return [this, id]() { done_.wlock()->push_back(id); };
+  }
+
+  std::vector<int> done() const {
+    return *done_.rlock();
+  }
+
+  // Whether before completed ahead of after
+  bool doneBefore(int before, int after) const {
+    auto done = done_.rlock();
+    auto beforeIt = std::find(done->begin(), done->end(), before);
+    auto afterIt = std::find(done->begin(), done->end(), after);
+    return beforeIt < afterIt;
+  }
+
+ private:
+  folly::Synchronized<std::vector<int>> done_;
+};
+
+} // namespace
+
+TEST(HwProgrammingSchedulerTest, SerialRunsInAddOrder) {
+  Recorder recorder;
+  HwProgrammingScheduler scheduler;
+  auto a = scheduler.add("a", recorder.step(0));
+  scheduler.add("b", recorder.step(1));
+  scheduler.add("c", recorder.step(2), {a});
+  scheduler.run();
+  EXPECT_EQ(recorder.done(), (std::vector<int>{0, 1, 2}));
+}
+
+TEST(HwProgrammingSchedulerTest, ConcurrentRespectsDependencies) {
+  folly::CPUThreadPoolExecutor executor(4);
+  for (auto round = 0; round < 20; ++round) {
+    Recorder recorder;
+    HwProgrammingScheduler scheduler(&executor);
+    auto ports = scheduler.add("ports", recorder.step(0));
+    auto intfs = scheduler.add("intfs", recorder.step(1), {ports});
+    std::vector<HwProgrammingScheduler::StepID> neighbors{intfs};
+    for (auto vlan = 0; vlan < 4; ++vlan) {
+      neighbors.push_back(
+          scheduler.add("neighbors", recorder.step(10 + vlan), {intfs}));
+    }
+    scheduler.add("routes", recorder.step(2), neighbors);
+    scheduler.add("acls", recorder.step(3), {ports});
+    scheduler.run();
+
+    ASSERT_EQ(recorder.done().size(), scheduler.numSteps());
+    EXPECT_TRUE(recorder.doneBefore(0, 1));
+    EXPECT_TRUE(recorder.doneBefore(0, 3));
+    for (auto vlan = 0; vlan < 4; ++vlan) {
+      EXPECT_TRUE(recorder.doneBefore(1, 10 + vlan));
+      EXPECT_TRUE(recorder.doneBefore(10 + vlan, 2));
+    }
+  }
+}
+
+TEST(HwProgrammingSchedulerTest, FailureSkipsDependents) {
+  folly::CPUThreadPoolExecutor executor(4);
+  for (auto* executorPtr : {static_cast<folly::Executor*>(nullptr),
+                            static_cast<folly::Executor*>(&executor)}) {
+    Recorder recorder;
+    HwProgrammingScheduler scheduler(executorPtr);
+    auto ports = scheduler.add("ports", recorder.step(0));
+    auto intfs = scheduler.add(
+        "intfs", []() { throw std::runtime_error("intfs"); }, {ports});
+    scheduler.add("routes", recorder.step(2), {intfs});
+    EXPECT_THROW(
+        {
+          try {
+            scheduler.run();
+          } catch (const std::runtime_error& ex) {
+            EXPECT_STREQ("intfs", ex.what());
+            throw;
+          }
+        },
+        std::runtime_error);
+    EXPECT_EQ(recorder.done(), (std::vector<int>{0}));
+  }
+}
@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/HwStatsScheduler.h"
+
+#include <fb303/ServiceData.h>
+#include <gflags/gflags.h>
+
+#include <gtest/gtest.h>
+
+DECLARE_int32(hw_stats_port_errors_interval_s);
+DECLARE_int32(hw_stats_trunks_interval_s);
+
+using namespace facebook::fboss;
+using namespace std::chrono;
+
+namespace {
+steady_clock::time_point at(int seconds) {
+  return steady_clock::time_point(std::chrono::seconds(1000 + seconds));
+}
+} // namespace
+
+TEST(HwStatsSchedulerTest, ZeroIntervalAlwaysDue) {
+  gflags::FlagSaver saver;
+  FLAGS_hw_stats_trunks_interval_s = 0;
+  FLAGS_hw_stats_port_errors_interval_s = 0;
+  HwStatsScheduler scheduler;
+  for (auto round = 0; round < 5; ++round) {
+    scheduler.startRound(at(0));
+    EXPECT_TRUE(scheduler.isDue(HwStatsCategory::TRUNKS));
+    EXPECT_TRUE(scheduler.isDue(HwStatsCategory::PORT_ERRORS, 1));
+  }
+}
+
+TEST(HwStatsSchedulerTest, GlobalInterval) {
+  gflags::FlagSaver saver;
+  FLAGS_hw_stats_trunks_interval_s = 5;
+  HwStatsScheduler scheduler;
+  std::vector<int> collectedAt;
+  for (auto second = 0; second < 20; ++second) {
+    scheduler.startRound(at(second));
+    if (scheduler.isDue(HwStatsCategory::TRUNKS)) {
+      collectedAt.push_back(second);
+    }
+  }
+  EXPECT_EQ(collectedAt, std::vector<int>({0, 5, 10, 15}));
+}
+
+TEST(HwStatsSchedulerTest, PerKeyIntervalIsSpread) {
+  gflags::FlagSaver saver;
+  constexpr auto kInterval = 10;
+  constexpr auto kNumPorts = 256;
+  FLAGS_hw_stats_port_errors_interval_s = kInterval;
+  HwStatsScheduler scheduler;
+
+  // Every port is collected on the first round
+  scheduler.startRound(at(0));
+  for (auto port = 0; port < kNumPorts; ++port) {
+    EXPECT_TRUE(scheduler.isDue(HwStatsCategory::PORT_ERRORS, port));
+  }
+
+  // Afterwards each port is collected exactly once per interval, and
+  // collections are spread across the rounds of the interval
+  std::vector<int> collectionsPerPort(kNumPorts);
+  int maxPerRound = 0;
+  for (auto second = 1; second <= 10 * kInterval; ++second) {
+    scheduler.startRound(at(second));
+    int collected = 0;
+    for (auto port = 0; port < kNumPorts; ++port) {
+      if (scheduler.isDue(HwStatsCategory::PORT_ERRORS, port)) {
+        ++collectionsPerPort[port];
+        ++collected;
+      }
+    }
+    maxPerRound = std::max(maxPerRound, collected);
+  }
+  for (auto collections : collectionsPerPort) {
+    EXPECT_EQ(10, collections);
+  }
+  EXPECT_LT(maxPerRound, kNumPorts / 2);
+}
+
+TEST(HwStatsSchedulerTest, CollectionTimePublished) {
+  HwStatsScheduler scheduler;
+  scheduler.startRound();
+  auto ran = false;
+  scheduler.collect(HwStatsCategory::ACLS, [&ran]() { ran = true; });
+  EXPECT_TRUE(ran);
+  EXPECT_TRUE(facebook::fb303::fbData->getStatMap()->contains(
+      "hw.stats.acls.collection_us"));
+}
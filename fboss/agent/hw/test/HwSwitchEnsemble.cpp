@@ -27,6 +27,9 @@
 
 #include <folly/experimental/FunctionScheduler.h>
 
+DECLARE_int32(hw_stats_port_errors_interval_s);
+DECLARE_int32(hw_stats_prbs_interval_s);
+
 DEFINE_bool(
     setup_thrift,
     false,
@@ -283,6 +286,9 @@ void HwSwitchEnsemble::setupEnsemble(
     std::unique_ptr<std::thread> thriftThread) {
   platform_ = std::move(platform);
   linkToggler_ = std::move(linkToggler);
+  // Tests expect every updateStats call to refresh all stats
+  FLAGS_hw_stats_port_errors_interval_s = 0;
+  FLAGS_hw_stats_prbs_interval_s = 0;
 
   programmedState_ = getHwSwitch()->init(this).switchState;
   // HwSwitch::init() returns an unpublished programmedState_.  SwSwitch is
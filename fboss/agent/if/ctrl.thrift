@@ -452,6 +452,40 @@ struct RouteUpdateLoggingInfo {
   3: bool exact
 }
 
+struct RouteUpdateTraceStage {
+  1: string name
+  // Time since the start of the trace
+  2: i64 elapsedUs
+}
+
+/*
+ * Per stage timestamps of a single route update call, from the thrift
+ * handler through the RIB, the SwSwitch update thread, hardware programming
+ * and state observers
+ */
+struct RouteUpdateTrace {
+  1: i64 id
+  // Type of route update, e.g. addUnicastRoutesInVrf or syncFibInVrf
+  2: string name
+  // Wall clock start time, microseconds since epoch
+  3: i64 startTimeUs
+  4: list<RouteUpdateTraceStage> stages
+}
+
+struct SwitchStateGenerationInfo {
+  1: i64 generation
+  // Time since the state was published
+  2: i64 ageMs
+  // Bytes of the state tree nodes no other live state shares
+  3: i64 uniqueBytes
+  /*
+   * Components which took a reference to the state through the state
+   * history. A state without holders is held by the current states or by
+   * consumers which do not register their references.
+   */
+  4: list<string> holders
+}
+
 struct MplsRouteUpdateLoggingInfo {
   // The label to log route updates for label, -1 for all labels
   1: mpls.MplsLabel label
@@ -839,6 +873,19 @@ service FbossCtrl extends fb303.FacebookService {
   void stopLoggingAnyMplsRouteUpdates(1: string identifier)
   list<MplsRouteUpdateLoggingInfo> getMplsRouteUpdateLoggingTrackedLabels()
 
+  /*
+   * Per stage timestamps of the last count route updates, most recent first
+   */
+  list<RouteUpdateTrace> getRouteUpdateTraces(1: i32 count)
+    throws (1: fboss.FbossBaseError error)
+
+  /*
+   * The switch state generations still alive, oldest first. Useful to find
+   * consumers holding on to old states.
+   */
+  list<SwitchStateGenerationInfo> getSwitchStateGenerations()
+    throws (1: fboss.FbossBaseError error)
+
   void keepalive()
 
   i32 getIdleTimeout()
@@ -26,9 +26,9 @@ namespace fboss {
 MultiPimPlatformMapping::MultiPimPlatformMapping(
     const std::string& jsonPlatformMappingStr)
     : PlatformMapping(jsonPlatformMappingStr) {
+  re2::RE2 portNameRe(kFbossPortNameRegex);
   for (auto& port : platformPorts_) {
     int portPimID = 0;
-    re2::RE2 portNameRe(kFbossPortNameRegex);
     if (!re2::RE2::FullMatch(
             *port.second.mapping_ref()->name_ref(), portNameRe, &portPimID)) {
       throw FbossError(
@@ -10,17 +10,147 @@
 
 #include "fboss/agent/platforms/common/PlatformMapping.h"
 
+#include <boost/filesystem/operations.hpp>
+#include <folly/FileUtil.h>
+#include <folly/hash/SpookyHashV2.h>
+#include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
 #include <thrift/lib/cpp/util/EnumUtils.h>
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 
 #include "fboss/agent/FbossError.h"
 
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <optional>
+
+DEFINE_string(
+    platform_mapping_cache_dir,
+    "/var/facebook/fboss/platform_mapping_cache",
+    "Directory under the persistent state dir where platform mappings are "
+    "cached as compact thrift, one file per platform mapping JSON, so that "
+    "their JSON is parsed once rather than on every agent and qsfp_service "
+    "start. The directory and cache files must be owned by the user running "
+    "the binary and not writable by anyone else. Empty disables the cache.");
+
+namespace {
+// Bump when cached mappings can no longer be read back
+auto constexpr kPlatformMappingCacheVersion = 2;
+
+// A cache file is a header of the JSON and payload hashes followed by the
+// compact thrift payload
+struct CacheHeader {
+  uint64_t jsonHash;
+  uint64_t payloadHash;
+};
+
+uint64_t hashOf(folly::StringPiece data) {
+  return folly::hash::SpookyHashV2::Hash64(data.data(), data.size(), 0);
+}
+
+std::string platformMappingCacheFile(uint64_t jsonHash) {
+  return folly::to<std::string>(
+      FLAGS_platform_mapping_cache_dir,
+      "/platform_mapping_v",
+      kPlatformMappingCacheVersion,
+      "_",
+      jsonHash,
+      ".bin");
+}
+
+// Only trust cache entries nobody but us could have written
+bool isPrivatePath(const std::string& path, bool directory) {
+  struct stat st;
+  if (lstat(path.c_str(), &st) != 0) {
+    return false;
+  }
+  bool typeOk = directory ? S_ISDIR(st.st_mode) : S_ISREG(st.st_mode);
+  return typeOk && st.st_uid == geteuid() &&
+      (st.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+}
+
+std::optional<std::string> readCachedPayload(
+    const std::string& cacheFile,
+    uint64_t jsonHash) {
+  std::string cached;
+  if (!isPrivatePath(FLAGS_platform_mapping_cache_dir, true) ||
+      !isPrivatePath(cacheFile, false) ||
+      !folly::readFile(cacheFile.c_str(), cached) ||
+      cached.size() < sizeof(CacheHeader)) {
+    return std::nullopt;
+  }
+  CacheHeader header;
+  std::memcpy(&header, cached.data(), sizeof(header));
+  auto payload = folly::StringPiece(cached).subpiece(sizeof(header));
+  if (header.jsonHash != jsonHash || header.payloadHash != hashOf(payload)) {
+    XLOG(WARNING) << "Ignoring corrupt platform mapping cache " << cacheFile;
+    return std::nullopt;
+  }
+  return payload.str();
+}
+
+void writeCachedPayload(
+    const std::string& cacheFile,
+    uint64_t jsonHash,
+    const std::string& payload) {
+  const auto& cacheDir = FLAGS_platform_mapping_cache_dir;
+  if (!boost::filesystem::exists(cacheDir)) {
+    boost::filesystem::create_directories(cacheDir);
+    boost::filesystem::permissions(cacheDir, boost::filesystem::owner_all);
+  }
+  if (!isPrivatePath(cacheDir, true)) {
+    throw facebook::fboss::FbossError(
+        cacheDir, " is not a directory only its owner can write to");
+  }
+  CacheHeader header{jsonHash, hashOf(payload)};
+  std::string cached(reinterpret_cast<const char*>(&header), sizeof(header));
+  cached += payload;
+  folly::writeFileAtomic(cacheFile, cached, 0600);
+}
+
+facebook::fboss::cfg::PlatformMapping parsePlatformMapping(
+    const std::string& jsonPlatformMappingStr) {
+  using facebook::fboss::cfg::PlatformMapping;
+  if (FLAGS_platform_mapping_cache_dir.empty()) {
+    return apache::thrift::SimpleJSONSerializer::deserialize<PlatformMapping>(
+        jsonPlatformMappingStr);
+  }
+
+  // Cache files are keyed on a hash of the JSON, so they never go stale
+  auto jsonHash = hashOf(jsonPlatformMappingStr);
+  auto cacheFile = platformMappingCacheFile(jsonHash);
+  if (auto cached = readCachedPayload(cacheFile, jsonHash)) {
+    try {
+      return apache::thrift::CompactSerializer::deserialize<PlatformMapping>(
+          *cached);
+    } catch (const std::exception& ex) {
+      XLOG(WARNING) << "Ignoring unreadable platform mapping cache "
+                    << cacheFile << ": " << ex.what();
+    }
+  }
+
+  auto mapping =
+      apache::thrift::SimpleJSONSerializer::deserialize<PlatformMapping>(
+          jsonPlatformMappingStr);
+  try {
+    writeCachedPayload(
+        cacheFile,
+        jsonHash,
+        apache::thrift::CompactSerializer::serialize<std::string>(mapping));
+  } catch (const std::exception& ex) {
+    XLOG(WARNING) << "Unable to cache platform mapping in " << cacheFile
+                  << ": " << ex.what();
+  }
+  return mapping;
+}
+} // namespace
+
 namespace facebook {
 namespace fboss {
 PlatformMapping::PlatformMapping(const std::string& jsonPlatformMappingStr) {
-  auto mapping =
-      apache::thrift::SimpleJSONSerializer::deserialize<cfg::PlatformMapping>(
-          jsonPlatformMappingStr);
+  auto mapping = parsePlatformMapping(jsonPlatformMappingStr);
   platformPorts_ = std::move(*mapping.ports_ref());
   supportedProfiles_ = std::move(*mapping.supportedProfiles_ref());
   for (auto chip : *mapping.chips_ref()) {
@@ -29,15 +159,38 @@ PlatformMapping::PlatformMapping(const std::string& jsonPlatformMappingStr) {
   if (auto portConfigOverrides = mapping.portConfigOverrides_ref()) {
     portConfigOverrides_ = std::move(*portConfigOverrides);
   }
+  for (const auto& port : platformPorts_) {
+    indexIphyPins(port.first, port.second);
+  }
+}
+
+void PlatformMapping::setPlatformPort(
+    int32_t portID,
+    cfg::PlatformPortEntry port) {
+  auto ret = platformPorts_.emplace(portID, std::move(port));
+  if (ret.second) {
+    indexIphyPins(portID, ret.first->second);
+  }
+}
+
+void PlatformMapping::indexIphyPins(
+    int32_t portID,
+    const cfg::PlatformPortEntry& port) {
+  for (const auto& profile : *port.supportedProfiles_ref()) {
+    iphyPins_.emplace(
+        std::make_pair(portID, profile.first),
+        &*profile.second.pins_ref()->iphy_ref());
+  }
 }
 
 void PlatformMapping::merge(PlatformMapping* mapping) {
-  for (auto port : mapping->platformPorts_) {
-    platformPorts_.emplace(port.first, std::move(port.second));
+  for (auto& port : mapping->platformPorts_) {
     mergePortConfigOverrides(
         port.first, mapping->getPortConfigOverrides(port.first));
+    setPlatformPort(port.first, std::move(port.second));
   }
   mapping->platformPorts_.clear();
+  mapping->iphyPins_.clear();
 
   for (auto profile : mapping->supportedProfiles_) {
     supportedProfiles_.emplace(profile.first, std::move(profile.second));
@@ -84,14 +237,12 @@ std::vector<phy::PinConfig> PlatformMapping::getPortIphyPinConfigs(
     PortID id,
     cfg::PortProfileID profileID,
     std::optional<double> cableLength) const {
-  auto itPlatformPort = platformPorts_.find(id);
-  if (itPlatformPort == platformPorts_.end()) {
-    throw FbossError("No PlatformPortEntry found for port ", id);
-  }
-
-  auto& supportedProfiles = *itPlatformPort->second.supportedProfiles_ref();
-  auto platformPortConfig = supportedProfiles.find(profileID);
-  if (platformPortConfig == supportedProfiles.end()) {
+  auto itIphyPins = iphyPins_.find(
+      std::make_pair(static_cast<int32_t>(id), profileID));
+  if (itIphyPins == iphyPins_.end()) {
+    if (platformPorts_.find(id) == platformPorts_.end()) {
+      throw FbossError("No PlatformPortEntry found for port ", id);
+    }
     throw FbossError(
         "No speed profile with id ",
         apache::thrift::util::enumNameSafe(profileID),
@@ -99,18 +250,18 @@ std::vector<phy::PinConfig> PlatformMapping::getPortIphyPinConfigs(
         id);
   }
 
-  const auto& iphyCfg = *platformPortConfig->second.pins_ref()->iphy_ref();
+  const auto& iphyCfg = *itIphyPins->second;
+  auto platformPortConfigOverrideFactorMatcher =
+      PlatformPortConfigOverrideFactorMatcher(id, profileID, cableLength);
   // Check whether there's an override
-  for (const auto portConfigOverride : portConfigOverrides_) {
+  for (const auto& portConfigOverride : portConfigOverrides_) {
     if (!portConfigOverride.pins_ref().has_value()) {
       // The override is not about Iphy pin configs. Skip
       continue;
     }
-    auto platformPortConfigOverrideFactorMatcher =
-        PlatformPortConfigOverrideFactorMatcher(id, profileID, cableLength);
     if (platformPortConfigOverrideFactorMatcher.matchWithFactor(
             *portConfigOverride.factor_ref())) {
-      auto overrideIphy = *portConfigOverride.pins_ref()->iphy_ref();
+      const auto& overrideIphy = *portConfigOverride.pins_ref()->iphy_ref();
       if (!overrideIphy.empty()) {
         // make sure the override iphy config size == iphyCfg or override
         // size == 1, in which case we use the same override for all lanes
@@ -158,7 +309,7 @@ PlatformMapping::getPortProfileConfig(
   // overrides if we don't get a valid value. If new use cases were to come
   // up later, we can extend the logic and the matcher.
   if (transceiverSpecComplianceCode.has_value()) {
-    for (const auto portConfigOverride : portConfigOverrides_) {
+    for (const auto& portConfigOverride : portConfigOverrides_) {
       if (!portConfigOverride.portProfileConfig_ref().has_value()) {
         // The override is not about portProfileConfig. Skip
         continue;
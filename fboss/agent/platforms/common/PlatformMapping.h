@@ -13,6 +13,8 @@
 #include "fboss/agent/types.h"
 #include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
 
+#include <folly/container/F14Map.h>
+
 namespace facebook {
 namespace fboss {
 
@@ -106,9 +108,7 @@ class PlatformMapping {
     return chips_;
   }
 
-  void setPlatformPort(int32_t portID, cfg::PlatformPortEntry port) {
-    platformPorts_.emplace(portID, port);
-  }
+  void setPlatformPort(int32_t portID, cfg::PlatformPortEntry port);
 
   void setChip(const std::string& chipName, phy::DataPlanePhyChip chip) {
     chips_.emplace(chipName, chip);
@@ -145,6 +145,18 @@ class PlatformMapping {
   // Forbidden copy constructor and assignment operator
   PlatformMapping(PlatformMapping const&) = delete;
   PlatformMapping& operator=(PlatformMapping const&) = delete;
+
+  void indexIphyPins(int32_t portID, const cfg::PlatformPortEntry& port);
+
+  /*
+   * Iphy pins of every port and profile in platformPorts_, so that pin
+   * lookups are a single hash lookup rather than two map lookups. Points
+   * into platformPorts_, whose entries are never modified once added.
+   */
+  folly::F14FastMap<
+      std::pair<int32_t, cfg::PortProfileID>,
+      const std::vector<phy::PinConfig>*>
+      iphyPins_;
 };
 } // namespace fboss
 } // namespace facebook
@@ -0,0 +1,125 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include <folly/Benchmark.h>
+#include <folly/Function.h>
+#include <folly/experimental/TestUtil.h>
+#include <folly/init/Init.h>
+
+#include <fboss/agent/platforms/common/wedge400c/Wedge400CPlatformMapping.h>
+#include <fboss/agent/platforms/wedge/minipack/Minipack16QPimPlatformMapping.h>
+#include <fboss/agent/platforms/wedge/yamp/YampPlatformMapping.h>
+
+#include <gflags/gflags.h>
+
+DECLARE_string(platform_mapping_cache_dir);
+
+using namespace facebook::fboss;
+
+/*
+ * Benchmarks for building platform mappings at startup, parsing the JSON
+ * every time versus reading back the cached binary mapping, and for the iphy
+ * pin lookups done while programming ports.
+ */
+
+namespace {
+
+std::unique_ptr<folly::test::TemporaryDirectory> cacheDir;
+
+using MappingFactory = folly::FunctionRef<std::unique_ptr<PlatformMapping>()>;
+
+std::unique_ptr<PlatformMapping> wedge400c() {
+  return std::make_unique<Wedge400CPlatformMapping>();
+}
+
+std::unique_ptr<PlatformMapping> minipack16q() {
+  return std::make_unique<Minipack16QPimPlatformMapping>(
+      ExternalPhyVersion::MILN5_2);
+}
+
+std::unique_ptr<PlatformMapping> yamp() {
+  return std::make_unique<YampPlatformMapping>();
+}
+
+void createMapping(size_t numIters, MappingFactory factory, bool cached) {
+  folly::BenchmarkSuspender suspender;
+  FLAGS_platform_mapping_cache_dir =
+      cached ? cacheDir->path().string() : std::string();
+  if (cached) {
+    // Warm the cache
+    factory();
+  }
+  suspender.dismiss();
+
+  for (size_t n = 0; n < numIters; ++n) {
+    folly::doNotOptimizeAway(factory());
+  }
+}
+
+void lookupIphyPins(size_t numIters, MappingFactory factory) {
+  folly::BenchmarkSuspender suspender;
+  auto mapping = factory();
+  suspender.dismiss();
+
+  for (size_t n = 0; n < numIters; ++n) {
+    for (const auto& port : mapping->getPlatformPorts()) {
+      for (const auto& profile : *port.second.supportedProfiles_ref()) {
+        folly::doNotOptimizeAway(
+            mapping->getPortIphyPinConfigs(PortID(port.first), profile.first));
+      }
+    }
+  }
+}
+
+} // unnamed namespace
+
+BENCHMARK(Wedge400CMappingFromJson, numIters) {
+  createMapping(numIters, wedge400c, false);
+}
+
+BENCHMARK_RELATIVE(Wedge400CMappingFromCache, numIters) {
+  createMapping(numIters, wedge400c, true);
+}
+
+BENCHMARK(Minipack16QMappingFromJson, numIters) {
+  createMapping(numIters, minipack16q, false);
+}
+
+BENCHMARK_RELATIVE(Minipack16QMappingFromCache, numIters) {
+  createMapping(numIters, minipack16q, true);
+}
+
+BENCHMARK(YampMappingFromJson, numIters) {
+  createMapping(numIters, yamp, false);
+}
+
+BENCHMARK_RELATIVE(YampMappingFromCache, numIters) {
+  createMapping(numIters, yamp, true);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(Wedge400CIphyPinLookups, numIters) {
+  lookupIphyPins(numIters, wedge400c);
+}
+
+BENCHMARK(YampIphyPinLookups, numIters) {
+  lookupIphyPins(numIters, yamp);
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+
+  // Keep the cache out of the one used by a running agent
+  cacheDir = std::make_unique<folly::test::TemporaryDirectory>();
+
+  folly::runBenchmarks();
+  cacheDir.reset();
+  return 0;
+}
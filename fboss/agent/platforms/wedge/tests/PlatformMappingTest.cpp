@@ -19,6 +19,10 @@
 #include "fboss/agent/platforms/wedge/wedge400/Wedge400PlatformMapping.h"
 #include "fboss/agent/platforms/wedge/yamp/YampPlatformMapping.h"
 
+#include <boost/filesystem/operations.hpp>
+#include <folly/FileUtil.h>
+#include <folly/experimental/TestUtil.h>
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
 namespace facebook {
@@ -228,6 +232,48 @@ TEST_F(PlatformMappingTest, VerifyOverrideMerge) {
   }
 }
 
+TEST_F(PlatformMappingTest, VerifyPlatformMappingCache) {
+  folly::test::TemporaryDirectory cacheDir;
+  FLAGS_platform_mapping_cache_dir = cacheDir.path().string();
+
+  // The first mapping is parsed from JSON and cached, the second one is read
+  // back from the cache
+  auto parsed = std::make_unique<Wedge400PlatformMapping>();
+  EXPECT_FALSE(boost::filesystem::is_empty(cacheDir.path()));
+  auto cached = std::make_unique<Wedge400PlatformMapping>();
+
+  EXPECT_EQ(parsed->getPlatformPorts(), cached->getPlatformPorts());
+  EXPECT_EQ(parsed->getSupportedProfiles(), cached->getSupportedProfiles());
+  EXPECT_EQ(parsed->getChips(), cached->getChips());
+  EXPECT_EQ(
+      parsed->getPortConfigOverrides(), cached->getPortConfigOverrides());
+  for (const auto& port : cached->getPlatformPorts()) {
+    for (const auto& profile : *port.second.supportedProfiles_ref()) {
+      EXPECT_EQ(
+          parsed->getPortIphyPinConfigs(PortID(port.first), profile.first),
+          cached->getPortIphyPinConfigs(PortID(port.first), profile.first));
+    }
+  }
+}
+
+TEST_F(PlatformMappingTest, VerifyCorruptPlatformMappingCache) {
+  folly::test::TemporaryDirectory cacheDir;
+  FLAGS_platform_mapping_cache_dir = cacheDir.path().string();
+
+  auto parsed = std::make_unique<Wedge400PlatformMapping>();
+  // Flip the last byte of the cached payload, it must not be trusted
+  boost::filesystem::directory_iterator cacheFile(cacheDir.path());
+  ASSERT_NE(cacheFile, boost::filesystem::directory_iterator());
+  std::string cached;
+  ASSERT_TRUE(folly::readFile(cacheFile->path().c_str(), cached));
+  cached.back() ^= 0xff;
+  ASSERT_TRUE(folly::writeFile(cached, cacheFile->path().c_str()));
+
+  auto reparsed = std::make_unique<Wedge400PlatformMapping>();
+  EXPECT_EQ(parsed->getPlatformPorts(), reparsed->getPlatformPorts());
+  EXPECT_EQ(parsed->getChips(), reparsed->getChips());
+}
+
 TEST_F(PlatformMappingTest, VerifyWedge40PlatformMapping) {
   // supported profiles
   std::vector<cfg::PortProfileID> expectedProfiles = {
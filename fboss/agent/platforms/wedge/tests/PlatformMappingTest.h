@@ -11,14 +11,21 @@
 
 #include "fboss/agent/platforms/common/PlatformMapping.h"
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
+DECLARE_string(platform_mapping_cache_dir);
+
 namespace facebook {
 namespace fboss {
 namespace test {
 class PlatformMappingTest : public ::testing::Test {
  public:
-  void SetUp() override {}
+  void SetUp() override {
+    // Keep tests off the default on-disk cache, cache tests point it at a
+    // temporary directory
+    FLAGS_platform_mapping_cache_dir = "";
+  }
 
   void setExpection(
       int numPort,
@@ -69,6 +76,7 @@ class PlatformMappingTest : public ::testing::Test {
   int expectedNumXphy_{0};
   int expectedNumTcvr_{0};
   std::vector<cfg::PortProfileID> expectedProfiles_;
+  gflags::FlagSaver flagSaver_;
 };
 } // namespace test
 } // namespace fboss
@@ -82,15 +82,11 @@ ForwardingInformationBaseUpdater::createUpdatedFib(
                                                      ribRoute.prefix().mask};
     std::shared_ptr<facebook::fboss::Route<AddressT>> fibRoute =
         fib->getNodeIf(fibPrefix);
-    if (fibRoute) {
-      if (toFibNextHop(ribRoute.getForwardInfo()) ==
-          fibRoute->getForwardInfo()) {
-        // Reuse prior FIB route
-      } else {
-        fibRoute = toFibRoute(ribRoute);
-      }
+    auto fibNextHopEntry = toFibNextHopCached(ribRoute.getForwardInfo());
+    if (fibRoute && fibNextHopEntry == fibRoute->getForwardInfo()) {
+      // Reuse prior FIB route
     } else {
-      fibRoute = toFibRoute(ribRoute);
+      fibRoute = toFibRoute(ribRoute, std::move(fibNextHopEntry));
     }
 
     updatedFib.emplace_hint(updatedFib.cend(), fibPrefix, fibRoute);
@@ -138,9 +134,39 @@ ForwardingInformationBaseUpdater::toFibNextHop(
   XLOG(FATAL) << "Unknown RouteNextHopEntry::Action value";
 }
 
+facebook::fboss::RouteNextHopEntry
+ForwardingInformationBaseUpdater::toFibNextHopCached(
+    const RouteNextHopEntry& ribNextHopEntry) {
+  if (ribNextHopEntry.getAction() !=
+      facebook::fboss::rib::RouteNextHopEntry::Action::NEXTHOPS) {
+    return toFibNextHop(ribNextHopEntry);
+  }
+  // The RIB is locked for the duration of the update, so the address of its
+  // interned next-hop set identifies the set.
+  const auto* ribNextHopSet = &ribNextHopEntry.getNextHopSet();
+  auto it = fibNextHopSets_.find(ribNextHopSet);
+  if (it == fibNextHopSets_.end()) {
+    it = fibNextHopSets_
+             .emplace(
+                 ribNextHopSet,
+                 toFibNextHop(ribNextHopEntry).getInternedNextHopSet())
+             .first;
+  }
+  return facebook::fboss::RouteNextHopEntry(
+      it->second, ribNextHopEntry.getAdminDistance());
+}
+
 template <typename AddrT>
 std::unique_ptr<facebook::fboss::Route<AddrT>>
 ForwardingInformationBaseUpdater::toFibRoute(const Route<AddrT>& ribRoute) {
+  return toFibRoute(ribRoute, toFibNextHop(ribRoute.getForwardInfo()));
+}
+
+template <typename AddrT>
+std::unique_ptr<facebook::fboss::Route<AddrT>>
+ForwardingInformationBaseUpdater::toFibRoute(
+    const Route<AddrT>& ribRoute,
+    facebook::fboss::RouteNextHopEntry fibNextHopEntry) {
   CHECK(ribRoute.isResolved());
 
   facebook::fboss::RoutePrefix<AddrT> fibPrefix;
@@ -149,7 +175,7 @@ ForwardingInformationBaseUpdater::toFibRoute(const Route<AddrT>& ribRoute) {
 
   auto fibRoute = std::make_unique<facebook::fboss::Route<AddrT>>(fibPrefix);
 
-  fibRoute->setResolved(toFibNextHop(ribRoute.getForwardInfo()));
+  fibRoute->setResolved(std::move(fibNextHopEntry));
   if (ribRoute.isConnected()) {
     fibRoute->setConnected();
   }
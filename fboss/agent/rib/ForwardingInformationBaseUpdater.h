@@ -11,11 +11,14 @@
 
 #include "fboss/agent/rib/NetworkToRouteMap.h"
 #include "fboss/agent/rib/Route.h"
+#include "fboss/agent/rib/RouteNextHopEntry.h"
 #include "fboss/agent/state/ForwardingInformationBase.h"
 #include "fboss/agent/state/Route.h"
 #include "fboss/agent/state/RouteNextHopEntry.h"
 #include "fboss/agent/types.h"
 
+#include <folly/container/F14Map.h>
+
 #include <memory>
 
 namespace facebook::fboss {
@@ -26,8 +29,6 @@ class SwitchState;
 
 namespace facebook::fboss::rib {
 
-class RouteNextHopEntry;
-
 class ForwardingInformationBaseUpdater {
  public:
   ForwardingInformationBaseUpdater(
@@ -52,9 +53,27 @@ class ForwardingInformationBaseUpdater {
       const std::shared_ptr<
           facebook::fboss::ForwardingInformationBase<AddressT>>& fib);
 
+  /*
+   * Same as toFibNextHop(), but converts each distinct (interned) RIB
+   * next-hop set only once per update. Since FIB next-hop sets are interned
+   * as well, comparing the result with the previous FIB entry is a pointer
+   * comparison.
+   */
+  facebook::fboss::RouteNextHopEntry toFibNextHopCached(
+      const RouteNextHopEntry& ribNextHopEntry);
+  template <typename AddrT>
+  static std::unique_ptr<facebook::fboss::Route<AddrT>> toFibRoute(
+      const Route<AddrT>& ribRoute,
+      facebook::fboss::RouteNextHopEntry fibNextHopEntry);
+
   RouterID vrf_;
   const IPv4NetworkToRouteMap& v4NetworkToRoute_;
   const IPv6NetworkToRouteMap& v6NetworkToRoute_;
+
+  folly::F14FastMap<
+      const RouteNextHopSet*,
+      facebook::fboss::RouteNextHopEntry::InternedNextHopSet>
+      fibNextHopSets_;
 };
 
 } // namespace facebook::fboss::rib
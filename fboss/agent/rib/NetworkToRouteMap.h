@@ -19,9 +19,18 @@
 
 namespace facebook::fboss::rib {
 
+/*
+ * Route maps hold up to millions of routes, so tree nodes are carved out
+ * of an arena rather than allocated one at a time.
+ */
 template <typename AddressT>
-class NetworkToRouteMap
-    : public facebook::network::RadixTree<AddressT, Route<AddressT>> {
+class NetworkToRouteMap : public facebook::network::RadixTree<
+                              AddressT,
+                              Route<AddressT>,
+                              facebook::network::RadixTreeTraits<
+                                  AddressT,
+                                  Route<AddressT>>,
+                              facebook::network::RadixTreeArenaAllocator> {
   static constexpr auto kRoutes = "routes";
 
  public:
@@ -23,24 +23,24 @@ namespace {
 constexpr auto kNexthops = "nexthops";
 constexpr auto kAction = "action";
 constexpr auto kAdminDistance = "adminDistance";
+} // namespace
+
+namespace facebook::fboss::rib {
 
-std::vector<facebook::fboss::NextHopThrift> thriftNextHopsFromAddresses(
+namespace util {
+
+std::vector<NextHopThrift> thriftNextHopsFromAddresses(
     const std::vector<facebook::network::thrift::BinaryAddress>& addrs) {
-  std::vector<facebook::fboss::NextHopThrift> nhs;
+  std::vector<NextHopThrift> nhs;
   nhs.reserve(addrs.size());
   for (const auto& addr : addrs) {
-    facebook::fboss::NextHopThrift nh;
+    NextHopThrift nh;
     *nh.address_ref() = addr;
     *nh.weight_ref() = 0;
     nhs.emplace_back(std::move(nh));
   }
   return nhs;
 }
-} // namespace
-
-namespace facebook::fboss::rib {
-
-namespace util {
 
 RouteNextHopSet toRouteNextHopSet(std::vector<NextHopThrift> const& nhs) {
   RouteNextHopSet rnhs;
@@ -63,10 +63,15 @@ std::vector<NextHopThrift> fromRouteNextHopSet(RouteNextHopSet const& nhs) {
 } // namespace util
 
 RouteNextHopEntry::RouteNextHopEntry(NextHopSet nhopSet, AdminDistance distance)
+    : RouteNextHopEntry(InternedNextHopSet(std::move(nhopSet)), distance) {}
+
+RouteNextHopEntry::RouteNextHopEntry(
+    InternedNextHopSet nhopSet,
+    AdminDistance distance)
     : adminDistance_(distance),
       action_(Action::NEXTHOPS),
       nhopSet_(std::move(nhopSet)) {
-  if (nhopSet_.size() == 0) {
+  if (nhopSet_->size() == 0) {
     throw FbossError("Empty nexthop set is passed to the RouteNextHopEntry");
   }
 }
@@ -99,7 +104,7 @@ std::string RouteNextHopEntry::str() const {
 bool operator==(const RouteNextHopEntry& a, const RouteNextHopEntry& b) {
   return (
       a.getAction() == b.getAction() and
-      a.getNextHopSet() == b.getNextHopSet() and
+      a.getInternedNextHopSet() == b.getInternedNextHopSet() and
       a.getAdminDistance() == b.getAdminDistance());
 }
 
@@ -148,7 +153,7 @@ folly::dynamic RouteNextHopEntry::toFollyDynamic() const {
   folly::dynamic entry = folly::dynamic::object;
   entry[kAction] = forwardActionStr(action_);
   folly::dynamic nhops = folly::dynamic::array;
-  for (const auto& nhop : nhopSet_) {
+  for (const auto& nhop : *nhopSet_) {
     nhops.push_back(nhop.toFollyDynamic());
   }
   entry[kNexthops] = std::move(nhops);
@@ -165,9 +170,11 @@ RouteNextHopEntry RouteNextHopEntry::fromFollyDynamic(
       : AdminDistance(entryJson[kAdminDistance].asInt());
   RouteNextHopEntry entry(Action::DROP, adminDistance);
   entry.action_ = action;
+  NextHopSet nhopSet;
   for (const auto& nhop : entryJson[kNexthops]) {
-    entry.nhopSet_.insert(util::nextHopFromFollyDynamic(nhop));
+    nhopSet.insert(util::nextHopFromFollyDynamic(nhop));
   }
+  entry.nhopSet_ = InternedNextHopSet(std::move(nhopSet));
   return entry;
 }
 
@@ -176,7 +183,7 @@ RouteNextHopEntry RouteNextHopEntry::from(
     AdminDistance defaultAdminDistance) {
   std::vector<NextHopThrift> nhts;
   if (route.nextHops_ref()->empty() && !route.nextHopAddrs_ref()->empty()) {
-    nhts = thriftNextHopsFromAddresses(*route.nextHopAddrs_ref());
+    nhts = util::thriftNextHopsFromAddresses(*route.nextHopAddrs_ref());
   } else {
     nhts = *route.nextHops_ref();
   }
@@ -194,7 +201,7 @@ bool RouteNextHopEntry::isValid(bool forMplsRoute) const {
   bool valid = true;
   if (!forMplsRoute) {
     /* for ip2mpls routes, next hop label forwarding action must be push */
-    for (const auto& nexthop : nhopSet_) {
+    for (const auto& nexthop : *nhopSet_) {
       if (action_ != Action::NEXTHOPS) {
         continue;
       }
@@ -13,8 +13,11 @@
 
 #include <folly/dynamic.h>
 
+#include "fboss/lib/Interned.h"
+
 #include "fboss/agent/rib/RouteNextHop.h"
 #include "fboss/agent/rib/RouteTypes.h"
+#include "fboss/agent/state/RouteNextHopSetHash.h"
 
 #include "fboss/agent/if/gen-cpp2/ctrl_types.h"
 
@@ -30,10 +33,14 @@ class StaticRouteWithNextHops;
 
 namespace facebook::fboss::rib {
 
+using RouteNextHopSetHash = RouteNextHopSetHashT<NextHop>;
+
 class RouteNextHopEntry {
  public:
   using Action = RouteForwardAction;
   using NextHopSet = boost::container::flat_set<NextHop>;
+  // Next-hop sets are interned, routes with the same set share one copy
+  using InternedNextHopSet = Interned<NextHopSet, RouteNextHopSetHash>;
 
   RouteNextHopEntry(Action action, AdminDistance distance)
       : adminDistance_(distance), action_(action) {
@@ -42,10 +49,12 @@ class RouteNextHopEntry {
 
   RouteNextHopEntry(NextHopSet nhopSet, AdminDistance distance);
 
+  RouteNextHopEntry(InternedNextHopSet nhopSet, AdminDistance distance);
+
   RouteNextHopEntry(NextHop nhop, AdminDistance distance)
-      : adminDistance_(distance), action_(Action::NEXTHOPS) {
-    nhopSet_.emplace(std::move(nhop));
-  }
+      : adminDistance_(distance),
+        action_(Action::NEXTHOPS),
+        nhopSet_(NextHopSet{std::move(nhop)}) {}
 
   AdminDistance getAdminDistance() const {
     return adminDistance_;
@@ -56,6 +65,10 @@ class RouteNextHopEntry {
   }
 
   const NextHopSet& getNextHopSet() const {
+    return *nhopSet_;
+  }
+
+  const InternedNextHopSet& getInternedNextHopSet() const {
     return nhopSet_;
   }
 
@@ -87,7 +100,7 @@ class RouteNextHopEntry {
 
   // Reset the NextHopSet
   void reset() {
-    nhopSet_.clear();
+    nhopSet_ = InternedNextHopSet();
     action_ = Action::DROP;
   }
 
@@ -107,7 +120,7 @@ class RouteNextHopEntry {
  private:
   AdminDistance adminDistance_;
   Action action_{Action::DROP};
-  NextHopSet nhopSet_;
+  InternedNextHopSet nhopSet_;
 };
 
 /**
@@ -129,6 +142,13 @@ using RouteNextHopSet = RouteNextHopEntry::NextHopSet;
 
 namespace util {
 
+/**
+ * Convert legacy next-hop addresses (UnicastRoute::nextHopAddrs) to thrift
+ * representation of ECMP nexthops.
+ */
+std::vector<NextHopThrift> thriftNextHopsFromAddresses(
+    const std::vector<facebook::network::thrift::BinaryAddress>& addrs);
+
 /**
  * Convert thrift representation of nexthops to RouteNextHops.
  */
@@ -86,6 +86,18 @@ std::string RouteNextHopsMulti::str() const {
 }
 
 void RouteNextHopsMulti::update(ClientID clientId, RouteNextHopEntry nhe) {
+  // Fast path for the common case of a single client owning the route
+  if (map_.empty()) {
+    map_.emplace(clientId, std::move(nhe));
+    lowestAdminDistanceClientId_ = clientId;
+    return;
+  }
+  if (map_.size() == 1 && map_.begin()->first == clientId) {
+    map_.begin()->second = std::move(nhe);
+    return;
+  }
+
+  auto adminDistance = nhe.getAdminDistance();
   auto iter = map_.find(clientId);
   if (iter == map_.end()) {
     map_.insert(std::make_pair(clientId, std::move(nhe)));
@@ -94,14 +106,10 @@ void RouteNextHopsMulti::update(ClientID clientId, RouteNextHopEntry nhe) {
   }
 
   // Let's check whether this has a preferred admin distance
-  if (map_.size() == 1) {
-    lowestAdminDistanceClientId_ = clientId;
-    return;
-  }
   auto entry = getEntryForClient(lowestAdminDistanceClientId_);
   if (!entry) {
     lowestAdminDistanceClientId_ = findLowestAdminDistance();
-  } else if (nhe.getAdminDistance() < entry->getAdminDistance()) {
+  } else if (adminDistance < entry->getAdminDistance()) {
     // Arbritary choice to use the newest one if we have multiple
     // with the same admin distance
     lowestAdminDistanceClientId_ = clientId;
@@ -154,6 +162,9 @@ bool RouteNextHopsMulti::isSame(ClientID id, const RouteNextHopEntry& nhe)
 
 std::pair<ClientID, const RouteNextHopEntry*> RouteNextHopsMulti::getBestEntry()
     const {
+  if (map_.size() == 1) {
+    return std::make_pair(map_.begin()->first, &map_.begin()->second);
+  }
   auto entry = getEntryForClient(lowestAdminDistanceClientId_);
   if (entry) {
     return std::make_pair(lowestAdminDistanceClientId_, entry);
@@ -14,6 +14,7 @@
 #include <folly/dynamic.h>
 
 #include <boost/container/flat_map.hpp>
+#include <boost/container/small_vector.hpp>
 
 #include "fboss/agent/if/gen-cpp2/ctrl_types.h"
 #include "fboss/agent/rib/RouteNextHopEntry.h"
@@ -41,11 +42,21 @@ namespace facebook::fboss::rib {
 
 /**
  * Map form clientId -> RouteNextHopEntry
+ *
+ * The vast majority of routes are programmed by a single client. The map is
+ * backed by a small_vector with room for one entry, so in that case the entry
+ * (which is then also the best entry) is stored inline in the route rather
+ * than in a separate heap allocation.
  */
 class RouteNextHopsMulti {
  protected:
+  using ClientEntries = boost::container::
+      small_vector<std::pair<ClientID, RouteNextHopEntry>, 1>;
+
   ClientID findLowestAdminDistance();
-  boost::container::flat_map<ClientID, RouteNextHopEntry> map_;
+  boost::container::
+      flat_map<ClientID, RouteNextHopEntry, std::less<ClientID>, ClientEntries>
+          map_;
   ClientID lowestAdminDistanceClientId_;
 
  public:
@@ -16,10 +16,22 @@
 #include "fboss/agent/rib/ForwardingInformationBaseUpdater.h"
 #include "fboss/agent/rib/RouteNextHopEntry.h"
 #include "fboss/agent/rib/RouteUpdater.h"
+#include "fboss/lib/StageTracer.h"
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <gflags/gflags.h>
 
 #include <memory>
 #include <utility>
 
+DEFINE_int32(
+    rib_route_decode_threads,
+    4,
+    "Number of threads used to decode large route updates before they are "
+    "applied to the standalone RIB. The pool is started on the first large "
+    "update. 0 decodes serially on the caller thread");
+
 namespace {
 class Timer {
  public:
@@ -40,6 +52,23 @@ class Timer {
 
 namespace facebook::fboss::rib {
 
+folly::Executor* RoutingInformationBase::getRouteDecodeExecutor(
+    size_t numRoutes) {
+  // Smaller updates are decoded serially anyway, so only the RIBs which see
+  // large updates pay for the decode threads
+  if (FLAGS_rib_route_decode_threads <= 0 ||
+      numRoutes <= UnicastRouteDecoder::kDefaultChunkSize) {
+    return nullptr;
+  }
+  auto executor = routeDecodeExecutor_.wlock();
+  if (!*executor) {
+    *executor = std::make_shared<folly::CPUThreadPoolExecutor>(
+        FLAGS_rib_route_decode_threads,
+        std::make_shared<folly::NamedThreadFactory>("RibRouteDecode"));
+  }
+  return executor->get();
+}
+
 void RoutingInformationBase::reconfigure(
     const RouterIDAndNetworkToInterfaceRoutes& configRouterIDToInterfaceRoutes,
     const std::vector<cfg::StaticRouteWithNextHops>& staticRoutesWithNextHops,
@@ -117,6 +146,12 @@ RoutingInformationBase::UpdateStatistics RoutingInformationBase::update(
 
   Timer updateTimer(&stats.duration);
 
+  // Decoding does not depend on RIB state, so do it before taking the lock
+  auto decodedRoutes =
+      UnicastRouteDecoder(getRouteDecodeExecutor(toAdd.size()))
+          .decode(toAdd, adminDistanceFromClientID);
+  StageTracer::markCurrent("routes_decoded");
+
   auto lockedRouteTables = synchronizedRouteTables_.wlock();
 
   auto it = lockedRouteTables->find(routerID);
@@ -131,21 +166,15 @@ RoutingInformationBase::UpdateStatistics RoutingInformationBase::update(
     updater.removeAllRoutesForClient(clientID);
   }
 
-  for (const auto& route : toAdd) {
-    auto network = facebook::network::toIPAddress(route.dest.ip);
-    auto mask = static_cast<uint8_t>(route.dest.prefixLength);
-
-    if (network.isV4()) {
+  for (auto& route : decodedRoutes) {
+    if (route.network.isV4()) {
       ++stats.v4RoutesAdded;
     } else {
       ++stats.v6RoutesAdded;
     }
 
     updater.addRoute(
-        network,
-        mask,
-        clientID,
-        RouteNextHopEntry::from(route, adminDistanceFromClientID));
+        route.network, route.mask, clientID, std::move(route.entry));
   }
 
   for (const auto& prefix : toDelete) {
@@ -162,6 +191,7 @@ RoutingInformationBase::UpdateStatistics RoutingInformationBase::update(
   }
 
   updater.updateDone();
+  StageTracer::markCurrent("rib_updated");
 
   fibUpdateCallback(
       routerID,
@@ -12,6 +12,7 @@
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
 #include "fboss/agent/if/gen-cpp2/FbossCtrl.h"
 #include "fboss/agent/rib/NetworkToRouteMap.h"
+#include "fboss/agent/rib/UnicastRouteDecoder.h"
 #include "fboss/agent/types.h"
 
 #include <folly/Synchronized.h>
@@ -21,6 +22,10 @@
 #include <thread>
 #include <vector>
 
+namespace folly {
+class CPUThreadPoolExecutor;
+} // namespace folly
+
 namespace facebook::fboss::rib {
 
 class RoutingInformationBase {
@@ -52,6 +57,11 @@ class RoutingInformationBase {
    * this mapping is exposed via SwSwitch, which we can't a dependency on here.
    * The adminDistanceFromClientID allows callsites to propogate admin distances
    * per client.
+   *
+   * Routes in `toAdd` are converted to RIB entries before the RIB lock is
+   * acquired. Large batches are converted in parallel on a pool of
+   * FLAGS_rib_route_decode_threads threads (see UnicastRouteDecoder), started
+   * by the first of them.
    */
   UpdateStatistics update(
       RouterID routerID,
@@ -132,6 +142,14 @@ class RoutingInformationBase {
           configRouterIDToInterfaceRoutes) const;
 
   SynchronizedRouteTables synchronizedRouteTables_;
+
+  // Executor to decode an update of numRoutes routes with, null to decode
+  // it serially. The pool is created on the first large update.
+  folly::Executor* getRouteDecodeExecutor(size_t numRoutes);
+
+  // Pool used to decode large route updates, null until one comes in
+  folly::Synchronized<std::shared_ptr<folly::CPUThreadPoolExecutor>>
+      routeDecodeExecutor_;
 };
 
 } // namespace facebook::fboss::rib
@@ -0,0 +1,151 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/rib/UnicastRouteDecoder.h"
+
+#include "fboss/agent/AddressUtil.h"
+
+#include <folly/Executor.h>
+#include <folly/container/F14Map.h>
+#include <folly/futures/Future.h>
+#include <folly/hash/Hash.h>
+
+#include <algorithm>
+#include <deque>
+#include <iterator>
+
+namespace {
+
+using facebook::fboss::NextHopThrift;
+
+// Hash/compare thrift next-hop lists by pointer to avoid copying them into
+// the cache key. The lists are owned by the request being decoded.
+struct NextHopThriftsPtrHash {
+  size_t operator()(const std::vector<NextHopThrift>* nhts) const {
+    size_t hash = nhts->size();
+    for (const auto& nht : *nhts) {
+      hash = folly::hash::hash_combine(
+          hash,
+          nht.address_ref()->addr,
+          nht.address_ref()->ifName_ref().value_or(""),
+          *nht.weight_ref());
+    }
+    return hash;
+  }
+};
+
+struct NextHopThriftsPtrEqual {
+  bool operator()(
+      const std::vector<NextHopThrift>* lhs,
+      const std::vector<NextHopThrift>* rhs) const {
+    return *lhs == *rhs;
+  }
+};
+
+} // namespace
+
+namespace facebook::fboss::rib {
+
+UnicastRouteDecoder::UnicastRouteDecoder(
+    folly::Executor* executor,
+    size_t chunkSize)
+    : executor_(executor), chunkSize_(std::max<size_t>(chunkSize, 1)) {}
+
+void UnicastRouteDecoder::decodeChunk(
+    const UnicastRoute* begin,
+    const UnicastRoute* end,
+    AdminDistance defaultAdminDistance,
+    DecodedUnicastRoutes* decoded) {
+  folly::F14FastMap<
+      const std::vector<NextHopThrift>*,
+      RouteNextHopEntry::InternedNextHopSet,
+      NextHopThriftsPtrHash,
+      NextHopThriftsPtrEqual>
+      nhopSetCache;
+  // Storage for next-hop lists converted from legacy nextHopAddrs, so that
+  // they can be used as cache keys as well.
+  std::deque<std::vector<NextHopThrift>> convertedNextHops;
+
+  decoded->reserve(end - begin);
+  for (auto route = begin; route != end; ++route) {
+    auto network = facebook::network::toIPAddress(route->dest.ip);
+    auto mask = static_cast<uint8_t>(route->dest.prefixLength);
+    auto adminDistance =
+        route->adminDistance_ref().value_or(defaultAdminDistance);
+
+    const std::vector<NextHopThrift>* nhts = &(*route->nextHops_ref());
+    if (nhts->empty() && !route->nextHopAddrs_ref()->empty()) {
+      convertedNextHops.push_back(
+          util::thriftNextHopsFromAddresses(*route->nextHopAddrs_ref()));
+      nhts = &convertedNextHops.back();
+    }
+
+    if (nhts->empty()) {
+      decoded->emplace_back(
+          std::move(network),
+          mask,
+          RouteNextHopEntry(RouteForwardAction::DROP, adminDistance));
+      continue;
+    }
+
+    auto it = nhopSetCache.find(nhts);
+    if (it == nhopSetCache.end()) {
+      it = nhopSetCache
+               .emplace(
+                   nhts,
+                   RouteNextHopEntry::InternedNextHopSet(
+                       util::toRouteNextHopSet(*nhts)))
+               .first;
+    }
+    decoded->emplace_back(
+        std::move(network), mask, RouteNextHopEntry(it->second, adminDistance));
+  }
+}
+
+DecodedUnicastRoutes UnicastRouteDecoder::decode(
+    const std::vector<UnicastRoute>& routes,
+    AdminDistance defaultAdminDistance) const {
+  DecodedUnicastRoutes decoded;
+  if (!executor_ || routes.size() <= chunkSize_) {
+    decodeChunk(
+        routes.data(),
+        routes.data() + routes.size(),
+        defaultAdminDistance,
+        &decoded);
+    return decoded;
+  }
+
+  auto numChunks = (routes.size() + chunkSize_ - 1) / chunkSize_;
+  std::vector<DecodedUnicastRoutes> chunks(numChunks);
+  std::vector<folly::SemiFuture<folly::Unit>> futures;
+  futures.reserve(numChunks);
+  for (size_t i = 0; i < numChunks; ++i) {
+    auto begin = routes.data() + i * chunkSize_;
+    auto end = routes.data() + std::min(routes.size(), (i + 1) * chunkSize_);
+    futures.push_back(folly::via(
+                          executor_,
+                          [begin, end, defaultAdminDistance, &chunks, i]() {
+                            decodeChunk(
+                                begin, end, defaultAdminDistance, &chunks[i]);
+                          })
+                          .semi());
+  }
+  // Rethrows the first decode error (e.g. a malformed address), if any
+  for (auto& result : folly::collectAll(std::move(futures)).get()) {
+    result.throwIfFailed();
+  }
+
+  decoded.reserve(routes.size());
+  for (auto& chunk : chunks) {
+    std::move(chunk.begin(), chunk.end(), std::back_inserter(decoded));
+  }
+  return decoded;
+}
+
+} // namespace facebook::fboss::rib
@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/agent/if/gen-cpp2/ctrl_types.h"
+#include "fboss/agent/rib/RouteNextHopEntry.h"
+#include "fboss/agent/types.h"
+
+#include <folly/IPAddress.h>
+
+#include <vector>
+
+namespace folly {
+class Executor;
+} // namespace folly
+
+namespace facebook::fboss::rib {
+
+struct DecodedUnicastRoute {
+  DecodedUnicastRoute(
+      folly::IPAddress network,
+      uint8_t mask,
+      RouteNextHopEntry entry)
+      : network(std::move(network)), mask(mask), entry(std::move(entry)) {}
+
+  folly::IPAddress network;
+  uint8_t mask;
+  RouteNextHopEntry entry;
+};
+
+using DecodedUnicastRoutes = std::vector<DecodedUnicastRoute>;
+
+/*
+ * UnicastRouteDecoder converts thrift UnicastRoutes into RIB-ready
+ * (network, mask, RouteNextHopEntry) tuples.
+ *
+ * Large requests (e.g. a full syncFib from BGP) are split into chunks which
+ * are decoded concurrently on the given executor. Within a chunk, identical
+ * thrift next-hop lists are converted and interned only once, and all routes
+ * using them share the interned RouteNextHopSet. ECMP fabrics have few
+ * distinct next-hop sets relative to the number of prefixes, so most routes
+ * hit this cache.
+ *
+ * Decoding does not touch the RIB, so it can run before acquiring the RIB
+ * lock. The relative order of routes is preserved in the output.
+ */
+class UnicastRouteDecoder {
+ public:
+  static constexpr size_t kDefaultChunkSize = 4096;
+
+  explicit UnicastRouteDecoder(
+      folly::Executor* executor = nullptr,
+      size_t chunkSize = kDefaultChunkSize);
+
+  DecodedUnicastRoutes decode(
+      const std::vector<UnicastRoute>& routes,
+      AdminDistance defaultAdminDistance) const;
+
+ private:
+  static void decodeChunk(
+      const UnicastRoute* begin,
+      const UnicastRoute* end,
+      AdminDistance defaultAdminDistance,
+      DecodedUnicastRoutes* decoded);
+
+  folly::Executor* executor_;
+  size_t chunkSize_;
+};
+
+} // namespace facebook::fboss::rib
@@ -0,0 +1,189 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "common/init/Init.h"
+#include "fboss/agent/rib/NetworkToRouteMap.h"
+#include "fboss/agent/rib/RouteNextHop.h"
+#include "fboss/agent/rib/RouteNextHopEntry.h"
+#include "fboss/agent/rib/RouteTypes.h"
+
+#include <folly/Benchmark.h>
+#include <folly/FileUtil.h>
+#include <folly/IPAddressV6.h>
+#include <folly/String.h>
+#include <folly/logging/xlog.h>
+
+#include <unistd.h>
+
+#include <map>
+
+using namespace facebook::fboss;
+
+/*
+ * Memory footprint and insert/lookup throughput of the standalone RIB route
+ * map at 100k and 1M routes. Routes are /64s spread over a small number of
+ * ECMP groups, which matches what large deployments look like: many routes,
+ * few distinct next-hop sets, and almost always a single client per route.
+ */
+
+namespace {
+
+auto constexpr kNumEcmpGroups = 64;
+auto constexpr kEcmpWidth = 4;
+const ClientID kBgpClient = ClientID(0);
+const ClientID kOpenrClient = ClientID(786);
+
+std::vector<folly::IPAddressV6> makeNetworks(size_t numRoutes) {
+  std::vector<folly::IPAddressV6> networks;
+  networks.reserve(numRoutes);
+  for (size_t i = 0; i < numRoutes; ++i) {
+    folly::ByteArray16 bytes{};
+    bytes[0] = 0x20;
+    bytes[1] = 0x01;
+    bytes[4] = (i >> 24) & 0xff;
+    bytes[5] = (i >> 16) & 0xff;
+    bytes[6] = (i >> 8) & 0xff;
+    bytes[7] = i & 0xff;
+    networks.emplace_back(bytes);
+  }
+  return networks;
+}
+
+const std::vector<folly::IPAddressV6>& networks(size_t numRoutes) {
+  static std::map<size_t, std::vector<folly::IPAddressV6>> cache;
+  auto it = cache.find(numRoutes);
+  if (it == cache.end()) {
+    it = cache.emplace(numRoutes, makeNetworks(numRoutes)).first;
+  }
+  return it->second;
+}
+
+std::vector<rib::RouteNextHopEntry> makeEntries(AdminDistance distance) {
+  std::vector<rib::RouteNextHopEntry> entries;
+  for (auto group = 0; group < kNumEcmpGroups; ++group) {
+    rib::RouteNextHopSet nhops;
+    for (auto member = 0; member < kEcmpWidth; ++member) {
+      auto addr = folly::IPAddress(folly::to<std::string>(
+          "fe80::", group * kEcmpWidth + member + 1));
+      nhops.emplace(rib::UnresolvedNextHop(addr, rib::ECMP_WEIGHT));
+    }
+    entries.emplace_back(std::move(nhops), distance);
+  }
+  return entries;
+}
+
+void populate(
+    rib::IPv6NetworkToRouteMap& routes,
+    size_t numRoutes,
+    bool secondClient) {
+  static const auto bgpEntries = makeEntries(AdminDistance::EBGP);
+  static const auto openrEntries = makeEntries(AdminDistance::OPENR);
+  const auto& nets = networks(numRoutes);
+  for (size_t i = 0; i < nets.size(); ++i) {
+    rib::RoutePrefix<folly::IPAddressV6> prefix{nets[i], 64};
+    auto ret = routes.insert(
+        prefix.network,
+        prefix.mask,
+        rib::RouteV6(prefix, kBgpClient, bgpEntries[i % kNumEcmpGroups]));
+    if (secondClient) {
+      ret.first->value().update(
+          kOpenrClient, openrEntries[i % kNumEcmpGroups]);
+    }
+  }
+}
+
+size_t currentRss() {
+  std::string statm;
+  if (!folly::readFile("/proc/self/statm", statm)) {
+    return 0;
+  }
+  std::vector<folly::StringPiece> fields;
+  folly::split(' ', statm, fields);
+  return fields.size() < 2
+      ? 0
+      : folly::to<size_t>(fields[1]) * sysconf(_SC_PAGESIZE);
+}
+
+void reportMemory(size_t numRoutes, bool secondClient) {
+  // Make sure prefixes and entries are generated outside the measurement
+  networks(numRoutes);
+  rib::IPv6NetworkToRouteMap warmup;
+  populate(warmup, 1, secondClient);
+
+  auto before = currentRss();
+  rib::IPv6NetworkToRouteMap routes;
+  populate(routes, numRoutes, secondClient);
+  auto after = currentRss();
+  XLOG(INFO) << numRoutes << " routes, " << (secondClient ? 2 : 1)
+             << " client(s): " << (after - before) << " bytes RSS, "
+             << (after - before) / numRoutes << " bytes/route";
+}
+
+void ribInsert(uint32_t iters, size_t numRoutes) {
+  folly::BenchmarkSuspender suspender;
+  networks(numRoutes);
+  for (uint32_t i = 0; i < iters; ++i) {
+    rib::IPv6NetworkToRouteMap routes;
+    suspender.dismiss();
+    populate(routes, numRoutes, false);
+    suspender.rehire();
+  }
+}
+
+void ribInsertTwoClients(uint32_t iters, size_t numRoutes) {
+  folly::BenchmarkSuspender suspender;
+  networks(numRoutes);
+  for (uint32_t i = 0; i < iters; ++i) {
+    rib::IPv6NetworkToRouteMap routes;
+    suspender.dismiss();
+    populate(routes, numRoutes, true);
+    suspender.rehire();
+  }
+}
+
+void ribLookup(uint32_t iters, size_t numRoutes) {
+  folly::BenchmarkSuspender suspender;
+  rib::IPv6NetworkToRouteMap routes;
+  populate(routes, numRoutes, false);
+  const auto& nets = networks(numRoutes);
+  suspender.dismiss();
+
+  size_t found = 0;
+  for (uint32_t i = 0; i < iters; ++i) {
+    for (const auto& network : nets) {
+      auto it = routes.longestMatch(network, 128);
+      found += it->value().getBestEntry().second->getNextHopSet().size();
+    }
+  }
+  folly::doNotOptimizeAway(found);
+  suspender.rehire();
+}
+
+} // namespace
+
+BENCHMARK_PARAM(ribInsert, 100000)
+BENCHMARK_PARAM(ribInsert, 1000000)
+BENCHMARK_PARAM(ribInsertTwoClients, 100000)
+BENCHMARK_PARAM(ribInsertTwoClients, 1000000)
+BENCHMARK_PARAM(ribLookup, 100000)
+BENCHMARK_PARAM(ribLookup, 1000000)
+
+int main(int argc, char** argv) {
+  facebook::initFacebook(&argc, &argv);
+  XLOG(INFO) << "sizeof(RouteV6): " << sizeof(rib::RouteV6)
+             << ", sizeof(RadixTreeNode): "
+             << sizeof(rib::IPv6NetworkToRouteMap::TreeNode);
+  for (auto numRoutes : {100000, 1000000}) {
+    reportMemory(numRoutes, false);
+    reportMemory(numRoutes, true);
+  }
+  folly::runBenchmarks();
+  return EXIT_SUCCESS;
+}
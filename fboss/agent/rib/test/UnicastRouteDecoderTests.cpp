@@ -0,0 +1,102 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/AddressUtil.h"
+#include "fboss/agent/if/gen-cpp2/ctrl_types.h"
+#include "fboss/agent/rib/RouteNextHopEntry.h"
+#include "fboss/agent/rib/UnicastRouteDecoder.h"
+
+#include <folly/IPAddress.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace facebook::fboss::rib;
+
+using facebook::fboss::AdminDistance;
+using facebook::fboss::NextHopThrift;
+using facebook::fboss::UnicastRoute;
+
+namespace {
+
+const AdminDistance kDefaultAdminDistance = AdminDistance::EBGP;
+auto constexpr kChunkSize = 16;
+
+std::vector<NextHopThrift> nextHopsThrift(int setId) {
+  std::vector<NextHopThrift> nexthops;
+  for (auto i = 1; i <= 4; ++i) {
+    NextHopThrift nexthop;
+    *nexthop.address_ref() = facebook::network::toBinaryAddress(
+        folly::IPAddress(folly::to<std::string>("2401:db00::", setId, ":", i)));
+    *nexthop.weight_ref() = static_cast<int32_t>(ECMP_WEIGHT);
+    nexthops.emplace_back(std::move(nexthop));
+  }
+  return nexthops;
+}
+
+// Routes in a mix of a few distinct next-hop sets, a few drop routes and
+// a few routes with an explicit admin distance
+std::vector<UnicastRoute> makeRoutes(int numRoutes) {
+  std::vector<UnicastRoute> routes;
+  for (auto i = 0; i < numRoutes; ++i) {
+    UnicastRoute route;
+    route.dest.ip = facebook::network::toBinaryAddress(folly::IPAddress(
+        folly::to<std::string>("10.", i / 256, ".", i % 256, ".0")));
+    route.dest.prefixLength = 24;
+    if (i % 10 != 0) {
+      route.nextHops_ref() = nextHopsThrift(i % 3);
+    }
+    if (i % 7 == 0) {
+      route.adminDistance_ref() = AdminDistance::IBGP;
+    }
+    routes.push_back(std::move(route));
+  }
+  return routes;
+}
+
+void verifyDecoded(
+    const std::vector<UnicastRoute>& routes,
+    const DecodedUnicastRoutes& decoded) {
+  ASSERT_EQ(routes.size(), decoded.size());
+  for (size_t i = 0; i < routes.size(); ++i) {
+    EXPECT_EQ(
+        decoded[i].network, facebook::network::toIPAddress(routes[i].dest.ip));
+    EXPECT_EQ(decoded[i].mask, routes[i].dest.prefixLength);
+    EXPECT_EQ(
+        decoded[i].entry,
+        RouteNextHopEntry::from(routes[i], kDefaultAdminDistance));
+  }
+}
+
+} // namespace
+
+TEST(UnicastRouteDecoder, SerialDecodeMatchesRouteNextHopEntryFrom) {
+  auto routes = makeRoutes(10 * kChunkSize);
+  UnicastRouteDecoder decoder(nullptr, kChunkSize);
+  verifyDecoded(routes, decoder.decode(routes, kDefaultAdminDistance));
+}
+
+TEST(UnicastRouteDecoder, ParallelDecodePreservesOrder) {
+  // Include a partial trailing chunk
+  auto routes = makeRoutes(10 * kChunkSize + 3);
+  folly::CPUThreadPoolExecutor executor(4);
+  UnicastRouteDecoder decoder(&executor, kChunkSize);
+  verifyDecoded(routes, decoder.decode(routes, kDefaultAdminDistance));
+}
+
+TEST(UnicastRouteDecoder, DecodeErrorIsPropagated) {
+  auto routes = makeRoutes(10 * kChunkSize);
+  // Malformed address in the middle of a chunk
+  routes[5 * kChunkSize + 1].dest.ip.addr = "bad";
+  folly::CPUThreadPoolExecutor executor(4);
+  UnicastRouteDecoder decoder(&executor, kChunkSize);
+  EXPECT_ANY_THROW(decoder.decode(routes, kDefaultAdminDistance));
+}
@@ -15,6 +15,7 @@
 #include <boost/cast.hpp>
 #include <boost/container/flat_map.hpp>
 #include <glog/logging.h>
+#include <functional>
 #include <memory>
 #include <type_traits>
 
@@ -113,6 +114,22 @@ class NodeBase {
     return nodeID_;
   }
 
+  /*
+   * Call fn on each child of this node. Unlike the forEachChild() methods
+   * of the fields, which publish() uses, this only reads the node and may
+   * be called on published nodes from any thread.
+   */
+  virtual void forEachChildNode(
+      const std::function<void(const NodeBase*)>& /*fn*/) const {}
+
+  /*
+   * Approximate bytes allocated for this node alone, not counting its
+   * children. Used to account the memory held by live SwitchStates.
+   */
+  virtual size_t getNodeBytes() const {
+    return sizeof(NodeBase);
+  }
+
  protected:
   NodeBase();
   NodeBase(NodeID id, uint32_t generation)
@@ -199,6 +216,17 @@ class NodeBaseT : public NodeBase {
 
   void publish() override;
 
+  void forEachChildNode(
+      const std::function<void(const NodeBase*)>& fn) const override {
+    // forEachChild() is not const, but only reads the child pointers
+    const_cast<Fields&>(fields_).forEachChild(
+        [&fn](NodeBase* child) { fn(child); });
+  }
+
+  size_t getNodeBytes() const override {
+    return sizeof(Node);
+  }
+
   const Fields* getFields() const {
     return &fields_;
   }
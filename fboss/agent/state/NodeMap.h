@@ -96,6 +96,12 @@ class NodeMapT : public NodeBaseT<MapTypeT, NodeMapFields<TraitsT>> {
     return this->getFields()->nodes.size();
   }
 
+  size_t getNodeBytes() const override {
+    // The entries of the flat map are allocated apart from the map node
+    return sizeof(MapType) +
+        getAllNodes().capacity() * sizeof(typename NodeContainer::value_type);
+  }
+
   const NodeContainer& getAllNodes() const {
     return this->getFields()->nodes;
   }
@@ -13,17 +13,24 @@
 
 #include <folly/dynamic.h>
 
+#include "fboss/lib/Interned.h"
+
 #include "fboss/agent/state/RouteNextHop.h"
+#include "fboss/agent/state/RouteNextHopSetHash.h"
 #include "fboss/agent/state/RouteTypes.h"
 
 DECLARE_uint32(ecmp_width);
 
 namespace facebook::fboss {
 
+using RouteNextHopSetHash = RouteNextHopSetHashT<NextHop>;
+
 class RouteNextHopEntry {
  public:
   using Action = RouteForwardAction;
   using NextHopSet = boost::container::flat_set<NextHop>;
+  // Next-hop sets are interned, routes with the same set share one copy
+  using InternedNextHopSet = Interned<NextHopSet, RouteNextHopSetHash>;
 
   RouteNextHopEntry(Action action, AdminDistance distance)
       : adminDistance_(distance), action_(action) {
@@ -32,10 +39,12 @@ class RouteNextHopEntry {
 
   RouteNextHopEntry(NextHopSet nhopSet, AdminDistance distance);
 
+  RouteNextHopEntry(InternedNextHopSet nhopSet, AdminDistance distance);
+
   RouteNextHopEntry(NextHop nhop, AdminDistance distance)
-      : adminDistance_(distance), action_(Action::NEXTHOPS) {
-    nhopSet_.emplace(std::move(nhop));
-  }
+      : adminDistance_(distance),
+        action_(Action::NEXTHOPS),
+        nhopSet_(NextHopSet{std::move(nhop)}) {}
 
   AdminDistance getAdminDistance() const {
     return adminDistance_;
@@ -46,6 +55,10 @@ class RouteNextHopEntry {
   }
 
   const NextHopSet& getNextHopSet() const {
+    return *nhopSet_;
+  }
+
+  const InternedNextHopSet& getInternedNextHopSet() const {
     return nhopSet_;
   }
 
@@ -79,7 +92,7 @@ class RouteNextHopEntry {
 
   // Reset the NextHopSet
   void reset() {
-    nhopSet_.clear();
+    nhopSet_ = InternedNextHopSet();
     action_ = Action::DROP;
   }
 
@@ -88,7 +101,7 @@ class RouteNextHopEntry {
  private:
   AdminDistance adminDistance_;
   Action action_{Action::DROP};
-  NextHopSet nhopSet_;
+  InternedNextHopSet nhopSet_;
 };
 
 /**
@@ -0,0 +1,41 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <boost/container/flat_set.hpp>
+
+#include <folly/hash/Hash.h>
+
+#include <cstdint>
+
+namespace facebook::fboss {
+
+/*
+ * Hash of a next-hop set, used to intern the next-hop sets of route entries.
+ * Shared by the SwitchState and standalone RIB route entries, whose NextHop
+ * types are distinct but have the same accessors.
+ */
+template <typename NextHopT>
+struct RouteNextHopSetHashT {
+  size_t operator()(const boost::container::flat_set<NextHopT>& nhops) const {
+    size_t hash = nhops.size();
+    for (const auto& nhop : nhops) {
+      hash = folly::hash::hash_combine(
+          hash,
+          nhop.addr(),
+          nhop.intfID().has_value() ? static_cast<uint32_t>(*nhop.intfID())
+                                    : 0,
+          nhop.weight());
+    }
+    return hash;
+  }
+};
+
+} // namespace facebook::fboss
@@ -103,6 +103,17 @@ class RouteTableRib : public NodeBase {
     NodeBase::publish();
   }
 
+  void forEachChildNode(
+      const std::function<void(const NodeBase*)>& fn) const override {
+    fn(nodeMap_.get());
+  }
+
+  size_t getNodeBytes() const override {
+    // The radix tree is not part of the state tree, so count it here
+    return sizeof(*this) +
+        radixTree_.size() * sizeof(typename RoutesRadixTree::TreeNode);
+  }
+
   RouteTableRib* modify(RouterID id, std::shared_ptr<SwitchState>* state);
 
   std::shared_ptr<RouteTableRib> clone() const {
@@ -39,8 +39,141 @@ using std::shared_ptr;
 
 namespace facebook::fboss {
 
+namespace {
+
+template <typename DeltaT>
+bool countChanges(const DeltaT& delta, StateDeltaSummary::Counts* counts) {
+  if (delta.getOld() == delta.getNew()) {
+    return false;
+  }
+  for (const auto& entryDelta : delta) {
+    if (!entryDelta.getOld()) {
+      ++counts->added;
+    } else if (!entryDelta.getNew()) {
+      ++counts->removed;
+    } else {
+      ++counts->changed;
+    }
+  }
+  return counts->total() > 0;
+}
+
+template <typename NodeT>
+bool nodeChanged(
+    const std::shared_ptr<NodeT>& oldNode,
+    const std::shared_ptr<NodeT>& newNode) {
+  return oldNode != newNode;
+}
+
+} // namespace
+
+StateDeltaSummary::StateDeltaSummary(const StateDelta& delta) {
+  const auto& oldState = delta.oldState();
+  const auto& newState = delta.newState();
+  if (!oldState || !newState || oldState == newState) {
+    return;
+  }
+  auto count = [this](Node node, const auto& nodeDelta) {
+    changed_.set(node, countChanges(nodeDelta, &counts_[node]));
+  };
+  count(PORTS, delta.getPortsDelta());
+  count(VLANS, delta.getVlansDelta());
+  count(INTERFACES, delta.getIntfsDelta());
+  count(ROUTE_TABLES, delta.getRouteTablesDelta());
+  // getAclsDelta() re-sorts both maps by priority, which counting does not
+  // need, so walk the ACL maps as they are
+  count(
+      ACLS,
+      NodeMapDelta<AclMap>(
+          oldState->getAcls().get(), newState->getAcls().get()));
+  count(QOS_POLICIES, delta.getQosPoliciesDelta());
+  count(AGGREGATE_PORTS, delta.getAggregatePortsDelta());
+  count(SFLOW_COLLECTORS, delta.getSflowCollectorsDelta());
+  count(LOAD_BALANCERS, delta.getLoadBalancersDelta());
+  count(MIRRORS, delta.getMirrorsDelta());
+  count(FIBS, delta.getFibsDelta());
+  count(LABEL_FIB, delta.getLabelForwardingInformationBaseDelta());
+
+  changed_.set(
+      CONTROL_PLANE,
+      nodeChanged(oldState->getControlPlane(), newState->getControlPlane()));
+  changed_.set(
+      SWITCH_SETTINGS,
+      nodeChanged(
+          oldState->getSwitchSettings(), newState->getSwitchSettings()));
+  changed_.set(
+      DEFAULT_DATA_PLANE_QOS_POLICY,
+      nodeChanged(
+          oldState->getDefaultDataPlaneQosPolicy(),
+          newState->getDefaultDataPlaneQosPolicy()));
+}
+
+folly::StringPiece StateDeltaSummary::getName(Node node) {
+  switch (node) {
+    case PORTS:
+      return "ports";
+    case VLANS:
+      return "vlans";
+    case INTERFACES:
+      return "interfaces";
+    case ROUTE_TABLES:
+      return "routeTables";
+    case ACLS:
+      return "acls";
+    case QOS_POLICIES:
+      return "qosPolicies";
+    case AGGREGATE_PORTS:
+      return "aggregatePorts";
+    case SFLOW_COLLECTORS:
+      return "sflowCollectors";
+    case LOAD_BALANCERS:
+      return "loadBalancers";
+    case MIRRORS:
+      return "mirrors";
+    case FIBS:
+      return "fibs";
+    case LABEL_FIB:
+      return "labelFib";
+    case CONTROL_PLANE:
+      return "controlPlane";
+    case SWITCH_SETTINGS:
+      return "switchSettings";
+    case DEFAULT_DATA_PLANE_QOS_POLICY:
+      return "defaultDataPlaneQosPolicy";
+    case NUM_NODES:
+      break;
+  }
+  return "unknown";
+}
+
+std::ostream& operator<<(std::ostream& out, const StateDeltaSummary& summary) {
+  out << "{";
+  auto first = true;
+  for (uint8_t i = 0; i < StateDeltaSummary::NUM_NODES; ++i) {
+    auto node = static_cast<StateDeltaSummary::Node>(i);
+    if (!summary.changed(node)) {
+      continue;
+    }
+    out << (first ? "" : ", ") << StateDeltaSummary::getName(node);
+    const auto& counts = summary.getCounts(node);
+    if (counts.total()) {
+      out << ": +" << counts.added << " -" << counts.removed << " ~"
+          << counts.changed;
+    }
+    first = false;
+  }
+  return out << "}";
+}
+
 StateDelta::~StateDelta() {}
 
+const StateDeltaSummary& StateDelta::getSummary() const {
+  std::call_once(summaryOnce_, [this]() {
+    summary_ = std::make_unique<StateDeltaSummary>(*this);
+  });
+  return *summary_;
+}
+
 NodeMapDelta<PortMap> StateDelta::getPortsDelta() const {
   return NodeMapDelta<PortMap>(old_->getPorts().get(), new_->getPorts().get());
 }
@@ -9,8 +9,11 @@
  */
 #pragma once
 
+#include <array>
+#include <bitset>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <ostream>
 
 #include "fboss/agent/state/AclMap.h"
@@ -31,10 +34,84 @@
 #include "fboss/agent/state/SwitchSettings.h"
 #include "fboss/agent/state/VlanMapDelta.h"
 
+#include <folly/Range.h>
+
 namespace facebook::fboss {
 
 class SwitchState;
 class ControlPlane;
+class StateDelta;
+
+/*
+ * Which top level nodes of the SwitchState a StateDelta changes, and for
+ * node maps, how many of their entries were added, removed and changed.
+ *
+ * This lets SwSwitch, HwSwitches and state observers skip the parts of the
+ * state an update left untouched without building their deltas, and size
+ * their work up front.
+ */
+class StateDeltaSummary {
+ public:
+  enum Node : uint8_t {
+    PORTS,
+    VLANS,
+    INTERFACES,
+    ROUTE_TABLES,
+    ACLS,
+    QOS_POLICIES,
+    AGGREGATE_PORTS,
+    SFLOW_COLLECTORS,
+    LOAD_BALANCERS,
+    MIRRORS,
+    FIBS,
+    LABEL_FIB,
+    CONTROL_PLANE,
+    SWITCH_SETTINGS,
+    DEFAULT_DATA_PLANE_QOS_POLICY,
+    NUM_NODES,
+  };
+
+  struct Counts {
+    uint32_t added{0};
+    uint32_t removed{0};
+    uint32_t changed{0};
+
+    uint32_t total() const {
+      return added + removed + changed;
+    }
+  };
+
+  StateDeltaSummary() {}
+  explicit StateDeltaSummary(const StateDelta& delta);
+
+  /*
+   * Whether the node changed. Node maps only count as changed if some of
+   * their entries did.
+   */
+  bool changed(Node node) const {
+    return changed_.test(node);
+  }
+  template <typename... Nodes>
+  bool anyChanged(Node node, Nodes... nodes) const {
+    return (changed(node) || ... || changed(nodes));
+  }
+  // Whether none of the nodes above changed
+  bool empty() const {
+    return changed_.none();
+  }
+  // Entries added, removed and changed in a node map
+  const Counts& getCounts(Node node) const {
+    return counts_[node];
+  }
+
+  static folly::StringPiece getName(Node node);
+
+ private:
+  std::bitset<NUM_NODES> changed_;
+  std::array<Counts, NUM_NODES> counts_;
+};
+
+std::ostream& operator<<(std::ostream& out, const StateDeltaSummary& summary);
 
 /*
  * StateDelta contains code for examining the differences between two
@@ -73,6 +150,12 @@ class StateDelta {
   getLabelForwardingInformationBaseDelta() const;
   DeltaValue<SwitchSettings> getSwitchSettingsDelta() const;
 
+  /*
+   * What the delta changes. Computed on first use, once for all of the
+   * users of the delta.
+   */
+  const StateDeltaSummary& getSummary() const;
+
  private:
   // Forbidden copy constructor and assignment operator
   StateDelta(StateDelta const&) = delete;
@@ -80,6 +163,8 @@ class StateDelta {
 
   std::shared_ptr<SwitchState> old_;
   std::shared_ptr<SwitchState> new_;
+  mutable std::once_flag summaryOnce_;
+  mutable std::unique_ptr<StateDeltaSummary> summary_;
 };
 
 std::ostream& operator<<(std::ostream& out, const StateDelta& stateDelta);
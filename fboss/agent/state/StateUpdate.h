@@ -16,6 +16,7 @@
 
 namespace facebook::fboss {
 
+class StageTrace;
 class SwitchState;
 
 /*
@@ -84,6 +85,9 @@ class StateUpdate {
 
   std::string name_;
   bool allowCoalesce_;
+  // Trace of the work which scheduled this update, if any. SwSwitch marks the
+  // update thread stages on it.
+  std::shared_ptr<StageTrace> trace_;
 
   // An intrusive list hook for maintaining the list of pending updates.
   folly::IntrusiveListHook listHook_;
@@ -368,6 +368,18 @@ class SwitchState : public NodeBaseT<SwitchState, SwitchStateFields> {
     BaseT::publish();
   }
 
+  void forEachChildNode(
+      const std::function<void(const NodeBase*)>& fn) const override {
+    using BaseT = NodeBaseT<SwitchState, SwitchStateFields>;
+    if (auto defaultDataPlaneQosPolicy = getDefaultDataPlaneQosPolicy()) {
+      fn(defaultDataPlaneQosPolicy.get());
+    }
+    if (auto qcmCfg = getQcmCfg()) {
+      fn(qcmCfg.get());
+    }
+    BaseT::forEachChildNode(fn);
+  }
+
  private:
   // Inherit the constructor required for clone()
   using NodeBaseT::NodeBaseT;
@@ -893,3 +893,35 @@ TEST(PortMap, iterateOrder) {
   ++it;
   EXPECT_EQ(ports->end(), it);
 }
+
+TEST(PortMap, stateDeltaSummary) {
+  auto stateV0 = make_shared<SwitchState>();
+  stateV0->registerPort(PortID(1), "port1");
+  stateV0->registerPort(PortID(2), "port2");
+  stateV0->publish();
+
+  auto stateV1 = stateV0->clone();
+  auto ports = stateV1->getPorts()->modify(&stateV1);
+  ports->getPort(PortID(1))->modify(&stateV1)->setAdminState(
+      cfg::PortState::ENABLED);
+  ports->registerPort(PortID(3), "port3");
+  stateV1->publish();
+
+  StateDelta delta(stateV0, stateV1);
+  const auto& summary = delta.getSummary();
+  EXPECT_FALSE(summary.empty());
+  EXPECT_TRUE(summary.changed(StateDeltaSummary::PORTS));
+  EXPECT_EQ(1, summary.getCounts(StateDeltaSummary::PORTS).added);
+  EXPECT_EQ(0, summary.getCounts(StateDeltaSummary::PORTS).removed);
+  EXPECT_EQ(1, summary.getCounts(StateDeltaSummary::PORTS).changed);
+  EXPECT_FALSE(summary.anyChanged(
+      StateDeltaSummary::VLANS,
+      StateDeltaSummary::ROUTE_TABLES,
+      StateDeltaSummary::ACLS,
+      StateDeltaSummary::SWITCH_SETTINGS));
+  // Computed once for all users of the delta
+  EXPECT_EQ(&summary, &delta.getSummary());
+
+  StateDelta noopDelta(stateV1, stateV1);
+  EXPECT_TRUE(noopDelta.getSummary().empty());
+}
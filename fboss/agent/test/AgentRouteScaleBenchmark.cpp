@@ -0,0 +1,342 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/AddressUtil.h"
+#include "fboss/agent/ApplyThriftConfig.h"
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/ThriftHandler.h"
+#include "fboss/agent/hw/sim/SimPlatform.h"
+#include "fboss/agent/hw/test/ConfigFactory.h"
+#include "fboss/agent/state/RouteTable.h"
+#include "fboss/agent/state/RouteTableMap.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/test/RouteScaleGenerators.h"
+#include "fboss/lib/StageTracer.h"
+
+#include <folly/Benchmark.h>
+#include <folly/MacAddress.h>
+#include <folly/dynamic.h>
+#include <folly/init/Init.h>
+#include <folly/json.h>
+#include <folly/logging/Init.h>
+#include <folly/logging/xlog.h>
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+
+FOLLY_INIT_LOGGING_CONFIG("fboss=INFO; default:async=true");
+DECLARE_int32(route_update_traces);
+DECLARE_int64(bm_max_iters);
+
+using namespace facebook::fboss;
+using facebook::network::toBinaryAddress;
+
+/*
+ * End to end route programming benchmarks which need no hardware. Routes from
+ * the route scale generators are pushed through the real thrift handler,
+ * standalone RIB, SwSwitch update queue and state observers of a SwSwitch
+ * running on the sim platform, so the results only cover the software side
+ * of route programming.
+ *
+ * Besides the usual benchmark timing, each run logs route throughput, the
+ * distribution of per thrift call latencies and where that time went,
+ * broken down by route update trace stage. Peak RSS is printed on exit.
+ */
+
+namespace {
+
+auto constexpr kNumPorts = 64;
+auto constexpr kEcmpWidth = 4;
+const int16_t kClient = static_cast<int16_t>(ClientID::BGPD);
+
+std::unique_ptr<SwSwitch> setupSwitch() {
+  auto sw = std::make_unique<SwSwitch>(std::make_unique<SimPlatform>(
+      folly::MacAddress("02:00:00:00:00:01"), kNumPorts));
+  sw->init(
+      nullptr /* No custom TunManager */, SwitchFlags::ENABLE_STANDALONE_RIB);
+
+  std::vector<PortID> ports;
+  for (int i = 1; i <= kNumPorts; ++i) {
+    ports.push_back(PortID(i));
+  }
+  auto config = utility::onePortPerVlanConfig(sw->getHw(), ports);
+  sw->updateStateBlocking(
+      "apply config", [&](const std::shared_ptr<SwitchState>& state) {
+        return applyThriftConfig(
+            state, &config, sw->getPlatform(), sw->getRib());
+      });
+  sw->initialConfigApplied(std::chrono::steady_clock::now());
+  sw->fibSynced();
+  return sw;
+}
+
+template <typename RouteScaleGeneratorT>
+utility::RouteDistributionGenerator::RouteChunks generateRouteChunks(
+    const std::shared_ptr<SwitchState>& appliedState) {
+  // Generators check new prefixes against the SwitchState route table for
+  // VRF 0, which stays empty when routes live in the standalone RIB
+  auto state = appliedState->clone();
+  if (!state->getRouteTables()->getRouteTableIf(RouterID(0))) {
+    state->getRouteTables()->modify(&state)->addRouteTable(
+        std::make_shared<RouteTable>(RouterID(0)));
+  }
+  state->publish();
+  return RouteScaleGeneratorT(state, utility::kDefaultChunkSize, kEcmpWidth)
+      .get();
+}
+
+IpPrefix toIpPrefix(const folly::CIDRNetwork& network) {
+  IpPrefix prefix;
+  prefix.ip = toBinaryAddress(network.first);
+  prefix.prefixLength = network.second;
+  return prefix;
+}
+
+std::unique_ptr<std::vector<UnicastRoute>> toUnicastRoutes(
+    const utility::RouteDistributionGenerator::RouteChunk& chunk) {
+  auto routes = std::make_unique<std::vector<UnicastRoute>>();
+  for (const auto& route : chunk) {
+    UnicastRoute unicastRoute;
+    unicastRoute.dest = toIpPrefix(route.prefix);
+    for (const auto& nhop : route.nhops) {
+      NextHopThrift nextHop;
+      *nextHop.address_ref() = toBinaryAddress(nhop);
+      unicastRoute.nextHops_ref()->push_back(std::move(nextHop));
+    }
+    routes->push_back(std::move(unicastRoute));
+  }
+  return routes;
+}
+
+std::unique_ptr<std::vector<IpPrefix>> toIpPrefixes(
+    const utility::RouteDistributionGenerator::RouteChunk& chunk) {
+  auto prefixes = std::make_unique<std::vector<IpPrefix>>();
+  for (const auto& route : chunk) {
+    prefixes->push_back(toIpPrefix(route.prefix));
+  }
+  return prefixes;
+}
+
+std::chrono::microseconds percentile(
+    std::vector<std::chrono::microseconds> samples,
+    double pct) {
+  if (samples.empty()) {
+    return std::chrono::microseconds(0);
+  }
+  auto idx = std::min(
+      samples.size() - 1, static_cast<size_t>(samples.size() * pct / 100));
+  std::nth_element(samples.begin(), samples.begin() + idx, samples.end());
+  return samples[idx];
+}
+
+void reportRun(
+    folly::StringPiece name,
+    size_t numRoutes,
+    const std::vector<std::chrono::microseconds>& callLatencies,
+    const StageTracer* tracer) {
+  std::chrono::microseconds total(0);
+  for (auto latency : callLatencies) {
+    total += latency;
+  }
+  XLOG(INFO) << name << ": " << numRoutes << " routes in "
+             << callLatencies.size() << " thrift calls took " << total.count()
+             << "us, "
+             << (total.count() ? numRoutes * 1000000 / total.count() : 0)
+             << " routes/s, per call latency p50: "
+             << percentile(callLatencies, 50).count()
+             << "us p99: " << percentile(callLatencies, 99).count()
+             << "us max: " << percentile(callLatencies, 100).count() << "us";
+
+  // Average time spent reaching each stage from the one before it
+  std::map<std::string, std::pair<std::chrono::microseconds, size_t>> stages;
+  for (const auto& trace : tracer->getRecentTraces(callLatencies.size())) {
+    auto traceStages = trace->getStages();
+    for (size_t i = 1; i < traceStages.size(); ++i) {
+      auto& stage = stages[traceStages[i].name];
+      stage.first += std::chrono::duration_cast<std::chrono::microseconds>(
+          traceStages[i].time - traceStages[i - 1].time);
+      ++stage.second;
+    }
+  }
+  for (const auto& stage : stages) {
+    XLOG(INFO) << name << ": stage " << stage.first
+               << " avg: " << stage.second.first.count() / stage.second.second
+               << "us";
+  }
+}
+
+// Run call and record how long it took in callLatencies
+template <typename CallT>
+void timeCall(
+    std::vector<std::chrono::microseconds>* callLatencies,
+    CallT&& call) {
+  auto begin = std::chrono::steady_clock::now();
+  call();
+  callLatencies->push_back(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - begin));
+}
+
+template <typename RouteScaleGeneratorT>
+void routeAddDelBenchmarker(folly::StringPiece name, bool measureAdd) {
+  folly::BenchmarkSuspender suspender;
+  auto sw = setupSwitch();
+  ThriftHandler handler(sw.get());
+  const auto chunks =
+      generateRouteChunks<RouteScaleGeneratorT>(sw->getState());
+  size_t numRoutes = 0;
+  std::vector<std::unique_ptr<std::vector<UnicastRoute>>> toAdd;
+  std::vector<std::unique_ptr<std::vector<IpPrefix>>> toDelete;
+  for (const auto& chunk : chunks) {
+    numRoutes += chunk.size();
+    toAdd.push_back(toUnicastRoutes(chunk));
+    toDelete.push_back(toIpPrefixes(chunk));
+  }
+  std::vector<std::chrono::microseconds> callLatencies;
+
+  if (measureAdd) {
+    suspender.dismiss();
+  }
+  for (auto& routes : toAdd) {
+    timeCall(&callLatencies, [&] {
+      handler.addUnicastRoutes(kClient, std::move(routes));
+    });
+  }
+  if (measureAdd) {
+    suspender.rehire();
+    reportRun(name, numRoutes, callLatencies, sw->getRouteUpdateTracer());
+    return;
+  }
+
+  callLatencies.clear();
+  suspender.dismiss();
+  for (auto& prefixes : toDelete) {
+    timeCall(&callLatencies, [&] {
+      handler.deleteUnicastRoutes(kClient, std::move(prefixes));
+    });
+  }
+  suspender.rehire();
+  reportRun(name, numRoutes, callLatencies, sw->getRouteUpdateTracer());
+}
+
+/*
+ * Steady state churn: with the full route scale programmed, withdraw and
+ * re-announce a handful of routes at a time. Each update touches little of
+ * a large state, so the time spent in state observers
+ * (observers_notified) dominates more than when programming the scale.
+ */
+template <typename RouteScaleGeneratorT>
+void routeChurnBenchmarker(folly::StringPiece name) {
+  auto constexpr kChurnRoutes = 16;
+  auto constexpr kChurnIterations = 500;
+  folly::BenchmarkSuspender suspender;
+  auto sw = setupSwitch();
+  ThriftHandler handler(sw.get());
+  const auto chunks =
+      generateRouteChunks<RouteScaleGeneratorT>(sw->getState());
+  for (const auto& chunk : chunks) {
+    handler.addUnicastRoutes(kClient, toUnicastRoutes(chunk));
+  }
+  utility::RouteDistributionGenerator::RouteChunk churnChunk(
+      chunks.front().begin(),
+      chunks.front().begin() +
+          std::min<size_t>(kChurnRoutes, chunks.front().size()));
+
+  std::vector<std::chrono::microseconds> callLatencies;
+  for (int i = 0; i < kChurnIterations; ++i) {
+    auto toDelete = toIpPrefixes(churnChunk);
+    auto toAdd = toUnicastRoutes(churnChunk);
+    suspender.dismiss();
+    timeCall(&callLatencies, [&] {
+      handler.deleteUnicastRoutes(kClient, std::move(toDelete));
+    });
+    timeCall(&callLatencies, [&] {
+      handler.addUnicastRoutes(kClient, std::move(toAdd));
+    });
+    suspender.rehire();
+  }
+  reportRun(
+      name,
+      churnChunk.size() * kChurnIterations * 2,
+      callLatencies,
+      sw->getRouteUpdateTracer());
+}
+
+} // namespace
+
+#define AGENT_ROUTE_ADD_BENCHMARK(name, RouteScaleGeneratorT) \
+  BENCHMARK(name) {                                           \
+    routeAddDelBenchmarker<RouteScaleGeneratorT>(#name, true); \
+  }
+
+#define AGENT_ROUTE_DEL_BENCHMARK(name, RouteScaleGeneratorT)  \
+  BENCHMARK(name) {                                            \
+    routeAddDelBenchmarker<RouteScaleGeneratorT>(#name, false); \
+  }
+
+AGENT_ROUTE_ADD_BENCHMARK(
+    AgentRswScaleRouteAdd,
+    utility::RSWRouteScaleGenerator);
+AGENT_ROUTE_DEL_BENCHMARK(
+    AgentRswScaleRouteDel,
+    utility::RSWRouteScaleGenerator);
+AGENT_ROUTE_ADD_BENCHMARK(
+    AgentFswScaleRouteAdd,
+    utility::FSWRouteScaleGenerator);
+AGENT_ROUTE_DEL_BENCHMARK(
+    AgentFswScaleRouteDel,
+    utility::FSWRouteScaleGenerator);
+AGENT_ROUTE_ADD_BENCHMARK(
+    AgentThAlpmScaleRouteAdd,
+    utility::THAlpmRouteScaleGenerator);
+AGENT_ROUTE_DEL_BENCHMARK(
+    AgentThAlpmScaleRouteDel,
+    utility::THAlpmRouteScaleGenerator);
+AGENT_ROUTE_ADD_BENCHMARK(
+    AgentHgridDuScaleRouteAdd,
+    utility::HgridDuRouteScaleGenerator);
+AGENT_ROUTE_DEL_BENCHMARK(
+    AgentHgridDuScaleRouteDel,
+    utility::HgridDuRouteScaleGenerator);
+AGENT_ROUTE_ADD_BENCHMARK(
+    AgentHgridUuScaleRouteAdd,
+    utility::HgridUuRouteScaleGenerator);
+AGENT_ROUTE_DEL_BENCHMARK(
+    AgentHgridUuScaleRouteDel,
+    utility::HgridUuRouteScaleGenerator);
+
+BENCHMARK(AgentRswScaleRouteChurn) {
+  routeChurnBenchmarker<utility::RSWRouteScaleGenerator>(
+      "AgentRswScaleRouteChurn");
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+  // Each iteration sets up a switch and programs a full route scale. As the
+  // HW benchmarks do, cap each benchmark at 2 iterations (folly benchmark
+  // counts iterations in powers of 2) instead of growing the count to fill
+  // its time budget
+  FLAGS_bm_max_iters = 2;
+  // Keep a trace of every thrift call for the per stage breakdown
+  FLAGS_route_update_traces = 100000;
+
+  folly::runBenchmarks();
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  folly::dynamic rusageJson = folly::dynamic::object;
+  rusageJson["max_rss"] = usage.ru_maxrss;
+  std::cout << toPrettyJson(rusageJson) << std::endl;
+  return 0;
+}
@@ -19,6 +19,7 @@
 #include "fboss/agent/SwitchStats.h"
 #include "fboss/agent/ThriftHandler.h"
 #include "fboss/agent/TxPacket.h"
+#include "fboss/agent/TxPacketTemplates.h"
 #include "fboss/agent/hw/mock/MockHwSwitch.h"
 #include "fboss/agent/hw/mock/MockPlatform.h"
 #include "fboss/agent/hw/mock/MockRxPacket.h"
@@ -305,6 +306,34 @@ TEST(ArpTest, BasicSendRequest) {
   counters.checkDelta(SwitchStats::kCounterPrefix + "arp.reply.rx.sum", 0);
 }
 
+TEST(ArpTest, SendRequestsFromTemplate) {
+  auto handle = setupTestHandle();
+  auto sw = handle->getSw();
+  VlanID vlanID(1);
+  IPAddressV4 senderIP = IPAddressV4("10.0.0.1");
+
+  auto state = sw->getState();
+  auto intf = state->getInterfaces()->getInterfaceIf(RouterID(0), senderIP);
+  ASSERT_NE(intf, nullptr);
+
+  // Requests from the same interface address share a template, only the
+  // target differs from one request to the next
+  size_t numTemplates = 0;
+  for (auto target : {"10.0.0.2", "10.0.0.3", "10.0.0.4"}) {
+    IPAddressV4 targetIP(target);
+    EXPECT_SWITCHED_PKT(
+        sw,
+        "ARP request",
+        checkArpRequest(senderIP, intf->getMac(), targetIP, vlanID));
+    ArpHandler::sendArpRequest(
+        sw, vlanID, intf->getMac(), senderIP, targetIP);
+    if (!numTemplates) {
+      numTemplates = sw->getTxPacketTemplates()->numTemplates();
+    }
+  }
+  EXPECT_EQ(sw->getTxPacketTemplates()->numTemplates(), numTemplates);
+}
+
 TEST(ArpTest, TableUpdates) {
   auto handle = setupTestHandle();
   auto sw = handle->getSw();
@@ -10,8 +10,14 @@
 
 #include "fboss/agent/AsyncLogger.h"
 
+#include <folly/FileUtil.h>
+#include <folly/logging/xlog.h>
 #include <gtest/gtest.h>
 #include <stdio.h>
+#include <sys/stat.h>
+
+#include <thread>
+#include <vector>
 
 #define TEST_LOG "/tmp/sai_logger_test"
 
@@ -122,3 +128,120 @@ TEST_F(AsyncLoggerTest, concurrentWaitTest) {
   // Therefore, the flush count should be equal or greater than two.
   EXPECT_GE(asyncLogger->flushCount_, 2);
 }
+
+TEST_F(AsyncLoggerTest, oversizedRecordTest) {
+  // Records larger than a segment bypass the ring. They are written out
+  // once appendLog returns, after the records logged before them.
+  std::string before = "before\n";
+  std::string str(AsyncLogger::kBufferSize * 2, '.');
+  std::string after = "after\n";
+  asyncLogger->appendLog(before.c_str(), before.size());
+  asyncLogger->appendLog(str.c_str(), str.size());
+
+  struct stat st;
+  ASSERT_EQ(stat(TEST_LOG, &st), 0);
+  EXPECT_EQ(st.st_size, before.size() + str.size());
+
+  asyncLogger->appendLog(after.c_str(), after.size());
+  asyncLogger->forceFlush();
+  std::string contents;
+  ASSERT_TRUE(folly::readFile(TEST_LOG, contents));
+  EXPECT_EQ(contents, before + str + after);
+}
+
+TEST_F(AsyncLoggerTest, concurrentOversizedRecordTest) {
+  auto constexpr kNumThreads = 4;
+  auto constexpr kRecordsPerThread = 10;
+  std::string small(128, '.');
+  std::string oversized(AsyncLogger::kBufferSize + 1, '.');
+
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&]() {
+      for (auto j = 0; j < kRecordsPerThread; ++j) {
+        asyncLogger->appendLog(small.c_str(), small.size());
+        asyncLogger->appendLog(oversized.c_str(), oversized.size());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  asyncLogger->forceFlush();
+
+  struct stat st;
+  ASSERT_EQ(stat(TEST_LOG, &st), 0);
+  EXPECT_EQ(
+      st.st_size,
+      kNumThreads * kRecordsPerThread * (small.size() + oversized.size()));
+}
+
+TEST(AsyncLoggerBackpressureTest, dropOnFullTest) {
+  // A tiny ring fills up faster than the flush thread can drain it. Records
+  // that do not fit are dropped and counted, the rest make it to the file.
+  auto constexpr kSegmentSize = 1024;
+  auto constexpr kNumSegments = 2;
+  AsyncLogger logger(
+      TEST_LOG,
+      100 /* logTimeout */,
+      AsyncLogger::BackpressureMode::DROP,
+      kSegmentSize,
+      kNumSegments);
+  std::string str(kSegmentSize / 2, '.');
+  logger.startFlushThread();
+
+  for (auto i = 0; i < 10 * kNumSegments; ++i) {
+    logger.appendLog(str.c_str(), str.size());
+  }
+  logger.forceFlush();
+  logger.stopFlushThread();
+
+  struct stat st;
+  ASSERT_EQ(stat(TEST_LOG, &st), 0);
+  EXPECT_EQ(
+      st.st_size + logger.droppedRecords() * str.size(),
+      10 * kNumSegments * str.size());
+  std::remove(TEST_LOG);
+}
+
+/*
+ * Multi-threaded throughput benchmark. Several producers append small records
+ * concurrently, similar to SaiTracer logging SAI calls from multiple threads.
+ * Checks that no data is lost in BLOCK mode and reports the throughput.
+ */
+TEST_F(AsyncLoggerTest, multiThreadedThroughputTest) {
+  auto constexpr kNumThreads = 8;
+  auto constexpr kRecordsPerThread = 100000;
+  std::string str(128, '.');
+  str.back() = '\n';
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&]() {
+      for (auto j = 0; j < kRecordsPerThread; ++j) {
+        asyncLogger->appendLog(str.c_str(), str.size());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+  asyncLogger->forceFlush();
+
+  uint64_t totalBytes =
+      static_cast<uint64_t>(kNumThreads) * kRecordsPerThread * str.size();
+  struct stat st;
+  ASSERT_EQ(stat(TEST_LOG, &st), 0);
+  EXPECT_EQ(st.st_size, totalBytes);
+  EXPECT_EQ(asyncLogger->droppedRecords(), 0);
+
+  XLOG(INFO) << "Appended " << kNumThreads * kRecordsPerThread << " records ("
+             << totalBytes << " bytes) from " << kNumThreads << " threads in "
+             << elapsed.count() << "us: "
+             << (totalBytes * 1000000.0 / std::max<int64_t>(elapsed.count(), 1) /
+                 (1 << 20))
+             << " MB/s, " << asyncLogger->flushCount_ << " segments flushed";
+}
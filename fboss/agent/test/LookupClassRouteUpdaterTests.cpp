@@ -21,6 +21,8 @@
 #include <folly/IPAddressV4.h>
 #include <folly/IPAddressV6.h>
 
+#include <chrono>
+
 using folly::IPAddressV4;
 using folly::IPAddressV6;
 
@@ -212,6 +214,68 @@ class LookupClassRouteUpdaterTest : public ::testing::Test {
     waitForStateUpdates(this->sw_);
   }
 
+  RoutePrefix<AddrT> kScaleRoutePrefix(uint32_t index) const {
+    if constexpr (std::is_same_v<AddrT, folly::IPAddressV4>) {
+      return RoutePrefix<AddrT>{
+          folly::IPAddressV4::fromLongHBO((20u << 24) | (index << 8)), 24};
+    } else {
+      auto bytes = folly::IPAddressV6{"2803:6080::"}.toByteArray();
+      bytes[4] = (index >> 8) & 0xff;
+      bytes[5] = index & 0xff;
+      return RoutePrefix<AddrT>{folly::IPAddressV6{bytes}, 48};
+    }
+  }
+
+  void addScaleRoutes(uint32_t numRoutes, std::vector<AddrT> nextHops) {
+    this->updateState(
+        "Add scale routes", [=](const std::shared_ptr<SwitchState>& state) {
+          auto newState = state->clone();
+
+          RouteNextHopSet nexthops;
+          for (const auto& nextHop : nextHops) {
+            nexthops.emplace(UnresolvedNextHop(nextHop, UCMP_DEFAULT_WEIGHT));
+          }
+
+          RouteUpdater updater(state->getRouteTables());
+          for (uint32_t i = 0; i < numRoutes; ++i) {
+            auto routePrefix = kScaleRoutePrefix(i);
+            updater.addRoute(
+                this->kRid(),
+                routePrefix.network,
+                routePrefix.mask,
+                this->kClientID(),
+                RouteNextHopEntry(nexthops, AdminDistance::MAX_ADMIN_DISTANCE));
+          }
+
+          auto newRouteTables = updater.updateDone();
+          newRouteTables->publish();
+          newState->resetRouteTables(newRouteTables);
+
+          return newState;
+        });
+
+    waitForStateUpdates(this->sw_);
+    this->sw_->getNeighborUpdater()->waitForPendingUpdates();
+    waitForBackgroundThread(this->sw_);
+    waitForStateUpdates(this->sw_);
+  }
+
+  void verifyScaleRoutesClassID(
+      uint32_t numRoutes,
+      std::optional<cfg::AclLookupClass> classID) {
+    this->verifyStateUpdateAfterNeighborCachePropagation([=]() {
+      auto routeTableRib = sw_->getState()
+                               ->getRouteTables()
+                               ->getRouteTable(kRid())
+                               ->template getRib<AddrT>();
+      for (uint32_t i = 0; i < numRoutes; ++i) {
+        auto route = routeTableRib->routes()->getRouteIf(kScaleRoutePrefix(i));
+        ASSERT_NE(route, nullptr);
+        EXPECT_EQ(route->getClassID(), classID);
+      }
+    });
+  }
+
   void removeNeighbor(const AddrT& ip) {
     this->updateState(
         "Add new route", [=](const std::shared_ptr<SwitchState>& state) {
@@ -493,6 +557,52 @@ TYPED_TEST(LookupClassRouteUpdaterTest, PortLookupClassesChange) {
       this->kroutePrefix1(), cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_3);
 }
 
+// Scale test cases
+
+/*
+ * Not a strict benchmark, but logs the time taken by classID processing at
+ * scale: every route inheriting classID when its nexthop resolves, and every
+ * route being re-added when queue-per-host is toggled on the port. Both
+ * should be proportional to the number of affected routes, and each result
+ * in a single classID state update.
+ */
+TYPED_TEST(LookupClassRouteUpdaterTest, ScaleRoutesLookupClassesToggle) {
+  constexpr uint32_t kNumRoutes = 4096;
+  auto timeIt = [](folly::StringPiece name, auto&& func) {
+    auto begin = std::chrono::steady_clock::now();
+    func();
+    XLOG(INFO) << name << " for " << kNumRoutes << " routes took "
+               << std::chrono::duration_cast<std::chrono::milliseconds>(
+                      std::chrono::steady_clock::now() - begin)
+                      .count()
+               << "ms";
+  };
+
+  this->addScaleRoutes(kNumRoutes, {this->kIpAddressA(), this->kIpAddressB()});
+
+  timeIt("Resolve nexthop", [this]() {
+    this->resolveNeighbor(this->kIpAddressA(), this->kMacAddressA());
+    this->verifyScaleRoutesClassID(
+        kNumRoutes, cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_0);
+  });
+
+  timeIt("Disable queue-per-host", [this]() {
+    this->updateLookupClasses({});
+    this->verifyScaleRoutesClassID(kNumRoutes, std::nullopt);
+  });
+
+  timeIt("Enable queue-per-host", [this]() {
+    this->updateLookupClasses(
+        {cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_0,
+         cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_1,
+         cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_2,
+         cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_3,
+         cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_4});
+    this->verifyScaleRoutesClassID(
+        kNumRoutes, cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_0);
+  });
+}
+
 template <typename AddrType, bool RouteFix>
 struct WarmbootTestT {
   using AddrT = AddrType;
@@ -11,10 +11,12 @@
 
 #include "fboss/agent/AddressUtil.h"
 #include "fboss/agent/FbossError.h"
+#include "fboss/agent/IPv6Handler.h"
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/SwitchStats.h"
 #include "fboss/agent/ThriftHandler.h"
 #include "fboss/agent/TxPacket.h"
+#include "fboss/agent/TxPacketTemplates.h"
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
 #include "fboss/agent/hw/mock/MockRxPacket.h"
 #include "fboss/agent/packet/EthHdr.h"
@@ -26,6 +28,7 @@
 #include "fboss/agent/state/InterfaceMap.h"
 #include "fboss/agent/state/RouteUpdater.h"
 #include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/VlanMap.h"
 #include "fboss/agent/test/CounterCache.h"
 #include "fboss/agent/test/HwTestHandle.h"
 #include "fboss/agent/test/NeighborEntryTest.h"
@@ -633,6 +636,45 @@ TEST(NdpTest, TriggerSolicitation) {
   counters.checkDelta(SwitchStats::kCounterPrefix + "trapped.pkts.sum", 1);
 }
 
+TEST(NdpTest, SolicitationsFromTemplate) {
+  auto handle = setupTestHandle();
+  auto sw = handle->getSw();
+  auto vlan = sw->getState()->getVlans()->getVlanIf(VlanID(5));
+  ASSERT_NE(vlan, nullptr);
+
+  // Solicitations from the same interface share a template, the destination,
+  // target and checksum get patched for each one
+  std::vector<std::tuple<IPAddressV6, MacAddress, IPAddressV6>> targets = {
+      {IPAddressV6("2401:db00:2110:3004::1"),
+       MacAddress("33:33:ff:00:00:01"),
+       IPAddressV6("ff02::1:ff00:1")},
+      {IPAddressV6("2401:db00:2110:3004::ab:cdef"),
+       MacAddress("33:33:ff:ab:cd:ef"),
+       IPAddressV6("ff02::1:ffab:cdef")},
+      {IPAddressV6("2401:db00:2110:3004::ff:ffff"),
+       MacAddress("33:33:ff:ff:ff:ff"),
+       IPAddressV6("ff02::1:ffff:ffff")},
+  };
+  size_t numTemplates = 0;
+  for (const auto& [targetIP, dstMac, dstIP] : targets) {
+    EXPECT_SWITCHED_PKT(
+        sw,
+        "neighbor solicitation",
+        checkNeighborSolicitation(
+            MacAddress("02:01:02:03:04:05"),
+            IPAddressV6("fe80::0001:02ff:fe03:0405"),
+            dstMac,
+            dstIP,
+            targetIP,
+            VlanID(5)));
+    IPv6Handler::sendMulticastNeighborSolicitation(sw, targetIP, vlan);
+    if (!numTemplates) {
+      numTemplates = sw->getTxPacketTemplates()->numTemplates();
+    }
+  }
+  EXPECT_EQ(sw->getTxPacketTemplates()->numTemplates(), numTemplates);
+}
+
 TEST(NdpTest, RouterAdvertisement) {
   seconds raInterval(1);
   auto config = createSwitchConfig(raInterval, seconds(0));
@@ -0,0 +1,199 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/ApplyThriftConfig.h"
+#include "fboss/agent/ArpHandler.h"
+#include "fboss/agent/IPv6Handler.h"
+#include "fboss/agent/NeighborUpdater.h"
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/hw/sim/SimPlatform.h"
+#include "fboss/agent/hw/test/ConfigFactory.h"
+#include "fboss/agent/packet/ICMPHdr.h"
+#include "fboss/agent/state/ArpTable.h"
+#include "fboss/agent/state/Interface.h"
+#include "fboss/agent/state/InterfaceMap.h"
+#include "fboss/agent/state/NdpTable.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/Vlan.h"
+#include "fboss/agent/state/VlanMap.h"
+
+#include <folly/Benchmark.h>
+#include <folly/MacAddress.h>
+#include <folly/init/Init.h>
+#include <folly/logging/xlog.h>
+
+#include <chrono>
+
+DECLARE_int32(neighbor_cache_threads);
+DECLARE_int64(bm_max_iters);
+
+using namespace facebook::fboss;
+
+/*
+ * Neighbor cache benchmarks simulating the ARP/NDP storm following a reboot:
+ * every host on every VLAN answers at once. Replies are handed straight to
+ * the NeighborUpdater, as ArpHandler and IPv6Handler would after parsing
+ * them on the RX thread, so the results cover the neighbor cache threads
+ * and the programming of the resulting entries into the SwitchState.
+ *
+ * The same storm is run with the neighbor caches sharded across a varying
+ * number of threads.
+ */
+
+namespace {
+
+auto constexpr kNumVlans = 64;
+auto constexpr kHostsPerVlan = 200u;
+
+struct VlanHosts {
+  VlanID vlan;
+  PortID port;
+  std::vector<folly::IPAddressV4> v4Hosts;
+  std::vector<folly::IPAddressV6> v6Hosts;
+};
+
+std::unique_ptr<SwSwitch> setupSwitch() {
+  auto sw = std::make_unique<SwSwitch>(std::make_unique<SimPlatform>(
+      folly::MacAddress("02:00:00:00:00:01"), kNumVlans));
+  sw->init(nullptr /* No custom TunManager */);
+
+  std::vector<PortID> ports;
+  for (int i = 1; i <= kNumVlans; ++i) {
+    ports.push_back(PortID(i));
+  }
+  auto config = utility::onePortPerVlanConfig(sw->getHw(), ports);
+  sw->updateStateBlocking(
+      "apply config", [&](const std::shared_ptr<SwitchState>& state) {
+        return applyThriftConfig(state, &config, sw->getPlatform());
+      });
+  sw->initialConfigApplied(std::chrono::steady_clock::now());
+  return sw;
+}
+
+std::vector<VlanHosts> getVlanHosts(const std::shared_ptr<SwitchState>& state) {
+  std::vector<VlanHosts> vlanHosts;
+  for (const auto& intf : *state->getInterfaces()) {
+    auto vlan = state->getVlans()->getVlan(intf->getVlanID());
+    if (vlan->getPorts().empty()) {
+      continue;
+    }
+    VlanHosts hosts{vlan->getID(), vlan->getPorts().begin()->first, {}, {}};
+    for (const auto& [addr, mask] : intf->getAddresses()) {
+      std::ignore = mask;
+      // Hosts take the addresses following the interface address
+      for (uint32_t host = 1; host <= kHostsPerVlan; ++host) {
+        if (addr.isV4()) {
+          hosts.v4Hosts.push_back(
+              folly::IPAddressV4::fromLongHBO(addr.asV4().toLongHBO() + host));
+        } else {
+          auto bytes = addr.asV6().toByteArray();
+          bytes[14] = host >> 8;
+          bytes[15] = host & 0xff;
+          hosts.v6Hosts.push_back(folly::IPAddressV6(bytes));
+        }
+      }
+    }
+    vlanHosts.push_back(std::move(hosts));
+  }
+  return vlanHosts;
+}
+
+folly::MacAddress hostMac(size_t index) {
+  return folly::MacAddress::fromHBO(0x020000000000 + index);
+}
+
+size_t numNeighborEntries(const std::shared_ptr<SwitchState>& state) {
+  size_t entries = 0;
+  for (const auto& vlan : *state->getVlans()) {
+    entries += vlan->getArpTable()->size() + vlan->getNdpTable()->size();
+  }
+  return entries;
+}
+
+void neighborStormBenchmark(int numThreads) {
+  folly::BenchmarkSuspender suspender;
+  FLAGS_neighbor_cache_threads = numThreads;
+  auto sw = setupSwitch();
+  auto vlanHosts = getVlanHosts(sw->getState());
+  auto updater = sw->getNeighborUpdater();
+  auto entriesBefore = numNeighborEntries(sw->getState());
+
+  suspender.dismiss();
+  auto begin = std::chrono::steady_clock::now();
+  size_t numReplies = 0;
+  // Interleave VLANs, as replies to a storm would
+  for (size_t host = 0; host < kHostsPerVlan; ++host) {
+    for (const auto& hosts : vlanHosts) {
+      PortDescriptor port(hosts.port);
+      if (host < hosts.v4Hosts.size()) {
+        updater->receivedArpMine(
+            hosts.vlan,
+            hosts.v4Hosts[host],
+            hostMac(numReplies++),
+            port,
+            ARP_OP_REPLY);
+      }
+      if (host < hosts.v6Hosts.size()) {
+        updater->receivedNdpMine(
+            hosts.vlan,
+            hosts.v6Hosts[host],
+            hostMac(numReplies++),
+            port,
+            ICMPv6Type::ICMPV6_TYPE_NDP_NEIGHBOR_ADVERTISEMENT,
+            0);
+      }
+    }
+  }
+  auto queued = std::chrono::steady_clock::now();
+  // Entries are programmed once the neighbor threads are done and every
+  // update they scheduled has been applied
+  updater->waitForPendingUpdates();
+  sw->updateStateBlocking(
+      "wait for neighbor updates",
+      [](const std::shared_ptr<SwitchState>& /*state*/) { return nullptr; });
+  auto done = std::chrono::steady_clock::now();
+  suspender.rehire();
+
+  auto entries = numNeighborEntries(sw->getState()) - entriesBefore;
+  CHECK_EQ(entries, numReplies);
+  auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                       done - begin)
+                       .count();
+  XLOG(INFO) << numThreads << " neighbor cache threads: " << numReplies
+             << " replies queued in "
+             << std::chrono::duration_cast<std::chrono::microseconds>(
+                    queued - begin)
+                    .count()
+             << "us, programmed in " << elapsedUs << "us, "
+             << (elapsedUs ? numReplies * 1000000 / elapsedUs : 0)
+             << " entries/s";
+}
+
+} // namespace
+
+BENCHMARK(NeighborStorm1Thread) {
+  neighborStormBenchmark(1);
+}
+
+BENCHMARK(NeighborStorm4Threads) {
+  neighborStormBenchmark(4);
+}
+
+BENCHMARK(NeighborStorm8Threads) {
+  neighborStormBenchmark(8);
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+  // Each iteration sets up a switch and runs a full storm
+  FLAGS_bm_max_iters = 2;
+  folly::runBenchmarks();
+  return 0;
+}
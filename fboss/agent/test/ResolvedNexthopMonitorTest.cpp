@@ -1,9 +1,11 @@
 // Copyright 2004-present Facebook. All Rights Reserved.
 
+#include "fboss/agent/test/CounterCache.h"
 #include "fboss/agent/test/HwTestHandle.h"
 #include "fboss/agent/test/TestUtils.h"
 
 #include "fboss/agent/ResolvedNexthopMonitor.h"
+#include "fboss/agent/ResolvedNexthopProbe.h"
 #include "fboss/agent/ResolvedNexthopProbeScheduler.h"
 #include "fboss/agent/TxPacket.h"
 #include "fboss/agent/packet/ICMPHdr.h"
@@ -15,8 +17,16 @@
 
 #include "folly/io/Cursor.h"
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <memory>
+#include <vector>
+
+DECLARE_int32(resolved_nexthop_probe_rate);
+DECLARE_int32(resolved_nexthop_probe_burst);
+
 namespace {
 using namespace facebook::fboss;
 using folly::IPAddressV4;
@@ -697,4 +707,66 @@ TEST_F(ResolvedNexthopMonitorTest, ProbeTriggeredOnEntryRemoveV6) {
   EXPECT_EQ(entry->isPending(), true);
 }
 
+TEST_F(ResolvedNexthopMonitorTest, ProbesPaced) {
+  gflags::FlagSaver flagSaver;
+  // Room for two probes, with the next token a second away
+  FLAGS_resolved_nexthop_probe_rate = 1;
+  FLAGS_resolved_nexthop_probe_burst = 2;
+
+  // Pace probes on a clock which only moves when the test says so. The
+  // pacer's own timer may still fire, but never finds more probes due than
+  // the test expects.
+  auto evb = sw_->getBackgroundEvb();
+  auto now = std::chrono::steady_clock::now();
+  auto pacer = std::make_unique<ResolvedNextHopProbePacer>(
+      sw_, evb, [&now]() { return now; });
+  std::vector<std::unique_ptr<ResolvedNextHopProbe>> probes;
+  for (auto i = 31; i <= 35; ++i) {
+    probes.push_back(std::make_unique<ResolvedNextHopProbe>(
+        evb,
+        ResolvedNextHop(
+            IPAddressV4(folly::to<std::string>("10.0.0.", i)),
+            InterfaceID(1),
+            1),
+        pacer.get()));
+  }
+  // Move the clock on and fire the pacer's timeout, on its EventBase
+  auto advance = [&](std::chrono::steady_clock::duration elapsed) {
+    evb->runInEventBaseThreadAndWait([&]() {
+      now += elapsed;
+      folly::AsyncTimeout& timeout = *pacer;
+      timeout.timeoutExpired();
+    });
+  };
+
+  CounterCache counters(sw_);
+  EXPECT_SWITCHED_PKT(sw_, "ARP request", [](const TxPacket* pkt) {
+    folly::io::Cursor cursor(pkt->buf());
+    cursor.skip(12); // dst and src mac
+    EXPECT_EQ(cursor.readBE<uint16_t>(), 0x8100); // tagged frame
+    EXPECT_EQ(cursor.readBE<uint16_t>(), 0x0001); // vlan tag
+    EXPECT_EQ(cursor.readBE<uint16_t>(), 0x0806); // arp proto
+  }).Times(3);
+  for (auto& probe : probes) {
+    probe->start();
+  }
+
+  // Two probes go out, the other three are pushed back a token apart
+  advance(std::chrono::seconds(0));
+  counters.update();
+  counters.checkDelta("resolved_nexthop_probe.sent.sum", 2);
+  counters.checkDelta("resolved_nexthop_probe.deferred.sum", 3);
+  counters.checkDelta("resolved_nexthop_probe.skipped.sum", 0);
+
+  // The next token only allows one more probe out
+  advance(std::chrono::seconds(1));
+  counters.update();
+  counters.checkDelta("resolved_nexthop_probe.sent.sum", 1);
+
+  evb->runInEventBaseThreadAndWait([&]() {
+    probes.clear();
+    pacer.reset();
+  });
+}
+
 } // namespace facebook::fboss
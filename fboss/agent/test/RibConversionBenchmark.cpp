@@ -13,6 +13,10 @@
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/hw/sim/SimPlatform.h"
 #include "fboss/agent/hw/test/ConfigFactory.h"
+#include "fboss/agent/state/RouteNextHopEntry.h"
+#include "fboss/agent/state/RouteTable.h"
+#include "fboss/agent/state/RouteTableMap.h"
+#include "fboss/agent/state/RouteTableRib.h"
 #include "fboss/agent/state/SwitchState.h"
 #include "fboss/agent/test/HwTestHandle.h"
 #include "fboss/agent/test/RouteScaleGenerators.h"
@@ -21,13 +25,116 @@
 #include <folly/Benchmark.h>
 #include <folly/MacAddress.h>
 #include <folly/dynamic.h>
+#include <folly/logging/xlog.h>
+
+#include <unordered_set>
 
 using namespace facebook::fboss;
 
+namespace {
+
+auto constexpr kEcmpWidth = 4;
+
+template <typename AddrT>
+void collectForwardInfos(
+    const std::shared_ptr<RouteTableRib<AddrT>>& rib,
+    std::vector<RouteNextHopEntry>* entries) {
+  for (const auto& route : *rib->routes()) {
+    entries->push_back(route->getForwardInfo());
+  }
+}
+
+std::vector<RouteNextHopEntry> collectForwardInfos(
+    const std::shared_ptr<SwitchState>& state) {
+  std::vector<RouteNextHopEntry> entries;
+  for (const auto& routeTable : *state->getRouteTables()) {
+    collectForwardInfos(routeTable->getRibV4(), &entries);
+    collectForwardInfos(routeTable->getRibV6(), &entries);
+  }
+  return entries;
+}
+
+} // namespace
+
 template <typename Generator>
-static void runConversionBenchmark() {
-  auto constexpr kEcmpWidth = 4;
+static std::shared_ptr<SwitchState> generateRouteScaleState() {
+  SimPlatform plat(folly::MacAddress(), 128);
+  std::vector<PortID> ports;
+  for (int i = 0; i < 128; ++i) {
+    ports.push_back(PortID(i));
+  }
+  cfg::SwitchConfig config =
+      utility::onePortPerVlanConfig(plat.getHwSwitch(), ports);
+  auto testHandle = createTestHandle(&config);
+  auto generator =
+      Generator(testHandle->getSw()->getAppliedState(), 1337, kEcmpWidth);
+  const auto& states = generator.getSwitchStates();
+  return states[states.size() - 1];
+}
+
+/*
+ * Next-hop sets are interned, so routes sharing an ECMP group share one copy
+ * of its next-hop set. Report how much memory that saves for the forwarding
+ * entries of a route scale generator's routes.
+ */
+template <typename Generator>
+static void reportInternedNextHopSetMemory(folly::StringPiece name) {
+  auto entries = collectForwardInfos(generateRouteScaleState<Generator>());
 
+  size_t bytesWithoutInterning = 0;
+  size_t bytesWithInterning = 0;
+  std::unordered_set<const RouteNextHopSet*> distinctSets;
+  for (const auto& entry : entries) {
+    const auto& nhops = entry.getNextHopSet();
+    auto bytes = sizeof(RouteNextHopSet) + nhops.size() * sizeof(NextHop);
+    bytesWithoutInterning += bytes;
+    if (distinctSets.insert(&nhops).second) {
+      bytesWithInterning += bytes;
+    }
+  }
+  bytesWithInterning +=
+      entries.size() * sizeof(RouteNextHopEntry::InternedNextHopSet);
+
+  XLOG(INFO) << name << ": " << entries.size() << " routes, "
+             << distinctSets.size() << " distinct next-hop sets, "
+             << bytesWithoutInterning << " bytes of next-hop sets without "
+             << "interning vs " << bytesWithInterning << " bytes interned";
+}
+
+/*
+ * Compare the forwarding entries of every route against an equal but
+ * independently built copy, as done when computing FIB deltas. With interning
+ * the next-hop sets compare by pointer, the baseline compares them by value.
+ */
+template <typename Generator>
+static void runNextHopCompareBenchmark(unsigned iters, bool byValue) {
+  folly::BenchmarkSuspender suspender;
+
+  auto entries = collectForwardInfos(generateRouteScaleState<Generator>());
+  std::vector<RouteNextHopEntry> copies;
+  copies.reserve(entries.size());
+  for (const auto& entry : entries) {
+    copies.push_back(
+        RouteNextHopEntry::fromFollyDynamic(entry.toFollyDynamic()));
+  }
+
+  suspender.dismiss();
+
+  size_t equal = 0;
+  for (unsigned iter = 0; iter < iters; ++iter) {
+    for (size_t i = 0; i < entries.size(); ++i) {
+      if (byValue) {
+        equal += entries[i].getNextHopSet() == copies[i].getNextHopSet();
+      } else {
+        equal += entries[i] == copies[i];
+      }
+    }
+  }
+  folly::doNotOptimizeAway(equal);
+}
+
+template <typename Generator>
+static void runConversionBenchmark() {
   SimPlatform plat(folly::MacAddress(), 128);
   std::vector<PortID> ports;
   for (int i = 0; i < 128; ++i) {
@@ -79,8 +186,29 @@ BENCHMARK(RibConversionHgridUu) {
   runConversionBenchmark<utility::HgridUuRouteScaleGenerator>();
 }
 
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(NextHopCompareByValueFSW, iters) {
+  runNextHopCompareBenchmark<utility::FSWRouteScaleGenerator>(iters, true);
+}
+
+BENCHMARK_RELATIVE(NextHopCompareInternedFSW, iters) {
+  runNextHopCompareBenchmark<utility::FSWRouteScaleGenerator>(iters, false);
+}
+
+BENCHMARK(NextHopCompareByValueTHAlpm, iters) {
+  runNextHopCompareBenchmark<utility::THAlpmRouteScaleGenerator>(iters, true);
+}
+
+BENCHMARK_RELATIVE(NextHopCompareInternedTHAlpm, iters) {
+  runNextHopCompareBenchmark<utility::THAlpmRouteScaleGenerator>(
+      iters, false);
+}
+
 int main(int argc, char** argv) {
   facebook::initFacebook(&argc, &argv);
+  reportInternedNextHopSetMemory<utility::FSWRouteScaleGenerator>("FSW");
+  reportInternedNextHopSetMemory<utility::THAlpmRouteScaleGenerator>("THAlpm");
   folly::runBenchmarks();
   return EXIT_SUCCESS;
 }
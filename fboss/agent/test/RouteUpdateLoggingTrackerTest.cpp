@@ -7,7 +7,9 @@
  *  of patent rights can be found in the PATENTS file in the same directory.
  *
  */
+#include <folly/Conv.h>
 #include <folly/IPAddress.h>
+#include "fboss/agent/FbossError.h"
 #include "fboss/agent/RouteUpdateLoggingPrefixTracker.h"
 #include "fboss/agent/state/RouteTypes.h"
 
@@ -155,4 +157,50 @@ TEST_F(PrefixTrackerTest, DeleteLessSpecificUntracked) {
   checkNotTracking(p2);
 }
 
+// Each identifier is matched against its own most specific covering prefix,
+// even when other identifiers track more specific ones
+TEST_F(PrefixTrackerTest, IdentifiersMatchIndependently) {
+  startTracking("1:1::", 32, "foo", false);
+  startTracking("1:1:1::", 48, "bar", false);
+  startTracking("1:1:1::", 48, "foo", true);
+  startTracking("1:1:1:1::", 64, "baz", true);
+
+  std::vector<std::string> ids;
+  EXPECT_TRUE(tracker.tracking(p1, ids));
+  // foo's /48 only tracks exact matches, and shadows its /32
+  EXPECT_EQ(ids, std::vector<std::string>({"bar", "baz"}));
+  EXPECT_TRUE(tracker.tracking(p2, ids));
+  EXPECT_EQ(ids, std::vector<std::string>({"foo"}));
+
+  stopTracking("1:1:1::", 48, "foo");
+  EXPECT_TRUE(tracker.tracking(p1, ids));
+  EXPECT_EQ(ids, std::vector<std::string>({"bar", "baz", "foo"}));
+
+  tracker.stopTracking("bar");
+  EXPECT_TRUE(tracker.tracking(p1, ids));
+  EXPECT_EQ(ids, std::vector<std::string>({"baz", "foo"}));
+}
+
+// Snapshots don't see tracking changes made after they were taken
+TEST_F(PrefixTrackerTest, SnapshotIsImmutable) {
+  startTracking("1:1::", 32, "foo", false);
+  auto snapshot = tracker.getSnapshot();
+  startTracking("1:1::", 32, "bar", false);
+  EXPECT_EQ(
+      snapshot->getIdentifiers(snapshot->match(p1)),
+      std::vector<std::string>({"foo"}));
+  EXPECT_EQ(tracker.getSnapshot()->match(p1).count(), 2);
+}
+
+TEST_F(PrefixTrackerTest, TooManyIdentifiers) {
+  auto maxIdentifiers = RouteUpdateLoggingPrefixTracker::kMaxIdentifiers;
+  for (size_t i = 0; i < maxIdentifiers; ++i) {
+    startTracking("1:1::", 32, folly::to<std::string>("id", i), false);
+  }
+  EXPECT_THROW(startTracking("::", 0, "oneTooMany", false), FbossError);
+  // Identifiers already tracking can still add prefixes
+  startTracking("::", 0, "id0", false);
+  checkTracking(pZero);
+}
+
 } // namespace
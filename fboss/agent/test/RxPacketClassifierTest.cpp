@@ -0,0 +1,67 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/RxPacketClassifier.h"
+#include "fboss/agent/hw/mock/MockRxPacket.h"
+
+#include <folly/MacAddress.h>
+#include <gtest/gtest.h>
+
+using namespace facebook::fboss;
+using folly::MacAddress;
+
+namespace {
+
+std::unique_ptr<MockRxPacket> makePacket(
+    folly::StringPiece ethHdr,
+    PortID port = PortID(1)) {
+  auto pkt = MockRxPacket::fromHex(ethHdr);
+  pkt->padToLength(68);
+  pkt->setSrcPort(port);
+  return pkt;
+}
+
+} // unnamed namespace
+
+TEST(RxPacketClassifier, taggedPacket) {
+  auto classified = RxPacketClassifier::classify(makePacket(
+      // dst mac, src mac
+      "ff ff ff ff ff ff  02 00 01 02 03 04"
+      // 802.1q, VLAN 1
+      "81 00  00 01"
+      // ARP
+      "08 06"));
+  ASSERT_TRUE(classified.has_value());
+  EXPECT_EQ(classified->dst, MacAddress::BROADCAST);
+  EXPECT_EQ(classified->src, MacAddress("02:00:01:02:03:04"));
+  EXPECT_EQ(classified->ethertype, 0x0806);
+  EXPECT_EQ(classified->l3Offset, 18);
+}
+
+TEST(RxPacketClassifier, untaggedPacket) {
+  auto classified = RxPacketClassifier::classify(makePacket(
+      // dst mac, src mac
+      "02 00 00 00 00 01  02 00 01 02 03 04"
+      // IPv6
+      "86 dd"
+      // Version 6
+      "60"));
+  ASSERT_TRUE(classified.has_value());
+  EXPECT_EQ(classified->dst, MacAddress("02:00:00:00:00:01"));
+  EXPECT_EQ(classified->ethertype, 0x86dd);
+  EXPECT_EQ(classified->l3Offset, 14);
+  EXPECT_EQ(classified->l3Cursor().read<uint8_t>(), 0x60);
+}
+
+TEST(RxPacketClassifier, shortPacket) {
+  auto pkt =
+      MockRxPacket::fromHex("ff ff ff ff ff ff  02 00 01 02 03 04 08 06");
+  EXPECT_FALSE(RxPacketClassifier::classify(std::move(pkt)).has_value());
+}
@@ -0,0 +1,207 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/ApplyThriftConfig.h"
+#include "fboss/agent/ArpHandler.h"
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/TxPacket.h"
+#include "fboss/agent/hw/mock/MockRxPacket.h"
+#include "fboss/agent/hw/sim/SimPlatform.h"
+#include "fboss/agent/hw/test/ConfigFactory.h"
+#include "fboss/agent/packet/ICMPHdr.h"
+#include "fboss/agent/packet/IPv6Hdr.h"
+#include "fboss/agent/packet/NDP.h"
+#include "fboss/agent/state/Interface.h"
+#include "fboss/agent/state/InterfaceMap.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/Vlan.h"
+#include "fboss/agent/state/VlanMap.h"
+
+#include <folly/Benchmark.h>
+#include <folly/MacAddress.h>
+#include <folly/init/Init.h>
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBuf.h>
+
+using namespace facebook::fboss;
+using folly::IPAddressV4;
+using folly::IPAddressV6;
+using folly::MacAddress;
+using folly::io::RWPrivateCursor;
+
+/*
+ * Benchmarks for the handling of trapped packets during an ARP/NDP storm:
+ * hosts on every VLAN resolving the switch's addresses at once. The same
+ * storm, interleaving ARP requests and neighbor solicitations, is handed to
+ * the SwSwitch one packet at a time.
+ */
+
+namespace {
+
+auto constexpr kNumVlans = 16;
+auto constexpr kHostsPerVlan = 64u;
+
+// Global state used by the benchmarks
+std::unique_ptr<SwSwitch> sw;
+std::vector<std::unique_ptr<MockRxPacket>> storm;
+
+std::unique_ptr<SwSwitch> setupSwitch() {
+  auto sw = std::make_unique<SwSwitch>(std::make_unique<SimPlatform>(
+      MacAddress("02:00:00:00:00:01"), kNumVlans));
+  sw->init(nullptr /* No custom TunManager */);
+
+  std::vector<PortID> ports;
+  for (int i = 1; i <= kNumVlans; ++i) {
+    ports.push_back(PortID(i));
+  }
+  auto config = utility::onePortPerVlanConfig(sw->getHw(), ports);
+  sw->updateStateBlocking(
+      "apply config", [&](const std::shared_ptr<SwitchState>& state) {
+        return applyThriftConfig(state, &config, sw->getPlatform());
+      });
+  sw->initialConfigApplied(std::chrono::steady_clock::now());
+  return sw;
+}
+
+std::unique_ptr<MockRxPacket>
+toRxPacket(std::unique_ptr<folly::IOBuf> buf, PortID port, VlanID vlan) {
+  auto pkt = std::make_unique<MockRxPacket>(std::move(buf));
+  pkt->setSrcPort(port);
+  pkt->setSrcVlan(vlan);
+  return pkt;
+}
+
+std::unique_ptr<MockRxPacket> makeArpRequest(
+    PortID port,
+    VlanID vlan,
+    MacAddress senderMac,
+    IPAddressV4 senderIP,
+    IPAddressV4 targetIP) {
+  uint32_t pktLen = 68;
+  auto buf = folly::IOBuf::create(pktLen);
+  buf->append(pktLen);
+  RWPrivateCursor cursor(buf.get());
+  TxPacket::writeEthHeader(
+      &cursor,
+      MacAddress::BROADCAST,
+      senderMac,
+      vlan,
+      ArpHandler::ETHERTYPE_ARP);
+  cursor.writeBE<uint16_t>(1); // htype: ethernet
+  cursor.writeBE<uint16_t>(0x0800); // ptype: IPv4
+  cursor.writeBE<uint8_t>(MacAddress::SIZE);
+  cursor.writeBE<uint8_t>(IPAddressV4::byteCount());
+  cursor.writeBE<uint16_t>(ARP_OP_REQUEST);
+  cursor.push(senderMac.bytes(), MacAddress::SIZE);
+  cursor.write<uint32_t>(senderIP.toLong());
+  cursor.push(MacAddress::ZERO.bytes(), MacAddress::SIZE);
+  cursor.write<uint32_t>(targetIP.toLong());
+  memset(cursor.writableData(), 0, cursor.length());
+  return toRxPacket(std::move(buf), port, vlan);
+}
+
+std::unique_ptr<MockRxPacket> makeNeighborSolicitation(
+    PortID port,
+    VlanID vlan,
+    MacAddress senderMac,
+    IPAddressV6 senderIP,
+    IPAddressV6 targetIP) {
+  NDPOptions ndpOptions;
+  ndpOptions.sourceLinkLayerAddress.emplace(senderMac);
+  uint32_t bodyLength = ICMPHdr::ICMPV6_UNUSED_LEN + IPAddressV6::byteCount() +
+      ndpOptions.computeTotalLength();
+
+  auto solicitedNodeAddr = targetIP.getSolicitedNodeAddress();
+  IPv6Hdr ipv6(senderIP, solicitedNodeAddr);
+  ipv6.payloadLength = ICMPHdr::SIZE + bodyLength;
+  ipv6.nextHeader = static_cast<uint8_t>(IP_PROTO::IP_PROTO_IPV6_ICMP);
+  ipv6.hopLimit = 255;
+  ICMPHdr icmp6(
+      static_cast<uint8_t>(ICMPv6Type::ICMPV6_TYPE_NDP_NEIGHBOR_SOLICITATION),
+      static_cast<uint8_t>(ICMPv6Code::ICMPV6_CODE_NDP_MESSAGE_CODE),
+      0);
+
+  uint32_t pktLen = ICMPHdr::computeTotalLengthV6(bodyLength);
+  auto buf = folly::IOBuf::create(pktLen);
+  buf->append(pktLen);
+  RWPrivateCursor cursor(buf.get());
+  icmp6.serializeFullPacket(
+      &cursor,
+      MacAddress::createMulticast(solicitedNodeAddr),
+      senderMac,
+      vlan,
+      ipv6,
+      bodyLength,
+      [&](RWPrivateCursor* bodyCursor) {
+        bodyCursor->writeBE<uint32_t>(0); // reserved
+        bodyCursor->push(targetIP.bytes(), IPAddressV6::byteCount());
+        ndpOptions.serialize(bodyCursor);
+      });
+  return toRxPacket(std::move(buf), port, vlan);
+}
+
+void init() {
+  sw = setupSwitch();
+
+  auto state = sw->getState();
+  size_t numHosts = 0;
+  // Interleave VLANs and protocols, as a storm would
+  for (uint32_t host = 1; host <= kHostsPerVlan; ++host) {
+    for (const auto& intf : *state->getInterfaces()) {
+      auto vlan = state->getVlans()->getVlan(intf->getVlanID());
+      if (vlan->getPorts().empty()) {
+        continue;
+      }
+      auto port = vlan->getPorts().begin()->first;
+      for (const auto& [addr, mask] : intf->getAddresses()) {
+        std::ignore = mask;
+        auto hostMac = MacAddress::fromHBO(0x020000000000 + ++numHosts);
+        // Hosts take the addresses following the interface address
+        if (addr.isV4()) {
+          storm.push_back(makeArpRequest(
+              port,
+              vlan->getID(),
+              hostMac,
+              IPAddressV4::fromLongHBO(addr.asV4().toLongHBO() + host),
+              addr.asV4()));
+        } else {
+          auto bytes = addr.asV6().toByteArray();
+          bytes[14] = host >> 8;
+          bytes[15] = host & 0xff;
+          storm.push_back(makeNeighborSolicitation(
+              port,
+              vlan->getID(),
+              hostMac,
+              IPAddressV6(bytes),
+              addr.asV6()));
+        }
+      }
+    }
+  }
+}
+
+} // unnamed namespace
+
+BENCHMARK(RxStormPerPacket, numIters) {
+  for (size_t n = 0; n < numIters; ++n) {
+    sw->packetReceived(storm[n % storm.size()]->clone());
+  }
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+
+  // As in the ARP benchmarks, set up the switch and the storm once, outside
+  // of the benchmark functions
+  init();
+
+  folly::runBenchmarks();
+  return 0;
+}
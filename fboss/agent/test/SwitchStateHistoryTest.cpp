@@ -0,0 +1,115 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/SwitchStateHistory.h"
+#include "fboss/agent/state/PortMap.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/test/TestUtils.h"
+
+#include <folly/Conv.h>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+DECLARE_int32(max_live_switch_state_generations);
+
+using namespace facebook::fboss;
+
+namespace {
+
+std::shared_ptr<SwitchState> addPort(
+    const std::shared_ptr<SwitchState>& state,
+    PortID id) {
+  auto newState = state->clone();
+  newState->getPorts()->modify(&newState)->registerPort(
+      id, folly::to<std::string>("port", static_cast<int>(id)));
+  newState->publish();
+  return newState;
+}
+
+} // namespace
+
+TEST(SwitchStateHistoryTest, UniqueBytes) {
+  SwitchStateHistory history;
+  auto oldState = testStateA();
+  oldState->publish();
+  history.published(oldState);
+  auto summary = history.getSummary();
+  ASSERT_EQ(1, summary.generations.size());
+  auto stateBytes = summary.generations[0].uniqueBytes;
+  EXPECT_GT(stateBytes, 0);
+  EXPECT_EQ(stateBytes, summary.totalBytes);
+
+  auto newState = addPort(oldState, PortID(100));
+  history.published(newState);
+  summary = history.getSummary();
+  ASSERT_EQ(2, summary.generations.size());
+  EXPECT_EQ(oldState->getGeneration(), summary.generations[0].generation);
+  EXPECT_EQ(newState->getGeneration(), summary.generations[1].generation);
+  // The states only share the nodes apart from their roots and port maps
+  EXPECT_GT(summary.generations[0].uniqueBytes, 0);
+  EXPECT_LT(summary.generations[0].uniqueBytes, stateBytes);
+  EXPECT_LT(summary.generations[1].uniqueBytes, stateBytes);
+  EXPECT_EQ(
+      summary.totalBytes, stateBytes + summary.generations[1].uniqueBytes);
+
+  // The old state and the nodes only it references go away together
+  oldState.reset();
+  summary = history.getSummary();
+  ASSERT_EQ(1, summary.generations.size());
+  EXPECT_EQ(summary.totalBytes, summary.generations[0].uniqueBytes);
+  EXPECT_EQ(1, history.numLiveGenerations());
+}
+
+TEST(SwitchStateHistoryTest, Holders) {
+  SwitchStateHistory history;
+  auto state = testStateA();
+  state->publish();
+  history.published(state);
+  auto held = history.hold(state, "observer");
+  EXPECT_EQ(state, held);
+  auto summary = history.getSummary();
+  ASSERT_EQ(1, summary.generations.size());
+  EXPECT_EQ(
+      std::vector<std::string>{"observer"}, summary.generations[0].holders);
+
+  // The state outlives the publisher's reference through the hold
+  std::weak_ptr<SwitchState> weakState = state;
+  state.reset();
+  EXPECT_FALSE(weakState.expired());
+  held.reset();
+  EXPECT_TRUE(weakState.expired());
+  EXPECT_EQ(0, history.numLiveGenerations());
+}
+
+TEST(SwitchStateHistoryTest, MaxGenerations) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_max_live_switch_state_generations = 2;
+  SwitchStateHistory history;
+  auto state = testStateA();
+  state->publish();
+  history.published(state);
+
+  std::shared_ptr<SwitchState> lagging;
+  auto numReleases = 0;
+  lagging = history.hold(state, "lagging", [&lagging, &numReleases]() {
+    ++numReleases;
+    lagging.reset();
+  });
+  state = addPort(state, PortID(100));
+  history.published(state);
+  EXPECT_EQ(0, numReleases);
+  EXPECT_NE(nullptr, lagging);
+
+  // A third generation is one too many, the lagging holder drops its state
+  auto current = addPort(state, PortID(101));
+  history.published(current);
+  EXPECT_EQ(1, numReleases);
+  EXPECT_EQ(nullptr, lagging);
+  EXPECT_EQ(2, history.numLiveGenerations());
+}
@@ -0,0 +1,162 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include <folly/container/F14Map.h>
+
+namespace facebook::fboss {
+
+/*
+ * Interned is a refcounted handle to an immutable value stored in a process
+ * wide intern table. Constructing an Interned from a value either returns a
+ * handle to an equal value already in the table, or adds the value to the
+ * table. The value is removed from the table when its last handle goes away.
+ *
+ * Since equal values share a single copy, handles compare equal iff they
+ * point to the same value, which is a pointer comparison. This is meant for
+ * values which are large relative to a pointer, expensive to compare and
+ * highly duplicated, e.g. ECMP next-hop sets shared by many routes.
+ *
+ * A default constructed handle refers to the default constructed value
+ * without touching the table. Interning a value equal to T() also yields
+ * that handle.
+ */
+template <
+    typename T,
+    typename Hash = std::hash<T>,
+    typename Equal = std::equal_to<T>>
+class Interned {
+ public:
+  struct Stats {
+    // Number of distinct values in the table
+    size_t distinctValues{0};
+    // Number of handles referring to values in the table
+    size_t references{0};
+  };
+
+  Interned() {}
+
+  explicit Interned(T value) {
+    if (!Equal()(value, emptyValue())) {
+      value_ = intern(std::move(value));
+    }
+  }
+
+  const T& get() const {
+    return value_ ? *value_ : emptyValue();
+  }
+  const T& operator*() const {
+    return get();
+  }
+  const T* operator->() const {
+    return &get();
+  }
+
+  bool operator==(const Interned& other) const {
+    return value_ == other.value_;
+  }
+  bool operator!=(const Interned& other) const {
+    return !(*this == other);
+  }
+  // Ordering is by value, so that it does not depend on allocation order
+  bool operator<(const Interned& other) const {
+    return value_ != other.value_ && get() < other.get();
+  }
+
+  static Stats getStats() {
+    Stats stats;
+    for (auto& shard : table().shards) {
+      std::lock_guard<std::mutex> guard(shard.lock);
+      stats.distinctValues += shard.values.size();
+      for (const auto& entry : shard.values) {
+        stats.references += entry.second.use_count();
+      }
+    }
+    return stats;
+  }
+
+ private:
+  static auto constexpr kNumShards = 16;
+
+  struct Key {
+    size_t hash;
+    const T* value;
+  };
+  struct KeyHash {
+    size_t operator()(const Key& key) const {
+      return key.hash;
+    }
+  };
+  struct KeyEqual {
+    bool operator()(const Key& lhs, const Key& rhs) const {
+      return lhs.hash == rhs.hash && Equal()(*lhs.value, *rhs.value);
+    }
+  };
+  struct Shard {
+    std::mutex lock;
+    folly::F14FastMap<Key, std::weak_ptr<const T>, KeyHash, KeyEqual> values;
+  };
+  struct Table {
+    std::array<Shard, kNumShards> shards;
+  };
+
+  static const T& emptyValue() {
+    static const T kEmpty{};
+    return kEmpty;
+  }
+
+  static Table& table() {
+    // Leaked on purpose: handles held by static objects may outlive it
+    static auto* table = new Table();
+    return *table;
+  }
+
+  static std::shared_ptr<const T> intern(T&& value) {
+    auto hash = Hash()(value);
+    auto& shard = table().shards[hash % kNumShards];
+
+    std::lock_guard<std::mutex> guard(shard.lock);
+    auto it = shard.values.find(Key{hash, &value});
+    if (it != shard.values.end()) {
+      if (auto existing = it->second.lock()) {
+        return existing;
+      }
+      // The last handle is being released concurrently and is waiting for
+      // the shard lock to erase this entry. Replace it, release() will notice.
+      shard.values.erase(it);
+    }
+    auto interned = std::shared_ptr<const T>(
+        new T(std::move(value)), [hash](const T* v) { release(hash, v); });
+    shard.values.emplace(Key{hash, interned.get()}, interned);
+    return interned;
+  }
+
+  static void release(size_t hash, const T* value) {
+    auto& shard = table().shards[hash % kNumShards];
+    {
+      std::lock_guard<std::mutex> guard(shard.lock);
+      auto it = shard.values.find(Key{hash, value});
+      if (it != shard.values.end() && it->first.value == value) {
+        shard.values.erase(it);
+      }
+    }
+    delete value;
+  }
+
+  std::shared_ptr<const T> value_;
+};
+
+} // namespace facebook::fboss
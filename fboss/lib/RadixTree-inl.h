@@ -34,9 +34,13 @@ RadixTreeNode<IPADDRTYPE, T>::searchDirection(
   return TreeDirection::PARENT;
 }
 
-template <typename IPADDRTYPE, typename T, typename TreeTraits>
-const typename RadixTree<IPADDRTYPE, T, TreeTraits>::TreeNode*
-RadixTree<IPADDRTYPE, T, TreeTraits>::longestMatchImpl(
+template <
+    typename IPADDRTYPE,
+    typename T,
+    typename TreeTraits,
+    template <typename> class NodeAllocator>
+const typename RadixTree<IPADDRTYPE, T, TreeTraits, NodeAllocator>::TreeNode*
+RadixTree<IPADDRTYPE, T, TreeTraits, NodeAllocator>::longestMatchImpl(
     const IPADDRTYPE& ipaddr,
     uint8_t masklen,
     bool& foundExact,
@@ -51,7 +55,7 @@ RadixTree<IPADDRTYPE, T, TreeTraits>::longestMatchImpl(
   // have a parent pointer
   TreeNode* parent = nullptr;
   TreeNode* lastValueNodeSeen = nullptr;
-  auto curNode = root_.get();
+  TreeNode* curNode = root_;
   auto done = false;
   while (curNode && !done) {
     auto searchDirection = curNode->searchDirection(toMatch, masklen);
@@ -96,8 +100,13 @@ RadixTree<IPADDRTYPE, T, TreeTraits>::longestMatchImpl(
   return includeNonValueNodes ? curNode : lastValueNodeSeen;
 }
 
-template <typename IPADDRTYPE, typename T, typename TreeTraits>
-inline void RadixTree<IPADDRTYPE, T, TreeTraits>::trailAppend(
+template <
+    typename IPADDRTYPE,
+    typename T,
+    typename TreeTraits,
+    template <typename> class NodeAllocator>
+inline void
+RadixTree<IPADDRTYPE, T, TreeTraits, NodeAllocator>::trailAppend(
     VecConstIterators* trail,
     bool includeNonValueNodes,
     const TreeNode* node) const {
@@ -108,10 +117,16 @@ inline void RadixTree<IPADDRTYPE, T, TreeTraits>::trailAppend(
   }
 }
 
-template <typename IPADDRTYPE, typename T, typename TreeTraits>
+template <
+    typename IPADDRTYPE,
+    typename T,
+    typename TreeTraits,
+    template <typename> class NodeAllocator>
 template <typename VALUE>
-std::pair<typename RadixTree<IPADDRTYPE, T, TreeTraits>::Iterator, bool>
-RadixTree<IPADDRTYPE, T, TreeTraits>::insert(
+std::pair<
+    typename RadixTree<IPADDRTYPE, T, TreeTraits, NodeAllocator>::Iterator,
+    bool>
+RadixTree<IPADDRTYPE, T, TreeTraits, NodeAllocator>::insert(
     const IPADDRTYPE& ipaddr,
     uint8_t mask,
     VALUE&& value) {
@@ -146,7 +161,7 @@ RadixTree<IPADDRTYPE, T, TreeTraits>::insert(
       // specific root.
       auto prefix = IPADDRTYPE::longestCommonPrefix(
           {root_->ipAddress(), root_->masklen()}, {toAdd, mask});
-      std::unique_ptr<TreeNode> newRoot = nullptr;
+      NodePtr newRoot;
       if (prefix.first == toAdd && prefix.second == mask) {
         // To be added node is the new root
         newRoot = std::move(newNode);
@@ -154,20 +169,20 @@ RadixTree<IPADDRTYPE, T, TreeTraits>::insert(
         // Add new root as a non value internal node
         newRoot = makeNode(prefix.first, prefix.second);
       }
-      auto oldRootDirection = newRoot->searchDirection(root_.get());
+      auto oldRootDirection = newRoot->searchDirection(root_);
       CHECK(
           oldRootDirection == TreeDirection::LEFT ||
           oldRootDirection == TreeDirection::RIGHT);
       if (oldRootDirection == TreeDirection::LEFT) {
-        newRoot->resetLeft(std::move(root_));
+        resetLeft(newRoot.get(), releaseRoot());
         if (newNode) {
           // new node was not moved to be the new root
-          newRoot->resetRight(std::move(newNode));
+          resetRight(newRoot.get(), std::move(newNode));
         }
       } else {
-        newRoot->resetRight(std::move(root_));
+        resetRight(newRoot.get(), releaseRoot());
         if (newNode) {
-          newRoot->resetLeft(std::move(newNode));
+          resetLeft(newRoot.get(), std::move(newNode));
         }
       }
       makeRoot(std::move(newRoot));
@@ -180,12 +195,12 @@ RadixTree<IPADDRTYPE, T, TreeTraits>::insert(
         toAddDirection == TreeDirection::RIGHT);
     if (toAddDirection == TreeDirection::LEFT) {
       if (!bestMatch->left()) {
-        bestMatch->resetLeft(std::move(newNode));
+        resetLeft(bestMatch, std::move(newNode));
         done = true;
       }
     } else {
       if (!bestMatch->right()) {
-        bestMatch->resetRight(std::move(newNode));
+        resetRight(bestMatch, std::move(newNode));
         done = true;
       }
     }
@@ -217,31 +232,31 @@ RadixTree<IPADDRTYPE, T, TreeTraits>::insert(
         // bestMatchChild and new node.
         auto internalNode = makeNode(prefix.first, prefix.second);
         auto internalNodeRaw = internalNode.get();
-        std::unique_ptr<TreeNode> oldBestMatchChild = nullptr;
+        NodePtr oldBestMatchChild;
         if (toAddDirection == TreeDirection::LEFT) {
-          oldBestMatchChild = bestMatch->resetLeft(std::move(internalNode));
+          oldBestMatchChild = resetLeft(bestMatch, std::move(internalNode));
         } else {
-          oldBestMatchChild = bestMatch->resetRight(std::move(internalNode));
+          oldBestMatchChild = resetRight(bestMatch, std::move(internalNode));
         }
         auto newNodeDirection = internalNodeRaw->searchDirection(newNode.get());
         CHECK(
             newNodeDirection == TreeDirection::LEFT ||
             newNodeDirection == TreeDirection::RIGHT);
         if (newNodeDirection == TreeDirection::LEFT) {
-          internalNodeRaw->resetLeft(std::move(newNode));
-          internalNodeRaw->resetRight(std::move(oldBestMatchChild));
+          resetLeft(internalNodeRaw, std::move(newNode));
+          resetRight(internalNodeRaw, std::move(oldBestMatchChild));
         } else {
-          internalNodeRaw->resetRight(std::move(newNode));
-          internalNodeRaw->resetLeft(std::move(oldBestMatchChild));
+          resetRight(internalNodeRaw, std::move(newNode));
+          resetLeft(internalNodeRaw, std::move(oldBestMatchChild));
         }
         CHECK(internalNode == nullptr);
       } else {
         // New node needs to be inserted  b/w bestMatch and bestMatchChild
-        std::unique_ptr<TreeNode> oldBestMatchChild = nullptr;
+        NodePtr oldBestMatchChild;
         if (toAddDirection == TreeDirection::LEFT) {
-          oldBestMatchChild = bestMatch->resetLeft(std::move(newNode));
+          oldBestMatchChild = resetLeft(bestMatch, std::move(newNode));
         } else {
-          oldBestMatchChild = bestMatch->resetRight(std::move(newNode));
+          oldBestMatchChild = resetRight(bestMatch, std::move(newNode));
         }
         auto bestMatchChildDirection =
             newNodeRaw->searchDirection(oldBestMatchChild.get());
@@ -249,9 +264,9 @@ RadixTree<IPADDRTYPE, T, TreeTraits>::insert(
             bestMatchChildDirection == TreeDirection::LEFT ||
             bestMatchChildDirection == TreeDirection::RIGHT);
         if (bestMatchChildDirection == TreeDirection::LEFT) {
-          newNodeRaw->resetLeft(std::move(oldBestMatchChild));
+          resetLeft(newNodeRaw, std::move(oldBestMatchChild));
         } else {
-          newNodeRaw->resetRight(std::move(oldBestMatchChild));
+          resetRight(newNodeRaw, std::move(oldBestMatchChild));
         }
       }
     }
@@ -272,8 +287,13 @@ RadixTree<IPADDRTYPE, T, TreeTraits>::insert(
  * as well. Why this is true is explained below for each of the
  * different cases of erase.
  */
-template <typename IPADDRTYPE, typename T, typename TreeTraits>
-bool RadixTree<IPADDRTYPE, T, TreeTraits>::erase(TreeNode* toDelete) {
+template <
+    typename IPADDRTYPE,
+    typename T,
+    typename TreeTraits,
+    template <typename> class NodeAllocator>
+bool RadixTree<IPADDRTYPE, T, TreeTraits, NodeAllocator>::erase(
+    TreeNode* toDelete) {
   if (!toDelete) {
     return false;
   }
@@ -299,19 +319,21 @@ bool RadixTree<IPADDRTYPE, T, TreeTraits>::erase(TreeNode* toDelete) {
     if (parent) {
       // Note - toDelete gets freed here.
       if (parent->left() == toDelete) {
-        parent->resetLeft(
-            left ? toDelete->resetLeft(nullptr)
-                 : toDelete->resetRight(nullptr));
+        resetLeft(
+            parent,
+            left ? resetLeft(toDelete, nullptr)
+                 : resetRight(toDelete, nullptr));
       } else {
-        parent->resetRight(
-            left ? toDelete->resetLeft(nullptr)
-                 : toDelete->resetRight(nullptr));
+        resetRight(
+            parent,
+            left ? resetLeft(toDelete, nullptr)
+                 : resetRight(toDelete, nullptr));
       }
     } else {
-      CHECK(root_.get() == toDelete);
+      CHECK(root_ == toDelete);
       // Update root, toDelete (old root) gets deleted as a result
       makeRoot(
-          left ? toDelete->resetLeft(nullptr) : toDelete->resetRight(nullptr));
+          left ? resetLeft(toDelete, nullptr) : resetRight(toDelete, nullptr));
     }
     // We just made toDelete's parent the parent of toDelete's only
     // child. There are 2 possibilities with regard to toDelete's parent
@@ -327,8 +349,8 @@ bool RadixTree<IPADDRTYPE, T, TreeTraits>::erase(TreeNode* toDelete) {
     // toDelete has no children.
     if (parent) {
       // Free toDelete
-      parent->left() == toDelete ? parent->resetLeft(nullptr)
-                                 : parent->resetRight(nullptr);
+      parent->left() == toDelete ? resetLeft(parent, nullptr)
+                                 : resetRight(parent, nullptr);
       if (parent->isNonValueNode()) {
         // toDelete's parent is a non value node. Since we removed
         // toDelete, toDelete's parent needs to be deleted as well
@@ -337,14 +359,14 @@ bool RadixTree<IPADDRTYPE, T, TreeTraits>::erase(TreeNode* toDelete) {
         TreeNode* grandParent = parent->parent();
         // toDeleteSibling must be non null since toDelete's parent
         // was a non value node, which always has 2 children.
-        auto toDeleteSibling = parent->left() ? parent->resetLeft(nullptr)
-                                              : parent->resetRight(nullptr);
+        auto toDeleteSibling = parent->left() ? resetLeft(parent, nullptr)
+                                              : resetRight(parent, nullptr);
         CHECK(toDeleteSibling);
         if (grandParent) {
           // Free toDelete's parent
           grandParent->left() == parent
-              ? grandParent->resetLeft(std::move(toDeleteSibling))
-              : grandParent->resetRight(std::move(toDeleteSibling));
+              ? resetLeft(grandParent, std::move(toDeleteSibling))
+              : resetRight(grandParent, std::move(toDeleteSibling));
           // Here we replaced one of grandparent's children with
           // another and removed parent, toDelete nodes. There are
           // 2 possibilities with regards to grand parent
@@ -363,7 +385,7 @@ bool RadixTree<IPADDRTYPE, T, TreeTraits>::erase(TreeNode* toDelete) {
           // 2 children), each subtree of such a tree is also valid.
           // Since the tree under toDeleteSibling is one such tree,
           // our post condition is held.
-          CHECK(root_.get() == parent);
+          CHECK(root_ == parent);
           CHECK(parent->isLeaf()); // Both children should be set to null
           makeRoot(std::move(toDeleteSibling));
         }
@@ -377,17 +399,21 @@ bool RadixTree<IPADDRTYPE, T, TreeTraits>::erase(TreeNode* toDelete) {
     } else {
       // To be deleted node has no parent and no children.
       // Its thus the root (and only node) in the tree.
-      CHECK_EQ(root_.get(), toDelete);
+      CHECK_EQ(root_, toDelete);
       // Empty tree, post condition trivially held.
-      root_.reset(nullptr);
+      makeRoot(nullptr);
     }
   }
   --size_;
   return true;
 }
 
-template <typename IPADDRTYPE, typename T, typename TreeTraits>
-bool RadixTree<IPADDRTYPE, T, TreeTraits>::radixSubTreesEqual(
+template <
+    typename IPADDRTYPE,
+    typename T,
+    typename TreeTraits,
+    template <typename> class NodeAllocator>
+bool RadixTree<IPADDRTYPE, T, TreeTraits, NodeAllocator>::radixSubTreesEqual(
     const TreeNode* nodeA,
     const TreeNode* nodeB) {
   if (nodeA && nodeB) {
@@ -401,25 +427,25 @@ bool RadixTree<IPADDRTYPE, T, TreeTraits>::radixSubTreesEqual(
   return !nodeA && !nodeB;
 }
 
-template <typename IPADDRTYPE, typename T, typename TreeTraits>
-std::unique_ptr<typename RadixTree<IPADDRTYPE, T, TreeTraits>::TreeNode>
-RadixTree<IPADDRTYPE, T, TreeTraits>::cloneSubTree(const TreeNode* node) {
+template <
+    typename IPADDRTYPE,
+    typename T,
+    typename TreeTraits,
+    template <typename> class NodeAllocator>
+typename RadixTree<IPADDRTYPE, T, TreeTraits, NodeAllocator>::NodePtr
+RadixTree<IPADDRTYPE, T, TreeTraits, NodeAllocator>::cloneSubTree(
+    const TreeNode* node) {
   if (!node) {
     return nullptr;
   }
-  std::unique_ptr<TreeNode> copy;
+  NodePtr copy;
   if (node->isValueNode()) {
-    copy = std::make_unique<TreeNode>(
-        node->ipAddress(),
-        node->masklen(),
-        node->value(),
-        node->nodeDeleteCallback());
+    copy = makeNode(node->ipAddress(), node->masklen(), node->value());
   } else {
-    copy = std::make_unique<TreeNode>(
-        node->ipAddress(), node->masklen(), node->nodeDeleteCallback());
+    copy = makeNode(node->ipAddress(), node->masklen());
   }
-  copy->resetLeft(cloneSubTree(node->left()));
-  copy->resetRight(cloneSubTree(node->right()));
+  resetLeft(copy.get(), cloneSubTree(node->left()));
+  resetRight(copy.get(), cloneSubTree(node->right()));
   return copy;
 }
 
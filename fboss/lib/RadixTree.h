@@ -8,7 +8,9 @@
 #include <exception>
 #include <functional>
 #include <memory>
+#include <new>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -28,36 +30,25 @@ namespace facebook::network {
  * ones created by the radix tree implementation, which will
  * hold no values. All non value nodes will have 2 children,
  * this invariant must be maintained at all times.
+ * Nodes are allocated and freed by the RadixTree they belong to, a
+ * node does not own its children.
  */
 template <typename IPADDRTYPE, typename T>
 class RadixTreeNode {
  public:
-  // Optional function parameter to call from destructor
+  // Optional function for the tree to call before freeing a node
   typedef std::function<void(const RadixTreeNode<IPADDRTYPE, T>&)>
       NodeDeleteCallback;
 
-  RadixTreeNode(
-      const IPADDRTYPE& ipAddr,
-      uint8_t mlen,
-      NodeDeleteCallback deleteCallback)
-      : ipAddress_(ipAddr), masklen_(mlen), deleteCallback_(deleteCallback) {}
+  RadixTreeNode(const IPADDRTYPE& ipAddr, uint8_t mlen)
+      : ipAddress_(ipAddr), masklen_(mlen) {}
 
   template <typename VALUE>
-  RadixTreeNode(
-      const IPADDRTYPE& ipAddr,
-      uint8_t mlen,
-      VALUE&& val,
-      NodeDeleteCallback deleteCallback)
-      : ipAddress_(ipAddr),
-        masklen_(mlen),
-        value_(std::forward<VALUE>(val)),
-        deleteCallback_(deleteCallback) {}
-
-  ~RadixTreeNode() {
-    if (deleteCallback_) {
-      deleteCallback_(*this);
-    }
-  }
+  RadixTreeNode(const IPADDRTYPE& ipAddr, uint8_t mlen, VALUE&& val)
+      : ipAddress_(ipAddr), masklen_(mlen), value_(std::forward<VALUE>(val)) {}
+
+  RadixTreeNode(const RadixTreeNode&) = delete;
+  RadixTreeNode& operator=(const RadixTreeNode&) = delete;
 
   enum class TreeDirection { LEFT, RIGHT, PARENT, THIS_NODE };
 
@@ -74,16 +65,16 @@ class RadixTreeNode {
     return masklen_;
   }
   const RadixTreeNode* left() const {
-    return left_.get();
+    return left_;
   }
   RadixTreeNode* left() {
-    return left_.get();
+    return left_;
   }
   const RadixTreeNode* right() const {
-    return right_.get();
+    return right_;
   }
   RadixTreeNode* right() {
-    return right_.get();
+    return right_;
   }
   RadixTreeNode* parent() {
     return parent_;
@@ -100,9 +91,6 @@ class RadixTreeNode {
   T& value() {
     return value_.value();
   }
-  NodeDeleteCallback nodeDeleteCallback() const {
-    return deleteCallback_;
-  }
   std::string str(bool printValue = true) const {
     auto nodeStr = folly::to<std::string>(ipAddress_.str(), "/", masklen_);
     if (printValue) {
@@ -129,20 +117,20 @@ class RadixTreeNode {
         (!isValueNode() || this->value() == r.value());
   }
 
-  std::unique_ptr<RadixTreeNode> resetLeft(
-      std::unique_ptr<RadixTreeNode> newLeft) {
-    auto old = std::move(left_);
-    left_ = std::move(newLeft);
+  // Replace left child, returns the detached old child
+  RadixTreeNode* resetLeft(RadixTreeNode* newLeft) {
+    auto old = left_;
+    left_ = newLeft;
     if (left_) {
       left_->setParent(this);
     }
     return old;
   }
 
-  std::unique_ptr<RadixTreeNode> resetRight(
-      std::unique_ptr<RadixTreeNode> newRight) {
-    auto old = std::move(right_);
-    right_ = std::move(newRight);
+  // Replace right child, returns the detached old child
+  RadixTreeNode* resetRight(RadixTreeNode* newRight) {
+    auto old = right_;
+    right_ = newRight;
     if (right_) {
       right_->setParent(this);
     }
@@ -166,10 +154,9 @@ class RadixTreeNode {
   IPADDRTYPE ipAddress_;
   uint32_t masklen_{0}; // Number of bits to match.
   std::optional<T> value_;
-  std::unique_ptr<RadixTreeNode> left_{nullptr};
-  std::unique_ptr<RadixTreeNode> right_{nullptr};
+  RadixTreeNode* left_{nullptr};
+  RadixTreeNode* right_{nullptr};
   RadixTreeNode* parent_{nullptr};
-  NodeDeleteCallback deleteCallback_;
 };
 
 /*
@@ -369,10 +356,109 @@ struct RadixTreeTraits {
   }
 };
 
+/*
+ * Node allocation policies for RadixTree. A policy is a class template
+ * over the node type which provides
+ *   Node* create(args...) - allocate and construct a node
+ *   void destroy(Node*)   - destroy and free a node
+ *   void clear()          - release cached memory, only called once all
+ *                           nodes allocated have been destroyed
+ * Moving a policy object moves ownership of the nodes it allocated.
+ */
+
+// Allocate every node individually on the heap
+template <typename Node>
+class RadixTreeHeapAllocator {
+ public:
+  template <typename... Args>
+  Node* create(Args&&... args) {
+    return new Node(std::forward<Args>(args)...);
+  }
+  void destroy(Node* node) {
+    delete node;
+  }
+  void clear() {}
+};
+
+/*
+ * Bump allocate nodes out of slabs of kNodesPerSlab nodes. Freed nodes
+ * go on a freelist and get reused before any new slab is allocated.
+ * Slabs are only given back on clear, i.e. when the tree is cleared or
+ * destroyed. This saves the per node malloc overhead and keeps nodes
+ * inserted together close in memory, which makes tree walks cheaper for
+ * large trees.
+ */
+template <typename Node>
+class RadixTreeArenaAllocator {
+ public:
+  static constexpr size_t kNodesPerSlab = 1024;
+
+  RadixTreeArenaAllocator() {}
+  RadixTreeArenaAllocator(RadixTreeArenaAllocator&& r) noexcept {
+    *this = std::move(r);
+  }
+  RadixTreeArenaAllocator& operator=(RadixTreeArenaAllocator&& r) noexcept {
+    slabs_.swap(r.slabs_);
+    std::swap(slabNodesUsed_, r.slabNodesUsed_);
+    std::swap(freeList_, r.freeList_);
+    r.clear();
+    return *this;
+  }
+
+  template <typename... Args>
+  Node* create(Args&&... args) {
+    auto slot = allocateSlot();
+    try {
+      return new (static_cast<void*>(slot)) Node(std::forward<Args>(args)...);
+    } catch (...) {
+      freeSlot(slot);
+      throw;
+    }
+  }
+  void destroy(Node* node) {
+    node->~Node();
+    freeSlot(reinterpret_cast<Slot*>(node));
+  }
+  void clear() {
+    slabs_.clear();
+    slabNodesUsed_ = kNodesPerSlab;
+    freeList_ = nullptr;
+  }
+
+ private:
+  union Slot {
+    Slot* next;
+    typename std::aligned_storage<sizeof(Node), alignof(Node)>::type storage;
+  };
+
+  Slot* allocateSlot() {
+    if (freeList_) {
+      auto slot = freeList_;
+      freeList_ = slot->next;
+      return slot;
+    }
+    if (slabNodesUsed_ == kNodesPerSlab) {
+      // Not make_unique, no need to zero out the slab
+      slabs_.emplace_back(new Slot[kNodesPerSlab]);
+      slabNodesUsed_ = 0;
+    }
+    return &slabs_.back()[slabNodesUsed_++];
+  }
+  void freeSlot(Slot* slot) {
+    slot->next = freeList_;
+    freeList_ = slot;
+  }
+
+  std::vector<std::unique_ptr<Slot[]>> slabs_;
+  size_t slabNodesUsed_{kNodesPerSlab};
+  Slot* freeList_{nullptr};
+};
+
 template <
     typename IPADDRTYPE,
     typename T,
-    typename TreeTraits = RadixTreeTraits<IPADDRTYPE, T>>
+    typename TreeTraits = RadixTreeTraits<IPADDRTYPE, T>,
+    template <typename> class NodeAllocator = RadixTreeHeapAllocator>
 class RadixTree {
  public:
   typedef RadixTreeNode<IPADDRTYPE, T> TreeNode;
@@ -382,22 +468,30 @@ class RadixTree {
   typedef typename TreeTraits::ConstIterator ConstIterator;
   typedef typename std::vector<ConstIterator> VecConstIterators;
 
+  /*
+   * nodeDelCallback, if set, is called for every node (value and non
+   * value) just before it is freed.
+   */
   explicit RadixTree(
       NodeDeleteCallback nodeDelCallback = NodeDeleteCallback(),
       const TreeTraits& treeTraits = TreeTraits())
       : nodeDeleteCallback_(nodeDelCallback), traits_(treeTraits) {}
 
+  ~RadixTree() {
+    clear();
+  }
+
   RadixTree(const RadixTree& r) = delete;
   RadixTree& operator=(const RadixTree& r) = delete;
 
   Iterator begin() {
-    return traits_.makeItr(root_.get());
+    return traits_.makeItr(root_);
   }
   Iterator end() {
     return traits_.makeItr(nullptr);
   }
   ConstIterator begin() const {
-    return traits_.makeCItr(root_.get());
+    return traits_.makeCItr(root_);
   }
   ConstIterator end() const {
     return traits_.makeCItr(nullptr);
@@ -405,8 +499,10 @@ class RadixTree {
 
   // Free all nodes and clear the tree.
   void clear() {
-    root_.reset(nullptr);
+    destroySubTree(root_);
+    root_ = nullptr;
     size_ = 0;
+    allocator_.clear();
   }
   RadixTree(RadixTree&& r) noexcept
       : nodeDeleteCallback_(r.nodeDeleteCallback_), traits_(r.traits_) {
@@ -415,10 +511,12 @@ class RadixTree {
   // Move radix tree onto this
   RadixTree& operator=(RadixTree&& r) noexcept {
     // Don't copy the traits and delete callback, use
-    // ones with which this Radix tree was created
-    size_ = r.size_;
-    makeRoot(std::move(r.root_));
-    r.size_ = 0;
+    // ones with which this Radix tree was created. Nodes
+    // moved over are freed with this tree's delete callback.
+    clear();
+    allocator_ = std::move(r.allocator_);
+    root_ = std::exchange(r.root_, nullptr);
+    size_ = std::exchange(r.size_, 0);
     return *this;
   }
   // Clone this radix tree onto another
@@ -430,7 +528,7 @@ class RadixTree {
         "clone template type must be the same as Radix tree value type");
     RadixTree copy(nodeDeleteCallback_, traits_);
     copy.size_ = size_;
-    copy.root_ = cloneSubTree(root_.get());
+    copy.root_ = copy.cloneSubTree(root_).release();
     return copy;
   }
   /*
@@ -577,10 +675,10 @@ class RadixTree {
     return size_;
   }
   const TreeNode* root() const {
-    return root_.get();
+    return root_;
   }
   TreeNode* root() {
-    return root_.get();
+    return root_;
   }
   NodeDeleteCallback nodeDeleteCallback() const {
     return nodeDeleteCallback_;
@@ -590,7 +688,36 @@ class RadixTree {
   }
 
  private:
-  static std::unique_ptr<TreeNode> cloneSubTree(const TreeNode* node);
+  /*
+   * Nodes are owned by their parent, and the root by the tree. NodePtr
+   * holds on to nodes (and subtrees) which are detached from the tree
+   * while it is being modified, and frees them if not reattached.
+   */
+  struct NodeDeleter {
+    RadixTree* tree{nullptr};
+    void operator()(TreeNode* node) const {
+      tree->destroySubTree(node);
+    }
+  };
+  using NodePtr = std::unique_ptr<TreeNode, NodeDeleter>;
+
+  NodePtr own(TreeNode* node) {
+    return NodePtr(node, NodeDeleter{this});
+  }
+
+  void destroySubTree(TreeNode* node) {
+    if (!node) {
+      return;
+    }
+    if (nodeDeleteCallback_) {
+      nodeDeleteCallback_(*node);
+    }
+    destroySubTree(node->left());
+    destroySubTree(node->right());
+    allocator_.destroy(node);
+  }
+
+  NodePtr cloneSubTree(const TreeNode* node);
   // Worker function to do the actual longest match lookup.
   const TreeNode* longestMatchImpl(
       const IPADDRTYPE& ipaddr,
@@ -611,23 +738,35 @@ class RadixTree {
             ipaddr, masklen, foundExact, includeNonValueNodes, trail));
   }
 
-  std::unique_ptr<TreeNode> makeNode(const IPADDRTYPE& ip, uint8_t masklen) {
-    return std::make_unique<TreeNode>(ip, masklen, nodeDeleteCallback_);
+  NodePtr makeNode(const IPADDRTYPE& ip, uint8_t masklen) {
+    return own(allocator_.create(ip, masklen));
   }
 
   template <typename VALUE>
-  std::unique_ptr<TreeNode>
-  makeNode(const IPADDRTYPE& ip, uint8_t masklen, VALUE&& value) {
-    return std::make_unique<TreeNode>(
-        ip, masklen, std::forward<VALUE>(value), nodeDeleteCallback_);
+  NodePtr makeNode(const IPADDRTYPE& ip, uint8_t masklen, VALUE&& value) {
+    return own(allocator_.create(ip, masklen, std::forward<VALUE>(value)));
   }
 
-  void makeRoot(std::unique_ptr<TreeNode> newRoot) {
-    CHECK(root_ != newRoot || root_ == nullptr);
+  // Replace root, the old root (and what is left under it) is freed
+  void makeRoot(NodePtr newRoot) {
+    CHECK(root_ != newRoot.get() || root_ == nullptr);
     if (newRoot) {
       newRoot->setParent(nullptr);
     }
-    root_ = std::move(newRoot);
+    own(std::exchange(root_, newRoot.release()));
+  }
+
+  // Detach root from the tree
+  NodePtr releaseRoot() {
+    return own(std::exchange(root_, nullptr));
+  }
+
+  // Replace node's left/right child, returns the detached old child
+  NodePtr resetLeft(TreeNode* node, NodePtr newLeft) {
+    return own(node->resetLeft(newLeft.release()));
+  }
+  NodePtr resetRight(TreeNode* node, NodePtr newRight) {
+    return own(node->resetRight(newRight.release()));
   }
 
   inline void trailAppend(
@@ -635,10 +774,11 @@ class RadixTree {
       bool includeNonValueNodes,
       const TreeNode* node) const;
 
-  std::unique_ptr<TreeNode> root_{nullptr};
+  TreeNode* root_{nullptr};
   size_t size_{0};
   NodeDeleteCallback nodeDeleteCallback_;
   TreeTraits traits_;
+  NodeAllocator<TreeNode> allocator_;
 };
 
 // RadixTreeIteratorImpl for IPAddress
@@ -808,11 +948,16 @@ class IPAddressRadixTreeIteratorImpl
   Iterator4 iterator4_{nullptr};
   Iterator6 iterator6_{nullptr};
 
+  template <typename U, template <typename> class NodeAllocator>
+  friend struct V4TreeInCompositeTreeTraits;
   template <typename U>
-  friend class V4TreeInCompositeTreeTraits;
-  template <typename U>
-  friend class V6TreeInCompositeTreeTraits;
-  template <typename IPADDRTYPE, typename U, typename TreeTraits>
+  friend struct V6TreeInCompositeTreeTraits;
+  template <
+      typename IPADDRTYPE,
+      typename U,
+      typename TreeTraits,
+      template <typename>
+      class NodeAllocator>
   friend class RadixTree;
 };
 
@@ -915,14 +1060,20 @@ struct V6TreeInCompositeTreeTraits {
  * Traits for V4 tree embedded inside a (composite V4 and V6)
  * IPAddress tree
  */
-template <typename T>
+template <
+    typename T,
+    template <typename> class NodeAllocator = RadixTreeHeapAllocator>
 struct V4TreeInCompositeTreeTraits {
   typedef RadixTreeIterator<folly::IPAddress, T> Iterator;
   typedef RadixTreeConstIterator<folly::IPAddress, T> ConstIterator;
   typedef RadixTreeNode<folly::IPAddressV6, T> TreeNode6;
   typedef RadixTreeNode<folly::IPAddressV4, T> TreeNode4;
 
-  typedef RadixTree<folly::IPAddressV6, T, V6TreeInCompositeTreeTraits<T>>
+  typedef RadixTree<
+      folly::IPAddressV6,
+      T,
+      V6TreeInCompositeTreeTraits<T>,
+      NodeAllocator>
       Tree6;
   explicit V4TreeInCompositeTreeTraits(Tree6& v6Tree) : v6Tree_(v6Tree) {}
 
@@ -978,8 +1129,12 @@ struct V4TreeInCompositeTreeTraits {
 };
 
 // Template specialization for RadixTree of folly::IPAddress
-template <typename T>
-class RadixTree<folly::IPAddress, T> {
+template <typename T, template <typename> class NodeAllocator>
+class RadixTree<
+    folly::IPAddress,
+    T,
+    RadixTreeTraits<folly::IPAddress, T>,
+    NodeAllocator> {
  public:
   typedef RadixTreeNode<folly::IPAddressV4, T> TreeNode4;
   typedef RadixTreeNode<folly::IPAddressV6, T> TreeNode6;
@@ -995,7 +1150,7 @@ class RadixTree<folly::IPAddress, T> {
       : ipv6Tree_(nodeDeleteCallback6, V6TreeInCompositeTreeTraits<T>()),
         ipv4Tree_(
             nodeDeleteCallback4,
-            V4TreeInCompositeTreeTraits<T>(ipv6Tree_)) {}
+            V4TreeInCompositeTreeTraits<T, NodeAllocator>(ipv6Tree_)) {}
 
   RadixTree(RadixTree&& r) noexcept
       : RadixTree(
@@ -1203,8 +1358,18 @@ class RadixTree<folly::IPAddress, T> {
   }
 
  private:
-  RadixTree<folly::IPAddressV6, T, V6TreeInCompositeTreeTraits<T>> ipv6Tree_;
-  RadixTree<folly::IPAddressV4, T, V4TreeInCompositeTreeTraits<T>> ipv4Tree_;
+  RadixTree<
+      folly::IPAddressV6,
+      T,
+      V6TreeInCompositeTreeTraits<T>,
+      NodeAllocator>
+      ipv6Tree_;
+  RadixTree<
+      folly::IPAddressV4,
+      T,
+      V4TreeInCompositeTreeTraits<T, NodeAllocator>,
+      NodeAllocator>
+      ipv4Tree_;
 };
 
 // Free standing helper functions
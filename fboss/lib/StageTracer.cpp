@@ -0,0 +1,129 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/lib/StageTracer.h"
+
+#include <fb303/ServiceData.h>
+#include <folly/Conv.h>
+
+#include <algorithm>
+
+namespace {
+// Histogram buckets of 10ms up to 2s, anything slower lands in the last one
+constexpr int64_t kHistogramBucketUs = 10000;
+constexpr int64_t kHistogramMaxUs = 2000000;
+const std::string kStartStage = "start";
+const std::string kDoneStage = "done";
+const std::string kTotalStage = "total";
+} // namespace
+
+namespace facebook::fboss {
+
+StageTrace::StageTrace(uint64_t id, std::string name)
+    : id_(id),
+      name_(std::move(name)),
+      startTime_(std::chrono::system_clock::now()) {
+  mark(kStartStage);
+}
+
+void StageTrace::mark(folly::StringPiece stage) {
+  auto now = std::chrono::steady_clock::now();
+  stages_.wlock()->push_back({stage.str(), now});
+}
+
+std::vector<StageTrace::Stage> StageTrace::getStages() const {
+  return stages_.copy();
+}
+
+StageTracer::StageTracer(std::string counterPrefix, size_t maxTraces)
+    : counterPrefix_(std::move(counterPrefix)), maxTraces_(maxTraces) {}
+
+std::shared_ptr<StageTrace> StageTracer::startTrace(std::string name) {
+  if (maxTraces_ == 0) {
+    return nullptr;
+  }
+  return std::make_shared<StageTrace>(nextID_++, std::move(name));
+}
+
+void StageTracer::finishTrace(const std::shared_ptr<StageTrace>& trace) {
+  if (!trace) {
+    return;
+  }
+  trace->mark(kDoneStage);
+
+  auto stages = trace->getStages();
+  for (size_t i = 1; i < stages.size(); ++i) {
+    exportStage(
+        stages[i].name,
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            stages[i].time - stages[i - 1].time));
+  }
+  exportStage(
+      kTotalStage,
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          stages.back().time - stages.front().time));
+
+  auto recentTraces = recentTraces_.wlock();
+  recentTraces->push_front(trace);
+  if (recentTraces->size() > maxTraces_) {
+    recentTraces->pop_back();
+  }
+}
+
+std::vector<std::shared_ptr<const StageTrace>> StageTracer::getRecentTraces(
+    size_t count) const {
+  auto recentTraces = recentTraces_.rlock();
+  count = std::min(count, recentTraces->size());
+  return std::vector<std::shared_ptr<const StageTrace>>(
+      recentTraces->begin(), recentTraces->begin() + count);
+}
+
+void StageTracer::exportStage(
+    const std::string& stage,
+    std::chrono::microseconds time) {
+  auto key = folly::to<std::string>(counterPrefix_, ".", stage, ".us");
+  if (!exportedStages_.rlock()->count(stage)) {
+    auto exportedStages = exportedStages_.wlock();
+    if (exportedStages->insert(stage).second) {
+      fb303::fbData->addHistogram(key, kHistogramBucketUs, 0, kHistogramMaxUs);
+      fb303::fbData->exportHistogramPercentile(key, 50, 95, 99);
+    }
+  }
+  fb303::fbData->addHistogramValue(key, time.count());
+}
+
+std::shared_ptr<StageTrace>& StageTracer::currentTrace() {
+  static thread_local std::shared_ptr<StageTrace> trace;
+  return trace;
+}
+
+const std::shared_ptr<StageTrace>& StageTracer::current() {
+  return currentTrace();
+}
+
+void StageTracer::markCurrent(folly::StringPiece stage) {
+  if (auto& trace = currentTrace()) {
+    trace->mark(stage);
+  }
+}
+
+ScopedStageTrace::ScopedStageTrace(StageTracer* tracer, std::string name)
+    : tracer_(tracer),
+      trace_(tracer_->startTrace(std::move(name))),
+      previous_(StageTracer::currentTrace()) {
+  StageTracer::currentTrace() = trace_;
+}
+
+ScopedStageTrace::~ScopedStageTrace() {
+  StageTracer::currentTrace() = std::move(previous_);
+  tracer_->finishTrace(trace_);
+}
+
+} // namespace facebook::fboss
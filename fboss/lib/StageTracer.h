@@ -0,0 +1,128 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include <folly/Range.h>
+#include <folly/Synchronized.h>
+#include <folly/container/F14Set.h>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * A StageTrace records when a single unit of work, e.g. a batch of route
+ * updates, reaches each stage of its processing. Work often hops threads on
+ * its way through the agent, so stages may be marked from any thread.
+ */
+class StageTrace {
+ public:
+  struct Stage {
+    std::string name;
+    std::chrono::steady_clock::time_point time;
+  };
+
+  StageTrace(uint64_t id, std::string name);
+
+  uint64_t getID() const {
+    return id_;
+  }
+  const std::string& getName() const {
+    return name_;
+  }
+  std::chrono::system_clock::time_point getStartTime() const {
+    return startTime_;
+  }
+
+  void mark(folly::StringPiece stage);
+  std::vector<Stage> getStages() const;
+
+ private:
+  StageTrace(const StageTrace&) = delete;
+  StageTrace& operator=(const StageTrace&) = delete;
+
+  const uint64_t id_;
+  const std::string name_;
+  const std::chrono::system_clock::time_point startTime_;
+  folly::Synchronized<std::vector<Stage>> stages_;
+};
+
+/*
+ * StageTracer hands out StageTraces and, once a trace is finished, exports
+ * the time spent between consecutive stages as <prefix>.<stage>.us fb303
+ * histograms (plus <prefix>.total.us) and keeps the last maxTraces traces
+ * around for on demand dumps.
+ *
+ * A trace is made current for the calling thread with ScopedStageTrace, so
+ * that code further down the stack can mark stages via markCurrent() without
+ * the trace being threaded through every call.
+ */
+class StageTracer {
+ public:
+  StageTracer(std::string counterPrefix, size_t maxTraces);
+
+  /*
+   * Start a new trace. Returns null if tracing is disabled, i.e. maxTraces is
+   * 0, all StageTrace helpers accept a null trace.
+   */
+  std::shared_ptr<StageTrace> startTrace(std::string name);
+  void finishTrace(const std::shared_ptr<StageTrace>& trace);
+
+  // Most recently finished traces first
+  std::vector<std::shared_ptr<const StageTrace>> getRecentTraces(
+      size_t count) const;
+
+  static const std::shared_ptr<StageTrace>& current();
+  static void markCurrent(folly::StringPiece stage);
+
+ private:
+  friend class ScopedStageTrace;
+
+  void exportStage(const std::string& stage, std::chrono::microseconds time);
+
+  static std::shared_ptr<StageTrace>& currentTrace();
+
+  const std::string counterPrefix_;
+  const size_t maxTraces_;
+  std::atomic<uint64_t> nextID_{1};
+  folly::Synchronized<std::deque<std::shared_ptr<const StageTrace>>>
+      recentTraces_;
+  folly::Synchronized<folly::F14FastSet<std::string>> exportedStages_;
+};
+
+/*
+ * Start a trace and make it current for the calling thread, the trace is
+ * finished and the previous current trace restored on destruction.
+ */
+class ScopedStageTrace {
+ public:
+  ScopedStageTrace(StageTracer* tracer, std::string name);
+  ~ScopedStageTrace();
+
+  const std::shared_ptr<StageTrace>& get() const {
+    return trace_;
+  }
+
+ private:
+  ScopedStageTrace(const ScopedStageTrace&) = delete;
+  ScopedStageTrace& operator=(const ScopedStageTrace&) = delete;
+
+  StageTracer* tracer_;
+  std::shared_ptr<StageTrace> trace_;
+  std::shared_ptr<StageTrace> previous_;
+};
+
+} // namespace facebook::fboss
@@ -10,14 +10,34 @@
 #include <folly/Synchronized.h>
 #include <folly/futures/Future.h>
 #include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
 
 #include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <thread>
 
+DEFINE_bool(
+    fpga_i2c_multi_descriptor,
+    false,
+    "Post queued FPGA I2C transactions to all descriptors of an RTC at once, "
+    "each using its share of the RTC IO blocks. Otherwise only descriptor 0 "
+    "is used.");
+
 namespace {
 constexpr uint32_t kFacebookFpgaRTCWriteBlock = 0x2000;
 constexpr uint32_t kFacebookFpgaRTCReadBlock = 0x3000;
 constexpr uint32_t kFacebookFpgaRTCIOBlockSize = 0x0200;
+// With --fpga_i2c_multi_descriptor, the descriptors of an RTC are assumed to
+// split its IO blocks evenly, and posting a descriptor to clear its done and
+// error status bits. Neither is confirmed by the FPGA spec yet.
+constexpr uint32_t kDescriptorIOBlockSize =
+    kFacebookFpgaRTCIOBlockSize / facebook::fboss::FbFpgaI2c::kNumDescriptors;
+
+// Roughly the time to transfer a byte on a 400KHz bus
+constexpr auto kByteTransferTime = std::chrono::microseconds(25);
+constexpr auto kMinPollInterval = std::chrono::microseconds(50);
+constexpr auto kMaxPollInterval = std::chrono::microseconds(1000);
 } // unnamed namespace
 
 namespace facebook::fboss {
@@ -29,27 +49,33 @@ FbFpgaI2c::FbFpgaI2c(FbDomFpga* fpga, uint32_t rtcId, uint32_t pimId)
   XLOG(DBG4, "Initialized I2C controller for rtcId={:d}", rtcId);
 }
 
-bool FbFpgaI2c::waitForResponse(size_t len) {
-  I2cRtcStatus rtcStatus;
-  uint32_t retries = 20;
-
-  // Make the initial wait according to the length of read/write.
-  usleep(100 * len);
-
-  rtcStatus = readReg<I2cRtcStatus>();
-
-  while (!rtcStatus.desc0done && --retries) {
-    usleep(1000);
+I2cRtcStatus FbFpgaI2c::waitForResponse(uint32_t numDescs, size_t len) {
+  auto allDone = [numDescs](const I2cRtcStatus& rtcStatus) {
+    for (uint32_t desc = 0; desc < numDescs; ++desc) {
+      if (!rtcStatus.descDone(desc) && !rtcStatus.descError(desc)) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // Give up once the transactions took far longer than their transfer
+  // should: 100us per byte plus 20ms.
+  auto deadline = std::chrono::steady_clock::now() +
+      std::chrono::microseconds(100 * len) + std::chrono::milliseconds(20);
+
+  // Make the initial wait according to the length of the transactions, then
+  // poll more and more slowly.
+  std::this_thread::sleep_for(kByteTransferTime * len);
+  auto pollInterval = kMinPollInterval;
+
+  auto rtcStatus = readReg<I2cRtcStatus>();
+  while (!allDone(rtcStatus) && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(pollInterval);
+    pollInterval = std::min(2 * pollInterval, kMaxPollInterval);
     rtcStatus = readReg<I2cRtcStatus>();
   }
-
-  if (rtcStatus.desc0error) {
-    XLOG(DBG5) << "I2C read/write ops has error.";
-    rtcStatus.reg = 0xffffffff;
-    return false;
-  }
-
-  return rtcStatus.desc0done;
+  return rtcStatus;
 }
 
 uint8_t FbFpgaI2c::readByte(uint8_t channel, uint8_t offset) {
@@ -62,43 +88,13 @@ void FbFpgaI2c::read(
     uint8_t channel,
     uint8_t offset,
     folly::MutableByteRange buf) {
-  I2cDescriptorLower descLower;
-  I2cDescriptorUpper descUpper;
-  descLower.reg = 0;
-  descUpper.reg = 0;
-
-  descLower.op = 1; // Read
-  descLower.len = buf.size();
-
-  descUpper.offset = offset;
-  descUpper.channel = channel;
-  descUpper.valid = 1;
-
-  writeReg(descLower);
-  writeReg(descUpper);
-
-  // Increment the counter for I2C read tranbsaction issued
-  incrReadTotal();
-
-  uint32_t readBlockAddr =
-      getRegAddr(kFacebookFpgaRTCReadBlock, kFacebookFpgaRTCIOBlockSize);
-
-  if (!waitForResponse(descLower.len)) {
-    // Increment the counter for I2C read transaction failure and
-    // throw error
-    incrReadFailed();
-
+  Transaction txn;
+  txn.channel = channel;
+  txn.offset = offset;
+  txn.readBuf = buf;
+  execute(folly::Range<Transaction*>(&txn, 1));
+  if (txn.failed) {
     throw FbFpgaI2cError("I2C read failed.");
-  } else {
-    for (int bytesRead = 0; bytesRead < buf.size(); bytesRead += 4) {
-      uint32_t data = fpga_->read(readBlockAddr + bytesRead);
-      std::memcpy(
-          buf.begin() + bytesRead,
-          &data,
-          std::min(buf.size() - bytesRead, (size_t)4));
-    }
-    // Update the number of bytes read
-    incrReadBytes(buf.size());
   }
 }
 
@@ -107,45 +103,115 @@ void FbFpgaI2c::writeByte(uint8_t channel, uint8_t offset, uint8_t val) {
 }
 
 void FbFpgaI2c::write(uint8_t channel, uint8_t offset, folly::ByteRange buf) {
-  I2cDescriptorLower descLower;
-  I2cDescriptorUpper descUpper;
-  descLower.reg = 0;
-  descUpper.reg = 0;
-
-  descLower.op = 0; // Write
-  descLower.len = buf.size();
+  Transaction txn;
+  txn.channel = channel;
+  txn.offset = offset;
+  txn.isRead = false;
+  txn.writeBuf = buf;
+  execute(folly::Range<Transaction*>(&txn, 1));
+  if (txn.failed) {
+    throw FbFpgaI2cError("I2C write failed.");
+  }
+}
 
-  descUpper.offset = offset;
-  descUpper.channel = channel;
-  descUpper.valid = 1;
+size_t FbFpgaI2c::batchSize(folly::Range<const Transaction*> txns) {
+  if (!FLAGS_fpga_i2c_multi_descriptor) {
+    return std::min(txns.size(), size_t(1));
+  }
+  size_t count = 0;
+  while (count < txns.size() && count < kNumDescriptors &&
+         txns[count].length() <= kDescriptorIOBlockSize) {
+    ++count;
+  }
+  // A transaction too long to share the IO blocks goes on its own
+  return std::max(count, std::min(txns.size(), size_t(1)));
+}
 
-  // Increment the counter for write transaction issued
-  incrWriteTotal();
+void FbFpgaI2c::execute(folly::Range<Transaction*> txns) {
+  if (txns.empty()) {
+    return;
+  }
+  CHECK_LE(txns.size(), kNumDescriptors);
+  CHECK(txns.size() == 1 || batchSize(txns) == txns.size());
 
+  uint32_t readBlockAddr =
+      getRegAddr(kFacebookFpgaRTCReadBlock, kFacebookFpgaRTCIOBlockSize);
   uint32_t writeBlockAddr =
       getRegAddr(kFacebookFpgaRTCWriteBlock, kFacebookFpgaRTCIOBlockSize);
 
-  for (int bytesWritten = 0; bytesWritten < buf.size(); bytesWritten += 4) {
-    uint32_t data;
-    std::memcpy(
-        &data,
-        buf.begin() + bytesWritten,
-        std::min(buf.size() - bytesWritten, (size_t)4));
-    fpga_->write(writeBlockAddr + bytesWritten, data);
-  }
+  size_t totalLen = 0;
+  for (uint32_t desc = 0; desc < txns.size(); ++desc) {
+    auto& txn = txns[desc];
+    I2cDescriptorLower descLower;
+    I2cDescriptorUpper descUpper;
+    descLower.reg = 0;
+    descUpper.reg = 0;
+
+    descLower.op = txn.isRead ? 1 : 0;
+    descLower.len = txn.length();
+
+    descUpper.offset = txn.offset;
+    descUpper.channel = txn.channel;
+    descUpper.valid = 1;
+
+    if (txn.isRead) {
+      // Increment the counter for I2C read transaction issued
+      incrReadTotal();
+    } else {
+      // Increment the counter for write transaction issued
+      incrWriteTotal();
+
+      auto blockAddr = writeBlockAddr + desc * kDescriptorIOBlockSize;
+      const auto& buf = txn.writeBuf;
+      for (int bytesWritten = 0; bytesWritten < buf.size();
+           bytesWritten += 4) {
+        uint32_t data = 0;
+        std::memcpy(
+            &data,
+            buf.begin() + bytesWritten,
+            std::min(buf.size() - bytesWritten, (size_t)4));
+        fpga_->write(blockAddr + bytesWritten, data);
+      }
+    }
 
-  writeReg(descLower);
-  writeReg(descUpper);
+    writeReg(descLower, desc);
+    writeReg(descUpper, desc);
+    totalLen += txn.length();
+  }
 
-  if (!waitForResponse(descLower.len)) {
-    // Increment the counter for I2c write transaction failure and
-    // throw error
-    incrWriteFailed();
+  auto rtcStatus = waitForResponse(txns.size(), totalLen);
+
+  for (uint32_t desc = 0; desc < txns.size(); ++desc) {
+    auto& txn = txns[desc];
+    txn.failed = rtcStatus.descError(desc) || !rtcStatus.descDone(desc);
+    if (txn.failed) {
+      XLOG(DBG5) << "I2C read/write ops has error on descriptor " << desc;
+      // Increment the counter for I2C transaction failure
+      if (txn.isRead) {
+        incrReadFailed();
+      } else {
+        incrWriteFailed();
+      }
+      continue;
+    }
 
-    throw FbFpgaI2cError("I2C write failed.");
+    if (txn.isRead) {
+      auto blockAddr = readBlockAddr + desc * kDescriptorIOBlockSize;
+      auto& buf = txn.readBuf;
+      for (int bytesRead = 0; bytesRead < buf.size(); bytesRead += 4) {
+        uint32_t data = fpga_->read(blockAddr + bytesRead);
+        std::memcpy(
+            buf.begin() + bytesRead,
+            &data,
+            std::min(buf.size() - bytesRead, (size_t)4));
+      }
+      // Update the number of bytes read
+      incrReadBytes(buf.size());
+    } else {
+      // Update the number of bytes write
+      incrWriteBytes(txn.writeBuf.size());
+    }
   }
-  // Update the number of bytes write
-  incrWriteBytes(buf.size());
 }
 
 template <typename Register>
@@ -158,10 +224,11 @@ Register FbFpgaI2c::readReg() {
 }
 
 template <typename Register>
-void FbFpgaI2c::writeReg(Register value) {
+void FbFpgaI2c::writeReg(Register value, uint32_t desc) {
   XLOG(DBG5) << value;
   fpga_->write(
-      getRegAddr(Register::baseAddr::value, Register::addrIncr::value),
+      getRegAddr(Register::baseAddr::value, Register::addrIncr::value) +
+          desc * Register::descIncr::value,
       value.reg);
 }
 
@@ -14,6 +14,8 @@
 #include <thread>
 
 namespace facebook::fboss {
+union I2cRtcStatus;
+
 inline uint8_t getI2cControllerIdx(uint8_t port) {
   return port / 4;
 }
@@ -29,6 +31,27 @@ class FbFpgaI2cError : public I2cError {
 
 class FbFpgaI2c : public I2cController {
  public:
+  // Number of descriptors of each RTC
+  static constexpr uint32_t kNumDescriptors = 4;
+
+  /*
+   * A read or write on one channel of the RTC. The buffers are owned by the
+   * caller and must stay valid until the transaction is done.
+   */
+  struct Transaction {
+    uint8_t channel{0};
+    uint8_t offset{0};
+    bool isRead{true};
+    folly::MutableByteRange readBuf;
+    folly::ByteRange writeBuf;
+    // Set once the transaction was executed
+    bool failed{false};
+
+    size_t length() const {
+      return isRead ? readBuf.size() : writeBuf.size();
+    }
+  };
+
   FbFpgaI2c(FbDomFpga* fpga, uint32_t rtcId, uint32_t pim);
 
   uint8_t readByte(uint8_t channel, uint8_t offset);
@@ -37,14 +60,30 @@ class FbFpgaI2c : public I2cController {
   void writeByte(uint8_t channel, uint8_t offset, uint8_t val);
   void write(uint8_t channel, uint8_t offset, folly::ByteRange buf);
 
+  /*
+   * Post the transactions to the descriptors of the RTC, which runs them in
+   * order, and wait for all of them to complete. Failed transactions are
+   * marked rather than thrown for. Use batchSize() to split a queue of
+   * transactions into batches that can be posted together.
+   */
+  void execute(folly::Range<Transaction*> txns);
+
+  /*
+   * Number of transactions at the front of txns that can be posted together.
+   * This is always 1 unless --fpga_i2c_multi_descriptor is set, in which case
+   * it is up to one per descriptor, as long as each fits in its descriptor's
+   * share of the RTC IO blocks. Longer transactions are posted on their own.
+   */
+  static size_t batchSize(folly::Range<const Transaction*> txns);
+
  private:
-  bool waitForResponse(size_t len);
+  I2cRtcStatus waitForResponse(uint32_t numDescs, size_t len);
   uint32_t getRegAddr(uint32_t regBase, uint32_t regIncr);
 
   template <typename Register>
   Register readReg();
   template <typename Register>
-  void writeReg(Register value);
+  void writeReg(Register value, uint32_t desc = 0);
 
   FbDomFpga* fpga_{nullptr};
 
@@ -8,9 +8,12 @@
 #include <ostream>
 
 namespace facebook::fboss {
+// Each RTC has four descriptors, whose lower and upper registers follow each
+// other in the RTC's register block.
 union I2cDescriptorUpper {
   using baseAddr = std::integral_constant<uint32_t, 0x504>;
   using addrIncr = std::integral_constant<uint32_t, 0x20>;
+  using descIncr = std::integral_constant<uint32_t, 0x8>;
 
   uint32_t reg;
   struct __attribute__((packed)) {
@@ -35,6 +38,7 @@ inline std::ostream& operator<<(
 union I2cDescriptorLower {
   using baseAddr = std::integral_constant<uint32_t, 0x500>;
   using addrIncr = std::integral_constant<uint32_t, 0x20>;
+  using descIncr = std::integral_constant<uint32_t, 0x8>;
 
   uint32_t reg;
   struct __attribute__((packed)) {
@@ -73,6 +77,14 @@ union I2cRtcStatus {
     uint32_t reserved3 : 2;
     uint32_t reserved : 16;
   };
+
+  bool descDone(uint32_t desc) const {
+    return reg & (1 << (4 * desc));
+  }
+
+  bool descError(uint32_t desc) const {
+    return reg & (1 << (4 * desc + 1));
+  }
 };
 
 inline std::ostream& operator<<(std::ostream& os, const I2cRtcStatus& status) {
@@ -0,0 +1,267 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/lib/fpga/FbFpgaI2c.h"
+#include "fboss/lib/fpga/FbFpgaRegisters.h"
+#include "fboss/lib/test/FakePhysicalMemory.h"
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstring>
+#include <set>
+#include <vector>
+
+DECLARE_bool(fpga_i2c_multi_descriptor);
+
+using namespace facebook::fboss;
+
+namespace {
+constexpr uint32_t kFakeFpgaAddr = 0xfb000000;
+constexpr uint32_t kFakeFpgaSize = 0x4000;
+constexpr uint32_t kRtcId = 1;
+constexpr uint8_t kNumChannels = 4;
+
+constexpr uint32_t kWriteBlock = 0x2000 + 0x200 * kRtcId;
+constexpr uint32_t kReadBlock = 0x3000 + 0x200 * kRtcId;
+constexpr uint32_t kDescBlockSize = 0x80;
+constexpr uint32_t kDescIncr = I2cDescriptorLower::descIncr::value;
+constexpr uint32_t kDescBase = I2cDescriptorLower::baseAddr::value +
+    I2cDescriptorLower::addrIncr::value * kRtcId;
+constexpr uint32_t kStatusAddr =
+    I2cRtcStatus::baseAddr::value + I2cRtcStatus::addrIncr::value * kRtcId;
+
+/*
+ * Simulates the RTC of an FPGA, with a 256 byte transceiver memory behind
+ * each of its channels. Transactions are run as soon as they are posted, but
+ * only reported done after a few polls of the status register.
+ *
+ * The per descriptor IO block slices and status bits follow the same
+ * assumptions as FbFpgaI2c, so the multi descriptor tests only check that
+ * both sides agree, not that the hardware behaves this way.
+ */
+class FakeFbFpgaDevice : public FpgaDevice {
+ public:
+  FakeFbFpgaDevice()
+      : FpgaDevice(kFakeFpgaAddr, kFakeFpgaSize),
+        mem_(kFakeFpgaAddr, kFakeFpgaSize, false) {
+    mem_.mmap();
+    for (auto& channelMem : channels_) {
+      for (int i = 0; i < channelMem.size(); ++i) {
+        channelMem[i] = i;
+      }
+    }
+  }
+
+  uint32_t read(uint32_t offset) const override {
+    if (offset == kStatusAddr) {
+      if (++statusReads_ >= pollsBeforeDone_) {
+        // Report what was posted so far, the next transactions come after
+        // the caller saw these ones done
+        if (!inFlight_.empty()) {
+          batches_.push_back(inFlight_.size());
+          inFlight_.clear();
+        }
+        return status_.reg;
+      }
+      return 0;
+    }
+    return mem_.read(offset);
+  }
+
+  void write(uint32_t offset, uint32_t value) override {
+    mem_.write(offset, value);
+    if (offset < kDescBase ||
+        offset >= kDescBase + kDescIncr * FbFpgaI2c::kNumDescriptors) {
+      return;
+    }
+    // Transactions start with a write to the upper descriptor register
+    uint32_t desc = (offset - kDescBase) / kDescIncr;
+    if ((offset - kDescBase) % kDescIncr == 0) {
+      return;
+    }
+    I2cDescriptorUpper upper;
+    upper.reg = value;
+    if (!upper.valid) {
+      return;
+    }
+    I2cDescriptorLower lower;
+    lower.reg = mem_.read(offset - 4);
+    runTransaction(desc, lower, upper);
+  }
+
+  std::array<uint8_t, 256>& channel(uint8_t channel) {
+    return channels_[channel];
+  }
+
+  void setFailingChannel(uint8_t channel) {
+    failingChannels_.insert(channel);
+  }
+
+  void setPollsBeforeDone(uint32_t polls) {
+    pollsBeforeDone_ = polls;
+  }
+
+  // Number of transactions posted together, per batch
+  const std::vector<size_t>& getBatches() const {
+    return batches_;
+  }
+
+ private:
+  void runTransaction(
+      uint32_t desc,
+      I2cDescriptorLower lower,
+      I2cDescriptorUpper upper) {
+    // Posting a transaction clears the status of its descriptor
+    status_.reg &= ~(0x3 << (4 * desc));
+    statusReads_ = 0;
+    inFlight_.push_back(desc);
+
+    if (failingChannels_.count(upper.channel)) {
+      status_.reg |= 0x2 << (4 * desc);
+      return;
+    }
+    auto& channelMem = channels_[upper.channel];
+    for (uint32_t i = 0; i < lower.len; i += 4) {
+      uint32_t word = 0;
+      auto len = std::min<uint32_t>(4, lower.len - i);
+      if (lower.op == 1) {
+        std::memcpy(&word, &channelMem[upper.offset + i], len);
+        mem_.write(kReadBlock + desc * kDescBlockSize + i, word);
+      } else {
+        word = mem_.read(kWriteBlock + desc * kDescBlockSize + i);
+        std::memcpy(&channelMem[upper.offset + i], &word, len);
+      }
+    }
+    status_.reg |= 0x1 << (4 * desc);
+  }
+
+  FakePhysicalMemory32 mem_;
+  std::array<std::array<uint8_t, 256>, kNumChannels>
+      channels_;
+  std::set<uint8_t> failingChannels_;
+  I2cRtcStatus status_{0};
+  uint32_t pollsBeforeDone_{1};
+  mutable uint32_t statusReads_{0};
+  mutable std::vector<uint32_t> inFlight_;
+  mutable std::vector<size_t> batches_;
+};
+
+class FbFpgaI2cTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    fpga_ = std::make_unique<FbDomFpga>(std::make_unique<FpgaMemoryRegion>(
+        "fakePim", &device_, 0, kFakeFpgaSize));
+  }
+
+ protected:
+  FbFpgaI2c::Transaction readTxn(
+      uint8_t channel,
+      uint8_t offset,
+      folly::MutableByteRange buf) {
+    FbFpgaI2c::Transaction txn;
+    txn.channel = channel;
+    txn.offset = offset;
+    txn.readBuf = buf;
+    return txn;
+  }
+
+  FakeFbFpgaDevice device_;
+  std::unique_ptr<FbDomFpga> fpga_;
+  gflags::FlagSaver flagSaver_;
+};
+} // namespace
+
+TEST_F(FbFpgaI2cTest, readWrite) {
+  FbFpgaI2c i2c(fpga_.get(), kRtcId, 1);
+  std::array<uint8_t, 6> data{1, 2, 3, 4, 5, 6};
+  i2c.write(2, 10, folly::ByteRange(data.data(), data.size()));
+  EXPECT_EQ(device_.channel(2)[15], 6);
+  EXPECT_EQ(device_.channel(1)[15], 15);
+
+  std::array<uint8_t, 6> buf{};
+  i2c.read(2, 10, folly::MutableByteRange(buf.data(), buf.size()));
+  EXPECT_EQ(buf, data);
+  EXPECT_EQ(i2c.readByte(3, 200), 200);
+
+  // Longer than a descriptor's share of the IO blocks
+  std::array<uint8_t, 200> page{};
+  i2c.read(0, 0, folly::MutableByteRange(page.data(), page.size()));
+  EXPECT_EQ(page[199], 199);
+
+  EXPECT_EQ(device_.getBatches(), std::vector<size_t>({1, 1, 1, 1}));
+  const auto& stats = i2c.getI2cControllerPlatformStats();
+  EXPECT_EQ(*stats.readTotal__ref(), 3);
+  EXPECT_EQ(*stats.readBytes__ref(), 207);
+  EXPECT_EQ(*stats.writeTotal__ref(), 1);
+  EXPECT_EQ(*stats.writeBytes__ref(), 6);
+}
+
+TEST_F(FbFpgaI2cTest, executeBatch) {
+  FLAGS_fpga_i2c_multi_descriptor = true;
+  FbFpgaI2c i2c(fpga_.get(), kRtcId, 1);
+  device_.setPollsBeforeDone(5);
+  std::array<std::array<uint8_t, 128>, 4> bufs{};
+  std::vector<FbFpgaI2c::Transaction> txns;
+  for (uint8_t channel = 0; channel < 4; ++channel) {
+    device_.channel(channel)[128 + channel] = 0xf0 + channel;
+    txns.push_back(readTxn(
+        channel,
+        128,
+        folly::MutableByteRange(bufs[channel].data(), bufs[channel].size())));
+  }
+  ASSERT_EQ(FbFpgaI2c::batchSize(folly::range(txns)), 4);
+  i2c.execute(folly::range(txns));
+
+  EXPECT_EQ(device_.getBatches(), std::vector<size_t>({4}));
+  for (uint8_t channel = 0; channel < 4; ++channel) {
+    EXPECT_FALSE(txns[channel].failed);
+    EXPECT_EQ(bufs[channel][channel], 0xf0 + channel);
+    EXPECT_EQ(bufs[channel][127], 255);
+  }
+}
+
+TEST_F(FbFpgaI2cTest, batchSize) {
+  std::array<uint8_t, 200> buf{};
+  auto small = readTxn(0, 0, folly::MutableByteRange(buf.data(), 128));
+  auto large = readTxn(0, 0, folly::MutableByteRange(buf.data(), 200));
+
+  std::vector<FbFpgaI2c::Transaction> txns;
+  EXPECT_EQ(FbFpgaI2c::batchSize(folly::range(txns)), 0);
+  txns = {small, small, small, small};
+  EXPECT_EQ(FbFpgaI2c::batchSize(folly::range(txns)), 1);
+
+  FLAGS_fpga_i2c_multi_descriptor = true;
+  txns = {large, small};
+  EXPECT_EQ(FbFpgaI2c::batchSize(folly::range(txns)), 1);
+  txns = {small, small, large, small};
+  EXPECT_EQ(FbFpgaI2c::batchSize(folly::range(txns)), 2);
+  txns = {small, small, small, small, small};
+  EXPECT_EQ(FbFpgaI2c::batchSize(folly::range(txns)), 4);
+}
+
+TEST_F(FbFpgaI2cTest, failedTransaction) {
+  FLAGS_fpga_i2c_multi_descriptor = true;
+  FbFpgaI2c i2c(fpga_.get(), kRtcId, 1);
+  device_.setFailingChannel(1);
+  std::array<uint8_t, 4> buf0{}, buf1{};
+  std::vector<FbFpgaI2c::Transaction> txns = {
+      readTxn(0, 4, folly::MutableByteRange(buf0.data(), buf0.size())),
+      readTxn(1, 4, folly::MutableByteRange(buf1.data(), buf1.size())),
+  };
+  i2c.execute(folly::range(txns));
+  EXPECT_FALSE(txns[0].failed);
+  EXPECT_TRUE(txns[1].failed);
+  EXPECT_EQ(buf0[0], 4);
+  EXPECT_EQ(*i2c.getI2cControllerPlatformStats().readFailed__ref(), 1);
+
+  EXPECT_THROW(i2c.readByte(1, 0), FbFpgaI2cError);
+}
@@ -0,0 +1,83 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/lib/Interned.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace facebook::fboss;
+
+using InternedString = Interned<std::string>;
+
+TEST(Interned, equalValuesShareStorage) {
+  InternedString a(std::string("foo"));
+  InternedString b(std::string("foo"));
+  InternedString c(std::string("bar"));
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(&a.get(), &b.get());
+  EXPECT_NE(a, c);
+  EXPECT_EQ(*a, "foo");
+  EXPECT_EQ(a->size(), 3);
+
+  auto stats = InternedString::getStats();
+  EXPECT_EQ(stats.distinctValues, 2);
+  EXPECT_EQ(stats.references, 3);
+}
+
+TEST(Interned, emptyValueIsNotInterned) {
+  InternedString a;
+  InternedString b(std::string(""));
+  EXPECT_EQ(a, b);
+  EXPECT_TRUE(a->empty());
+  EXPECT_EQ(InternedString::getStats().distinctValues, 0);
+}
+
+TEST(Interned, releasedWithLastHandle) {
+  {
+    InternedString a(std::string("foo"));
+    auto b = a;
+    EXPECT_EQ(InternedString::getStats().distinctValues, 1);
+    EXPECT_EQ(InternedString::getStats().references, 2);
+  }
+  EXPECT_EQ(InternedString::getStats().distinctValues, 0);
+
+  // Re-interning after release creates a new entry
+  InternedString c(std::string("foo"));
+  EXPECT_EQ(InternedString::getStats().distinctValues, 1);
+}
+
+TEST(Interned, orderedByValue) {
+  InternedString a(std::string("a"));
+  InternedString b(std::string("b"));
+  EXPECT_TRUE(a < b);
+  EXPECT_FALSE(b < a);
+  EXPECT_FALSE(a < InternedString(std::string("a")));
+}
+
+TEST(Interned, concurrentInternAndRelease) {
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < 8; ++i) {
+    threads.emplace_back([]() {
+      for (auto j = 0; j < 10000; ++j) {
+        InternedString a(std::to_string(j % 16));
+        InternedString b(std::to_string(j % 16));
+        EXPECT_EQ(a, b);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(InternedString::getStats().distinctValues, 0);
+}
@@ -27,6 +27,10 @@ DEFINE_int32(
     lookup_count,
     5000,
     "The number of elements to look up on each lookup iteration");
+DEFINE_int32(
+    allocator_prefix_count,
+    1000000,
+    "The number of prefixes in trees used to compare node allocators");
 namespace {
 set<Prefix4> insertSet4;
 set<Prefix4> eraseSet4;
@@ -37,6 +41,7 @@ set<Prefix6> eraseSet6;
 set<Prefix6> exactMatchSet6;
 set<Prefix6> longestMatchSet6;
 vector<int> valueSet;
+vector<Prefix6> allocatorPrefixes6;
 
 // V4 Benchmarks
 template <typename TREE>
@@ -197,6 +202,94 @@ BENCHMARK_RELATIVE(RadixTreeLongestMatch6) {
   }
 }
 
+// Node allocator benchmarks, comparing heap and arena allocated nodes
+
+template <template <typename> class NodeAllocator>
+using AllocatorTree6 = RadixTree<
+    IPAddressV6,
+    int,
+    RadixTreeTraits<IPAddressV6, int>,
+    NodeAllocator>;
+
+template <template <typename> class NodeAllocator>
+void setupAllocatorTree6(AllocatorTree6<NodeAllocator>& tree) {
+  auto count = 0;
+  for (const auto& pfx : allocatorPrefixes6) {
+    tree.insert(pfx.ip, pfx.mask, count++);
+  }
+}
+
+// Trees for lookup and iteration benchmarks are built once
+template <template <typename> class NodeAllocator>
+const AllocatorTree6<NodeAllocator>& allocatorTree6() {
+  static auto tree = [] {
+    AllocatorTree6<NodeAllocator> t;
+    setupAllocatorTree6<NodeAllocator>(t);
+    return t;
+  }();
+  return tree;
+}
+
+template <template <typename> class NodeAllocator>
+void allocatorInsert6() {
+  AllocatorTree6<NodeAllocator> rtree;
+  setupAllocatorTree6<NodeAllocator>(rtree);
+  // Don't count freeing the tree
+  BENCHMARK_SUSPEND {
+    rtree.clear();
+  }
+}
+
+template <template <typename> class NodeAllocator>
+void allocatorLookup6() {
+  const AllocatorTree6<NodeAllocator>* rtree;
+  BENCHMARK_SUSPEND {
+    rtree = &allocatorTree6<NodeAllocator>();
+  }
+  auto found = 0;
+  for (const auto& pfx : allocatorPrefixes6) {
+    found += rtree->longestMatch(pfx.ip, 128) != rtree->end();
+  }
+  folly::doNotOptimizeAway(found);
+}
+
+template <template <typename> class NodeAllocator>
+void allocatorIterate6() {
+  const AllocatorTree6<NodeAllocator>* rtree;
+  BENCHMARK_SUSPEND {
+    rtree = &allocatorTree6<NodeAllocator>();
+  }
+  auto sum = 0;
+  for (const auto& node : *rtree) {
+    sum += node.value();
+  }
+  folly::doNotOptimizeAway(sum);
+}
+
+BENCHMARK(HeapAllocatorInsert6) {
+  allocatorInsert6<RadixTreeHeapAllocator>();
+}
+
+BENCHMARK_RELATIVE(ArenaAllocatorInsert6) {
+  allocatorInsert6<RadixTreeArenaAllocator>();
+}
+
+BENCHMARK(HeapAllocatorLookup6) {
+  allocatorLookup6<RadixTreeHeapAllocator>();
+}
+
+BENCHMARK_RELATIVE(ArenaAllocatorLookup6) {
+  allocatorLookup6<RadixTreeArenaAllocator>();
+}
+
+BENCHMARK(HeapAllocatorIterate6) {
+  allocatorIterate6<RadixTreeHeapAllocator>();
+}
+
+BENCHMARK_RELATIVE(ArenaAllocatorIterate6) {
+  allocatorIterate6<RadixTreeArenaAllocator>();
+}
+
 } // namespace
 
 int main(int /*argc*/, char* /*argv*/ []) {
@@ -252,5 +345,17 @@ int main(int /*argc*/, char* /*argv*/ []) {
     auto newIp = pfx.ip.mask(newMask);
     longestMatchSet6.insert(Prefix6(newIp, newMask));
   }
+
+  // Prefixes for allocator benchmarks, /32 to /64 as seen in routing tables
+  set<Prefix6> allocatorSet6;
+  while (allocatorSet6.size() < FLAGS_allocator_prefix_count) {
+    auto mask = 32 + folly::Random::rand32(33);
+    ByteArray16 ba{};
+    *(uint64_t*)(&ba[0]) = folly::Random::rand64();
+    auto ip = IPAddressV6(ba).mask(mask);
+    if (allocatorSet6.insert(Prefix6(ip, mask)).second) {
+      allocatorPrefixes6.push_back(Prefix6(ip, mask));
+    }
+  }
   runBenchmarks();
 }
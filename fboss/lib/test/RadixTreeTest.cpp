@@ -1527,3 +1527,70 @@ TEST(RadixTree, SubTreeIterator) {
   }
   EXPECT_EQ(rtree.end().subTreeIterator(), rtree.end());
 }
+
+/*
+ * Heap and arena allocated trees should behave the same, including
+ * calling the delete callback and reusing freed arena nodes.
+ */
+TEST(RadixTree, ArenaAllocator) {
+  using ArenaTree = RadixTree<
+      IPAddressV4,
+      int,
+      RadixTreeTraits<IPAddressV4, int>,
+      RadixTreeArenaAllocator>;
+  auto heapDeleted = 0;
+  auto arenaDeleted = 0;
+  RadixTree<IPAddressV4, int> heapTree(
+      [&](const RadixTreeNode<IPAddressV4, int>& /*node*/) { ++heapDeleted; });
+  ArenaTree arenaTree([&](const RadixTreeNode<IPAddressV4, int>& /*node*/) {
+    ++arenaDeleted;
+  });
+  std::vector<std::pair<IPAddressV4, uint8_t>> inserted;
+  set<Prefix4> prefixesSeen;
+  auto const kInsertCount = 5000;
+  for (auto i = 0; i < kInsertCount;) {
+    auto mask = folly::Random::rand32(33);
+    auto ip = IPAddressV4::fromLongHBO(folly::Random::rand32()).mask(mask);
+    if (!prefixesSeen.insert(Prefix4(ip, mask)).second) {
+      continue;
+    }
+    ++i;
+    EXPECT_TRUE(heapTree.insert(ip, mask, i).second);
+    EXPECT_TRUE(arenaTree.insert(ip, mask, i).second);
+    inserted.emplace_back(ip, mask);
+  }
+  // Erase half and re-insert, arena nodes are recycled through the freelist
+  for (auto i = 0; i < kInsertCount; i += 2) {
+    EXPECT_TRUE(heapTree.erase(inserted[i].first, inserted[i].second));
+    EXPECT_TRUE(arenaTree.erase(inserted[i].first, inserted[i].second));
+  }
+  EXPECT_EQ(heapDeleted, arenaDeleted);
+  for (auto i = 0; i < kInsertCount; i += 4) {
+    EXPECT_TRUE(
+        heapTree.insert(inserted[i].first, inserted[i].second, i).second);
+    EXPECT_TRUE(
+        arenaTree.insert(inserted[i].first, inserted[i].second, i).second);
+  }
+  EXPECT_EQ(heapTree.size(), arenaTree.size());
+  auto heapItr = heapTree.begin();
+  auto arenaItr = arenaTree.begin();
+  for (; heapItr != heapTree.end(); ++heapItr, ++arenaItr) {
+    ASSERT_NE(arenaItr, arenaTree.end());
+    EXPECT_TRUE(heapItr->equalSansLinks(*arenaItr));
+  }
+  EXPECT_EQ(arenaItr, arenaTree.end());
+
+  // Clones and moved trees own their own nodes
+  auto arenaCopy = arenaTree.clone();
+  EXPECT_TRUE(arenaCopy == arenaTree);
+  ArenaTree arenaMoved(std::move(arenaCopy));
+  EXPECT_EQ(0, arenaCopy.size());
+  EXPECT_EQ(nullptr, arenaCopy.root());
+  EXPECT_TRUE(arenaMoved == arenaTree);
+
+  heapTree.clear();
+  arenaTree.clear();
+  EXPECT_EQ(heapDeleted, arenaDeleted);
+  EXPECT_EQ(0, arenaTree.size());
+  EXPECT_EQ(arenaTree.begin(), arenaTree.end());
+}
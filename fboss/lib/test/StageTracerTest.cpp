@@ -0,0 +1,96 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/lib/StageTracer.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace facebook::fboss;
+
+namespace {
+std::vector<std::string> stageNames(const StageTrace& trace) {
+  std::vector<std::string> names;
+  for (const auto& stage : trace.getStages()) {
+    names.push_back(stage.name);
+  }
+  return names;
+}
+} // namespace
+
+TEST(StageTracer, scopedTraceMarksStages) {
+  StageTracer tracer("test.scoped", 10);
+  EXPECT_EQ(StageTracer::current(), nullptr);
+  {
+    ScopedStageTrace trace(&tracer, "update");
+    EXPECT_EQ(StageTracer::current(), trace.get());
+    StageTracer::markCurrent("first");
+    // Stages marked from another thread land on the same trace
+    auto handedOff = StageTracer::current();
+    std::thread([handedOff]() {
+      EXPECT_EQ(StageTracer::current(), nullptr);
+      handedOff->mark("second");
+    }).join();
+  }
+  EXPECT_EQ(StageTracer::current(), nullptr);
+  // Marking with no current trace is a no-op
+  StageTracer::markCurrent("ignored");
+
+  auto traces = tracer.getRecentTraces(10);
+  ASSERT_EQ(traces.size(), 1);
+  EXPECT_EQ(traces[0]->getName(), "update");
+  EXPECT_EQ(
+      stageNames(*traces[0]),
+      std::vector<std::string>({"start", "first", "second", "done"}));
+  auto stages = traces[0]->getStages();
+  for (size_t i = 1; i < stages.size(); ++i) {
+    EXPECT_LE(stages[i - 1].time, stages[i].time);
+  }
+}
+
+TEST(StageTracer, nestedTracesRestorePrevious) {
+  StageTracer tracer("test.nested", 10);
+  ScopedStageTrace outer(&tracer, "outer");
+  {
+    ScopedStageTrace inner(&tracer, "inner");
+    EXPECT_EQ(StageTracer::current(), inner.get());
+    EXPECT_NE(inner.get()->getID(), outer.get()->getID());
+  }
+  EXPECT_EQ(StageTracer::current(), outer.get());
+}
+
+TEST(StageTracer, keepsMostRecentTraces) {
+  StageTracer tracer("test.recent", 3);
+  for (auto i = 0; i < 5; ++i) {
+    ScopedStageTrace trace(&tracer, std::to_string(i));
+  }
+  auto traces = tracer.getRecentTraces(10);
+  ASSERT_EQ(traces.size(), 3);
+  EXPECT_EQ(traces[0]->getName(), "4");
+  EXPECT_EQ(traces[1]->getName(), "3");
+  EXPECT_EQ(traces[2]->getName(), "2");
+  EXPECT_GT(traces[0]->getID(), traces[1]->getID());
+
+  EXPECT_EQ(tracer.getRecentTraces(1).size(), 1);
+}
+
+TEST(StageTracer, disabledTracer) {
+  StageTracer tracer("test.disabled", 0);
+  {
+    ScopedStageTrace trace(&tracer, "update");
+    EXPECT_EQ(trace.get(), nullptr);
+    EXPECT_EQ(StageTracer::current(), nullptr);
+    StageTracer::markCurrent("ignored");
+  }
+  EXPECT_TRUE(tracer.getRecentTraces(10).empty());
+}
@@ -29,6 +29,7 @@
 #include "fboss/lib/BmcRestClient.h"
 #include "fboss/lib/usb/UsbError.h"
 
+#include <gflags/gflags.h>
 #include <glog/logging.h>
 
 #include <folly/ScopeGuard.h>
@@ -36,16 +37,65 @@
 #include <folly/logging/xlog.h>
 #include <libusb-1.0/libusb.h>
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+DEFINE_bool(
+    cp2112_async_transfers,
+    false,
+    "Submit CP2112 requests along with the transfers picking up their "
+    "responses, and poll for transfer completion with an adaptive interval. "
+    "Off by default until it has been validated on hardware");
+
 using folly::ByteRange;
 using folly::Endian;
 using folly::MutableByteRange;
 using folly::StringPiece;
 using std::chrono::duration_cast;
+using std::chrono::microseconds;
 using std::chrono::milliseconds;
 using std::chrono::steady_clock;
 
 namespace {
 
+// The CP2112 always uses endpoint 1 for interrupt transfers.
+constexpr uint8_t kIntrOutEndpoint = LIBUSB_ENDPOINT_OUT | 1;
+constexpr uint8_t kIntrInEndpoint = LIBUSB_ENDPOINT_IN | 1;
+
+// We run the bus at 400KHz, where a byte and its ack take 22.5us.  Polls
+// for transfer completion start after that time, then back off.
+constexpr auto kByteTransferTime = std::chrono::nanoseconds(22500);
+constexpr auto kMinPollInterval = microseconds(250);
+constexpr auto kMaxPollInterval = milliseconds(10);
+
+microseconds initialPollInterval(size_t length) {
+  if (!FLAGS_cp2112_async_transfers) {
+    return kMaxPollInterval;
+  }
+  // Account for the address byte as well
+  return std::max<microseconds>(
+      kMinPollInterval,
+      duration_cast<microseconds>(kByteTransferTime * (length + 1)));
+}
+
+microseconds nextPollInterval(microseconds interval) {
+  return std::min<microseconds>(2 * interval, kMaxPollInterval);
+}
+
+facebook::fboss::UsbInterruptTransfer makeIntrTransfer(
+    uint8_t endpoint,
+    uint8_t* buf,
+    uint16_t length,
+    milliseconds timeout) {
+  facebook::fboss::UsbInterruptTransfer transfer;
+  transfer.endpoint = endpoint;
+  transfer.buf = buf;
+  transfer.length = length;
+  transfer.timeout = timeout;
+  return transfer;
+}
+
 struct ReportType {
   enum : uint16_t {
     INPUT = 0x0100,
@@ -122,12 +172,22 @@ CP2112::CP2112() : ownCtx_(true) {
   if (rc != 0) {
     throw LibusbError(rc, "failed to initialize libusb");
   }
+  transport_ = std::make_unique<LibusbTransport>(ctx_, VENDOR_ID, PRODUCT_ID);
 }
 
-CP2112::CP2112(libusb_context* ctx) : ctx_(ctx), ownCtx_(false) {}
+CP2112::CP2112(libusb_context* ctx)
+    : ctx_(ctx),
+      transport_(
+          std::make_unique<LibusbTransport>(ctx_, VENDOR_ID, PRODUCT_ID)),
+      ownCtx_(false) {}
+
+CP2112::CP2112(std::unique_ptr<UsbTransport> transport)
+    : transport_(std::move(transport)), ownCtx_(false) {}
 
 CP2112::~CP2112() {
   close();
+  // The transport has to let go of the device before the context goes away
+  transport_.reset();
   if (ctx_ && ownCtx_) {
     libusb_exit(ctx_);
   }
@@ -149,8 +209,7 @@ void CP2112::open(bool setSmbusConfig) {
 }
 
 void CP2112::close() {
-  handle_.close();
-  dev_.reset();
+  transport_->close();
 }
 
 void CP2112::resetFromUserver() {
@@ -302,16 +361,14 @@ void CP2112::read(uint8_t address, MutableByteRange buf, milliseconds timeout) {
   }
   ensureGoodState();
 
-  // Send the read request
+  // Send the read request, and wait for the response data
   uint8_t usbBuf[64];
   usbBuf[0] = ReportID::READ_REQUEST;
   usbBuf[1] = address;
   setBE<uint16_t>(usbBuf + 2, buf.size());
-  intrOut("read", usbBuf, sizeof(usbBuf), timeout);
 
-  // Wait for the response data
   try {
-    processReadResponse(buf, timeout);
+    processReadResponse(buf, timeout, usbBuf);
   } catch (UsbError& e) {
     XLOG(DBG5) << "CP2112 i2c read error";
     // Increment the counter for I2c read failure and throw error
@@ -349,12 +406,10 @@ void CP2112::write(uint8_t address, ByteRange buf, milliseconds timeout) {
   usbBuf[2] = buf.size();
   memcpy(usbBuf + 3, buf.begin(), buf.size());
 
-  // Wait for the write to complete
+  // Send the write request, and wait for the write to complete
   auto end = steady_clock::now() + timeout;
-  intrOut("write request", usbBuf, sizeof(usbBuf), timeout);
-
   try {
-    waitForTransfer("write", end);
+    waitForTransfer("write", end, buf.size(), usbBuf);
   } catch (UsbError& e) {
     XLOG(DBG5) << "cp2112 i2c write error";
     // Increment the counter for I2c write failure and throw error
@@ -403,11 +458,10 @@ void CP2112::writeReadUnsafe(
   setBE<uint16_t>(usbBuf + 2, readBuf.size());
   usbBuf[4] = writeBuf.size();
   memcpy(usbBuf + 5, writeBuf.begin(), writeBuf.size());
-  intrOut("addressed read", usbBuf, sizeof(usbBuf), timeout);
 
   // Wait for the response data
   try {
-    processReadResponse(readBuf, timeout);
+    processReadResponse(readBuf, timeout, usbBuf);
   } catch (UsbError& e) {
     LOG(ERROR) << "cp2112 i2c write read error";
     // Increment the counter for I2c write and read failure, then throw error
@@ -423,9 +477,7 @@ void CP2112::writeReadUnsafe(
 }
 
 void CP2112::openDevice() {
-  dev_ = UsbDevice::find(ctx_, VENDOR_ID, PRODUCT_ID);
-  handle_ = dev_.open();
-  handle_.claimInterface(0);
+  transport_->open();
 }
 
 void CP2112::initSettings() {
@@ -581,7 +633,10 @@ std::string CP2112::getCompleteStatusMsg(uint8_t status1) {
   return folly::to<std::string>("unexpected failure status=", status1);
 }
 
-void CP2112::processReadResponse(MutableByteRange buf, milliseconds timeout) {
+void CP2112::processReadResponse(
+    MutableByteRange buf,
+    milliseconds timeout,
+    const uint8_t* request) {
   // Wait for the read response data from the device.
   //
   // This is unfortunately quite tricky and fragile.  The device's autoSendRead
@@ -614,24 +669,20 @@ void CP2112::processReadResponse(MutableByteRange buf, milliseconds timeout) {
   // for this request.  By using XFER_STATUS_REQUEST we know that any
   // READ_RESPONSE we receive right now is extraneous.)
   auto end = steady_clock::now() + timeout;
-  milliseconds timeLeft = waitForTransfer("read", end);
+  milliseconds timeLeft = waitForTransfer("read", end, buf.size(), request);
 
   // The device has finished reading data from the I2C bus.
   // Now we just have to read it over USB.
   uint8_t usbBuf[64];
+  uint8_t forceSendBuf[64];
+  forceSendBuf[0] = ReportID::READ_FORCE_SEND;
+  forceSendBuf[1] = 1;
   uint16_t bytesRead{0};
   bool sendRead = true;
+  auto pollInterval = initialPollInterval(0);
   while (true) {
-    // Send READ_FORCE_SEND if we think the device won't send data to us
-    // otherwise.
-    if (sendRead) {
-      usbBuf[0] = ReportID::READ_FORCE_SEND;
-      usbBuf[1] = 1;
-      intrOut("read force send", usbBuf, sizeof(usbBuf), milliseconds(5));
-      sendRead = false;
-    }
-
-    // Wait for a READ_RESPONSE.
+    // Wait for a READ_RESPONSE, sending READ_FORCE_SEND first if we think the
+    // device won't send data to us otherwise.
     // We use a fixed 10ms timeout here, regardless of timeLeft.
     // libusb doesn't deal very well with timeouts much smaller than this.
     // If we set the timeout too low, we may time out even though the device is
@@ -641,7 +692,16 @@ void CP2112::processReadResponse(MutableByteRange buf, milliseconds timeout) {
     // avoid this case, though.  I haven't seen the device get stuck waiting on
     // READ_FORCE_SEND yet with the current logic.)
     try {
-      intrIn(usbBuf, sizeof(usbBuf), milliseconds(10));
+      if (sendRead) {
+        sendRead = false;
+        intrOutIn(
+            {{"read force send", forceSendBuf}},
+            milliseconds(5),
+            usbBuf,
+            milliseconds(10));
+      } else {
+        intrIn(usbBuf, sizeof(usbBuf), milliseconds(10));
+      }
     } catch (const LibusbError& ex) {
       VLOG(1) << "timed out waiting on READ_RESPONSE, sending READ_FORCE_SEND";
       // If we timed out, send a READ_FORCE_SEND and keep trying.
@@ -649,7 +709,7 @@ void CP2112::processReadResponse(MutableByteRange buf, milliseconds timeout) {
       if (ex.errorCode() != LIBUSB_ERROR_TIMEOUT) {
         throw;
       }
-      timeLeft = updateTimeLeft(end, false);
+      timeLeft = updateTimeLeft(end, microseconds(0));
       if (timeLeft <= milliseconds(0)) {
         throw UsbError("timed out waiting on read response data");
       }
@@ -707,8 +767,12 @@ void CP2112::processReadResponse(MutableByteRange buf, milliseconds timeout) {
 
     // If we are still here the transaction is still in progress.
     // Update timeLeft.  If no data was returned, also sleep briefly to avoid
-    // spinning on the CPU.
-    bool sleep = (length == 0);
+    // spinning on the CPU, backing off while no data comes.
+    auto sleep = microseconds(0);
+    if (length == 0) {
+      sleep = pollInterval;
+      pollInterval = nextPollInterval(pollInterval);
+    }
     timeLeft = updateTimeLeft(end, sleep);
     if (timeLeft <= milliseconds(0)) {
       throw UsbError("timed out waiting on read response data");
@@ -732,20 +796,35 @@ void CP2112::getTransferStatusImpl(
     uint8_t* usbBuf,
     milliseconds timeout,
     StringPiece operation,
-    uint32_t loopIter) {
+    uint32_t loopIter,
+    const uint8_t* request) {
   uint16_t bufSize = 64;
 
-  // Send an XFER_STATUS_REQUEST
-  usbBuf[0] = ReportID::XFER_STATUS_REQUEST;
-  usbBuf[1] = 1;
+  // Send an XFER_STATUS_REQUEST, after the request starting the transfer if
+  // there is one.
+  uint8_t statusRequest[64];
+  statusRequest[0] = ReportID::XFER_STATUS_REQUEST;
+  statusRequest[1] = 1;
 
-  intrOut("get xfer status", usbBuf, bufSize, timeout);
   // Wait for the XFER_STATUS_RESPONSE.  Note that we ignore timeout here,
   // and always pass in a fixed timeout of 20ms.  The device should return
   // a XFER_STATUS_RESPONSE here.  If we time out in libusb and fail to
   // read it here, this may confuse state later on, as we will read the
   // XFER_STATUS_RESPONSE when we aren't expecting it.
-  intrIn(usbBuf, bufSize, milliseconds(20));
+  if (request) {
+    auto requestName = folly::to<std::string>(operation, " request");
+    intrOutIn(
+        {{requestName, request}, {"get xfer status", statusRequest}},
+        timeout,
+        usbBuf,
+        milliseconds(20));
+  } else {
+    intrOutIn(
+        {{"get xfer status", statusRequest}},
+        timeout,
+        usbBuf,
+        milliseconds(20));
+  }
 
   if (usbBuf[0] == ReportID::READ_RESPONSE) {
     // It is slightly tricky to anticipate how many READ_RESPONSE packets
@@ -781,15 +860,23 @@ void CP2112::getTransferStatusImpl(
 
 milliseconds CP2112::waitForTransfer(
     StringPiece operation,
-    steady_clock::time_point end) {
+    steady_clock::time_point end,
+    size_t length,
+    const uint8_t* request) {
   auto now = steady_clock::now();
   milliseconds timeLeft = duration_cast<milliseconds>(end - now);
 
   uint8_t usbBuf[64];
   uint32_t loopIter{0};
+  auto pollInterval = initialPollInterval(length);
   while (true) {
     ++loopIter;
-    getTransferStatusImpl(usbBuf, timeLeft, operation, loopIter);
+    getTransferStatusImpl(
+        usbBuf,
+        timeLeft,
+        operation,
+        loopIter,
+        loopIter == 1 ? request : nullptr);
 
     uint8_t status0 = usbBuf[1];
     uint8_t status1 = usbBuf[2];
@@ -818,7 +905,8 @@ milliseconds CP2112::waitForTransfer(
           " completion");
     }
 
-    timeLeft = updateTimeLeft(end, true);
+    timeLeft = updateTimeLeft(end, pollInterval);
+    pollInterval = nextPollInterval(pollInterval);
     if (timeLeft < milliseconds(0)) {
       cancelTransfer();
       throw UsbError(
@@ -830,16 +918,16 @@ milliseconds CP2112::waitForTransfer(
   }
 }
 
-milliseconds CP2112::updateTimeLeft(steady_clock::time_point end, bool sleep) {
+milliseconds CP2112::updateTimeLeft(
+    steady_clock::time_point end,
+    microseconds sleep) {
   auto now = steady_clock::now();
-  auto timeLeft = duration_cast<milliseconds>(end - now);
-  if (timeLeft >= milliseconds(0) && sleep) {
-    auto sleepDuration = std::min(timeLeft, milliseconds(10));
-    usleep(sleepDuration.count() * 1000);
-    timeLeft -= sleepDuration;
+  if (now < end && sleep > microseconds(0)) {
+    std::this_thread::sleep_for(
+        std::min<microseconds>(duration_cast<microseconds>(end - now), sleep));
+    now = steady_clock::now();
   }
-
-  return timeLeft;
+  return duration_cast<milliseconds>(end - now);
 }
 
 uint16_t
@@ -851,16 +939,8 @@ CP2112::featureReportIn(ReportID report, uint8_t* buf, uint16_t length) {
   uint8_t bRequest = Hid::GET_REPORT;
   uint16_t wValue = ReportType::FEATURE | static_cast<uint16_t>(report);
   uint16_t wIndex = 0; // the interface index
-  unsigned int timeoutMS = 1000;
-  int rc = libusb_control_transfer(
-      handle_.handle(),
-      bRequestType,
-      bRequest,
-      wValue,
-      wIndex,
-      buf,
-      length,
-      timeoutMS);
+  int rc = transport_->controlTransfer(
+      bRequestType, bRequest, wValue, wIndex, buf, length, milliseconds(1000));
   if (rc < 0) {
     throw LibusbError(rc, "failed to get feature report ", report);
   }
@@ -894,16 +974,14 @@ void CP2112::featureReportOut(
   uint8_t bRequest = Hid::SET_REPORT;
   uint16_t wValue = ReportType::FEATURE | static_cast<uint16_t>(report);
   uint16_t wIndex = 0; // the interface index
-  unsigned int timeoutMS = 1000;
-  int rc = libusb_control_transfer(
-      handle_.handle(),
+  int rc = transport_->controlTransfer(
       bRequestType,
       bRequest,
       wValue,
       wIndex,
       const_cast<uint8_t*>(buf),
       length,
-      timeoutMS);
+      milliseconds(1000));
   if (rc < 0) {
     throw LibusbError(rc, "failed to set feature report ", report);
   }
@@ -927,10 +1005,6 @@ void CP2112::intrOut(
   DCHECK_EQ(length, 64);
   vlogHex(6, "intr out:", buf, length);
 
-  // The CP2112 always uses endpoint 1 for interrupt transfers.
-  uint8_t outEndpoint = LIBUSB_ENDPOINT_OUT | 1;
-  int lenResult;
-
   // Always pass in a timeout of at least 5ms, even if the caller specifies
   // something smaller.  We generally don't want to timeout inside
   // libusb calls--if this occurs we can't easily tell if the tranfer was sent
@@ -938,47 +1012,104 @@ void CP2112::intrOut(
   //
   // This minimum timeout helps ensure that we timeout inside our own timeout
   // checks, and not inside libusb calls.
-  int usbTimeout = std::max(timeout.count(), 5L);
-
-  int rc = libusb_interrupt_transfer(
-      handle_.handle(),
-      outEndpoint,
+  auto transfer = makeIntrTransfer(
+      kIntrOutEndpoint,
       const_cast<uint8_t*>(buf),
       length,
-      &lenResult,
-      usbTimeout);
-  if (rc != 0) {
-    busGood_ = false;
-    throw LibusbError(rc, "failed to send ", name, " request");
-  }
+      std::max(timeout, milliseconds(5)));
+  transport_->submit(&transfer);
+  transport_->wait(&transfer);
+  checkIntrOut(name, transfer);
 }
 
 void CP2112::intrIn(uint8_t* buf, uint16_t length, milliseconds timeout) {
   // The CP2112 always uses 64-byte interrupt transfers.
   DCHECK_EQ(length, 64);
 
-  // The CP2112 always uses endpoint 1 for interrupt transfers.
-  uint8_t outEndpoint = LIBUSB_ENDPOINT_IN | 1;
-  int lenResult;
-
   // Pass in a timeout of at least 1ms for libusb.
   // With a timeout of 0 libusb won't even bother checking for available data,
   // it just returns a timeout error immediately.
-  int usbTimeout = std::max(timeout.count(), 1L);
-  int rc = libusb_interrupt_transfer(
-      handle_.handle(), outEndpoint, buf, length, &lenResult, usbTimeout);
-  if (rc != 0) {
+  auto transfer = makeIntrTransfer(
+      kIntrInEndpoint, buf, length, std::max(timeout, milliseconds(1)));
+  transport_->submit(&transfer);
+  transport_->wait(&transfer);
+  checkIntrIn(transfer);
+}
+
+void CP2112::intrOutIn(
+    std::initializer_list<IntrRequest> requests,
+    milliseconds timeout,
+    uint8_t* response,
+    milliseconds responseTimeout) {
+  if (!FLAGS_cp2112_async_transfers) {
+    for (const auto& request : requests) {
+      intrOut(request.name, request.buf, 64, timeout);
+    }
+    intrIn(response, 64, responseTimeout);
+    return;
+  }
+
+  // Submit the transfer picking up the response first, so that it completes
+  // in the first USB frame the response is available, and the requests
+  // back to back.  Same minimum timeouts as intrOut() and intrIn().
+  auto responseTransfer = makeIntrTransfer(
+      kIntrInEndpoint,
+      response,
+      64,
+      std::max(responseTimeout, milliseconds(1)));
+  transport_->submit(&responseTransfer);
+
+  std::vector<UsbInterruptTransfer> requestTransfers;
+  requestTransfers.reserve(requests.size());
+  for (const auto& request : requests) {
+    vlogHex(6, "intr out:", request.buf, 64);
+    requestTransfers.push_back(makeIntrTransfer(
+        kIntrOutEndpoint,
+        const_cast<uint8_t*>(request.buf),
+        64,
+        std::max(timeout, milliseconds(5))));
+  }
+  for (auto& transfer : requestTransfers) {
+    transport_->submit(&transfer);
+  }
+
+  // Every transfer has to be done before its buffer goes away, even if an
+  // earlier one failed.
+  for (auto& transfer : requestTransfers) {
+    transport_->wait(&transfer);
+  }
+  transport_->wait(&responseTransfer);
+
+  auto request = requests.begin();
+  for (const auto& transfer : requestTransfers) {
+    checkIntrOut(request->name, transfer);
+    ++request;
+  }
+  checkIntrIn(responseTransfer);
+}
+
+void CP2112::checkIntrOut(
+    StringPiece name,
+    const UsbInterruptTransfer& transfer) {
+  if (transfer.status != 0) {
+    busGood_ = false;
+    throw LibusbError(transfer.status, "failed to send ", name, " request");
+  }
+}
+
+void CP2112::checkIntrIn(const UsbInterruptTransfer& transfer) {
+  if (transfer.status != 0) {
     busGood_ = false;
-    throw LibusbError(rc, "error waiting for interrupt response");
+    throw LibusbError(transfer.status, "error waiting for interrupt response");
   }
-  if (lenResult != 64) {
+  if (transfer.actualLength != 64) {
     busGood_ = false;
     throw UsbError(
         "unexpected interrupt response length received from "
         "CP2112:",
-        lenResult);
+        transfer.actualLength);
   }
-  vlogHex(6, "intr in:", buf, length);
+  vlogHex(6, "intr in:", transfer.buf, transfer.length);
 }
 
 bool CP2112::SMBusConfig::operator==(const SMBusConfig& other) const {
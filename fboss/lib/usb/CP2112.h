@@ -10,15 +10,14 @@
 #pragma once
 
 #include "fboss/lib/i2c/I2cController.h"
-#include "fboss/lib/usb/UsbDevice.h"
-#include "fboss/lib/usb/UsbHandle.h"
+#include "fboss/lib/usb/UsbTransport.h"
 
 #include <folly/Range.h>
 
 #include <chrono>
 #include <cstdint>
-
-struct libusb_transfer;
+#include <initializer_list>
+#include <memory>
 
 namespace facebook::fboss {
 class CP2112Intf : public I2cController {
@@ -84,6 +83,11 @@ class CP2112Intf : public I2cController {
  * implement a non-blocking API, but Linux's standard I2C APIs only provide
  * blocking APIs.  Code that wants to deal with other I2C interfaces therefore
  * already has to support blocking operation.
+ *
+ * Under the hood, USB interrupt transfers are asynchronous: with
+ * --cp2112_async_transfers, each request is submitted along with the first
+ * transfer status request and the transfer picking up the response, rather
+ * than waiting a USB frame for each of them in turn.
  */
 class CP2112 : public CP2112Intf {
  public:
@@ -258,12 +262,14 @@ class CP2112 : public CP2112Intf {
 
   CP2112();
   explicit CP2112(libusb_context* ctx);
+  // Talk to the device through the given transport, e.g. a fake device
+  explicit CP2112(std::unique_ptr<UsbTransport> transport);
   ~CP2112() override;
 
   void open(bool setSmbusConfig = true) override;
   void close() override;
   bool isOpen() const override {
-    return handle_.isOpen();
+    return transport_->isOpen();
   }
 
   std::chrono::milliseconds getDefaultTimeout() const override {
@@ -411,20 +417,30 @@ class CP2112 : public CP2112Intf {
 
   static std::string getBusyStatusMsg(uint8_t status1);
   static std::string getCompleteStatusMsg(uint8_t status1);
+
+  /*
+   * Wait for the transfer to complete and read its response data. The
+   * request starting the transfer, if given, is sent along with the first
+   * transfer status request.
+   */
   void processReadResponse(
       folly::MutableByteRange buf,
-      std::chrono::milliseconds timeout);
+      std::chrono::milliseconds timeout,
+      const uint8_t* request = nullptr);
   void getTransferStatusImpl(
       uint8_t* usbBuf,
       std::chrono::milliseconds timeout,
       folly::StringPiece operation,
-      uint32_t loopIter);
+      uint32_t loopIter,
+      const uint8_t* request = nullptr);
   std::chrono::milliseconds waitForTransfer(
       folly::StringPiece operation,
-      std::chrono::steady_clock::time_point end);
+      std::chrono::steady_clock::time_point end,
+      size_t length,
+      const uint8_t* request = nullptr);
   std::chrono::milliseconds updateTimeLeft(
       std::chrono::steady_clock::time_point end,
-      bool sleep);
+      std::chrono::microseconds sleep);
 
   uint16_t featureReportIn(ReportID report, uint8_t* buf, uint16_t length);
   void fullFeatureReportIn(ReportID report, uint8_t* buf, uint16_t length);
@@ -436,9 +452,27 @@ class CP2112 : public CP2112Intf {
       std::chrono::milliseconds timeout);
   void intrIn(uint8_t* buf, uint16_t length, std::chrono::milliseconds timeout);
 
+  /*
+   * Send interrupt out requests, then receive the interrupt in response to
+   * the last one.
+   */
+  struct IntrRequest {
+    folly::StringPiece name;
+    const uint8_t* buf;
+  };
+  void intrOutIn(
+      std::initializer_list<IntrRequest> requests,
+      std::chrono::milliseconds timeout,
+      uint8_t* response,
+      std::chrono::milliseconds responseTimeout);
+
+  void checkIntrOut(
+      folly::StringPiece name,
+      const UsbInterruptTransfer& transfer);
+  void checkIntrIn(const UsbInterruptTransfer& transfer);
+
   libusb_context* ctx_{nullptr};
-  UsbDevice dev_;
-  UsbHandle handle_;
+  std::unique_ptr<UsbTransport> transport_;
   bool ownCtx_{false};
   bool busGood_{true};
   std::chrono::milliseconds defaultTimeout_{500};
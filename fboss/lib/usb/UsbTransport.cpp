@@ -0,0 +1,144 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/lib/usb/UsbTransport.h"
+
+#include <glog/logging.h>
+
+#include <libusb-1.0/libusb.h>
+
+namespace {
+
+// Same mapping as libusb's synchronous API
+int toErrorCode(libusb_transfer_status status) {
+  switch (status) {
+    case LIBUSB_TRANSFER_COMPLETED:
+      return 0;
+    case LIBUSB_TRANSFER_TIMED_OUT:
+      return LIBUSB_ERROR_TIMEOUT;
+    case LIBUSB_TRANSFER_STALL:
+      return LIBUSB_ERROR_PIPE;
+    case LIBUSB_TRANSFER_OVERFLOW:
+      return LIBUSB_ERROR_OVERFLOW;
+    case LIBUSB_TRANSFER_NO_DEVICE:
+      return LIBUSB_ERROR_NO_DEVICE;
+    case LIBUSB_TRANSFER_CANCELLED:
+      return LIBUSB_ERROR_INTERRUPTED;
+    case LIBUSB_TRANSFER_ERROR:
+      break;
+  }
+  return LIBUSB_ERROR_IO;
+}
+
+void LIBUSB_CALL transferDone(libusb_transfer* usbTransfer) {
+  auto transfer = static_cast<facebook::fboss::UsbInterruptTransfer*>(
+      usbTransfer->user_data);
+  transfer->status = toErrorCode(usbTransfer->status);
+  transfer->actualLength = usbTransfer->actual_length;
+  transfer->completed = true;
+}
+
+} // namespace
+
+namespace facebook::fboss {
+
+LibusbTransport::LibusbTransport(
+    libusb_context* ctx,
+    uint16_t vendorId,
+    uint16_t productId)
+    : ctx_(ctx), vendorId_(vendorId), productId_(productId) {}
+
+LibusbTransport::~LibusbTransport() {
+  close();
+}
+
+void LibusbTransport::open() {
+  dev_ = UsbDevice::find(ctx_, vendorId_, productId_);
+  handle_ = dev_.open();
+  handle_.claimInterface(0);
+}
+
+void LibusbTransport::close() {
+  handle_.close();
+  dev_.reset();
+}
+
+int LibusbTransport::controlTransfer(
+    uint8_t requestType,
+    uint8_t request,
+    uint16_t value,
+    uint16_t index,
+    uint8_t* buf,
+    uint16_t length,
+    std::chrono::milliseconds timeout) {
+  CHECK(isOpen());
+  return libusb_control_transfer(
+      handle_.handle(),
+      requestType,
+      request,
+      value,
+      index,
+      buf,
+      length,
+      timeout.count());
+}
+
+void LibusbTransport::submit(UsbInterruptTransfer* transfer) {
+  CHECK(isOpen());
+  transfer->completed = false;
+  transfer->actualLength = 0;
+  auto usbTransfer = libusb_alloc_transfer(0);
+  if (!usbTransfer) {
+    transfer->status = LIBUSB_ERROR_NO_MEM;
+    transfer->completed = true;
+    return;
+  }
+  libusb_fill_interrupt_transfer(
+      usbTransfer,
+      handle_.handle(),
+      transfer->endpoint,
+      transfer->buf,
+      transfer->length,
+      &transferDone,
+      transfer,
+      transfer->timeout.count());
+
+  int rc = libusb_submit_transfer(usbTransfer);
+  if (rc != 0) {
+    libusb_free_transfer(usbTransfer);
+    transfer->status = rc;
+    transfer->completed = true;
+    return;
+  }
+  transfer->impl = usbTransfer;
+}
+
+void LibusbTransport::wait(UsbInterruptTransfer* transfer) {
+  auto usbTransfer = static_cast<libusb_transfer*>(transfer->impl);
+  if (!usbTransfer) {
+    // Failed to submit
+    return;
+  }
+
+  // The completion callback runs from libusb_handle_events, on this thread
+  bool cancelled = false;
+  while (!transfer->completed) {
+    int rc = libusb_handle_events_completed(ctx_, nullptr);
+    if (rc < 0 && rc != LIBUSB_ERROR_INTERRUPTED && !cancelled) {
+      // The transfer still has to complete before it can be freed
+      VLOG(1) << "error handling USB events: " << libusb_error_name(rc);
+      libusb_cancel_transfer(usbTransfer);
+      cancelled = true;
+    }
+  }
+  libusb_free_transfer(usbTransfer);
+  transfer->impl = nullptr;
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,120 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/lib/usb/UsbDevice.h"
+#include "fboss/lib/usb/UsbHandle.h"
+
+#include <chrono>
+#include <cstdint>
+
+struct libusb_context;
+
+namespace facebook::fboss {
+
+/*
+ * An interrupt transfer to or from a USB device.
+ */
+struct UsbInterruptTransfer {
+  uint8_t endpoint{0};
+  uint8_t* buf{nullptr};
+  uint16_t length{0};
+  std::chrono::milliseconds timeout{0};
+
+  // Set once the transfer is done. status is 0 on success, or a libusb
+  // error code.
+  bool completed{false};
+  int status{0};
+  int actualLength{0};
+
+  // State of the transport while the transfer is in flight
+  void* impl{nullptr};
+};
+
+/*
+ * The USB transfers used by the CP2112 driver.
+ *
+ * Interrupt transfers are asynchronous, so that a request and the transfer
+ * picking up its response can be in flight at the same time. Transfers on
+ * the same endpoint complete in the order they were submitted.
+ */
+class UsbTransport {
+ public:
+  virtual ~UsbTransport() {}
+
+  virtual void open() = 0;
+  virtual void close() = 0;
+  virtual bool isOpen() const = 0;
+
+  /*
+   * Synchronous control transfer. Returns the number of bytes transferred,
+   * or a negative libusb error code.
+   */
+  virtual int controlTransfer(
+      uint8_t requestType,
+      uint8_t request,
+      uint16_t value,
+      uint16_t index,
+      uint8_t* buf,
+      uint16_t length,
+      std::chrono::milliseconds timeout) = 0;
+
+  /*
+   * Start an interrupt transfer. Failures to submit complete the transfer
+   * right away.
+   */
+  virtual void submit(UsbInterruptTransfer* transfer) = 0;
+
+  /*
+   * Wait until a submitted transfer completed, failed or timed out.
+   */
+  virtual void wait(UsbInterruptTransfer* transfer) = 0;
+};
+
+/*
+ * UsbTransport for a device found by its vendor and product ID, through
+ * libusb's asynchronous API.
+ */
+class LibusbTransport : public UsbTransport {
+ public:
+  LibusbTransport(libusb_context* ctx, uint16_t vendorId, uint16_t productId);
+  ~LibusbTransport() override;
+
+  void open() override;
+  void close() override;
+  bool isOpen() const override {
+    return handle_.isOpen();
+  }
+
+  int controlTransfer(
+      uint8_t requestType,
+      uint8_t request,
+      uint16_t value,
+      uint16_t index,
+      uint8_t* buf,
+      uint16_t length,
+      std::chrono::milliseconds timeout) override;
+
+  void submit(UsbInterruptTransfer* transfer) override;
+  void wait(UsbInterruptTransfer* transfer) override;
+
+ private:
+  // Forbidden copy constructor and assignment operator
+  LibusbTransport(LibusbTransport const&) = delete;
+  LibusbTransport& operator=(LibusbTransport const&) = delete;
+
+  libusb_context* ctx_{nullptr};
+  const uint16_t vendorId_;
+  const uint16_t productId_;
+  UsbDevice dev_;
+  UsbHandle handle_;
+};
+
+} // namespace facebook::fboss
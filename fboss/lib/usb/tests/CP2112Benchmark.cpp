@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/lib/usb/CP2112.h"
+#include "fboss/lib/usb/tests/FakeCP2112Device.h"
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include <array>
+
+DECLARE_bool(cp2112_async_transfers);
+
+using namespace facebook::fboss;
+
+/*
+ * Benchmarks for a refresh of the management pages of 32 transceivers
+ * behind a CP2112 and a tree of muxes, against a fake device with USB frame
+ * and SMBus timings. For each port the mux is selected, then the page is
+ * read at offset 128.
+ */
+
+namespace {
+
+constexpr auto kNumPorts = 32;
+constexpr uint8_t kMuxAddr = 0xe0;
+constexpr uint8_t kQsfpAddr = 0xa0;
+
+void refreshPorts(bool async, size_t numIters) {
+  folly::BenchmarkSuspender suspender;
+  gflags::FlagSaver flagSaver;
+  FLAGS_cp2112_async_transfers = async;
+  auto device = std::make_unique<FakeCP2112Device>();
+  device->device(kMuxAddr);
+  device->device(kQsfpAddr);
+  CP2112 cp2112(std::move(device));
+  cp2112.open();
+  suspender.dismiss();
+
+  std::array<uint8_t, 128> page;
+  for (size_t n = 0; n < numIters; ++n) {
+    for (uint8_t port = 0; port < kNumPorts; ++port) {
+      cp2112.writeByte(kMuxAddr, 1 << (port % 8));
+      cp2112.writeByte(kQsfpAddr, 128);
+      cp2112.read(kQsfpAddr, folly::MutableByteRange(page.data(), page.size()));
+    }
+  }
+}
+
+} // unnamed namespace
+
+BENCHMARK(RefreshPortsSync, numIters) {
+  refreshPorts(false, numIters);
+}
+
+BENCHMARK_RELATIVE(RefreshPortsAsync, numIters) {
+  refreshPorts(true, numIters);
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,97 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/lib/usb/CP2112.h"
+#include "fboss/lib/usb/UsbError.h"
+#include "fboss/lib/usb/tests/FakeCP2112Device.h"
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <array>
+
+DECLARE_bool(cp2112_async_transfers);
+
+using namespace facebook::fboss;
+
+namespace {
+constexpr uint8_t kMuxAddr = 0xe0;
+constexpr uint8_t kQsfpAddr = 0xa0;
+
+// Run every test with and without async transfers
+class CP2112Test : public ::testing::TestWithParam<bool> {
+ public:
+  void SetUp() override {
+    FLAGS_cp2112_async_transfers = GetParam();
+    auto device = std::make_unique<FakeCP2112Device>();
+    device_ = device.get();
+    for (int i = 0; i < 256; ++i) {
+      device_->device(kQsfpAddr)[i] = i;
+    }
+    device_->device(kMuxAddr);
+    cp2112_ = std::make_unique<CP2112>(std::move(device));
+    cp2112_->open();
+  }
+
+ protected:
+  uint8_t readByte(uint8_t address) {
+    uint8_t value{0};
+    cp2112_->read(address, folly::MutableByteRange(&value, 1));
+    return value;
+  }
+
+  gflags::FlagSaver flagSaver_;
+  FakeCP2112Device* device_{nullptr};
+  std::unique_ptr<CP2112> cp2112_;
+};
+} // namespace
+
+TEST_P(CP2112Test, readWrite) {
+  std::array<uint8_t, 4> data{10, 1, 2, 3};
+  cp2112_->write(kQsfpAddr, folly::ByteRange(data.data(), data.size()));
+  EXPECT_EQ(device_->device(kQsfpAddr)[12], 3);
+
+  uint8_t offset = 10;
+  cp2112_->write(kQsfpAddr, folly::ByteRange(&offset, 1));
+  std::array<uint8_t, 4> buf{};
+  cp2112_->read(kQsfpAddr, folly::MutableByteRange(buf.data(), buf.size()));
+  EXPECT_EQ(buf, (std::array<uint8_t, 4>{1, 2, 3, 13}));
+}
+
+TEST_P(CP2112Test, multiResponseRead) {
+  // Takes several READ_RESPONSE reports
+  uint8_t offset = 0;
+  std::array<uint8_t, 200> buf{};
+  cp2112_->writeReadUnsafe(
+      kQsfpAddr,
+      folly::ByteRange(&offset, 1),
+      folly::MutableByteRange(buf.data(), buf.size()));
+  for (int i = 0; i < buf.size(); ++i) {
+    EXPECT_EQ(buf[i], i);
+  }
+  EXPECT_EQ(readByte(kQsfpAddr), 200);
+}
+
+TEST_P(CP2112Test, addressNotAcknowledged) {
+  std::array<uint8_t, 4> buf{};
+  EXPECT_THROW(
+      cp2112_->read(0x50, folly::MutableByteRange(buf.data(), buf.size())),
+      UsbError);
+  EXPECT_THROW(cp2112_->writeByte(0x50, 1), UsbError);
+
+  // The device is still in sync with us
+  cp2112_->writeByte(kQsfpAddr, 128);
+  EXPECT_EQ(readByte(kQsfpAddr), 128);
+}
+
+INSTANTIATE_TEST_CASE_P(
+    CP2112Test,
+    CP2112Test,
+    ::testing::Values(false, true));
@@ -0,0 +1,341 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/lib/usb/UsbTransport.h"
+
+#include <glog/logging.h>
+#include <libusb-1.0/libusb.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * A CP2112 behind a fake USB transport, with I2C devices on its bus.
+ *
+ * Interrupt transfers complete on USB frame boundaries: the device takes
+ * one request per frame, and a response is picked up in the first frame
+ * after it is ready that an IN transfer is waiting for it. SMBus transfers
+ * take the time to clock their bytes out. Waiting for a transfer sleeps
+ * until it completes, so that benchmarks see realistic latencies.
+ */
+class FakeCP2112Device : public UsbTransport {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using Report = std::array<uint8_t, 64>;
+
+  FakeCP2112Device() : epoch_(Clock::now()) {}
+
+  void open() override {
+    open_ = true;
+  }
+  void close() override {
+    open_ = false;
+  }
+  bool isOpen() const override {
+    return open_;
+  }
+
+  int controlTransfer(
+      uint8_t requestType,
+      uint8_t /* request */,
+      uint16_t value,
+      uint16_t /* index */,
+      uint8_t* buf,
+      uint16_t length,
+      std::chrono::milliseconds /* timeout */) override {
+    uint8_t report = value & 0xff;
+    if (requestType & LIBUSB_ENDPOINT_IN) {
+      std::memset(buf, 0, length);
+      buf[0] = report;
+      if (report == kGetVersion) {
+        buf[1] = 0x0c;
+        buf[2] = 2;
+      } else if (report == kSmbusConfig) {
+        std::memcpy(buf, smbusConfig_.data(), length);
+      }
+      return length;
+    }
+    if (report == kResetDevice) {
+      // The device drops off the bus to re-enumerate
+      return LIBUSB_ERROR_PIPE;
+    }
+    if (report == kSmbusConfig) {
+      std::memcpy(smbusConfig_.data(), buf, length);
+    }
+    return length;
+  }
+
+  void submit(UsbInterruptTransfer* transfer) override {
+    CHECK(open_);
+    ++numIntrTransfers_;
+    transfer->completed = false;
+    auto now = Clock::now();
+    if (transfer->endpoint & LIBUSB_ENDPOINT_IN) {
+      inQueue_.push_back({transfer, now, {}});
+      return;
+    }
+    // The device takes one request per frame
+    auto at = std::max(nextFrame(now), lastOutAt_ + frameInterval_);
+    lastOutAt_ = at;
+    Pending pending{transfer, at, {}};
+    std::memcpy(pending.report.data(), transfer->buf, transfer->length);
+    outQueue_.push_back(pending);
+  }
+
+  void wait(UsbInterruptTransfer* transfer) override {
+    while (!transfer->completed) {
+      CHECK(step()) << "waiting on a transfer that was never submitted";
+    }
+  }
+
+  /*
+   * Memory of the I2C device at an address, in the on-the-wire format. The
+   * first byte of a write sets the offset to access, the rest are written
+   * from there on. Reads go on from the offset.
+   */
+  std::array<uint8_t, 256>& device(uint8_t address) {
+    return devices_[address].mem;
+  }
+
+  void setFrameInterval(std::chrono::microseconds interval) {
+    frameInterval_ = interval;
+  }
+
+  void setByteTime(std::chrono::nanoseconds byteTime) {
+    byteTime_ = byteTime;
+  }
+
+  uint32_t getNumIntrTransfers() const {
+    return numIntrTransfers_;
+  }
+
+ private:
+  // Report IDs, see CP2112::ReportID
+  enum : uint8_t {
+    kResetDevice = 0x01,
+    kGetVersion = 0x05,
+    kSmbusConfig = 0x06,
+    kReadRequest = 0x10,
+    kWriteReadRequest = 0x11,
+    kReadForceSend = 0x12,
+    kReadResponse = 0x13,
+    kWrite = 0x14,
+    kXferStatusRequest = 0x15,
+    kXferStatusResponse = 0x16,
+    kCancelXfer = 0x17,
+  };
+
+  struct Device {
+    std::array<uint8_t, 256> mem{};
+    uint8_t offset{0};
+  };
+
+  struct Pending {
+    UsbInterruptTransfer* transfer;
+    Clock::time_point at;
+    Report report;
+  };
+
+  // The SMBus transfer in progress or last completed
+  struct SmbusTransfer {
+    bool active{false};
+    bool isRead{false};
+    bool failed{false};
+    Clock::time_point doneAt;
+    std::vector<uint8_t> data;
+  };
+
+  Clock::time_point nextFrame(Clock::time_point time) const {
+    auto frames = (time - epoch_ + frameInterval_ - Clock::duration(1)) /
+        frameInterval_;
+    return epoch_ + frames * frameInterval_;
+  }
+
+  // Run the next event, returning false if there is none
+  bool step() {
+    std::optional<Clock::time_point> outAt;
+    if (!outQueue_.empty()) {
+      outAt = outQueue_.front().at;
+    }
+    std::optional<Clock::time_point> inAt;
+    bool inTimesOut = false;
+    if (!inQueue_.empty()) {
+      const auto& in = inQueue_.front();
+      if (!reports_.empty()) {
+        // Responses go out in the frame after they are ready
+        auto readyAt = reports_.front().first + Clock::duration(1);
+        inAt = nextFrame(std::max(in.at, readyAt));
+      } else {
+        inAt = in.at + in.transfer->timeout;
+        inTimesOut = true;
+      }
+    }
+    if (!outAt && !inAt) {
+      return false;
+    }
+
+    if (outAt && (!inAt || *outAt <= *inAt)) {
+      std::this_thread::sleep_until(*outAt);
+      auto out = outQueue_.front();
+      outQueue_.pop_front();
+      processRequest(out.report, out.at);
+      complete(out.transfer, 0, out.transfer->length);
+    } else {
+      std::this_thread::sleep_until(*inAt);
+      auto in = inQueue_.front();
+      inQueue_.pop_front();
+      if (inTimesOut) {
+        complete(in.transfer, LIBUSB_ERROR_TIMEOUT, 0);
+      } else {
+        std::memcpy(in.transfer->buf, reports_.front().second.data(), 64);
+        reports_.pop_front();
+        complete(in.transfer, 0, 64);
+      }
+    }
+    return true;
+  }
+
+  void complete(UsbInterruptTransfer* transfer, int status, int length) {
+    transfer->status = status;
+    transfer->actualLength = length;
+    transfer->completed = true;
+  }
+
+  void queueReport(const Report& report, Clock::time_point readyAt) {
+    reports_.emplace_back(readyAt, report);
+  }
+
+  void startTransfer(
+      uint8_t address,
+      bool isRead,
+      size_t length,
+      Clock::time_point at) {
+    smbus_ = SmbusTransfer();
+    smbus_.active = true;
+    smbus_.isRead = isRead;
+    smbus_.doneAt = at + byteTime_ * (length + 1);
+    auto it = devices_.find(address);
+    if (it == devices_.end()) {
+      // Nobody acknowledges the address
+      smbus_.failed = true;
+      return;
+    }
+    if (isRead) {
+      auto& dev = it->second;
+      for (size_t i = 0; i < length; ++i) {
+        smbus_.data.push_back(dev.mem[dev.offset++]);
+      }
+    }
+  }
+
+  void write(uint8_t address, const uint8_t* data, size_t length) {
+    auto it = devices_.find(address);
+    if (it == devices_.end() || length == 0) {
+      return;
+    }
+    auto& dev = it->second;
+    dev.offset = data[0];
+    for (size_t i = 1; i < length; ++i) {
+      dev.mem[dev.offset++] = data[i];
+    }
+  }
+
+  void processRequest(const Report& request, Clock::time_point at) {
+    Report response{};
+    switch (request[0]) {
+      case kReadRequest:
+        startTransfer(request[1], true, (request[2] << 8) | request[3], at);
+        break;
+      case kWriteReadRequest: {
+        size_t length = (request[2] << 8) | request[3];
+        write(request[1], request.data() + 5, request[4]);
+        startTransfer(request[1], true, length, at);
+        // The write goes first, with its own address byte
+        smbus_.doneAt += byteTime_ * (request[4] + 1);
+        break;
+      }
+      case kWrite:
+        write(request[1], request.data() + 3, request[2]);
+        startTransfer(request[1], false, request[2], at);
+        break;
+      case kXferStatusRequest:
+        response[0] = kXferStatusResponse;
+        if (smbus_.active && at < smbus_.doneAt) {
+          response[1] = 1; // busy
+          response[2] = smbus_.isRead ? 2 : 3;
+        } else if (smbus_.active && smbus_.failed) {
+          response[1] = 3; // failed, address not acknowledged
+          response[2] = 0;
+        } else if (smbus_.active) {
+          response[1] = 2; // succeeded
+          response[2] = 5;
+          response[5] = smbus_.data.size() >> 8;
+          response[6] = smbus_.data.size() & 0xff;
+        }
+        queueReport(response, at);
+        break;
+      case kReadForceSend:
+        if (!smbus_.active || !smbus_.isRead || at < smbus_.doneAt) {
+          response[0] = kReadResponse;
+          response[1] = 1; // busy
+          queueReport(response, at);
+          break;
+        }
+        for (size_t pos = 0; pos < smbus_.data.size(); pos += 61) {
+          auto length = std::min<size_t>(61, smbus_.data.size() - pos);
+          response[0] = kReadResponse;
+          response[1] = 2; // read success
+          response[2] = length;
+          std::memcpy(response.data() + 3, smbus_.data.data() + pos, length);
+          queueReport(response, at);
+        }
+        // The device always finishes with a 0-length idle response
+        response = Report{};
+        response[0] = kReadResponse;
+        queueReport(response, at);
+        smbus_ = SmbusTransfer();
+        break;
+      case kCancelXfer:
+        smbus_ = SmbusTransfer();
+        break;
+      default:
+        LOG(FATAL) << "unexpected CP2112 request " << (int)request[0];
+    }
+  }
+
+  bool open_{false};
+  const Clock::time_point epoch_;
+  // Full speed USB device polled every frame
+  std::chrono::microseconds frameInterval_{1000};
+  // A byte and its ack at 400KHz
+  std::chrono::nanoseconds byteTime_{22500};
+  uint32_t numIntrTransfers_{0};
+
+  std::array<uint8_t, 14> smbusConfig_{kSmbusConfig};
+  std::map<uint8_t, Device> devices_;
+  SmbusTransfer smbus_;
+
+  Clock::time_point lastOutAt_;
+  std::deque<Pending> outQueue_;
+  std::deque<Pending> inQueue_;
+  std::deque<std::pair<Clock::time_point, Report>> reports_;
+};
+
+} // namespace facebook::fboss